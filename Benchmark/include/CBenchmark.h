@@ -0,0 +1,108 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CBenchmark.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_BENCHMARK_H_
+#define _C_BENCHMARK_H_
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+namespace vbtbenchmark
+{
+
+/**
+ * @brief Iteration state of a running benchmark
+ *
+ * Benchmark body loops on KeepRunning. The runner increases the iteration count until a run takes long enough to be
+ * measured and reports the time per iteration of that run. Only the loop is timed, setup of the benchmark before the first
+ * KeepRunning call is not measured.
+ */
+class CBenchmarkState
+{
+public:
+
+    CBenchmarkState(long long a_nIterationCount);
+
+    ///Returns true while there are iterations left to run
+    bool KeepRunning()
+    {
+        if(m_nRemaining == m_nIterationCount)
+            m_startTime = std::chrono::steady_clock::now();
+
+        if(m_nRemaining-- > 0)
+            return true;
+
+        m_endTime = std::chrono::steady_clock::now();
+        return false;
+    }
+
+    ///Return the number of iterations of the run
+    long long GetIterationCount() const;
+
+    ///Sets the number of items processed in each iteration, reported as items per second
+    void SetItemsPerIteration(long long a_nItemCount);
+
+    ///Return the number of items processed in each iteration
+    long long GetItemsPerIteration() const;
+
+    ///Return the time spent in the benchmark loop in seconds
+    double GetElapsedSeconds() const;
+
+private:
+
+    long long m_nIterationCount;
+    long long m_nRemaining;
+    long long m_nItemsPerIteration;
+    std::chrono::steady_clock::time_point m_startTime;
+    std::chrono::steady_clock::time_point m_endTime;
+};
+
+typedef void (*BenchmarkFunction)(CBenchmarkState&);
+
+///Registers a benchmark function on static initialization
+class CBenchmarkRegistration
+{
+public:
+    CBenchmarkRegistration(const char* a_pName, BenchmarkFunction a_pFunction);
+};
+
+///Runs the registered benchmarks whose name contains the given filter. Returns the number of benchmarks run
+int RunBenchmarks(const std::string& a_rFilter, double a_dMinTime);
+
+///Prevents the compiler from optimizing out the computation of the given value
+template <typename T>
+inline void DoNotOptimize(const T& a_rValue)
+{
+    asm volatile("" : : "g"(&a_rValue) : "memory");
+}
+
+}
+
+///Defines and registers a benchmark function
+#define VBT_BENCHMARK(name) \
+    static void name(vbtbenchmark::CBenchmarkState&); \
+    static vbtbenchmark::CBenchmarkRegistration name##_registration(#name, name); \
+    static void name(vbtbenchmark::CBenchmarkState& a_rState)
+
+#endif // _C_BENCHMARK_H_
@@ -0,0 +1,103 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CReplayCheck.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_REPLAY_CHECK_H_
+#define _C_REPLAY_CHECK_H_
+
+#include "CSyntheticVariantGenerator.h"
+#include "CTaskScheduler.h"
+#include <string>
+#include <vector>
+#include <map>
+
+namespace vbtbenchmark
+{
+
+///Synthetic workload of the replay check and the replay limits it runs with
+struct SReplayCheckCase
+{
+    std::string m_name;
+    SSyntheticWorkloadConfig m_workload;
+    int m_nMaxPathSize;
+    int m_nMaxIterationCount;
+};
+
+///Best path decisions and the variant status of a single replay of a case
+struct SReplayCheckResult
+{
+    ///Decision of each variant (see core::EVariantDecision) and the sync points of the genotype match best path
+    std::vector<int> m_aGenotypeDecisionsBase;
+    std::vector<int> m_aGenotypeDecisionsCalled;
+    std::vector<int> m_aGenotypeSyncPoints;
+    ///Decisions of the allele match best path, indexed by the order of the variants excluded by the genotype match
+    std::vector<int> m_aAlleleDecisionsBase;
+    std::vector<int> m_aAlleleDecisionsCalled;
+    std::vector<int> m_aAlleleSyncPoints;
+    ///Variant status after both replays, approximate variants are marked by adding 100
+    std::vector<int> m_aStatusBase;
+    std::vector<int> m_aStatusCalled;
+};
+
+/**
+ * @brief Regression check of the best path decisions of the replay on synthetic chromosomes
+ *
+ * Each case is replayed serially in genotype match mode and then in allele match mode on the excluded variants, as the
+ * comparison tools do. The decisions of every variant, the sync points and the variant status are compared with:
+ *  - the fused parallel replay (CParallelPathReplay::FindBestPaths) on 2, 4 and 8 threads, which split the case into
+ *    different blocks
+ *  - the summary of the case in the golden file (counts of the included variants and a hash of all values)
+ *
+ * Cases need no input files, and some of them have many regions skipped as too complex.
+ */
+class CReplayCheck
+{
+public:
+
+    /**
+     * @brief Runs the check. Returns 0 if all cases pass, 1 if any case fails and -1 on error
+     *
+     * @param a_rGoldenPath Golden file of the case summaries
+     * @param a_bUpdateGolden Write the summaries of the serial replays to the golden file instead of comparing
+     */
+    int Run(const std::string& a_rGoldenPath, bool a_bUpdateGolden);
+
+private:
+
+    ///Replays the case serially or in parallel on the given scheduler (serially if it is NULL)
+    void Replay(const SReplayCheckCase& a_rCase, core::CTaskScheduler* a_pScheduler, SReplayCheckResult& a_rResult) const;
+
+    ///Compares the results of a case and prints the first difference. Returns false if they differ
+    bool Compare(const SReplayCheckCase& a_rCase, int a_nThreadCount, const SReplayCheckResult& a_rSerial, const SReplayCheckResult& a_rParallel) const;
+
+    ///Return the summary of the result written to the golden file
+    std::string GetSummary(const SReplayCheckResult& a_rResult) const;
+
+    ///Reads the case summaries of the golden file. Returns false if the file cannot be read
+    bool ReadGolden(const std::string& a_rGoldenPath, std::map<std::string, std::string>& a_rSummaries) const;
+
+    bool WriteGolden(const std::string& a_rGoldenPath, const std::vector<std::string>& a_rCaseNames, const std::vector<std::string>& a_rSummaries) const;
+};
+
+}
+
+#endif // _C_REPLAY_CHECK_H_
@@ -0,0 +1,164 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CSyntheticVariantGenerator.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_SYNTHETIC_VARIANT_GENERATOR_H_
+#define _C_SYNTHETIC_VARIANT_GENERATOR_H_
+
+#include "CVariant.h"
+#include "COrientedVariant.h"
+#include "CFastaParser.h"
+#include "EVcfName.h"
+#include <string>
+#include <vector>
+#include <random>
+
+namespace vbtbenchmark
+{
+
+///Parameters of a synthetic workload. Densities are the expected number of variant events per reference base
+struct SSyntheticWorkloadConfig
+{
+    ///Seed of the generator, the same configuration always generates the same workload
+    unsigned int m_nSeed = 1;
+
+    std::string m_chromosomeName = "chrSynthetic";
+    int m_nReferenceLength = 100000;
+
+    double m_dSnpDensity = 0.001;
+    double m_dIndelDensity = 0.0002;
+    ///Length of the inserted or deleted sequence is uniform in [1, m_nMaxIndelLength]
+    int m_nMaxIndelLength = 8;
+
+    ///Fraction of the heterozygous variants, the rest are homozygous alternate
+    double m_dHeterozygousRatio = 0.6;
+
+    ///Probability that a variant event is a cluster of nearby and overlapping variants, and the largest variant count of a cluster
+    double m_dClusterRate = 0.02;
+    int m_nMaxClusterSize = 6;
+
+    ///Fraction of the reference made of short tandem repeats. Half of the insertions duplicate the following reference bases
+    double m_dRepeatFraction = 0.1;
+
+    ///Fraction of the base variants that are called identically and called with a different genotype or allele. The rest are missed
+    double m_dCalledMatchRate = 0.9;
+    double m_dCalledMismatchRate = 0.05;
+    ///Number of false positive calls per base variant
+    double m_dFalsePositiveRate = 0.05;
+};
+
+///Variant record of a synthetic vcf. Indels include the anchor base as in VCF
+struct SSyntheticRecord
+{
+    ///0-based position of the REF sequence
+    int m_nPosition;
+    std::string m_ref;
+    std::vector<std::string> m_alts;
+    ///Genotype of the single sample (indexes to REF and ALT alleles)
+    int m_genotype[2];
+};
+
+///Variant lists of a single vcf in the form the comparison core takes them
+struct SSyntheticVariantLists
+{
+    std::vector<const CVariant*> m_aVariantList;
+    ///Two genotype match oriented variants of each variant
+    std::vector<const core::COrientedVariant*> m_aOrientedVariantList;
+};
+
+/**
+ * @brief Generates reproducible base and called variant sets for benchmarking the comparison engine
+ *
+ * Reference is a random sequence with short tandem repeats. Base variants are SNPs and indels placed with the given densities,
+ * some of them in clusters of overlapping variants. Called variants are derived from the base variants by copying, changing the
+ * genotype or the allele, dropping them and adding false positives. Variants are built the same way CVcfReader builds them in
+ * reference overlap mode, and the records can be written as VCF and FASTA files to benchmark the whole tool.
+ */
+class CSyntheticVariantGenerator
+{
+public:
+
+    ///Generates the reference and the base and called variants of the given workload
+    void Generate(const SSyntheticWorkloadConfig& a_rConfig);
+
+    ///Return the generated reference sequence
+    const std::string& GetReference() const;
+
+    ///Return the contig of the generated reference. Sequence is owned by the generator
+    SContig GetContig();
+
+    ///Return the records of the given vcf in position order
+    const std::vector<SSyntheticRecord>& GetRecords(EVcfName a_uVcfName) const;
+
+    ///Return the variants of the given vcf sorted by their start position
+    const std::vector<CVariant>& GetVariants(EVcfName a_uVcfName) const;
+
+    ///Fills the variant list and the oriented variant list of the given vcf
+    void GetVariantLists(EVcfName a_uVcfName, SSyntheticVariantLists& a_rLists) const;
+
+    ///Writes the records of the given vcf as a single sample VCF file. Returns false if the file cannot be written
+    bool WriteVcf(EVcfName a_uVcfName, const std::string& a_rFilePath) const;
+
+    ///Writes the reference as a FASTA file. Returns false if the file cannot be written
+    bool WriteFasta(const std::string& a_rFilePath) const;
+
+private:
+
+    ///Return a uniformly distributed integer in [0, a_nRange)
+    int Uniform(int a_nRange);
+
+    ///Return true with the given probability
+    bool Chance(double a_dProbability);
+
+    ///Return a nucleotide other than the given one
+    char OtherBase(char a_cBase);
+
+    void GenerateReference();
+
+    ///Generates the ALT allele of a SNP or an indel anchored at the given position and sets the REF of the record accordingly
+    void GenerateAllele(SSyntheticRecord& a_rRecord, bool a_bIsSnp);
+
+    ///Generates a record at the given position with the configured variant type and genotype ratios
+    SSyntheticRecord GenerateRecord(int a_nPosition);
+
+    void GenerateBaseRecords();
+
+    void GenerateCalledRecords();
+
+    ///Builds the variants and the oriented variants of the given vcf from its records
+    void BuildVariants(EVcfName a_uVcfName);
+
+    SSyntheticWorkloadConfig m_config;
+    std::mt19937 m_random;
+
+    std::string m_reference;
+
+    std::vector<SSyntheticRecord> m_aRecords[2];
+    ///Strings of the variants of each vcf
+    CVariantArena m_aArenas[2];
+    std::vector<CVariant> m_aVariants[2];
+    std::vector<core::COrientedVariant> m_aOrientedVariants[2];
+};
+
+}
+
+#endif // _C_SYNTHETIC_VARIANT_GENERATOR_H_
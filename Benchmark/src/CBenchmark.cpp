@@ -0,0 +1,134 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CBenchmark.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CBenchmark.h"
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+using namespace vbtbenchmark;
+
+namespace
+{
+
+struct SBenchmark
+{
+    const char* m_pName;
+    BenchmarkFunction m_pFunction;
+};
+
+//Constructed on first use, registrations run during static initialization of the other translation units
+std::vector<SBenchmark>& GetBenchmarks()
+{
+    static std::vector<SBenchmark> benchmarks;
+    return benchmarks;
+}
+
+//Runs the benchmark with the given iteration count and returns the elapsed time of its loop in seconds
+double RunOnce(const SBenchmark& a_rBenchmark, long long a_nIterationCount, long long* a_pItemsPerIteration)
+{
+    CBenchmarkState state(a_nIterationCount);
+    a_rBenchmark.m_pFunction(state);
+
+    if(a_pItemsPerIteration != NULL)
+        *a_pItemsPerIteration = state.GetItemsPerIteration();
+    return state.GetElapsedSeconds();
+}
+
+}
+
+CBenchmarkState::CBenchmarkState(long long a_nIterationCount)
+: m_nIterationCount(a_nIterationCount),
+  m_nRemaining(a_nIterationCount),
+  m_nItemsPerIteration(0),
+  m_startTime(std::chrono::steady_clock::now()),
+  m_endTime(m_startTime)
+{
+}
+
+long long CBenchmarkState::GetIterationCount() const
+{
+    return m_nIterationCount;
+}
+
+void CBenchmarkState::SetItemsPerIteration(long long a_nItemCount)
+{
+    m_nItemsPerIteration = a_nItemCount;
+}
+
+long long CBenchmarkState::GetItemsPerIteration() const
+{
+    return m_nItemsPerIteration;
+}
+
+double CBenchmarkState::GetElapsedSeconds() const
+{
+    return std::chrono::duration<double>(m_endTime - m_startTime).count();
+}
+
+CBenchmarkRegistration::CBenchmarkRegistration(const char* a_pName, BenchmarkFunction a_pFunction)
+{
+    SBenchmark benchmark = {a_pName, a_pFunction};
+    GetBenchmarks().push_back(benchmark);
+}
+
+int vbtbenchmark::RunBenchmarks(const std::string& a_rFilter, double a_dMinTime)
+{
+    int runCount = 0;
+
+    std::printf("%-40s %15s %15s %15s\n", "Benchmark", "Time(ns)", "Iterations", "Items/s");
+
+    for(unsigned int k = 0; k < GetBenchmarks().size(); k++)
+    {
+        const SBenchmark& benchmark = GetBenchmarks()[k];
+        if(std::string(benchmark.m_pName).find(a_rFilter) == std::string::npos)
+            continue;
+
+        //Increase the iteration count until the run is long enough to be measured. Calibration runs also warm up the caches
+        //and the allocator, the reported time is taken from a separate run with the final iteration count
+        long long iterationCount = 1;
+        while(iterationCount < (1LL << 40))
+        {
+            double elapsed = RunOnce(benchmark, iterationCount, NULL);
+            if(elapsed >= a_dMinTime)
+                break;
+
+            //Aim slightly above the minimum time, growing at most 10 times per run
+            long long nextCount = elapsed > 0 ? static_cast<long long>(iterationCount * a_dMinTime * 1.4 / elapsed) : iterationCount * 10;
+            iterationCount = std::max(iterationCount + 1, std::min(nextCount, iterationCount * 10));
+        }
+
+        long long itemsPerIteration = 0;
+        const double elapsed = RunOnce(benchmark, iterationCount, &itemsPerIteration);
+
+        const double nsPerIteration = elapsed * 1e9 / iterationCount;
+        if(itemsPerIteration > 0)
+            std::printf("%-40s %15.1f %15lld %15.0f\n", benchmark.m_pName, nsPerIteration, iterationCount, itemsPerIteration * iterationCount / elapsed);
+        else
+            std::printf("%-40s %15.1f %15lld %15s\n", benchmark.m_pName, nsPerIteration, iterationCount, "-");
+        std::fflush(stdout);
+        runCount++;
+    }
+
+    return runCount;
+}
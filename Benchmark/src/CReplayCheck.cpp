@@ -0,0 +1,361 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CReplayCheck.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CReplayCheck.h"
+#include "CPathReplay.h"
+#include "CParallelPathReplay.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+using namespace core;
+using namespace vbtbenchmark;
+
+namespace
+{
+
+std::vector<SReplayCheckCase> GetReplayCheckCases()
+{
+    std::vector<SReplayCheckCase> cases;
+
+    SReplayCheckCase clustered;
+    clustered.m_name = "clustered";
+    clustered.m_workload.m_nSeed = 1;
+    clustered.m_workload.m_nReferenceLength = 300000;
+    clustered.m_workload.m_dSnpDensity = 0.02;
+    clustered.m_workload.m_dIndelDensity = 0.01;
+    clustered.m_workload.m_dClusterRate = 0.2;
+    clustered.m_workload.m_nMaxClusterSize = 6;
+    clustered.m_workload.m_dRepeatFraction = 0.3;
+    clustered.m_workload.m_nMaxIndelLength = 10;
+    clustered.m_nMaxPathSize = DEFAULT_MAX_PATH_SIZE;
+    clustered.m_nMaxIterationCount = DEFAULT_MAX_ITERATION_SIZE;
+    cases.push_back(clustered);
+
+    //Low limits skip many regions as too complex. When the paths of a block end in such a region, the included variants of its
+    //best path are not in variant index order
+    SReplayCheckCase complexSkips = clustered;
+    complexSkips.m_name = "complex_skips";
+    complexSkips.m_workload.m_nSeed = 15;
+    complexSkips.m_workload.m_nReferenceLength = 200000;
+    complexSkips.m_workload.m_dSnpDensity = 0.05;
+    complexSkips.m_workload.m_dIndelDensity = 0.05;
+    complexSkips.m_workload.m_dClusterRate = 0.1;
+    complexSkips.m_workload.m_nMaxClusterSize = 8;
+    complexSkips.m_nMaxPathSize = 40;
+    complexSkips.m_nMaxIterationCount = 3000;
+    cases.push_back(complexSkips);
+
+    return cases;
+}
+
+void GetDecisions(const CDecisionArray& a_rDecisions, std::vector<int>& a_rValues)
+{
+    a_rValues.resize(a_rDecisions.GetVariantCount());
+    for(int k = 0; k < a_rDecisions.GetVariantCount(); k++)
+        a_rValues[k] = a_rDecisions.Get(k);
+}
+
+void GetStatus(const std::vector<const CVariant*>& a_rVariantList, std::vector<int>& a_rValues)
+{
+    a_rValues.resize(a_rVariantList.size());
+    for(unsigned int k = 0; k < a_rVariantList.size(); k++)
+        a_rValues[k] = a_rVariantList[k]->m_variantStatus + (a_rVariantList[k]->m_bIsApproximate ? 100 : 0);
+}
+
+//Returns the index of the first difference of the given values, -1 if they are equal
+int FindDifference(const std::vector<int>& a_rFirst, const std::vector<int>& a_rSecond)
+{
+    for(unsigned int k = 0; k < a_rFirst.size() && k < a_rSecond.size(); k++)
+    {
+        if(a_rFirst[k] != a_rSecond[k])
+            return k;
+    }
+
+    return a_rFirst.size() == a_rSecond.size() ? -1 : (int)std::min(a_rFirst.size(), a_rSecond.size());
+}
+
+const int VALUE_LIST_COUNT = 8;
+const char* VALUE_LIST_NAMES[VALUE_LIST_COUNT] = {"genotype match base decision", "genotype match called decision", "genotype match sync point",
+                                                  "allele match base decision", "allele match called decision", "allele match sync point",
+                                                  "base variant status", "called variant status"};
+
+void GetValueLists(const SReplayCheckResult& a_rResult, const std::vector<int>* a_pValueLists[VALUE_LIST_COUNT])
+{
+    a_pValueLists[0] = &a_rResult.m_aGenotypeDecisionsBase;
+    a_pValueLists[1] = &a_rResult.m_aGenotypeDecisionsCalled;
+    a_pValueLists[2] = &a_rResult.m_aGenotypeSyncPoints;
+    a_pValueLists[3] = &a_rResult.m_aAlleleDecisionsBase;
+    a_pValueLists[4] = &a_rResult.m_aAlleleDecisionsCalled;
+    a_pValueLists[5] = &a_rResult.m_aAlleleSyncPoints;
+    a_pValueLists[6] = &a_rResult.m_aStatusBase;
+    a_pValueLists[7] = &a_rResult.m_aStatusCalled;
+}
+
+int CountIncluded(const std::vector<int>& a_rDecisions)
+{
+    return (int)std::count_if(a_rDecisions.begin(), a_rDecisions.end(), [](int a_nDecision) { return a_nDecision >= eDECISION_INCLUDED_FIRST; });
+}
+
+//FNV-1a hash of the values
+void AddToHash(uint64_t& a_rHash, int a_nValue)
+{
+    for(int k = 0; k < 4; k++)
+    {
+        a_rHash ^= (a_nValue >> (8 * k)) & 0xFF;
+        a_rHash *= 1099511628211ULL;
+    }
+}
+
+}
+
+int CReplayCheck::Run(const std::string& a_rGoldenPath, bool a_bUpdateGolden)
+{
+    std::map<std::string, std::string> goldenSummaries;
+    if(!a_bUpdateGolden && !ReadGolden(a_rGoldenPath, goldenSummaries))
+        return -1;
+
+    const int threadCounts[3] = {2, 4, 8};
+    std::vector<std::string> caseNames;
+    std::vector<std::string> summaries;
+    bool isPassed = true;
+
+    for(const SReplayCheckCase& rCase : GetReplayCheckCases())
+    {
+        SReplayCheckResult serialResult;
+        Replay(rCase, NULL, serialResult);
+        caseNames.push_back(rCase.m_name);
+        summaries.push_back(GetSummary(serialResult));
+
+        if(a_bUpdateGolden)
+        {
+            std::cout << rCase.m_name << " " << summaries.back() << std::endl;
+            continue;
+        }
+
+        bool isCasePassed = true;
+        std::map<std::string, std::string>::const_iterator golden = goldenSummaries.find(rCase.m_name);
+        if(golden == goldenSummaries.end() || golden->second != summaries.back())
+        {
+            std::cout << "FAIL " << rCase.m_name << ": summary of the serial replay differs from " << a_rGoldenPath << std::endl;
+            std::cout << "  expected: " << (golden == goldenSummaries.end() ? "none" : golden->second) << std::endl;
+            std::cout << "  actual:   " << summaries.back() << std::endl;
+            isCasePassed = false;
+        }
+
+        for(int k = 0; k < 3 && isCasePassed; k++)
+        {
+            CTaskScheduler scheduler(threadCounts[k]);
+            SReplayCheckResult parallelResult;
+            Replay(rCase, &scheduler, parallelResult);
+            isCasePassed = Compare(rCase, threadCounts[k], serialResult, parallelResult);
+        }
+
+        if(isCasePassed)
+        {
+            std::cout << "PASS " << rCase.m_name << " (" << serialResult.m_aGenotypeDecisionsBase.size() << " base, ";
+            std::cout << serialResult.m_aGenotypeDecisionsCalled.size() << " called variants)" << std::endl;
+        }
+        isPassed = isPassed && isCasePassed;
+    }
+
+    if(a_bUpdateGolden)
+        return WriteGolden(a_rGoldenPath, caseNames, summaries) ? 0 : -1;
+
+    return isPassed ? 0 : 1;
+}
+
+void CReplayCheck::Replay(const SReplayCheckCase& a_rCase, CTaskScheduler* a_pScheduler, SReplayCheckResult& a_rResult) const
+{
+    //Each replay generates its own variants since the replay sets their status
+    CSyntheticVariantGenerator generator;
+    generator.Generate(a_rCase.m_workload);
+
+    SSyntheticVariantLists baseLists;
+    SSyntheticVariantLists calledLists;
+    generator.GetVariantLists(eBASE, baseLists);
+    generator.GetVariantLists(eCALLED, calledLists);
+    SContig contig = generator.GetContig();
+
+    //Messages of the skipped complex regions are not printed
+    std::stringstream replayMessages;
+    std::streambuf* pErrorBuffer = std::cerr.rdbuf(replayMessages.rdbuf());
+
+    CPath genotypeMatchPath;
+    CPath alleleMatchPath;
+    if(a_pScheduler == NULL)
+    {
+        CPathReplay genotypeReplay(baseLists.m_aVariantList, calledLists.m_aVariantList, baseLists.m_aOrientedVariantList, calledLists.m_aOrientedVariantList);
+        genotypeReplay.SetPrintSummary(false);
+        genotypeReplay.SetMaxPathAndIteration(a_rCase.m_nMaxPathSize, a_rCase.m_nMaxIterationCount);
+        genotypeMatchPath = genotypeReplay.FindBestPath(contig, true);
+
+        //Allele match replay of the excluded variants with a single allele on both haplotypes
+        std::vector<const CVariant*> varListBase;
+        std::vector<const CVariant*> varListCalled;
+        for(int k = 0; k < genotypeMatchPath.m_baseSemiPath.GetDecisions().GetVariantCount(); k++)
+        {
+            if(genotypeMatchPath.m_baseSemiPath.GetDecisions().IsExcluded(k))
+                varListBase.push_back(baseLists.m_aVariantList[k]);
+        }
+        for(int k = 0; k < genotypeMatchPath.m_calledSemiPath.GetDecisions().GetVariantCount(); k++)
+        {
+            if(genotypeMatchPath.m_calledSemiPath.GetDecisions().IsExcluded(k))
+                varListCalled.push_back(calledLists.m_aVariantList[k]);
+        }
+
+        std::vector<COrientedVariant> ovarsBase;
+        std::vector<COrientedVariant> ovarsCalled;
+        for(unsigned int k = 0; k < varListBase.size(); k++)
+        {
+            ovarsBase.push_back(COrientedVariant(*varListBase[k], 0));
+            ovarsBase.push_back(COrientedVariant(*varListBase[k], 1));
+        }
+        for(unsigned int k = 0; k < varListCalled.size(); k++)
+        {
+            ovarsCalled.push_back(COrientedVariant(*varListCalled[k], 0));
+            ovarsCalled.push_back(COrientedVariant(*varListCalled[k], 1));
+        }
+
+        std::vector<const COrientedVariant*> ovarListBase;
+        std::vector<const COrientedVariant*> ovarListCalled;
+        for(unsigned int k = 0; k < ovarsBase.size(); k++)
+            ovarListBase.push_back(&ovarsBase[k]);
+        for(unsigned int k = 0; k < ovarsCalled.size(); k++)
+            ovarListCalled.push_back(&ovarsCalled[k]);
+
+        CPathReplay alleleReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
+        alleleReplay.SetPrintSummary(false);
+        alleleReplay.SetMaxPathAndIteration(a_rCase.m_nMaxPathSize, a_rCase.m_nMaxIterationCount);
+        alleleMatchPath = alleleReplay.FindBestPath(contig, false);
+    }
+    else
+    {
+        CParallelPathReplay replay(baseLists.m_aVariantList, calledLists.m_aVariantList, baseLists.m_aOrientedVariantList, calledLists.m_aOrientedVariantList);
+        replay.SetScheduler(a_pScheduler);
+        replay.SetMaxPathAndIteration(a_rCase.m_nMaxPathSize, a_rCase.m_nMaxIterationCount);
+        replay.FindBestPaths(contig, genotypeMatchPath, alleleMatchPath);
+    }
+
+    std::cerr.rdbuf(pErrorBuffer);
+
+    GetDecisions(genotypeMatchPath.m_baseSemiPath.GetDecisions(), a_rResult.m_aGenotypeDecisionsBase);
+    GetDecisions(genotypeMatchPath.m_calledSemiPath.GetDecisions(), a_rResult.m_aGenotypeDecisionsCalled);
+    a_rResult.m_aGenotypeSyncPoints = genotypeMatchPath.m_aSyncPointList;
+    GetDecisions(alleleMatchPath.m_baseSemiPath.GetDecisions(), a_rResult.m_aAlleleDecisionsBase);
+    GetDecisions(alleleMatchPath.m_calledSemiPath.GetDecisions(), a_rResult.m_aAlleleDecisionsCalled);
+    a_rResult.m_aAlleleSyncPoints = alleleMatchPath.m_aSyncPointList;
+    GetStatus(baseLists.m_aVariantList, a_rResult.m_aStatusBase);
+    GetStatus(calledLists.m_aVariantList, a_rResult.m_aStatusCalled);
+}
+
+bool CReplayCheck::Compare(const SReplayCheckCase& a_rCase, int a_nThreadCount, const SReplayCheckResult& a_rSerial, const SReplayCheckResult& a_rParallel) const
+{
+    const std::vector<int>* pSerialValues[VALUE_LIST_COUNT];
+    const std::vector<int>* pParallelValues[VALUE_LIST_COUNT];
+    GetValueLists(a_rSerial, pSerialValues);
+    GetValueLists(a_rParallel, pParallelValues);
+
+    for(int k = 0; k < VALUE_LIST_COUNT; k++)
+    {
+        const int index = FindDifference(*pSerialValues[k], *pParallelValues[k]);
+        if(index == -1)
+            continue;
+
+        std::cout << "FAIL " << a_rCase.m_name << ": " << VALUE_LIST_NAMES[k] << " " << index << " differs between the serial replay and the parallel replay on " << a_nThreadCount << " threads (";
+        std::cout << (index < (int)pSerialValues[k]->size() ? std::to_string((*pSerialValues[k])[index]) : "none") << " vs ";
+        std::cout << (index < (int)pParallelValues[k]->size() ? std::to_string((*pParallelValues[k])[index]) : "none") << ")" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+std::string CReplayCheck::GetSummary(const SReplayCheckResult& a_rResult) const
+{
+    const std::vector<int>* pValues[VALUE_LIST_COUNT];
+    GetValueLists(a_rResult, pValues);
+
+    //List sizes are hashed too, so that values moving between the lists change the hash
+    uint64_t hash = 14695981039346656037ULL;
+    for(int k = 0; k < VALUE_LIST_COUNT; k++)
+    {
+        AddToHash(hash, (int)pValues[k]->size());
+        for(unsigned int j = 0; j < pValues[k]->size(); j++)
+            AddToHash(hash, (*pValues[k])[j]);
+    }
+
+    char hashText[17];
+    snprintf(hashText, sizeof(hashText), "%016llx", (unsigned long long)hash);
+
+    std::stringstream summary;
+    summary << a_rResult.m_aGenotypeDecisionsBase.size() << " " << a_rResult.m_aGenotypeDecisionsCalled.size() << " ";
+    summary << CountIncluded(a_rResult.m_aGenotypeDecisionsBase) << " " << CountIncluded(a_rResult.m_aGenotypeDecisionsCalled) << " ";
+    summary << CountIncluded(a_rResult.m_aAlleleDecisionsBase) << " " << CountIncluded(a_rResult.m_aAlleleDecisionsCalled) << " ";
+    summary << a_rResult.m_aGenotypeSyncPoints.size() << " " << hashText;
+    return summary.str();
+}
+
+bool CReplayCheck::ReadGolden(const std::string& a_rGoldenPath, std::map<std::string, std::string>& a_rSummaries) const
+{
+    std::ifstream goldenFile(a_rGoldenPath.c_str());
+    if(!goldenFile.is_open())
+    {
+        std::cerr << "Golden file " << a_rGoldenPath << " cannot be read" << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while(std::getline(goldenFile, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+
+        const size_t separator = line.find(' ');
+        if(separator != std::string::npos)
+            a_rSummaries[line.substr(0, separator)] = line.substr(separator + 1);
+    }
+
+    return true;
+}
+
+bool CReplayCheck::WriteGolden(const std::string& a_rGoldenPath, const std::vector<std::string>& a_rCaseNames, const std::vector<std::string>& a_rSummaries) const
+{
+    std::ofstream goldenFile(a_rGoldenPath.c_str());
+    if(!goldenFile.is_open())
+    {
+        std::cerr << "Golden file " << a_rGoldenPath << " cannot be written" << std::endl;
+        return false;
+    }
+
+    goldenFile << "#Written by vbt-bench -replay-check -update-golden. Fields: case, base and called variant counts, included base and" << std::endl;
+    goldenFile << "#called variants of the genotype match and the allele match, genotype match sync points, hash of all decisions and status" << std::endl;
+    for(unsigned int k = 0; k < a_rCaseNames.size(); k++)
+        goldenFile << a_rCaseNames[k] << " " << a_rSummaries[k] << std::endl;
+
+    std::cout << "Golden file is written to " << a_rGoldenPath << std::endl;
+    return true;
+}
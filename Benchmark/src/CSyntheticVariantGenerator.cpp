@@ -0,0 +1,433 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CSyntheticVariantGenerator.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CSyntheticVariantGenerator.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <climits>
+#include <cmath>
+
+using namespace vbtbenchmark;
+
+namespace
+{
+
+const char NUCLEOTIDES[] = "ACGT";
+
+//Repeat units are 1-6 bases long with 3-12 copies
+const int MAX_REPEAT_UNIT_LENGTH = 6;
+const int MIN_REPEAT_COPY_COUNT = 3;
+const int MAX_REPEAT_COPY_COUNT = 12;
+const double AVERAGE_REPEAT_LENGTH = 3.5 * 7.5;
+
+//Fraction of the heterozygous variants with two different ALT alleles
+const double MULTI_ALLELIC_RATIO = 0.1;
+
+//Distance kept from the contig end so that the longest indel and its anchor base fit in the reference
+const int CONTIG_END_MARGIN = 2;
+
+}
+
+void CSyntheticVariantGenerator::Generate(const SSyntheticWorkloadConfig& a_rConfig)
+{
+    m_config = a_rConfig;
+    m_random.seed(a_rConfig.m_nSeed);
+
+    GenerateReference();
+    GenerateBaseRecords();
+    GenerateCalledRecords();
+    BuildVariants(eBASE);
+    BuildVariants(eCALLED);
+}
+
+const std::string& CSyntheticVariantGenerator::GetReference() const
+{
+    return m_reference;
+}
+
+SContig CSyntheticVariantGenerator::GetContig()
+{
+    SContig contig;
+    contig.m_chromosomeName = m_config.m_chromosomeName;
+    contig.m_pRefSeq = &m_reference[0];
+    contig.m_nRefLength = (int)m_reference.size();
+    return contig;
+}
+
+const std::vector<SSyntheticRecord>& CSyntheticVariantGenerator::GetRecords(EVcfName a_uVcfName) const
+{
+    return m_aRecords[a_uVcfName];
+}
+
+const std::vector<CVariant>& CSyntheticVariantGenerator::GetVariants(EVcfName a_uVcfName) const
+{
+    return m_aVariants[a_uVcfName];
+}
+
+void CSyntheticVariantGenerator::GetVariantLists(EVcfName a_uVcfName, SSyntheticVariantLists& a_rLists) const
+{
+    a_rLists.m_aVariantList.clear();
+    a_rLists.m_aOrientedVariantList.clear();
+
+    for(unsigned int k = 0; k < m_aVariants[a_uVcfName].size(); k++)
+        a_rLists.m_aVariantList.push_back(&m_aVariants[a_uVcfName][k]);
+    for(unsigned int k = 0; k < m_aOrientedVariants[a_uVcfName].size(); k++)
+        a_rLists.m_aOrientedVariantList.push_back(&m_aOrientedVariants[a_uVcfName][k]);
+}
+
+bool CSyntheticVariantGenerator::WriteVcf(EVcfName a_uVcfName, const std::string& a_rFilePath) const
+{
+    std::ofstream file(a_rFilePath.c_str());
+    if(!file.is_open())
+    {
+        std::cerr << "Synthetic vcf file " << a_rFilePath << " cannot be opened" << std::endl;
+        return false;
+    }
+
+    file << "##fileformat=VCFv4.2" << std::endl;
+    file << "##FILTER=<ID=PASS,Description=\"All filters passed\">" << std::endl;
+    file << "##contig=<ID=" << m_config.m_chromosomeName << ",length=" << m_reference.size() << ">" << std::endl;
+    file << "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">" << std::endl;
+    file << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tSAMPLE" << std::endl;
+
+    const std::vector<SSyntheticRecord>& records = m_aRecords[a_uVcfName];
+    for(unsigned int k = 0; k < records.size(); k++)
+    {
+        const SSyntheticRecord& record = records[k];
+        file << m_config.m_chromosomeName << '\t' << (record.m_nPosition + 1) << "\t.\t" << record.m_ref << '\t';
+        for(unsigned int m = 0; m < record.m_alts.size(); m++)
+            file << (m == 0 ? "" : ",") << record.m_alts[m];
+        file << "\t50\tPASS\t.\tGT\t" << record.m_genotype[0] << '/' << record.m_genotype[1] << '\n';
+    }
+
+    return file.good();
+}
+
+bool CSyntheticVariantGenerator::WriteFasta(const std::string& a_rFilePath) const
+{
+    std::ofstream file(a_rFilePath.c_str());
+    if(!file.is_open())
+    {
+        std::cerr << "Synthetic fasta file " << a_rFilePath << " cannot be opened" << std::endl;
+        return false;
+    }
+
+    const int lineLength = 60;
+    file << '>' << m_config.m_chromosomeName << std::endl;
+    for(unsigned int k = 0; k < m_reference.size(); k += lineLength)
+        file << m_reference.substr(k, lineLength) << '\n';
+
+    return file.good();
+}
+
+int CSyntheticVariantGenerator::Uniform(int a_nRange)
+{
+    return a_nRange <= 1 ? 0 : (int)(m_random() % (unsigned int)a_nRange);
+}
+
+bool CSyntheticVariantGenerator::Chance(double a_dProbability)
+{
+    return m_random() / 4294967296.0 < a_dProbability;
+}
+
+char CSyntheticVariantGenerator::OtherBase(char a_cBase)
+{
+    char base;
+    do
+        base = NUCLEOTIDES[Uniform(4)];
+    while(base == a_cBase);
+    return base;
+}
+
+void CSyntheticVariantGenerator::GenerateReference()
+{
+    //Probability of starting a repeat at a base so that the repeats cover the given fraction of the reference on average
+    const double repeatFraction = std::min(std::max(m_config.m_dRepeatFraction, 0.0), 0.99);
+    const double repeatStartRate = repeatFraction / (AVERAGE_REPEAT_LENGTH - (AVERAGE_REPEAT_LENGTH - 1) * repeatFraction);
+
+    m_reference.clear();
+    m_reference.reserve(m_config.m_nReferenceLength);
+
+    while((int)m_reference.size() < m_config.m_nReferenceLength)
+    {
+        if(Chance(repeatStartRate))
+        {
+            std::string unit;
+            const int unitLength = 1 + Uniform(MAX_REPEAT_UNIT_LENGTH);
+            for(int k = 0; k < unitLength; k++)
+                unit += NUCLEOTIDES[Uniform(4)];
+
+            const int copyCount = MIN_REPEAT_COPY_COUNT + Uniform(MAX_REPEAT_COPY_COUNT - MIN_REPEAT_COPY_COUNT + 1);
+            for(int k = 0; k < copyCount; k++)
+                m_reference += unit;
+        }
+        else
+            m_reference += NUCLEOTIDES[Uniform(4)];
+    }
+
+    m_reference.resize(m_config.m_nReferenceLength);
+}
+
+void CSyntheticVariantGenerator::GenerateAllele(SSyntheticRecord& a_rRecord, bool a_bIsSnp)
+{
+    const int position = a_rRecord.m_nPosition;
+
+    if(a_bIsSnp)
+    {
+        a_rRecord.m_ref = m_reference.substr(position, 1);
+        a_rRecord.m_alts.push_back(std::string(1, OtherBase(m_reference[position])));
+        return;
+    }
+
+    const int length = 1 + Uniform(m_config.m_nMaxIndelLength);
+    if(Chance(0.5))
+    {
+        a_rRecord.m_ref = m_reference.substr(position, length + 1);
+        a_rRecord.m_alts.push_back(m_reference.substr(position, 1));
+    }
+    else
+    {
+        //Duplication of the following bases expands the repeat the variant is in
+        std::string inserted;
+        if(Chance(0.5))
+            inserted = m_reference.substr(position + 1, length);
+        else
+        {
+            for(int k = 0; k < length; k++)
+                inserted += NUCLEOTIDES[Uniform(4)];
+        }
+        a_rRecord.m_ref = m_reference.substr(position, 1);
+        a_rRecord.m_alts.push_back(a_rRecord.m_ref + inserted);
+    }
+}
+
+SSyntheticRecord CSyntheticVariantGenerator::GenerateRecord(int a_nPosition)
+{
+    SSyntheticRecord record;
+    record.m_nPosition = a_nPosition;
+
+    const double variantDensity = m_config.m_dSnpDensity + m_config.m_dIndelDensity;
+    GenerateAllele(record, variantDensity <= 0 || Chance(m_config.m_dSnpDensity / variantDensity));
+
+    if(!Chance(m_config.m_dHeterozygousRatio))
+    {
+        record.m_genotype[0] = 1;
+        record.m_genotype[1] = 1;
+        return record;
+    }
+
+    record.m_genotype[0] = 0;
+    record.m_genotype[1] = 1;
+
+    if(Chance(MULTI_ALLELIC_RATIO))
+    {
+        //Second ALT allele of the same type sharing the REF allele
+        const std::string& ref = record.m_ref;
+        const std::string& alt = record.m_alts[0];
+        std::string secondAlt;
+
+        if(ref.length() == 1 && alt.length() == 1)
+        {
+            do
+                secondAlt = std::string(1, NUCLEOTIDES[Uniform(4)]);
+            while(secondAlt == ref || secondAlt == alt);
+        }
+        else if(alt.length() == 1)
+            secondAlt = ref.length() > 2 ? ref.substr(0, 1) + ref.substr(ref.length() - 1) : ref.substr(0, 1) + OtherBase(ref[1]);
+        else
+        {
+            secondAlt = ref;
+            for(unsigned int k = 1; k <= alt.length(); k++)
+                secondAlt += NUCLEOTIDES[Uniform(4)];
+        }
+
+        if(secondAlt != alt && secondAlt != ref)
+        {
+            record.m_alts.push_back(secondAlt);
+            record.m_genotype[0] = 1;
+            record.m_genotype[1] = 2;
+        }
+    }
+
+    return record;
+}
+
+void CSyntheticVariantGenerator::GenerateBaseRecords()
+{
+    std::vector<SSyntheticRecord>& records = m_aRecords[eBASE];
+    records.clear();
+
+    const double variantDensity = m_config.m_dSnpDensity + m_config.m_dIndelDensity;
+    if(variantDensity <= 0)
+        return;
+
+    const int lastPosition = m_config.m_nReferenceLength - m_config.m_nMaxIndelLength - CONTIG_END_MARGIN;
+    int position = 0;
+
+    while(true)
+    {
+        //Exponential gaps between the variant events
+        const double gap = -std::log(1.0 - m_random() / 4294967296.0) / variantDensity;
+        position += 1 + (int)std::min(gap, (double)INT_MAX / 2);
+        if(position >= lastPosition)
+            break;
+
+        //Variants of a cluster start before or right after the end of the previous one, so that they overlap or share a sync region
+        const int clusterSize = Chance(m_config.m_dClusterRate) ? 2 + Uniform(std::max(1, m_config.m_nMaxClusterSize - 1)) : 1;
+        for(int k = 0; k < clusterSize && position < lastPosition; k++)
+        {
+            records.push_back(GenerateRecord(position));
+            position += 1 + Uniform((int)records.back().m_ref.length() + 2);
+        }
+    }
+}
+
+void CSyntheticVariantGenerator::GenerateCalledRecords()
+{
+    const std::vector<SSyntheticRecord>& baseRecords = m_aRecords[eBASE];
+    std::vector<SSyntheticRecord>& records = m_aRecords[eCALLED];
+    records.clear();
+
+    for(unsigned int k = 0; k < baseRecords.size(); k++)
+    {
+        const double outcome = m_random() / 4294967296.0;
+
+        if(outcome < m_config.m_dCalledMatchRate)
+            records.push_back(baseRecords[k]);
+
+        else if(outcome < m_config.m_dCalledMatchRate + m_config.m_dCalledMismatchRate)
+        {
+            if(Chance(0.5))
+            {
+                //Genotype error: heterozygous calls become homozygous and vice versa
+                SSyntheticRecord record = baseRecords[k];
+                if(record.m_genotype[0] != record.m_genotype[1])
+                {
+                    record.m_alts.resize(1);
+                    record.m_genotype[0] = 1;
+                    record.m_genotype[1] = 1;
+                }
+                else
+                    record.m_genotype[0] = 0;
+                records.push_back(record);
+            }
+            else
+                records.push_back(GenerateRecord(baseRecords[k].m_nPosition));
+        }
+    }
+
+    const int lastPosition = m_config.m_nReferenceLength - m_config.m_nMaxIndelLength - CONTIG_END_MARGIN;
+    const int falsePositiveCount = (int)(baseRecords.size() * m_config.m_dFalsePositiveRate);
+    for(int k = 0; k < falsePositiveCount && lastPosition > 0; k++)
+        records.push_back(GenerateRecord(Uniform(lastPosition)));
+
+    std::stable_sort(records.begin(), records.end(), [](const SSyntheticRecord& a_rLhs, const SSyntheticRecord& a_rRhs)
+                     { return a_rLhs.m_nPosition < a_rRhs.m_nPosition; });
+}
+
+void CSyntheticVariantGenerator::BuildVariants(EVcfName a_uVcfName)
+{
+    const std::vector<SSyntheticRecord>& records = m_aRecords[a_uVcfName];
+    std::vector<CVariant>& variants = m_aVariants[a_uVcfName];
+    std::vector<core::COrientedVariant>& orientedVariants = m_aOrientedVariants[a_uVcfName];
+
+    CVariantArena& arena = m_aArenas[a_uVcfName];
+
+    orientedVariants.clear();
+    variants.assign(records.size(), CVariant());
+    arena = CVariantArena();
+    arena.SetContigName(m_config.m_chromosomeName);
+
+    //Same steps as CVcfReader::GetNextRecord in reference overlap mode (alleles are trimmed from the beginning first)
+    for(unsigned int k = 0; k < records.size(); k++)
+    {
+        const SSyntheticRecord& record = records[k];
+        CVariant& variant = variants[k];
+
+        variant.m_nVcfId = a_uVcfName;
+        variant.m_nChrId = 0;
+        variant.m_nId = k;
+        variant.SetArena(&arena);
+        variant.m_bIsFilterPASS = true;
+        variant.m_fQuality = 50;
+        variant.m_nZygotCount = 2;
+        variant.m_nOriginalPos = record.m_nPosition;
+        variant.m_bIsNoCall = false;
+
+        std::string allelesStr = record.m_ref;
+        for(unsigned int m = 0; m < record.m_alts.size(); m++)
+            allelesStr += "," + record.m_alts[m];
+        variant.SetAllelesStr(arena.AddSequence(allelesStr.data(), (int)allelesStr.size()), (int)record.m_ref.length());
+
+        for(int i = 0; i < 2; i++)
+        {
+            const int genotype = record.m_genotype[i];
+            variant.m_genotype[i] = genotype;
+            variant.SetAlleleSequence(i, genotype);
+            variant.m_alleles[i].m_nStartPos = record.m_nPosition;
+            variant.m_alleles[i].m_nEndPos = record.m_nPosition + (int)record.m_ref.length();
+        }
+
+        variant.m_bIsHeterozygous = variant.GetAlleleSeq(0) != variant.GetAlleleSeq(1);
+        variant.m_nAlleleCount = variant.m_bIsHeterozygous ? 2 : 1;
+
+        for(int i = 0; i < 2; i++)
+        {
+            if(record.m_genotype[i] == 0)
+                variant.m_alleles[i].m_bIsIgnored = true;
+            else
+                variant.TrimVariant(i, true);
+        }
+
+        int maxEnd = -1;
+        int minStart = INT_MAX;
+        for(int i = 0; i < variant.m_nAlleleCount; i++)
+        {
+            if(!variant.m_alleles[i].m_bIsIgnored)
+            {
+                maxEnd = std::max(maxEnd, variant.m_alleles[i].m_nEndPos);
+                minStart = std::min(minStart, variant.m_alleles[i].m_nStartPos);
+            }
+        }
+        variant.m_nEndPos = maxEnd == -1 ? record.m_nPosition : maxEnd;
+        variant.m_nStartPos = minStart == INT_MAX ? record.m_nPosition : minStart;
+    }
+
+    //Same order as CUtils::CompareVariants used by the variant providers
+    std::sort(variants.begin(), variants.end(), [](const CVariant& a_rLhs, const CVariant& a_rRhs)
+              {
+                  if(a_rLhs.m_nStartPos != a_rRhs.m_nStartPos)
+                      return a_rLhs.m_nStartPos < a_rRhs.m_nStartPos;
+                  if(a_rLhs.m_nEndPos != a_rRhs.m_nEndPos)
+                      return a_rLhs.m_nEndPos < a_rRhs.m_nEndPos;
+                  return a_rLhs.m_nId < a_rRhs.m_nId;
+              });
+
+    orientedVariants.reserve(2 * variants.size());
+    for(unsigned int k = 0; k < variants.size(); k++)
+    {
+        orientedVariants.push_back(core::COrientedVariant(variants[k], true));
+        orientedVariants.push_back(core::COrientedVariant(variants[k], false));
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  HaplotypeBenchmarks.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CSyntheticVariantGenerator.h"
+#include "CHaplotypeSequence.h"
+
+using namespace core;
+using namespace vbtbenchmark;
+
+namespace
+{
+
+const int HAPLOTYPE_BENCHMARK_REF_LENGTH = 10000;
+
+//Steps a haplotype over the whole reference with the variants of the given density in each iteration
+void RunHaplotypeNext(CBenchmarkState& a_rState, double a_dSnpDensity, double a_dIndelDensity)
+{
+    SSyntheticWorkloadConfig config;
+    config.m_nReferenceLength = HAPLOTYPE_BENCHMARK_REF_LENGTH;
+    config.m_dSnpDensity = a_dSnpDensity;
+    config.m_dIndelDensity = a_dIndelDensity;
+
+    CSyntheticVariantGenerator generator;
+    generator.Generate(config);
+    SSyntheticVariantLists lists;
+    generator.GetVariantLists(eBASE, lists);
+
+    //Overlapping variants cannot be on the same haplotype, only the first of them is added
+    const std::string& reference = generator.GetReference();
+    CHaplotypeSequence haplotype(reference.c_str(), (int)reference.size());
+    for(unsigned int k = 0; k < lists.m_aOrientedVariantList.size(); k += 2)
+    {
+        if(haplotype.IsNew(*lists.m_aOrientedVariantList[k]))
+            haplotype.AddVariant(*lists.m_aOrientedVariantList[k]);
+    }
+
+    long long stepCount = 0;
+    while(a_rState.KeepRunning())
+    {
+        CHaplotypeSequence sequence(haplotype);
+        stepCount = 0;
+        while(sequence.HasNext())
+        {
+            sequence.Next();
+            DoNotOptimize(sequence.NextBase());
+            stepCount++;
+        }
+    }
+
+    a_rState.SetItemsPerIteration(stepCount);
+}
+
+}
+
+VBT_BENCHMARK(BM_HaplotypeNext_NoVariant)
+{
+    RunHaplotypeNext(a_rState, 0, 0);
+}
+
+VBT_BENCHMARK(BM_HaplotypeNext_Sparse)
+{
+    RunHaplotypeNext(a_rState, 0.001, 0.0002);
+}
+
+VBT_BENCHMARK(BM_HaplotypeNext_Dense)
+{
+    RunHaplotypeNext(a_rState, 0.02, 0.005);
+}
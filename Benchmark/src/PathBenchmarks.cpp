@@ -0,0 +1,173 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  PathBenchmarks.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CPath.h"
+#include "COrientedVariant.h"
+#include "CVariant.h"
+#include <string>
+#include <vector>
+
+using namespace core;
+
+namespace
+{
+
+const int PATH_BENCHMARK_REF_LENGTH = 1000;
+
+//Reference of the path benchmarks: a repeating non-periodic pattern
+const std::string& GetReference()
+{
+    static std::string reference;
+    if(reference.empty())
+    {
+        const char nucleotides[] = "ACGT";
+        unsigned int state = 12345;
+        for(int k = 0; k < PATH_BENCHMARK_REF_LENGTH; k++)
+        {
+            state = state * 1103515245 + 12345;
+            reference += nucleotides[(state >> 16) & 3];
+        }
+    }
+    return reference;
+}
+
+//Heterozygous SNP at the given position, alternate base is the next nucleotide of the reference
+void MakeHeterozygousSnp(CVariant& a_rVariant, int a_nPosition)
+{
+    const std::string& reference = GetReference();
+    const char alternate = reference[a_nPosition] == 'A' ? 'C' : 'A';
+    const std::string allelesStr = reference.substr(a_nPosition, 1) + "," + alternate;
+    static CVariantArena arena;
+    if(arena.GetContigName().empty())
+        arena.SetContigName("chrBench");
+
+    a_rVariant.Clear();
+    a_rVariant.m_nVcfId = 0;
+    a_rVariant.m_nChrId = 0;
+    a_rVariant.SetArena(&arena);
+    a_rVariant.m_nOriginalPos = a_nPosition;
+    a_rVariant.SetAllelesStr(arena.AddSequence(allelesStr.data(), (int)allelesStr.size()), 1);
+    a_rVariant.m_nZygotCount = 2;
+    a_rVariant.m_nAlleleCount = 2;
+    a_rVariant.m_bIsHeterozygous = true;
+    a_rVariant.m_genotype[0] = 0;
+    a_rVariant.m_genotype[1] = 1;
+    a_rVariant.SetAlleleSequence(0, 0);
+    a_rVariant.SetAlleleSequence(1, 1);
+    for(int k = 0; k < 2; k++)
+    {
+        a_rVariant.m_alleles[k].m_nStartPos = a_nPosition;
+        a_rVariant.m_alleles[k].m_nEndPos = a_nPosition + 1;
+    }
+    a_rVariant.m_nStartPos = a_nPosition;
+    a_rVariant.m_nEndPos = a_nPosition + 1;
+}
+
+//Copies the given path in each iteration
+void RunPathCopy(vbtbenchmark::CBenchmarkState& a_rState, int a_nQueuedVariantCount)
+{
+    const std::string& reference = GetReference();
+    std::vector<CVariant> variants(a_nQueuedVariantCount + 1);
+    std::vector<COrientedVariant> orientedVariants;
+    for(int k = 0; k <= a_nQueuedVariantCount; k++)
+    {
+        MakeHeterozygousSnp(variants[k], 100 + 2 * k);
+        orientedVariants.push_back(COrientedVariant(variants[k], true));
+    }
+
+    //The first included variant is the variant in play, the rest are queued on both haplotypes of both semipaths
+    CPath path(reference.c_str(), (int)reference.size());
+    for(int k = 0; k <= a_nQueuedVariantCount; k++)
+    {
+        path.Include(eBASE, orientedVariants[k], k);
+        path.Include(eCALLED, orientedVariants[k], k);
+    }
+
+    while(a_rState.KeepRunning())
+    {
+        CPath copy(path);
+        vbtbenchmark::DoNotOptimize(copy);
+    }
+}
+
+//Forks the given path and includes the next variant to both semipaths in each iteration, as the replay does on each decision
+void RunPathInclude(vbtbenchmark::CBenchmarkState& a_rState, int a_nQueuedVariantCount)
+{
+    const std::string& reference = GetReference();
+    std::vector<CVariant> variants(a_nQueuedVariantCount + 2);
+    std::vector<COrientedVariant> orientedVariants;
+    for(int k = 0; k < (int)variants.size(); k++)
+    {
+        MakeHeterozygousSnp(variants[k], 100 + 2 * k);
+        orientedVariants.push_back(COrientedVariant(variants[k], true));
+    }
+
+    CPath path(reference.c_str(), (int)reference.size());
+    for(int k = 0; k <= a_nQueuedVariantCount; k++)
+    {
+        path.Include(eBASE, orientedVariants[k], k);
+        path.Include(eCALLED, orientedVariants[k], k);
+    }
+
+    const int nextIndex = a_nQueuedVariantCount + 1;
+    while(a_rState.KeepRunning())
+    {
+        CPath fork(path);
+        fork.Include(eBASE, orientedVariants[nextIndex], nextIndex);
+        fork.Include(eCALLED, orientedVariants[nextIndex], nextIndex);
+        vbtbenchmark::DoNotOptimize(fork);
+    }
+}
+
+}
+
+VBT_BENCHMARK(BM_PathInclude_NoQueuedVariant)
+{
+    RunPathInclude(a_rState, 0);
+}
+
+VBT_BENCHMARK(BM_PathInclude_4QueuedVariants)
+{
+    RunPathInclude(a_rState, 4);
+}
+
+VBT_BENCHMARK(BM_PathCopy_NoQueuedVariant)
+{
+    RunPathCopy(a_rState, 0);
+}
+
+VBT_BENCHMARK(BM_PathCopy_2QueuedVariants)
+{
+    RunPathCopy(a_rState, 2);
+}
+
+VBT_BENCHMARK(BM_PathCopy_4QueuedVariants)
+{
+    RunPathCopy(a_rState, 4);
+}
+
+VBT_BENCHMARK(BM_PathCopy_16QueuedVariants)
+{
+    RunPathCopy(a_rState, 16);
+}
@@ -0,0 +1,98 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  PathSetBenchmarks.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CSyntheticVariantGenerator.h"
+#include "CPathSet.h"
+#include "CPathPool.h"
+#include "CPath.h"
+#include <vector>
+#include <algorithm>
+
+using namespace core;
+using namespace vbtbenchmark;
+
+namespace
+{
+
+//Adds the given number of distinct paths to the frontier, looks each of them up and pops them in order in each iteration
+void RunPathSet(CBenchmarkState& a_rState, int a_nPathCount)
+{
+    //Dense heterozygous SNPs, each path includes a different one
+    SSyntheticWorkloadConfig config;
+    config.m_nReferenceLength = 20 * a_nPathCount + 100;
+    config.m_dSnpDensity = 0.1;
+    config.m_dIndelDensity = 0;
+    config.m_dHeterozygousRatio = 1.0;
+    config.m_dClusterRate = 0;
+
+    CSyntheticVariantGenerator generator;
+    generator.Generate(config);
+    SSyntheticVariantLists lists;
+    generator.GetVariantLists(eBASE, lists);
+
+    const std::string& reference = generator.GetReference();
+    const int pathCount = std::min(a_nPathCount, (int)lists.m_aVariantList.size());
+
+    CPathPool pool;
+    std::vector<CPathContainer> paths;
+    std::vector<uint64_t> hashes;
+    for(int k = 0; k < pathCount; k++)
+    {
+        CPath path(reference.c_str(), (int)reference.size());
+        path.Include(eBASE, *lists.m_aOrientedVariantList[2 * k], k);
+        paths.push_back(pool.Create(path));
+        hashes.push_back(paths.back().m_pPath->GetStateHash());
+    }
+
+    CPathSet pathSet;
+    CPathContainer popped;
+    while(a_rState.KeepRunning())
+    {
+        for(int k = 0; k < pathCount; k++)
+            pathSet.Add(paths[k], hashes[k]);
+        for(int k = 0; k < pathCount; k++)
+            DoNotOptimize(pathSet.Find(paths[k], hashes[k]));
+        while(!pathSet.Empty())
+            pathSet.GetLeastAdvanced(popped);
+    }
+
+    a_rState.SetItemsPerIteration(3 * pathCount);
+}
+
+}
+
+VBT_BENCHMARK(BM_PathSet_16Paths)
+{
+    RunPathSet(a_rState, 16);
+}
+
+VBT_BENCHMARK(BM_PathSet_256Paths)
+{
+    RunPathSet(a_rState, 256);
+}
+
+VBT_BENCHMARK(BM_PathSet_4096Paths)
+{
+    RunPathSet(a_rState, 4096);
+}
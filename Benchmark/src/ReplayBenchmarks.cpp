@@ -0,0 +1,148 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  ReplayBenchmarks.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CSyntheticVariantGenerator.h"
+#include "CPathReplay.h"
+
+using namespace core;
+using namespace vbtbenchmark;
+
+namespace
+{
+
+//Replays the whole synthetic chromosome with a new CPathReplay in each iteration
+void RunFindBestPath(CBenchmarkState& a_rState, const SSyntheticWorkloadConfig& a_rConfig)
+{
+    CSyntheticVariantGenerator generator;
+    generator.Generate(a_rConfig);
+
+    SSyntheticVariantLists baseLists;
+    SSyntheticVariantLists calledLists;
+    generator.GetVariantLists(eBASE, baseLists);
+    generator.GetVariantLists(eCALLED, calledLists);
+    SContig contig = generator.GetContig();
+
+    while(a_rState.KeepRunning())
+    {
+        CPathReplay replay(baseLists.m_aVariantList, calledLists.m_aVariantList, baseLists.m_aOrientedVariantList, calledLists.m_aOrientedVariantList);
+        replay.SetPrintSummary(false);
+        CPath bestPath = replay.FindBestPath(contig, true);
+        DoNotOptimize(bestPath);
+    }
+
+    a_rState.SetItemsPerIteration(baseLists.m_aVariantList.size() + calledLists.m_aVariantList.size());
+}
+
+//Replays a short chromosome whose cluster grows the path list up to the default maximum path size (150,000). Items are the replay iterations
+void RunLargeFrontier(CBenchmarkState& a_rState, const SSyntheticWorkloadConfig& a_rConfig)
+{
+    CSyntheticVariantGenerator generator;
+    generator.Generate(a_rConfig);
+
+    SSyntheticVariantLists baseLists;
+    SSyntheticVariantLists calledLists;
+    generator.GetVariantLists(eBASE, baseLists);
+    generator.GetVariantLists(eCALLED, calledLists);
+    SContig contig = generator.GetContig();
+
+    //Iteration count is taken from the region statistics of an untimed replay, the timed replays do not collect them
+    long long iterationCount = 0;
+    {
+        CPathReplay replay(baseLists.m_aVariantList, calledLists.m_aVariantList, baseLists.m_aOrientedVariantList, calledLists.m_aOrientedVariantList);
+        replay.SetPrintSummary(false);
+        replay.SetMaxPathAndIteration(DEFAULT_MAX_PATH_SIZE, DEFAULT_MAX_ITERATION_SIZE);
+        replay.SetCollectRegionStats(true);
+        replay.FindBestPath(contig, true);
+        for(const SReplayRegionStats& region : replay.GetRegionStats())
+            iterationCount += region.m_nIterationCount;
+    }
+
+    while(a_rState.KeepRunning())
+    {
+        CPathReplay replay(baseLists.m_aVariantList, calledLists.m_aVariantList, baseLists.m_aOrientedVariantList, calledLists.m_aOrientedVariantList);
+        replay.SetPrintSummary(false);
+        replay.SetMaxPathAndIteration(DEFAULT_MAX_PATH_SIZE, DEFAULT_MAX_ITERATION_SIZE);
+        CPath bestPath = replay.FindBestPath(contig, true);
+        DoNotOptimize(bestPath);
+    }
+
+    a_rState.SetItemsPerIteration(iterationCount);
+}
+
+}
+
+VBT_BENCHMARK(BM_FindBestPath_Sparse)
+{
+    SSyntheticWorkloadConfig config;
+    config.m_nReferenceLength = 1000000;
+    config.m_dSnpDensity = 0.001;
+    config.m_dIndelDensity = 0.0001;
+    RunFindBestPath(a_rState, config);
+}
+
+VBT_BENCHMARK(BM_FindBestPath_Dense)
+{
+    SSyntheticWorkloadConfig config;
+    config.m_nReferenceLength = 200000;
+    config.m_dSnpDensity = 0.01;
+    config.m_dIndelDensity = 0.002;
+    RunFindBestPath(a_rState, config);
+}
+
+VBT_BENCHMARK(BM_FindBestPath_Clustered)
+{
+    SSyntheticWorkloadConfig config;
+    config.m_nReferenceLength = 200000;
+    config.m_dSnpDensity = 0.002;
+    config.m_dIndelDensity = 0.001;
+    config.m_dClusterRate = 0.2;
+    RunFindBestPath(a_rState, config);
+}
+
+VBT_BENCHMARK(BM_FindBestPath_RepeatRich)
+{
+    SSyntheticWorkloadConfig config;
+    config.m_nReferenceLength = 200000;
+    config.m_dSnpDensity = 0.001;
+    config.m_dIndelDensity = 0.002;
+    config.m_dRepeatFraction = 0.5;
+    config.m_nMaxIndelLength = 12;
+    RunFindBestPath(a_rState, config);
+}
+
+//Heterozygous clusters of overlapping indels in repeats. One of the clusters exceeds the maximum path size
+VBT_BENCHMARK(BM_FindBestPath_LargeFrontier)
+{
+    SSyntheticWorkloadConfig config;
+    config.m_nSeed = 6;
+    config.m_nReferenceLength = 600;
+    config.m_dSnpDensity = 0.05;
+    config.m_dIndelDensity = 0.02;
+    config.m_dClusterRate = 0.5;
+    config.m_nMaxClusterSize = 12;
+    config.m_dRepeatFraction = 0.5;
+    config.m_nMaxIndelLength = 12;
+    config.m_dHeterozygousRatio = 1.0;
+    RunLargeFrontier(a_rState, config);
+}
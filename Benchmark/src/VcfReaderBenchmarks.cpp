@@ -0,0 +1,114 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  VcfReaderBenchmarks.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CSyntheticVariantGenerator.h"
+#include "CVcfReader.h"
+#include "SConfig.h"
+#include <cstdio>
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+
+using namespace vbtbenchmark;
+
+///Writes the synthetic base vcf of the reader benchmarks to a temporary file. Returns false if the file cannot be written
+static bool WriteBenchmarkVcf(char* a_pFilePath)
+{
+    SSyntheticWorkloadConfig config;
+    config.m_nReferenceLength = 1000000;
+    config.m_dSnpDensity = 0.01;
+
+    CSyntheticVariantGenerator generator;
+    generator.Generate(config);
+
+    int fileDescriptor = mkstemp(a_pFilePath);
+    if(fileDescriptor == -1)
+    {
+        std::cerr << "Temporary VCF file of the benchmark cannot be created" << std::endl;
+        return false;
+    }
+    close(fileDescriptor);
+
+    if(!generator.WriteVcf(eBASE, a_pFilePath))
+    {
+        std::remove(a_pFilePath);
+        return false;
+    }
+    return true;
+}
+
+VBT_BENCHMARK(BM_VcfReader_GetNextRecord)
+{
+    char filePath[] = "/tmp/vbt_bench_XXXXXX";
+    if(!WriteBenchmarkVcf(filePath))
+        return;
+
+    SConfig readerConfig;
+    CVariant variant;
+    long long recordCount = 0;
+    while(a_rState.KeepRunning())
+    {
+        CVcfReader reader;
+        if(!reader.Open(filePath))
+            break;
+        reader.setID(0);
+
+        recordCount = 0;
+        while(reader.GetNextRecord(&variant, 0, readerConfig))
+            recordCount++;
+        reader.Close();
+    }
+
+    a_rState.SetItemsPerIteration(recordCount);
+    std::remove(filePath);
+}
+
+//Reads the records into a list the way the variant providers do, each variant is moved out after it is decoded
+VBT_BENCHMARK(BM_VcfReader_GetNextRecordToList)
+{
+    char filePath[] = "/tmp/vbt_bench_XXXXXX";
+    if(!WriteBenchmarkVcf(filePath))
+        return;
+
+    SConfig readerConfig;
+    CVariant variant;
+    std::vector<CVariant> variantList;
+    long long recordCount = 0;
+    while(a_rState.KeepRunning())
+    {
+        CVcfReader reader;
+        if(!reader.Open(filePath))
+            break;
+        reader.setID(0);
+
+        variantList.clear();
+        while(reader.GetNextRecord(&variant, (int)variantList.size(), readerConfig))
+            variantList.push_back(std::move(variant));
+        recordCount = (long long)variantList.size();
+        reader.Close();
+    }
+
+    a_rState.SetItemsPerIteration(recordCount);
+    std::remove(filePath);
+}
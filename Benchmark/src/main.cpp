@@ -0,0 +1,71 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  main.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "CBenchmark.h"
+#include "CReplayCheck.h"
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    double minTime = 0.5;
+    bool isReplayCheck = false;
+    bool isUpdateGolden = false;
+    std::string goldenPath = "Benchmark/replay_check_golden.txt";
+
+    for(int k = 1; k < argc; k++)
+    {
+        if(0 == strcmp(argv[k], "-min-time") && k + 1 < argc)
+            minTime = atof(argv[++k]);
+        else if(0 == strcmp(argv[k], "-replay-check"))
+            isReplayCheck = true;
+        else if(0 == strcmp(argv[k], "-golden") && k + 1 < argc)
+            goldenPath = argv[++k];
+        else if(0 == strcmp(argv[k], "-update-golden"))
+            isUpdateGolden = true;
+        else if(0 == strcmp(argv[k], "--help"))
+        {
+            std::cout << "Usage: ./vbt-bench [-min-time <seconds>] [<name filter>]" << std::endl;
+            std::cout << "       ./vbt-bench -replay-check [-golden <file>] [-update-golden]" << std::endl;
+            return 0;
+        }
+        else
+            filter = argv[k];
+    }
+
+    if(isReplayCheck)
+    {
+        vbtbenchmark::CReplayCheck replayCheck;
+        return replayCheck.Run(goldenPath, isUpdateGolden);
+    }
+
+    if(0 == vbtbenchmark::RunBenchmarks(filter, minTime))
+    {
+        std::cerr << "No benchmark matches the filter " << filter << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  VcfReaderThroughput.cpp
+ *  VariantBenchmarkingTools
+ *
+ *  Standalone records/sec measurement of CVcfReader. It only uses the reader API that every revision of the tree has
+ *  (Open, setID, GetNextRecord, Close), so make bench-compare can build it against any BENCH_BASE revision.
+ *
+ */
+
+#include "CVcfReader.h"
+#include "SConfig.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+///Writes a single sample vcf of SNPs and short indels generated from a fixed seed. Returns false if the file cannot be written
+static bool WriteSyntheticVcf(const char* a_pFilePath, int a_nRecordCount)
+{
+    FILE* pFile = fopen(a_pFilePath, "w");
+    if(pFile == NULL)
+    {
+        std::cerr << "Temporary VCF file cannot be created" << std::endl;
+        return false;
+    }
+
+    const int contigLength = a_nRecordCount * 100 + 1000;
+    fprintf(pFile, "##fileformat=VCFv4.2\n");
+    fprintf(pFile, "##contig=<ID=chr1,length=%d>\n", contigLength);
+    fprintf(pFile, "##FILTER=<ID=PASS,Description=\"All filters passed\">\n");
+    fprintf(pFile, "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n");
+    fprintf(pFile, "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tSAMPLE\n");
+
+    const char bases[] = "ACGT";
+    unsigned int seed = 42;
+    int position = 1;
+    for(int k = 0; k < a_nRecordCount; k++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        position += 10 + static_cast<int>((seed >> 16) % 180);
+        const char ref = bases[(seed >> 8) & 3];
+        const char alt = bases[((seed >> 8) + 1) & 3];
+        const char* genotype = (seed & 1) ? "0/1" : "1/1";
+
+        switch((seed >> 4) % 10)
+        {
+            case 0:
+                fprintf(pFile, "chr1\t%d\t.\t%c\t%c%c%c\t50\tPASS\t.\tGT\t%s\n", position, ref, ref, alt, alt, genotype);
+                break;
+            case 1:
+                fprintf(pFile, "chr1\t%d\t.\t%c%c%c\t%c\t50\tPASS\t.\tGT\t%s\n", position, ref, alt, alt, ref, genotype);
+                break;
+            default:
+                fprintf(pFile, "chr1\t%d\t.\t%c\t%c\t50\tPASS\t.\tGT\t%s\n", position, ref, alt, genotype);
+                break;
+        }
+    }
+
+    fclose(pFile);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int recordCount = 200000;
+    int repeatCount = 5;
+    std::string vcfPath;
+
+    for(int k = 1; k < argc; k++)
+    {
+        if(0 == strcmp(argv[k], "-records") && k + 1 < argc)
+            recordCount = atoi(argv[++k]);
+        else if(0 == strcmp(argv[k], "-repeat") && k + 1 < argc)
+            repeatCount = atoi(argv[++k]);
+        else if(0 == strcmp(argv[k], "--help"))
+        {
+            std::cout << "Usage: ./vbt-reader-bench [-records <count>] [-repeat <count>] [<vcf file>]" << std::endl;
+            return 0;
+        }
+        else
+            vcfPath = argv[k];
+    }
+
+    char tempPath[] = "/tmp/vbt_reader_bench_XXXXXX";
+    const bool isTemporary = vcfPath.empty();
+    if(isTemporary)
+    {
+        int fileDescriptor = mkstemp(tempPath);
+        if(fileDescriptor == -1)
+        {
+            std::cerr << "Temporary VCF file cannot be created" << std::endl;
+            return -1;
+        }
+        close(fileDescriptor);
+        if(!WriteSyntheticVcf(tempPath, recordCount))
+            return -1;
+        vcfPath = tempPath;
+    }
+
+    //The best of the repeats is reported so that a noisy run does not hide the difference between two revisions
+    SConfig readerConfig;
+    CVariant variant;
+    long long readCount = 0;
+    double bestSeconds = -1;
+    for(int r = 0; r < repeatCount; r++)
+    {
+        CVcfReader reader;
+        if(!reader.Open(vcfPath.c_str()))
+        {
+            std::cerr << "VCF file " << vcfPath << " cannot be opened" << std::endl;
+            break;
+        }
+        reader.setID(0);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        readCount = 0;
+        while(reader.GetNextRecord(&variant, 0, readerConfig))
+            readCount++;
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        reader.Close();
+
+        if(bestSeconds < 0 || elapsed.count() < bestSeconds)
+            bestSeconds = elapsed.count();
+    }
+
+    if(isTemporary)
+        std::remove(tempPath);
+
+    if(bestSeconds <= 0)
+        return -1;
+
+    std::cout << "VcfReader records: " << readCount << "  best of " << repeatCount << ": " << bestSeconds * 1000.0 << " ms  "
+              << static_cast<long long>(readCount / bestSeconds) << " records/sec" << std::endl;
+    return 0;
+}
@@ -28,14 +28,17 @@
 
 #include <string>
 
-//MAX NUMBER OF THREAD COUNT
-const int MAX_THREAD_COUNT = 25;
+//MAX NUMBER OF THREAD COUNT (Sanity limit for the -thread-count parameter)
+const int MAX_THREAD_COUNT = 1024;
 
 //LEAST NUMBER OF VARIANT REQUIRED TO PROCESS THE CHROMOSOME
 const int LEAST_VARIANT_THRESHOLD = 0;
 
-//THREAD COUNT BY DEFAULT IN CASE PROGRAM WONT WORK IN PLATFORM MODE
-const int DEFAULT_THREAD_COUNT = 2;
+//THREAD COUNT BY DEFAULT (0 uses the number of cores available to the process, taking cpu affinity and cgroup quota into account)
+const int DEFAULT_THREAD_COUNT = 0;
+
+//THREAD COUNT USED WHEN THE NUMBER OF AVAILABLE CORES CANNOT BE DETECTED
+const int FALLBACK_THREAD_COUNT = 2;
 
 //DEFAULT BASE PAIR LENGTH OF A VARIANT THAT COMPARISON ENGINE PROCESSS
 const int DEFAULT_MAX_BP_LENGTH = 1000;
@@ -46,6 +49,42 @@ const int DEFAULT_MAX_PATH_SIZE = 150000;
 //DEFAULT SIZE OF ITERATION COUNT (For Dynamic Programming result saving. This variable should be increased carefully since it is easy to exceed available memory)
 const int DEFAULT_MAX_ITERATION_SIZE = 10000000;
 
+//DEFAULT NUMBER OF PATHS KEPT BY THE BEAM SEARCH MODE WHEN A COMPLEX REGION IS REACHED
+const int DEFAULT_BEAM_WIDTH = 1000;
+
+//MINIMUM ITERATION BUDGET OF A REGION WHEN THE ADAPTIVE BUDGET IS ENABLED
+const int ADAPTIVE_MIN_ITERATION_BUDGET = 100000;
+
+//ITERATION BUDGET GIVEN TO A REGION FOR EACH ITERATION PREDICTED BY THE COMPLEXITY ESTIMATOR
+const int ADAPTIVE_BUDGET_FACTOR = 16;
+
+//A REGION IS SENT TO THE COMPLEX REGION FALLBACK DIRECTLY IF ITS PREDICTED PATH COUNT IS THIS MANY TIMES (LOG2) OVER THE MAXIMUM PATH SIZE
+const int ADAPTIVE_HOPELESS_MARGIN_BITS = 8;
+
+//PHASE SET ID OF THE PHASED GENOTYPES WITHOUT A PS FORMAT FIELD (VCF spec puts all of them into the same phase set)
+const int UNNAMED_PHASE_SET = -2;
+
+//NUMBER OF PATH OBJECTS ALLOCATED AT ONCE BY THE PATH POOL OF EACH VARIANT REPLAY
+const int PATH_POOL_SLAB_SIZE = 256;
+
+//NUMBER OF PATH POOL SLABS KEPT ALIVE AFTER A SYNC POINT (Free slabs beyond this count are released back to the system)
+const int PATH_POOL_RETAINED_SLAB_COUNT = 16;
+
+//MINIMUM NUMBER OF VARIANTS (BASE + CALLED) IN A BLOCK OF THE PARALLEL VARIANT REPLAY
+const int PARALLEL_REPLAY_MIN_BLOCK_SIZE = 1000;
+
+//NUMBER OF BLOCKS PER THREAD THAT PARALLEL VARIANT REPLAY AIMS FOR (Smaller blocks balance the threads better)
+const int PARALLEL_REPLAY_BLOCKS_PER_THREAD = 8;
+
+//MINIMUM NUMBER OF VARIANTS (BASE + CALLED) IN A REGION STORED IN THE REPLAY CACHE (Smaller regions are replayed faster than they are looked up)
+const int REPLAY_CACHE_MIN_VARIANT_COUNT = 3;
+
+//MAXIMUM REFERENCE LENGTH OF A REGION STORED IN THE REPLAY CACHE (From the first variant of the region to the variant following the region)
+const int REPLAY_CACHE_MAX_REGION_LENGTH = 10000;
+
+//FILE NAME OF THE REPLAY CACHE INSIDE THE CACHE DIRECTORY
+const std::string REPLAY_CACHE_FILE_NAME = "vbt_replay_cache.bin";
+
 //DEFAULT SIZE OF SMALL VARIANTS FOR MENDELIAN VIOLATION DETECTION
 const int SMALL_VARIANT_SIZE = 5;
 
@@ -0,0 +1,122 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CDecisionArray.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_DECISION_ARRAY_H_
+#define _C_DECISION_ARRAY_H_
+
+#include <vector>
+#include <cstdint>
+
+namespace core
+{
+
+class COrientedVariant;
+
+///Decision of the best path for a single variant
+enum EVariantDecision
+{
+    ///Variant is not replayed (e.g. skipped in a complex region)
+    eDECISION_UNDECIDED = 0,
+    eDECISION_EXCLUDED = 1,
+    ///Variant is included with the first oriented variant of the pair (index 2*i of the oriented variant list)
+    eDECISION_INCLUDED_FIRST = 2,
+    ///Variant is included with the second oriented variant of the pair (index 2*i+1 of the oriented variant list)
+    eDECISION_INCLUDED_SECOND = 3
+};
+
+/**
+ * @brief Compact record of the best path decisions indexed by variant index
+ *
+ * Each variant takes 2 bits, so the decisions of a whole chromosome fit in a quarter byte per variant instead of a pointer
+ * per included variant and an index per excluded variant. Included and excluded variants are read in variant index order
+ * by looking up the variant lists the path is replayed on.
+ */
+class CDecisionArray
+{
+public:
+
+    CDecisionArray();
+
+    ///Resets the array to the given number of undecided variants
+    void Reset(int a_nVariantCount);
+
+    /**
+     * @brief Sets the decisions from the included/excluded lists of a replay
+     *
+     * @param a_rOrientedVariantList Oriented variant list of the replay (2 oriented variants per variant)
+     * @param a_rIncludedVarList Included oriented variants (not necessarily in variant index order)
+     * @param a_rExcludedVarList Excluded variant indexes
+     */
+    void Fill(const std::vector<const COrientedVariant*>& a_rOrientedVariantList,
+              const std::vector<const COrientedVariant*>& a_rIncludedVarList,
+              const std::vector<int>& a_rExcludedVarList);
+
+    ///Set the decision of the given variant
+    void Set(int a_nVariantIndex, EVariantDecision a_decision);
+
+    ///Return the decision of the given variant
+    EVariantDecision Get(int a_nVariantIndex) const
+    {
+        return static_cast<EVariantDecision>((m_aPackedDecisions[a_nVariantIndex >> 2] >> ((a_nVariantIndex & 3) << 1)) & 3);
+    }
+
+    ///Checks if the given variant is included with either orientation
+    bool IsIncluded(int a_nVariantIndex) const
+    {
+        return Get(a_nVariantIndex) >= eDECISION_INCLUDED_FIRST;
+    }
+
+    ///Checks if the given variant is excluded
+    bool IsExcluded(int a_nVariantIndex) const
+    {
+        return Get(a_nVariantIndex) == eDECISION_EXCLUDED;
+    }
+
+    ///Return the oriented variant chosen for the given included variant from the oriented variant list of the replay
+    const COrientedVariant* GetIncludedVariant(const std::vector<const COrientedVariant*>& a_rOrientedVariantList, int a_nVariantIndex) const;
+
+    ///Return the number of variants
+    int GetVariantCount() const;
+
+    ///Return the number of included variants
+    int GetIncludedCount() const;
+
+    ///Return the number of excluded variants
+    int GetExcludedCount() const;
+
+private:
+
+    ///Return the index of the variant of the given oriented variant, searching forward from a_nStartIndex first. Returns -1 if it is not found
+    int FindVariantIndex(const std::vector<const COrientedVariant*>& a_rOrientedVariantList, const COrientedVariant* a_pVariant, int a_nStartIndex) const;
+
+    ///Decisions of 4 consecutive variants are packed in each byte
+    std::vector<uint8_t> m_aPackedDecisions;
+
+    int m_nVariantCount;
+    int m_nIncludedCount;
+    int m_nExcludedCount;
+};
+
+}
+
+#endif // _C_DECISION_ARRAY_H_
@@ -28,15 +28,18 @@
 #ifndef _C_HAPLOTYPE_SEQUENCE_H_
 #define _C_HAPLOTYPE_SEQUENCE_H_
 
-#include <deque>
 #include "CVariant.h"
 #include "COrientedVariant.h"
+#include "CInlineQueue.h"
 
 namespace core
 {
 
 const int g_nINVALID = -1;
 
+///Number of queued variants stored inside the haplotype before the queue spills to the heap
+const int HAPLOTYPE_INLINE_VARIANT_COUNT = 4;
+
 /**
  * @brief Container that stores information of each haplotype during the variant replay processing
  *
@@ -72,6 +75,9 @@ class CHaplotypeSequence
     ///Compare given haplotype sequence with this
     int CompareTo(const CHaplotypeSequence& a_rObj) const;
     
+    ///Return the hash of the replay state compared by CompareTo in O(1) (Sequences comparing equal have the same hash)
+    uint64_t GetStateHash() const;
+    
     ///Test if the haplotype is currently within a variant
     bool IsOnTemplate() const;
 
@@ -99,12 +105,23 @@ class CHaplotypeSequence
     ///Detects variant overlaps
     bool IsNew(const COrientedVariant& a_rVar) const;
     
+    /**
+     * @brief Return the number of plain steps available from the current position
+     *
+     * A plain step is a Next() call that neither enters nor leaves a variant and keeps WantsFutureVariantBases unchanged.
+     * a_rpBases is set to the bases returned by NextBase after each of these steps.
+     */
+    int GetPlainStepCount(const char*& a_rpBases) const;
+    
+    ///Performs the given number of plain steps at once (see GetPlainStepCount)
+    void PlainStep(int a_nStepCount);
+    
     ///[TEST Purpose] print the haplotype
     void Print() const;
     
   private:
   /// Sorted list of variants yet to be processed
-  std::deque<COrientedVariant> m_aVariants;
+  CInlineQueue<COrientedVariant, HAPLOTYPE_INLINE_VARIANT_COUNT> m_aVariants;
 
   ///Reference nucleotid sequence
   const char* m_aRefSequence;
@@ -120,6 +137,10 @@ class CHaplotypeSequence
 
   /// Variant that currently in or next one.
   COrientedVariant m_nextVariant;
+  
+  /// Zobrist style hash of the pending variant queue: sum of the hashes of variants in m_aVariants.
+  /// It is updated incrementally when a variant is queued (AddVariant) or consumed (Next, MoveForward)
+  uint64_t m_nQueueHash;
 
 };
 
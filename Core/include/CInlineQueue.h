@@ -0,0 +1,170 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CInlineQueue.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+
+#ifndef _C_INLINE_QUEUE_H_
+#define _C_INLINE_QUEUE_H_
+
+#include <algorithm>
+
+namespace core
+{
+
+/**
+ * @brief FIFO queue that keeps up to N elements inside the object and spills to the heap beyond that
+ *
+ * CInlineQueue stores the variants waiting on a haplotype. The queue rarely holds more than a few variants, but it is
+ * copied with every path branch, so keeping the elements inline avoids an allocation for each copy. Elements are kept
+ * in [m_nHead, m_nTail) of the storage. Popping only moves the head, and the live elements are moved to the front when
+ * the tail reaches the end of the storage. T should be cheap to default construct and copy.
+ */
+template <typename T, int N>
+class CInlineQueue
+{
+public:
+
+    CInlineQueue()
+    : m_pData(m_aInline),
+      m_nCapacity(N),
+      m_nHead(0),
+      m_nTail(0)
+    {}
+
+    ///Copy constructor (only the live elements are copied)
+    CInlineQueue(const CInlineQueue& a_rObj)
+    : m_pData(m_aInline),
+      m_nCapacity(N),
+      m_nHead(0),
+      m_nTail(0)
+    {
+        CopyFrom(a_rObj);
+    }
+
+    ~CInlineQueue()
+    {
+        if(m_pData != m_aInline)
+            delete[] m_pData;
+    }
+
+    CInlineQueue& operator=(const CInlineQueue& a_rObj)
+    {
+        if(this != &a_rObj)
+        {
+            m_nHead = 0;
+            m_nTail = 0;
+            CopyFrom(a_rObj);
+        }
+        return *this;
+    }
+
+    ///Appends the given element to the end of the queue
+    void PushBack(const T& a_rValue)
+    {
+        if(m_nTail == m_nCapacity)
+            MakeRoom();
+        m_pData[m_nTail++] = a_rValue;
+    }
+
+    ///Removes the first element
+    void PopFront()
+    {
+        m_nHead++;
+        if(m_nHead == m_nTail)
+        {
+            m_nHead = 0;
+            m_nTail = 0;
+        }
+    }
+
+    ///Return the first element
+    const T& Front() const
+    {
+        return m_pData[m_nHead];
+    }
+
+    ///Return the element at the given position from the front
+    const T& operator[](int a_nIndex) const
+    {
+        return m_pData[m_nHead + a_nIndex];
+    }
+
+    int Size() const
+    {
+        return m_nTail - m_nHead;
+    }
+
+    bool Empty() const
+    {
+        return m_nTail == m_nHead;
+    }
+
+private:
+
+    ///Copies the elements of the given queue into the storage of this (queue should be empty)
+    void CopyFrom(const CInlineQueue& a_rObj)
+    {
+        const int size = a_rObj.Size();
+        if(size > m_nCapacity)
+            Reallocate(size);
+        std::copy(a_rObj.m_pData + a_rObj.m_nHead, a_rObj.m_pData + a_rObj.m_nTail, m_pData);
+        m_nTail = size;
+    }
+
+    ///Frees the space at the end of the storage, either by moving the elements to the front or by growing the storage
+    void MakeRoom()
+    {
+        if(m_nHead > 0)
+        {
+            std::copy(m_pData + m_nHead, m_pData + m_nTail, m_pData);
+            m_nTail -= m_nHead;
+            m_nHead = 0;
+        }
+        else
+            Reallocate(2 * m_nCapacity);
+    }
+
+    ///Moves the elements to a heap storage with the given capacity
+    void Reallocate(int a_nCapacity)
+    {
+        T* pData = new T[a_nCapacity];
+        std::copy(m_pData + m_nHead, m_pData + m_nTail, pData);
+        if(m_pData != m_aInline)
+            delete[] m_pData;
+
+        m_pData = pData;
+        m_nCapacity = a_nCapacity;
+        m_nTail -= m_nHead;
+        m_nHead = 0;
+    }
+
+    T m_aInline[N];
+    ///Storage of the elements, points to m_aInline until the queue spills to the heap
+    T* m_pData;
+    int m_nCapacity;
+    int m_nHead;
+    int m_nTail;
+};
+
+}
+
+#endif // _C_INLINE_QUEUE_H_
@@ -29,6 +29,7 @@
 #define _C_ORIENTED_VARIANT_H_
 
 #include "CVariant.h"
+#include "StateHash.h"
 
 namespace core
 {
@@ -54,11 +55,29 @@ class COrientedVariant
     COrientedVariant(const COrientedVariant& a_rObj);    
     
     ///Get the allele alt string
-    const SAllele& GetAllele() const;
+    const SAllele& GetAllele() const
+    {
+        return m_variant->m_alleles[m_nAlleleIndex];
+    }
+    
+    ///Return the sequence of the selected allele. Points into the arena of the variant and is not null terminated, see GetSequenceLength
+    const char* GetSequence() const
+    {
+        return m_pSequence;
+    }
+    
+    ///Return the length of the selected allele sequence
+    int GetSequenceLength() const
+    {
+        return m_nSequenceLength;
+    }
     
     ///Compare variants according to start/end position
     int CompareTo(const COrientedVariant& a_rObj) const;
     
+    ///Return the hash of the fields used by CompareTo (Variants comparing equal have the same hash)
+    uint64_t GetHash() const;
+    
     ///Gets the start position of the variant
     int GetStartPos() const;
     
@@ -87,12 +106,18 @@ class COrientedVariant
     void Print() const;
 
     private:
+    ///Sets the sequence view of the selected allele
+    void InitSequence();
+    
     ///Index of the selected allele of this variant
     int m_nAlleleIndex;
     ///Index of the other allele of this variant
     int m_nOtherAlleleIndex;
     ///Pointer Access to variant
     const CVariant* m_variant;
+    ///Sequence of the selected allele, read by the replay without going through the variant
+    const char* m_pSequence;
+    int m_nSequenceLength;
     ///If the selected allele is first number or not (eg.  a/b   a-> true b-> false)
     bool m_bIsOrderOfGenotype;
     ///If oriented variant is null
@@ -0,0 +1,270 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CParallelPathReplay.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_PARALLEL_PATH_REPLAY_H_
+#define _C_PARALLEL_PATH_REPLAY_H_
+
+#include "CPathReplay.h"
+#include "CPath.h"
+#include "CTaskScheduler.h"
+#include <vector>
+
+namespace core
+{
+
+///Range of base and called variants replayed together. Index ranges are [start, end)
+struct SReplayBlock
+{
+    int m_nBaseStart;
+    int m_nBaseEnd;
+    int m_nCalledStart;
+    int m_nCalledEnd;
+    ///Smallest start position of the variants in the block
+    int m_nStartPosition;
+};
+
+///Result of the replay of a single block
+struct SReplayBlockResult
+{
+    ///Best path of the block. Decisions are indexed relative to the block
+    CPath m_bestPath;
+    ///Settle point of the replay (see CPathReplay::IsSettled)
+    bool m_bIsSettled;
+    int m_nSettledPosition;
+    ///Complex region skips started before the first variant of the block
+    bool m_bSkippedFromStartBase;
+    bool m_bSkippedFromStartCalled;
+    ///Statistics of the sync regions of the block (empty if the statistics are not collected)
+    std::vector<SReplayRegionStats> m_aRegionStats;
+};
+
+///Blocks stitched together, more than one block is stitched if the boundaries between them are not safe to cut
+struct SReplayGroup
+{
+    ///Variant ranges of the group
+    SReplayBlock m_block;
+    ///Indexes of the first and the last block of the group. Result of the group is stored to the result of its last block
+    int m_nFirstBlock;
+    int m_nLastBlock;
+};
+
+///Allele match replay of the variants excluded by the genotype match best path of a block
+struct SAlleleMatchBlock
+{
+    ///Genotype mismatches of the block in variant index order
+    std::vector<const CVariant*> m_aVariantListBase;
+    std::vector<const CVariant*> m_aVariantListCalled;
+    ///Variant status of the genotype mismatches before the allele match replay
+    std::vector<EVariantMatch> m_aInitialStatusBase;
+    std::vector<EVariantMatch> m_aInitialStatusCalled;
+    std::vector<bool> m_aInitialApproximateBase;
+    std::vector<bool> m_aInitialApproximateCalled;
+    ///Allele match best path of the genotype mismatches
+    SReplayBlockResult m_result;
+};
+
+/**
+ * @brief Runs the variant replay of a single contig on multiple threads
+ *
+ * Variant lists are split into blocks at reference gaps wider than the longest variant, where no variant of either vcf
+ * overlaps the gap. Blocks are replayed concurrently with their own CPathReplay and the best paths are stitched in order.
+ * A cut is only kept if the replay of the preceding block ended in a single synchronized path before reaching the next
+ * block, which is the state a serial replay would continue from. Otherwise the neighbouring blocks are merged and replayed
+ * again, so the stitched path is always identical to the result of a single CPathReplay over the whole contig.
+ */
+class CParallelPathReplay
+{
+public:
+
+    ///Sets variant for comparison
+    CParallelPathReplay(std::vector<const CVariant*>& a_aVarListBase,
+                        std::vector<const CVariant*>& a_aVarListCalled,
+                        std::vector<const COrientedVariant*>& a_aOVarListBase,
+                        std::vector<const COrientedVariant*>& a_aOvarlistCalled);
+
+    ///Sets maximum pathsize and maximum path iteration count
+    void SetMaxPathAndIteration(int a_nMaxPathSize, int a_nMaxIterationCount);
+
+    ///Sets the strategy for the regions exceeding the path size or iteration limit, and the number of paths kept in beam search mode
+    void SetComplexRegionMode(EComplexRegionMode a_mode, int a_nBeamWidth);
+
+    ///Enables the complexity estimation of each region before replay (see CPathReplay::SetAdaptiveBudget)
+    void SetAdaptiveBudget(bool a_bIsEnabled);
+
+    ///Sets the cache of the resolved region decisions shared by the block replays (see CPathReplay::SetReplayCache)
+    void SetReplayCache(CReplayCache* a_pReplayCache);
+
+    ///Sets the file that the statistics of the sync regions of the stitched best paths are written to, under the given comparison name
+    void SetReplayStats(CReplayStats* a_pReplayStats, const std::string& a_rComparisonName);
+
+    ///Sets the scheduler used to replay the blocks. Contig is replayed serially on the calling thread if no scheduler is set
+    void SetScheduler(CTaskScheduler* a_pScheduler);
+
+    ///Clears variants belong to best path (kept for interface compatibility with CPathReplay)
+    void Clear();
+
+    /**
+     * @brief Finds the best path for the given chromosome by replaying its independent blocks in parallel
+     *
+     * @param a_contig Chromosome to be processed
+     * @param a_bIsGenotypeMatch comparison mode (true is genotype matching - ga4gh method3, and false is allele matching - ga4gh method2)
+     */
+    CPath FindBestPath(SContig a_contig, bool a_bIsGenotypeMatch);
+
+    /**
+     * @brief Finds the genotype match best path and the allele match best path of the genotype mismatches in a single pass
+     *
+     * Allele match replay of each block runs in the same task right after its genotype match replay, only on the variants
+     * excluded by the block. Blocks without any genotype mismatch are not replayed again. Result is identical to running
+     * FindBestPath in genotype match mode and then in allele match mode on the excluded variants.
+     *
+     * @param a_contig Chromosome to be processed
+     * @param a_rGenotypeMatchPath Genotype match best path
+     * @param a_rAlleleMatchPath Allele match best path. Decisions are indexed by the order of the variants among the excluded
+     * variants of the genotype match best path
+     */
+    void FindBestPaths(SContig a_contig, CPath& a_rGenotypeMatchPath, CPath& a_rAlleleMatchPath);
+
+private:
+
+    ///Replays the whole contig on the calling thread
+    CPath ReplayContig(const SContig& a_rContig, bool a_bIsGenotypeMatch);
+
+    ///Writes the collected region statistics of the stitched best path if a statistics file is set
+    void WriteRegionStats(const SContig& a_rContig, bool a_bIsGenotypeMatch, const std::vector<SReplayRegionStats>& a_rRegionStats) const;
+
+    ///Copies the replay settings to the given replay
+    void CopySettingsTo(CParallelPathReplay& a_rReplay) const;
+
+    ///Stores the variant status before replay
+    void StoreInitialStatus();
+
+    ///Splits the variant lists at the safe cut points into blocks of at least the minimum block size
+    void SplitIntoBlocks(std::vector<SReplayBlock>& a_rBlocks) const;
+
+    ///Replays the variants of the given block
+    void ReplayBlock(const SReplayBlock& a_rBlock, const SContig& a_rContig, bool a_bIsGenotypeMatch, SReplayBlockResult& a_rResult);
+
+    ///Replays the given variants as a block preceded by other variants of the contig
+    void ReplayVariants(std::vector<const CVariant*>& a_rVarListBase,
+                        std::vector<const CVariant*>& a_rVarListCalled,
+                        std::vector<const COrientedVariant*>& a_rOVarListBase,
+                        std::vector<const COrientedVariant*>& a_rOVarListCalled,
+                        const SContig& a_rContig,
+                        bool a_bIsGenotypeMatch,
+                        SReplayBlockResult& a_rResult) const;
+
+    ///Collects the variants excluded by the genotype match best path of the block and replays them in allele match mode
+    void ReplayAlleleMatchBlock(const SReplayBlock& a_rBlock, const SReplayBlockResult& a_rGenotypeResult, const SContig& a_rContig, SAlleleMatchBlock& a_rResult) const;
+
+    /**
+     * @brief Stitches the block results in order. Blocks which did not settle before the next block are merged with it, and the
+     * merged groups are replayed again concurrently until every group settles before the next one
+     *
+     * @param a_rGroups Stitched groups of blocks. Result of each group is stored to the result of its last block
+     */
+    CPath StitchBlocks(const SContig& a_rContig,
+                       bool a_bIsGenotypeMatch,
+                       const std::vector<SReplayBlock>& a_rBlocks,
+                       std::vector<SReplayBlockResult>& a_rResults,
+                       std::vector<SReplayGroup>& a_rGroups);
+
+    ///Extends the last group to the given block and adds the group to the groups to be replayed
+    void MergeGroups(std::vector<SReplayGroup>& a_rGroups, const SReplayBlock& a_rNextBlock, int a_nNextLastBlock, std::vector<int>& a_rReplayedGroups) const;
+
+    ///Replays the given groups on the scheduler. Result of each group is stored to the result of its last block
+    void ReplayGroups(const SContig& a_rContig,
+                      bool a_bIsGenotypeMatch,
+                      const std::vector<SReplayGroup>& a_rGroups,
+                      const std::vector<int>& a_rReplayedGroups,
+                      std::vector<SReplayBlockResult>& a_rResults);
+
+    ///Checks if the serial replay would reach the next block with a single synchronized path
+    bool IsSafeBoundary(const SReplayBlockResult& a_rResult, const SReplayBlock& a_rNextBlock) const;
+
+    ///Appends the best path decisions of the block to the stitched decisions
+    void AppendBlockResult(const SReplayBlock& a_rBlock, const SReplayBlockResult& a_rResult, int a_nNextBlockStart);
+
+    ///Copies the decisions of a single vcf of the block to the stitched decisions and updates the largest included end position
+    void AppendBlockDecisions(const CDecisionArray& a_rBlockDecisions,
+                              int a_nBlockStart,
+                              const std::vector<const CVariant*>& a_rVariantList,
+                              CDecisionArray& a_rDecisions,
+                              int& a_rIncludedEnd);
+
+    ///Replicates the complex skip of a serial replay started from the variant preceding the block
+    void AddSkippedFromStart(EVcfName a_uVcfName, const SReplayBlock& a_rBlock, const SReplayBlockResult& a_rResult);
+
+    ///Restores the variant status of the block to the value before replay
+    void RestoreVariantStatus(const SReplayBlock& a_rBlock);
+
+    ///Marks the variants skipped from the start of the stitched blocks as complex skipped
+    void MarkSkippedFromStart();
+
+    std::vector<const CVariant*>& m_aVariantListBase;
+    std::vector<const CVariant*>& m_aVariantListCalled;
+    std::vector<const COrientedVariant*>& m_aOrientedVariantListBase;
+    std::vector<const COrientedVariant*>& m_aOrientedVariantListCalled;
+
+    ///Cutoff path size to fit in memory
+    int m_nMaxPathSize;
+    ///Cutoff iteration count without enqueing any variant to the pathlist
+    int m_nMaxIterationCount;
+    ///Strategy for the regions exceeding the cutoffs and the number of paths kept by beam search
+    EComplexRegionMode m_complexRegionMode;
+    int m_nBeamWidth;
+    ///Assign the iteration budget of each region from its complexity estimate
+    bool m_bAdaptiveBudget;
+    ///Cache of the resolved region decisions (NULL if the cache is disabled)
+    CReplayCache* m_pReplayCache;
+    ///File of the sync region statistics (NULL if the statistics are not collected) and the name of the compared pair
+    CReplayStats* m_pReplayStats;
+    std::string m_comparisonName;
+    ///Scheduler that executes the block replays
+    CTaskScheduler* m_pScheduler;
+
+    //Variant status before replay
+    std::vector<EVariantMatch> m_aInitialStatusBase;
+    std::vector<EVariantMatch> m_aInitialStatusCalled;
+    std::vector<bool> m_aInitialApproximateBase;
+    std::vector<bool> m_aInitialApproximateCalled;
+
+    //Stitched best path decisions
+    CDecisionArray m_decisionsBase;
+    CDecisionArray m_decisionsCalled;
+    std::vector<int> m_SyncPointsBest;
+
+    //Largest end position of the stitched included variants
+    int m_nIncludedEndBase;
+    int m_nIncludedEndCalled;
+
+    ///Region statistics of the stitched blocks
+    std::vector<SReplayRegionStats> m_aRegionStats;
+
+    ///Variants marked as complex skipped while stitching
+    std::vector<const CVariant*> m_aSkippedFromStart;
+};
+
+}
+
+#endif // _C_PARALLEL_PATH_REPLAY_H_
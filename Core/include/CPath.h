@@ -29,13 +29,15 @@
 #define _C_PATH_H_
 
 #include "CSemiPath.h"
+#include "CPersistentList.h"
 #include "EVcfName.h"
-#include <memory>
 
 namespace core
 {
 
 class CPathContainer;
+class CPathPool;
+struct SPathSlab;
 class CSyncPoint;
 class CMendelianVariantProvider;
 
@@ -45,6 +47,8 @@ class CMendelianVariantProvider;
  *
  * CPath is the largest container that sotores variant replay information during variant comparison. Each CPath
  * Object consist of 2 SemiPaths represent base and called vcfs and a list of synchronization points.
+ * Copying a path is O(1) in the number of decisions made so far, since the decision lists are persistent.
+ * Paths generated during replay are allocated from the CPathPool of the replay and referenced with CPathContainer.
  */
 class CPath
 {
@@ -57,6 +61,9 @@ class CPath
     ///Copy constructor
     CPath(const CPath& a_rObj);
     
+    ///Assignment operator (pool bookkeeping of the path is not copied)
+    CPath& operator=(const CPath& a_rObj);
+    
     /// Check if the two semipaths are synchronized
     bool InSync() const;
     
@@ -66,14 +73,18 @@ class CPath
     ///Compare two the given path with this
     int CompareTo(const CPath& a_rObj) const;
     
+    ///Return the hash of the replay state compared by CompareTo (Paths comparing equal have the same hash)
+    uint64_t GetStateHash() const;
+    
     ///Exclude the variant to the given side
     CPath& Exclude(EVcfName a_nVCF, const CVariant& a_rVariant, int a_nVariantIndex);
     
     ///Include variant to the given side
     CPath& Include(EVcfName a_nVCF, const COrientedVariant& a_rVariant, int a_nVariantIndex);
     
-    ///Add variant to the given side of path and return the path count
+    ///Add variant to the given side of path and return the path count. New paths are allocated from the given pool
     int AddVariant(CPathContainer* a_pPathList,
+                   CPathPool& a_rPathPool,
                    EVcfName a_nVcfName,
                    const std::vector<const CVariant*>& a_pVariantList,
                    const std::vector<const COrientedVariant*>& a_pOVariantList,
@@ -88,6 +99,14 @@ class CPath
     //
     void Step();
     
+    /**
+     * @brief Performs up to the given number of Step calls at once. Returns the number of steps performed
+     *
+     * Steps are only taken while no haplotype enters or leaves a variant, the path stays out of sync and the semipaths keep
+     * matching, so the result is the same as calling Step and Matches one by one. Bases are compared in chunks.
+     */
+    int StepPlain(int a_nMaxStepCount);
+    
     ///Force move haplotypes to the given position
     void MoveForward(int a_nPosition);
 
@@ -103,49 +122,84 @@ class CPath
     ///Check if the path has finished
     bool HasFinished() const;
     
-    ///Delete all Included variants
-    void ClearIncludedVariants();
-    ///Add variants to the included variant list
-    void AddIncludedVariants(std::vector<const COrientedVariant*>& a_rIncludedVarListCalled,
-                             std::vector<const COrientedVariant*>& a_rIncludedVarListBase);
+    /**
+     * @brief Compares the phase states of the semipaths (only set when the variants have phase sets)
+     *
+     * Phase state only separates the paths that are out of sync. Synchronized paths are merged as if the variants were
+     * unphased, and the better path carries its phase state to the rest of the phase set.
+     */
+    int ComparePhase(const CPath& a_rObj) const;
     
-    ///Delete all excluded variant indexes
+    ///Delete all pending included variants
+    void ClearIncludedVariants();
+    ///Delete all pending excluded variant indexes
     void ClearExcludedVariants();
-    ///Add variant indexes to the excluded variant list
-    void AddExcludedVariants(std::vector<int>& a_rIncludedVarListCalled, std::vector<int>& a_rIncludedVarListBase);
+    ///Set the decisions of the called and base variants
+    void SetDecisions(const CDecisionArray& a_rDecisionsCalled, const CDecisionArray& a_rDecisionsBase);
     
-    ///Delete all sync point list
+    ///Push a syncronisation point reached during replay
+    void PushSyncPoint(int a_nSyncPoint);
+    
+    ///Delete all sync point list (both pending and materialized)
     void ClearSyncPointList();
     ///Add sync points to the sync point list
     void AddSyncPointList(std::vector<int>& a_rSyncPointArray);
     
-    ///Sorts included variants (baseline and called) according to variant ids
-    void SortIncludedVariants();
-    
     ///Semi path object for base
     CSemiPath m_baseSemiPath;
     
     ///Semi path object for called
     CSemiPath m_calledSemiPath;
     
-    ///Position index list of the syncronisation points
+    ///Position index list of the syncronisation points (materialized list of the best path)
     std::vector<int> m_aSyncPointList;
     
+    ///Syncronisation points reached during replay since the last flush (shared between path copies)
+    CPersistentList<int> m_aPendingSyncPoints;
+    
     ///Added variant count to called since last sync
     int m_nCSinceSync;
     
     ///Added variant count to called since last sync
     int m_nBSinceSync;
     
+    //Running score of the path since the last flush. Used by CPathReplay::FindBetter to compare paths in constant time
+    ///Number of pending included variants of base/called semipath
+    int m_nIncludedCountBase;
+    int m_nIncludedCountCalled;
+    ///Allele index of the last pending included variant of base/called semipath (-1 if there is none)
+    int m_nLastIncludedAlleleBase;
+    int m_nLastIncludedAlleleCalled;
+    ///Last pending sync point (0 if there is none)
+    int m_nLastSyncPoint;
+    
     //TEST Purpose
     int m_nPathId;
     
+    private:
+    
+    friend class CPathPool;
+    friend class CPathContainer;
+    
+    ///Number of CPathContainers referencing this path
+    int m_nPoolRefCount;
+    ///Slab of the pool that the path belongs to (NULL if the path is not allocated from a pool)
+    SPathSlab* m_pPoolSlab;
+    ///Next path in the free list of the pool
+    CPath* m_pNextFree;
+    
+    ///Checks if the path is out of sync and any side has a phase state
+    bool HasPhase() const;
+    
+    ///Return the orientation of the phase states of both sides as a single value
+    int GetPhaseOrientation() const;
 };
 
 /**
  * @brief A Path Container that stores the reference of a path for effective store in std::set container
  *
- * CPathContainer contains a pointer to CPath object and couple overload constructors
+ * CPathContainer contains a reference counted pointer to a CPath object allocated from a CPathPool. The path is
+ * returned to its pool when the last container referencing it is destroyed.
  */
 class CPathContainer
 {
@@ -156,19 +210,34 @@ public:
         m_pPath = 0;
     }
     
+    ///Reference the given path acquired from a CPathPool
+    explicit CPathContainer(CPath* a_pPath)
+    {
+        m_pPath = a_pPath;
+        m_pPath->m_nPoolRefCount++;
+    }
+    
     CPathContainer(const CPathContainer& a_rObj)
     {
         m_pPath = a_rObj.m_pPath;
+        if(m_pPath != 0)
+            m_pPath->m_nPoolRefCount++;
     }
     
-    CPathContainer(const char* a_aRefSequence, int a_nRefSize)
+    ~CPathContainer()
     {
-        m_pPath = std::shared_ptr<CPath>(new CPath(a_aRefSequence,a_nRefSize));
+        Release();
     }
     
-    CPathContainer(const CPath& a_rPath, int a_nSyncPointToPush)
+    CPathContainer& operator=(const CPathContainer& a_rObj)
     {
-        m_pPath = std::shared_ptr<CPath>(new CPath(a_rPath, a_nSyncPointToPush));
+        //Keep the pointer before release since a_rObj can be this container
+        CPath* pPath = a_rObj.m_pPath;
+        if(pPath != 0)
+            pPath->m_nPoolRefCount++;
+        Release();
+        m_pPath = pPath;
+        return *this;
     }
     
     bool operator<(const CPathContainer& a_rObj) const
@@ -177,7 +246,12 @@ public:
     }
     
     //Pointer to path object
-    std::shared_ptr<CPath> m_pPath;
+    CPath* m_pPath;
+    
+private:
+    
+    ///Drop the reference to the path and return it to its pool if it is not referenced anymore
+    void Release();
     
 };
 
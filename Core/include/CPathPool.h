@@ -0,0 +1,115 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CPathPool.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_PATH_POOL_H_
+#define _C_PATH_POOL_H_
+
+#include "CPath.h"
+#include "Constants.h"
+#include <vector>
+
+namespace core
+{
+
+class CPathPool;
+
+///Block of path objects allocated at once by the path pool
+struct SPathSlab
+{
+    ///Path objects of the slab
+    CPath m_aPaths[PATH_POOL_SLAB_SIZE];
+    ///Number of paths currently in use
+    int m_nLiveCount;
+    ///Owner pool of the slab
+    CPathPool* m_pPool;
+};
+
+/**
+ * @brief Slab allocator for CPath objects generated during variant replay
+ *
+ * Each CPathReplay owns a pool. Paths are allocated in slabs of PATH_POOL_SLAB_SIZE and released paths are kept constructed
+ * in a free list. A reused path is overwritten with assignment so that the storage of its haplotype sequences is recycled
+ * instead of being reallocated. At sync points (where the path set is empty) the slabs with no path in use are released in bulk.
+ * The pool is not thread safe: it should only be used by the thread owning the CPathReplay.
+ */
+class CPathPool
+{
+public:
+    
+    CPathPool();
+    
+    ~CPathPool();
+    
+    ///Return an unused path from the pool. Content of the path is undefined and it should be assigned by the caller
+    CPath* Acquire();
+    
+    ///Return a new path from the pool which is a copy of the given path
+    CPathContainer Create(const CPath& a_rSource);
+    
+    ///Put the given path back to the free list of the pool
+    void Release(CPath* a_pPath);
+    
+    ///Frees the slabs which have no path in use if the pool has grown beyond PATH_POOL_RETAINED_SLAB_COUNT
+    void Reclaim();
+    
+    ///Reset the allocation counters
+    void ResetCounters();
+    
+    ///Return the number of paths served by the pool since the last counter reset
+    int GetAcquireCount() const;
+    
+    ///Return the number of slabs allocated from heap since the last counter reset
+    int GetSlabAllocationCount() const;
+    
+    ///Return the maximum number of paths in use at the same time since the last counter reset
+    int GetPeakLiveCount() const;
+    
+private:
+    
+    CPathPool(const CPathPool&);
+    CPathPool& operator=(const CPathPool&);
+    
+    ///Allocates a new slab and add its paths to the free list
+    void AllocateSlab();
+    
+    ///All slabs owned by the pool
+    std::vector<SPathSlab*> m_aSlabs;
+    
+    ///Head of the free path list
+    CPath* m_pFreeList;
+    
+    ///Number of slabs with no path in use
+    int m_nEmptySlabCount;
+    
+    ///Number of paths in use
+    int m_nLiveCount;
+    
+    //Allocation counters
+    int m_nAcquireCount;
+    int m_nSlabAllocationCount;
+    int m_nPeakLiveCount;
+};
+
+}
+
+#endif // _C_PATH_POOL_H_
@@ -30,7 +30,12 @@
 
 #include "CVariantProvider.h"
 #include "CPathSet.h"
+#include "CPathPool.h"
 #include "CVariant.h"
+#include "EComplexRegionMode.h"
+#include "CReplayCache.h"
+#include "CReplayStats.h"
+#include <chrono>
 
 namespace core
 {
@@ -38,6 +43,55 @@ namespace core
 class CPath;
 class CPathContainer;
 
+///Complexity estimate of the cluster of overlapping variants that follows a sync point
+struct SRegionEstimate
+{
+    ///Number of base and called variants in the cluster
+    int m_nVariantCount;
+    ///Number of heterozygous variants in the cluster
+    int m_nHeterozygousCount;
+    ///Total length of the longest allele (ref or alt) of each variant
+    int m_nAlleleSpan;
+    ///Reference region of the cluster
+    int m_nStartPosition;
+    int m_nEndPosition;
+    ///Log2 of the predicted number of paths alive in the cluster
+    double m_dPathBits;
+};
+
+///Cluster of overlapping variants that follows a sync point, replayed with the decisions of the replay cache
+struct SCachedRegion
+{
+    ///Content hash of the cluster, the variants following it and the reference sequence reachable from it
+    SReplayCacheKey m_key;
+    ///Variant index ranges of the cluster (inclusive, end is start - 1 if the side has no variant in the cluster)
+    int m_nBaseStart;
+    int m_nBaseEnd;
+    int m_nCalledStart;
+    int m_nCalledEnd;
+    ///Sizes of the flushed decision lists when the replay of the cluster started
+    int m_nFlushedIncludedBase;
+    int m_nFlushedExcludedBase;
+    int m_nFlushedIncludedCalled;
+    int m_nFlushedExcludedCalled;
+};
+
+///Replay state at the start of the sync region whose statistics are collected
+struct SRegionStatsStart
+{
+    ///Index of the last variant processed before the region on each side
+    int m_nBaseIndex;
+    int m_nCalledIndex;
+    ///Total iteration count of the replay when the region started
+    long long m_nIterationCount;
+    ///Largest number of paths alive since the region started
+    int m_nPeakPathCount;
+    ///Complex region and beam search region counters of the replay when the region started
+    int m_nComplexRegionCount;
+    int m_nBeamRegionCount;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
 /**
  * @brief Core Variant Comparison class that compares given 2 variant sets
  *
@@ -57,9 +111,42 @@ class CPathReplay
         ///Sets maximum pathsize and maximum path iteration count
         void SetMaxPathAndIteration(int a_nMaxPathSize, int a_nMaxIterationCount);
     
+        ///Sets the strategy for the regions exceeding the path size or iteration limit, and the number of paths kept in beam search mode
+        void SetComplexRegionMode(EComplexRegionMode a_mode, int a_nBeamWidth);
+    
+        ///Enables the complexity estimation of each region before replay (iteration budget proportional to the predicted complexity)
+        void SetAdaptiveBudget(bool a_bIsEnabled);
+    
         ///Clears variants belong to best path
         void Clear();
     
+        ///Sets the cache that stores the decisions of the resolved regions (NULL disables the cache)
+        void SetReplayCache(CReplayCache* a_pReplayCache);
+    
+        ///Enables the collection of the statistics of each sync region (see GetRegionStats)
+        void SetCollectRegionStats(bool a_bIsEnabled);
+    
+        ///Return the statistics of the sync regions of the last replay in position order (empty if the collection is disabled)
+        const std::vector<SReplayRegionStats>& GetRegionStats() const;
+    
+        ///Enables/disables the FINISHED summary line printed after each replay
+        void SetPrintSummary(bool a_bPrintSummary);
+    
+        ///Marks the variant lists as a block of a larger list which has preceding variants on the given sides
+        void SetHasPrecedingVariants(bool a_bBase, bool a_bCalled);
+    
+        ///Checks if the last replay reached a single synchronized path after processing all of its variants
+        bool IsSettled() const;
+    
+        ///Return the furthest position processed by the last replay when it settled (-1 if it is not settled)
+        int GetSettledPosition() const;
+    
+        ///Checks if the last replay skipped a complex region starting before the first variant of the given side
+        bool IsSkippedFromStart(EVcfName a_uVcfName) const;
+    
+        ///Estimates the relative replay cost of the given variant lists from their variant count and density (used to order the chromosome jobs)
+        static double EstimateCost(const std::vector<const CVariant*>& a_rVarListBase, const std::vector<const CVariant*>& a_rVarListCalled);
+    
         /**
          * @brief Finds the best path by generating all possible paths for the given chromosome
          *
@@ -84,6 +171,63 @@ class CPathReplay
         ///Compare the two paths and find the one that maximize TP count
         bool FindBetter(const CPathContainer& lhs, const CPathContainer& rhs);
     
+        ///Compares the running scores of the paths used by FindBetter. Returns a positive value if lhs is better, 0 if they are equal
+        static int CompareScore(const CPath& a_rLhs, const CPath& a_rRhs);
+    
+        /**
+         * @brief Reduces the path list and the processed path to the best scoring paths (beam search mode)
+         *
+         * At most m_nBeamWidth paths are kept, and the frontier is at least halved so that a region exceeding the iteration
+         * limit with a narrow frontier still makes progress. Processed path is set to the least advanced kept path.
+         */
+        void KeepBestPaths(CPathContainer& a_rProcessedPath);
+    
+        /**
+         * @brief Estimates the complexity of the variant cluster the synchronized path replays next
+         *
+         * Cluster is the chain of overlapping base and called variants that follows the path. Each homozygous variant doubles
+         * the paths and each heterozygous variant triples them (two phases and exclusion), and longer alleles keep more paths
+         * apart before they merge. Walk stops once the cluster is predicted to be hopeless.
+         */
+        SRegionEstimate EstimateRegion(const CPath& a_rSyncPath) const;
+    
+        ///Checks if the estimated region would exceed the maximum path size by far
+        bool IsHopelessRegion(const SRegionEstimate& a_rEstimate) const;
+    
+        ///Return the iteration budget of the estimated region, proportional to its predicted iteration count
+        int GetIterationBudget(const SRegionEstimate& a_rEstimate) const;
+    
+        /**
+         * @brief Finds the cluster of overlapping variants that follows the synchronized path and computes its cache key
+         *
+         * Key covers everything the replay of the cluster can depend on: the variants of the cluster relative to its start, the
+         * start of the variants following it and the reference sequence up to them. Returns false if the cluster should not be
+         * cached (too small or too long, phased variants, or the last cluster of the contig).
+         */
+        bool GetCachedRegion(const CPath& a_rSyncPath, const SContig& a_rContig, bool a_bIsGenotypeMatch, SCachedRegion& a_rRegion) const;
+    
+        ///Collects the decisions of the cluster made by the replay until the given synchronized path. Returns false if any variant is undecided
+        bool GetRegionDecisions(const CPath& a_rSyncPath, const SCachedRegion& a_rRegion, std::vector<uint8_t>& a_rDecisions) const;
+    
+        /**
+         * @brief Moves the synchronized path over the cluster with the cached decisions
+         *
+         * Path takes the same steps as the surviving branch of a full replay of the cluster, so the result is the path that a
+         * full replay would reach the next variant with. Returns false if the decisions do not fit the path.
+         */
+        bool PlayCachedRegion(CPath& a_rPath, const SContig& a_rContig, const SCachedRegion& a_rRegion, const std::vector<uint8_t>& a_rDecisions, bool a_bIsGenotypeMatch);
+    
+        /**
+         * @brief Adds the statistics of the region that ends at the given synchronized path and starts the next region
+         *
+         * Sync points reached without processing any variant do not end the region. Outcome of the region is decided from the
+         * complex region and beam search region counters of the replay.
+         */
+        void AddRegionStats(const CPath& a_rSyncPath, long long a_nTotalIterations, int a_nComplexRegionCount, int a_nBeamRegionCount, SRegionStatsStart& a_rStart);
+    
+        ///Marks the variants in the given index ranges (inclusive) as decided by beam search
+        void MarkApproximateVariants(int a_nBaseStart, int a_nBaseEnd, int a_nCalledStart, int a_nCalledEnd);
+    
         ///Process next variant for the input path
         bool EnqueueVariant(CPath& a_rPathToPlay, EVcfName a_uVcfSide, bool a_bIsGenotypeMatch);
     
@@ -93,9 +237,38 @@ class CPathReplay
          */
         int GetNextVariant(const CSemiPath& a_rSemiPath) const;
     
+        ///Checks if the path is synchronized and all variants of both sides are processed
+        bool IsAllVariantsProcessed(const CPath& a_rPath) const;
+    
         ///Move the path to the specified position, ignoring any intervening variants. Returns the skipped variant count
         int SkipVariantsTo(CPath& a_rPath, const SContig& a_rContig, int a_nMaxPos);
     
+        /**
+         * @brief Steps the popped path until it needs a decision or another path of the path list should be processed first
+         *
+         * Each step taken after the first one replaces a pop of the replay loop, so at most a_nMaxPopCount of them are taken.
+         * Steps that need no check are taken at once with CPath::StepPlain. Returns the number of pops replaced, a_rIsMatching is
+         * set to false if the path does not match anymore and should be dropped
+         */
+        int StepPath(CPath& a_rPath, const SContig& a_rContig, int a_nMaxPopCount, int& a_rMaxProcessedPosition, bool& a_rIsMatching);
+    
+        ///Return the number of steps the path can take without reaching a position where a variant of either side is enqueued
+        int GetStepCountToNextVariant(const CPath& a_rPath) const;
+    
+        ///Checks if the next base and called variants of the synchronized path are an identical substitution isolated from the other variants
+        bool IsTrivialVariantPair(const CPath& a_rPath, const SContig& a_rContig) const;
+    
+        /**
+         * @brief Includes the trivial variant pair to both sides of the path and moves it to the next sync point
+         *
+         * Result is the same path that survives the full replay of the pair (genotype match of the first orientation). Returns false
+         * if the path does not match while passing the pair, in which case the path should be discarded.
+         */
+        bool PlayTrivialVariantPair(CPath& a_rPath, const SContig& a_rContig);
+    
+        ///Pool that allocates the paths generated during replay (declared before m_pathList so that it outlives the stored paths)
+        CPathPool m_pathPool;
+    
         ///Path list to store generated paths
         CPathSet m_pathList;
         
@@ -121,6 +294,40 @@ class CPathReplay
         int m_nMaxPathSize;
         ///Cutoff iteration count without enqueing any variant to the pathlist
         int m_nMaxIterationCount;
+    
+        ///Strategy for the regions exceeding the cutoffs and the number of paths kept by beam search
+        EComplexRegionMode m_complexRegionMode;
+        int m_nBeamWidth;
+    
+        ///Assign the iteration budget of each region from its complexity estimate
+        bool m_bAdaptiveBudget;
+    
+        ///Cache of the resolved region decisions (NULL if the cache is disabled)
+        CReplayCache* m_pReplayCache;
+    
+        //Largest variant index enqueued on each side since the replay of the current cached region started
+        int m_nMaxEnqueuedIndexBase;
+        int m_nMaxEnqueuedIndexCalled;
+    
+        ///Collect the statistics of each sync region
+        bool m_bCollectRegionStats;
+        ///Statistics of the sync regions of the last replay
+        std::vector<SReplayRegionStats> m_aRegionStats;
+    
+        ///Print the FINISHED summary line at the end of replay
+        bool m_bPrintSummary;
+    
+        //Set when the variant lists are a block of a larger list that has variants before the block on that side
+        bool m_bHasPrecedingVariantsBase;
+        bool m_bHasPrecedingVariantsCalled;
+    
+        //Settle point of the last replay (used to validate block boundaries of CParallelPathReplay)
+        bool m_bIsSettled;
+        int m_nSettledPosition;
+    
+        //Set when a complex region is skipped from a sync path that had no variant processed on that side yet
+        bool m_bSkippedFromStartBase;
+        bool m_bSkippedFromStartCalled;
 };
 
 }
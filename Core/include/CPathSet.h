@@ -27,14 +27,19 @@
 #define _C_PATH_SET_H_
 
 #include "CPath.h"
-#include <set>
+#include <vector>
+#include <cstdint>
 
 namespace core
 {
 
 /**
- * @brief Search Tree of CPaths - current countainer is std::set from STL
+ * @brief Frontier of CPaths waiting to be processed during variant replay
  *
+ * Paths are kept in a binary min-heap ordered by CPath::CompareTo, so the least advanced path is popped first (the same
+ * order std::set would give). Equivalent paths are detected with an open addressing hash table keyed by the replay state
+ * hash of the path, deep comparison is only done when the hashes are equal. Both structures are flat arrays which are
+ * reused between sync points.
  */
 class CPathSet
 {
@@ -42,41 +47,78 @@ class CPathSet
 
     CPathSet();
     
-    ///Return size of Tree
+    ///Return size of the frontier
     int Size() const;
-    
-    std::set<CPathContainer>::iterator End() const;
 
-    ///Clear the search tree
+    ///Clear the frontier
     void Clear();
 
-    ///Add CPathContainer to search tree
-    void Add(const CPathContainer& item);
-
-    ///Delete CPathContainer from search tree
-    void Erase(const CPathContainer& item);
+    ///Add CPathContainer to the frontier. There should be no equivalent path in the frontier. a_nHash is the state hash of the path
+    void Add(const CPathContainer& a_rItem, uint64_t a_nHash);
     
-    ///Find closest CPathContainer in search tree to the given path
-    std::set<CPathContainer>::iterator Find(const CPathContainer& item);
+    ///Return the stored path equivalent to the given path (see CPath::IsEqual) or NULL. a_nHash is the state hash of the path
+    CPathContainer* Find(const CPathContainer& a_rItem, uint64_t a_nHash);
     
-    ///Pops the least advanced CPathContainer from the search tree
-    void GetLeastAdvanced(CPathContainer& items);
+    ///Pops the least advanced CPathContainer from the frontier
+    void GetLeastAdvanced(CPathContainer& a_rItem);
+    
+    ///Return the least advanced CPathContainer without removing it. Frontier should not be empty
+    const CPathContainer& PeekLeastAdvanced() const;
 
-    ///Checks if the search tree is empty
+    ///Checks if the frontier is empty
     bool Empty();
 
-    ///Chekcs if the search tree contains given CPathContainer
-    bool Contains(const CPathContainer& item) const;
-
-    CPathContainer floor(const CPathContainer& a_rObj);
+    ///Chekcs if the frontier contains given CPathContainer
+    bool Contains(const CPathContainer& a_rItem) const;
     
-    ///Print the search tree [FOR TEST]
+    ///Print the frontier [FOR TEST]
     void Print() const;
 
   private:
     
-    std::set<CPathContainer> m_set;
-
+    ///Heap element
+    struct SHeapEntry
+    {
+        CPathContainer m_path;
+        uint64_t m_nHash;
+        ///Slot of the path in the hash table
+        int m_nTableSlot;
+    };
+    
+    ///Hash table element
+    struct STableEntry
+    {
+        uint64_t m_nHash;
+        ///Index of the path in the heap (-1 if slot is empty)
+        int m_nHeapIndex;
+    };
+    
+    ///Heap ordering of two entries
+    bool IsLess(int a_nLhsIndex, int a_nRhsIndex) const;
+    
+    ///Swaps the two heap entries and updates their hash table slots
+    void SwapEntries(int a_nIndex1, int a_nIndex2);
+    
+    void SiftUp(int a_nIndex);
+    void SiftDown(int a_nIndex);
+    
+    ///Insert the heap entry to the hash table
+    void InsertToTable(int a_nHeapIndex);
+    
+    ///Remove the given slot from the hash table (backward shift deletion)
+    void RemoveFromTable(int a_nSlot);
+    
+    ///Doubles the hash table size and reinserts all heap entries
+    void GrowTable();
+    
+    ///Min-heap of paths
+    std::vector<SHeapEntry> m_aHeap;
+    
+    ///Open addressing (linear probing) hash table. Size is always power of 2
+    std::vector<STableEntry> m_aTable;
+    
+    ///Number of heap elements in use
+    int m_nSize;
 };
 
 }
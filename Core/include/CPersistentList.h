@@ -0,0 +1,151 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CPersistentList.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_PERSISTENT_LIST_H_
+#define _C_PERSISTENT_LIST_H_
+
+#include <vector>
+#include <cstddef>
+
+namespace core
+{
+
+/**
+ * @brief Append-only list whose copies share their common prefix
+ *
+ * CPersistentList stores the decisions (included/excluded variants, sync points) made along a path. Every path branch
+ * copies its parent lists, so the list is kept as a chain of reference counted nodes pointing from the newest element
+ * to the oldest one. A copy only increments the reference count of the newest node and appending creates a single node,
+ * both are O(1) regardless of the number of elements. The list is materialized into a flat vector with AppendTo.
+ *
+ * Reference counts are not atomic: a list and all its copies must stay within the thread that owns the CPathReplay.
+ */
+template <typename T>
+class CPersistentList
+{
+public:
+
+    CPersistentList()
+    : m_pHead(NULL)
+    {}
+
+    ///Copy constructor (shares all nodes of a_rObj)
+    CPersistentList(const CPersistentList& a_rObj)
+    : m_pHead(a_rObj.m_pHead)
+    {
+        if(m_pHead != NULL)
+            m_pHead->m_nRefCount++;
+    }
+
+    ~CPersistentList()
+    {
+        Release(m_pHead);
+    }
+
+    CPersistentList& operator=(const CPersistentList& a_rObj)
+    {
+        if(m_pHead != a_rObj.m_pHead)
+        {
+            if(a_rObj.m_pHead != NULL)
+                a_rObj.m_pHead->m_nRefCount++;
+            Release(m_pHead);
+            m_pHead = a_rObj.m_pHead;
+        }
+        return *this;
+    }
+
+    ///Append the given value to the end of the list
+    void PushBack(const T& a_rValue)
+    {
+        SNode* pNode = new SNode;
+        pNode->m_value = a_rValue;
+        pNode->m_pPrevious = m_pHead;
+        pNode->m_nSize = Size() + 1;
+        pNode->m_nRefCount = 1;
+        //The reference of this list to the old head is transferred to the new node
+        m_pHead = pNode;
+    }
+
+    ///Return the last appended value. List should not be empty
+    const T& Back() const
+    {
+        return m_pHead->m_value;
+    }
+
+    ///Return the number of elements in the list
+    int Size() const
+    {
+        return m_pHead == NULL ? 0 : m_pHead->m_nSize;
+    }
+
+    ///Checks if the list is empty
+    bool Empty() const
+    {
+        return m_pHead == NULL;
+    }
+
+    ///Remove all elements of this list (copies of the list are not affected)
+    void Clear()
+    {
+        Release(m_pHead);
+        m_pHead = NULL;
+    }
+
+    ///Append the elements of the list to the given vector in insertion order
+    void AppendTo(std::vector<T>& a_rVector) const
+    {
+        size_t offset = a_rVector.size();
+        a_rVector.resize(offset + Size());
+
+        for(SNode* pNode = m_pHead; pNode != NULL; pNode = pNode->m_pPrevious)
+            a_rVector[offset + pNode->m_nSize - 1] = pNode->m_value;
+    }
+
+private:
+
+    struct SNode
+    {
+        T m_value;
+        SNode* m_pPrevious;
+        int m_nSize;
+        int m_nRefCount;
+    };
+
+    ///Drop one reference of the given node. Released chain is freed iteratively to avoid deep recursion on long lists
+    static void Release(SNode* a_pNode)
+    {
+        while(a_pNode != NULL && --a_pNode->m_nRefCount == 0)
+        {
+            SNode* pPrevious = a_pNode->m_pPrevious;
+            delete a_pNode;
+            a_pNode = pPrevious;
+        }
+    }
+
+    ///Most recently appended node
+    SNode* m_pHead;
+};
+
+}
+
+#endif // _C_PERSISTENT_LIST_H_
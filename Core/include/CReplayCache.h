@@ -0,0 +1,158 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CReplayCache.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_REPLAY_CACHE_H_
+#define _C_REPLAY_CACHE_H_
+
+#include "StateHash.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace core
+{
+
+///Decision of a variant stored in the replay cache
+enum EReplayDecision
+{
+    eREPLAY_EXCLUDED = 0,
+    ///Variant is included with the first oriented variant of the pair (index 2*i of the oriented variant list)
+    eREPLAY_INCLUDED_FIRST = 1,
+    ///Variant is included with the second oriented variant of the pair (index 2*i+1 of the oriented variant list)
+    eREPLAY_INCLUDED_SECOND = 2
+};
+
+///Content hash of a replayed region. Two independent 64 bit hashes are used to make the collisions negligible
+struct SReplayCacheKey
+{
+    uint64_t m_nHash1;
+    uint64_t m_nHash2;
+};
+
+///Add the given value to both hashes of the key
+inline void CombineCacheKey(SReplayCacheKey& a_rKey, uint64_t a_nValue)
+{
+    a_rKey.m_nHash1 = CombineHash(a_rKey.m_nHash1, a_nValue);
+    a_rKey.m_nHash2 = CombineHash(a_rKey.m_nHash2, ~a_nValue);
+}
+
+/**
+ * @brief Persistent, content addressed store of the variant decisions of replayed regions
+ *
+ * Cache is a single file inside the cache directory that is memory mapped when it is opened. File starts with a header,
+ * followed by the entries sorted by their key and the decision bytes of the entries. Lookups binary search the mapped entries,
+ * so opening a large cache costs nothing until its entries are used. Regions resolved during the run are kept in memory and
+ * merged with the mapped entries when the cache is saved. The cache is shared by the replays of all threads.
+ */
+class CReplayCache
+{
+public:
+
+    CReplayCache();
+
+    ///Unmaps the cache file
+    ~CReplayCache();
+
+    /**
+     * @brief Maps the cache file of the given directory (directory is created if it does not exist)
+     *
+     * A missing file is not an error. A file written by a different cache version or with different replay settings is ignored
+     * and replaced when the cache is saved. Returns false if the directory cannot be used.
+     */
+    bool Open(const std::string& a_rDirectory, uint64_t a_nSettingsHash);
+
+    ///Checks if the cache is opened
+    bool IsOpen() const;
+
+    ///Writes the mapped entries and the entries added during the run to the cache file. Returns false if the file cannot be written
+    bool Save();
+
+    ///Finds the decisions of the region with the given key. Hit and miss counters are updated
+    bool Find(const SReplayCacheKey& a_rKey, std::vector<uint8_t>& a_rDecisions);
+
+    ///Stores the decisions of a region resolved during the run
+    void Insert(const SReplayCacheKey& a_rKey, const std::vector<uint8_t>& a_rDecisions);
+
+    ///Return the number of lookups that found the region
+    int GetHitCount() const;
+
+    ///Return the number of lookups that did not find the region
+    int GetMissCount() const;
+
+    ///Return the number of regions added during the run
+    int GetInsertCount() const;
+
+private:
+
+    CReplayCache(const CReplayCache&);
+    CReplayCache& operator=(const CReplayCache&);
+
+    ///Header of the cache file
+    struct SFileHeader
+    {
+        char m_aMagic[8];
+        uint64_t m_nSettingsHash;
+        uint64_t m_nEntryCount;
+        uint64_t m_nDecisionSize;
+    };
+
+    ///Entry of the cache file. Decisions of the entry are stored at the given offset of the decision section
+    struct SFileEntry
+    {
+        uint64_t m_nHash1;
+        uint64_t m_nHash2;
+        uint64_t m_nDecisionOffset;
+        uint64_t m_nDecisionCount;
+    };
+
+    ///Unmaps the cache file
+    void Close();
+
+    ///Path of the cache file
+    std::string m_filePath;
+    ///Replay settings that the entries are valid for
+    uint64_t m_nSettingsHash;
+    bool m_bIsOpen;
+
+    //Mapped cache file (NULL if there is no valid file)
+    void* m_pMappedFile;
+    size_t m_nMappedSize;
+    const SFileEntry* m_pEntries;
+    uint64_t m_nEntryCount;
+    const uint8_t* m_pDecisions;
+
+    ///Regions resolved during the run that are not in the mapped file
+    std::map<std::pair<uint64_t, uint64_t>, std::vector<uint8_t>> m_aNewEntries;
+    std::mutex m_newEntryMutex;
+
+    std::atomic<int> m_nHitCount;
+    std::atomic<int> m_nMissCount;
+    std::atomic<int> m_nInsertCount;
+};
+
+}
+
+#endif // _C_REPLAY_CACHE_H_
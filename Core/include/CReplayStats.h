@@ -0,0 +1,98 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CReplayStats.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_REPLAY_STATS_H_
+#define _C_REPLAY_STATS_H_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+
+namespace core
+{
+
+///How the replay finished a sync region
+enum EReplayRegionOutcome
+{
+    ///All paths of the region are replayed
+    eREGION_RESOLVED,
+    ///Region exceeded the replay limits and its variants are skipped
+    eREGION_SKIPPED,
+    ///Region exceeded the replay limits and it is resolved by beam search
+    eREGION_FALLBACK
+};
+
+///Replay statistics of the variants between two consecutive sync points
+struct SReplayRegionStats
+{
+    ///Reference range covered by the variants of the region (0-based, end is exclusive)
+    int m_nStartPosition;
+    int m_nEndPosition;
+    int m_nBaseVariantCount;
+    int m_nCalledVariantCount;
+    ///Largest number of paths alive at the same time
+    int m_nPeakPathCount;
+    long long m_nIterationCount;
+    long long m_nElapsedNanoseconds;
+    EReplayRegionOutcome m_outcome;
+};
+
+/**
+ * @brief Writes the per sync region replay statistics to a tab delimited file
+ *
+ * Each replay collects the statistics of its regions in its own buffer without any synchronization. The buffer of a
+ * chromosome is written once its replay is completed, so the file is shared by all threads with a single lock per chromosome.
+ */
+class CReplayStats
+{
+public:
+
+    ///Opens the given file and writes the header line. Returns false if the file cannot be opened
+    bool Open(const std::string& a_rFilePath);
+
+    ///Checks if the statistics file is opened
+    bool IsOpen() const;
+
+    ///Closes the statistics file
+    void Close();
+
+    /**
+     * @brief Writes the statistics of the regions of a chromosome
+     *
+     * @param a_rChromosome Chromosome name
+     * @param a_rComparison Name of the compared vcf pair
+     * @param a_bIsGenotypeMatch Replay mode of the regions (genotype match or allele match)
+     * @param a_rRegions Region statistics in position order
+     */
+    void Write(const std::string& a_rChromosome, const std::string& a_rComparison, bool a_bIsGenotypeMatch, const std::vector<SReplayRegionStats>& a_rRegions);
+
+private:
+
+    std::ofstream m_file;
+    std::mutex m_fileMutex;
+};
+
+}
+
+#endif // _C_REPLAY_STATS_H_
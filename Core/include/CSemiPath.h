@@ -29,6 +29,8 @@
 #define _C_SEMI_PATH_H_
 
 #include "CHaplotypeSequence.h"
+#include "CPersistentList.h"
+#include "CDecisionArray.h"
 #include "EVcfName.h"
 #include <vector>
 
@@ -40,6 +42,8 @@ namespace core
  *
  * CSemiPath stores the variant replay information of single vcf. Each CSemipath contains two haplotype 
  * (since human is diploid). Variants included/excluded so far is stored at CSemipath level.
+ * During replay the decisions are kept in persistent lists which are shared between the copies of a semipath; they are
+ * materialized into a compact decision array only for the best path.
  *
  */
 class CSemiPath
@@ -62,9 +66,6 @@ class CSemiPath
     ///Return vcf name of the semi path
     EVcfName GetVcfName() const;
     
-    ///Return the list of excluded variants
-    const std::vector<int>& GetExcluded() const;
-    
     ///Gets the end position the semipath (max of haplotypeA and haplotypeB)
     int GetPosition() const;
     
@@ -80,8 +81,14 @@ class CSemiPath
     ///Set the index of last variant added
     void SetVariantIndex(int a_nVariantIndex);
     
-    ///Return pointer to included variants
-    const std::vector<const COrientedVariant*>& GetIncludedVariants() const;
+    ///Return the decisions of the variants (materialized decisions of the best path)
+    const CDecisionArray& GetDecisions() const;
+    
+    ///Return the number of variants included during replay since the last flush
+    int GetPendingIncludedCount() const;
+    
+    ///Append included/excluded variants decided during replay since the last flush to the given lists
+    void AppendPendingVariants(std::vector<const COrientedVariant*>& a_rIncludedVarList, std::vector<int>& a_rExcludedVarList) const;
     
     ///Check whether this half path is fully on the template (i.e. no haplotypes are within a variant)
     bool IsOnTemplate() const;
@@ -94,6 +101,9 @@ class CSemiPath
     
     ///Check whether this half path is equal to the given half path
     bool IsEqual(const CSemiPath& a_rObj) const;
+    
+    ///Return the hash of the replay state compared by CompareTo
+    uint64_t GetStateHash() const;
 
     ///Checks if both haplotype A and B is finished
     bool HasFinished() const;
@@ -121,19 +131,28 @@ class CSemiPath
 
     void StepHaplotypeA();
     void StepHaplotypeB();
+    
+    ///Return haplotype A or B
+    const CHaplotypeSequence& GetHaplotype(bool a_bIsHaplotypeA) const;
+    
+    ///Performs plain steps on haplotype A or B (see CHaplotypeSequence::GetPlainStepCount)
+    void PlainStepHaplotype(bool a_bIsHaplotypeA, int a_nStepCount);
+    
+    ///Return the phase set of the last phased heterozygous variant included (-1 if there is none)
+    int GetPhaseSet() const;
+    
+    ///Checks if the last phased heterozygous variant is included in the unordered orientation
+    bool IsPhaseSwapped() const;
+    
+    ///Set the phase set and the orientation of the last phased heterozygous variant included
+    void SetPhase(int a_nPhaseSet, bool a_bIsSwapped);
 
-    ///Clear the included variants
+    ///Clear the pending included variants
     void ClearIncludedVariants();
-    ///Set the included variants
-    void AddIncludedVariants(std::vector<const COrientedVariant*>& a_rIncludedVarList);
-    
-    ///Clear the included variants
+    ///Clear the pending excluded variants
     void ClearExcludedVariants();
-    ///Set the included variants
-    void AddExcludedVariants(std::vector<int>& a_rExcludedVarList);
-
-    ///Sorts included variants according to variant ids
-    void SortIncludedVariants();
+    ///Set the decisions of the variants
+    void SetDecisions(const CDecisionArray& a_rDecisions);
     
     ///[TEST Purpose]Print semipath
     void Print() const;
@@ -148,9 +167,16 @@ class CSemiPath
     int m_nVariantEndPosition;
     ///Last variant included
     int m_nIncludedVariantEndPosition;
+    ///Phase set and orientation of the last phased heterozygous variant included (phase set is -1 if there is none)
+    int m_nPhaseSet;
+    bool m_bIsPhaseSwapped;
+
+    ///Variants included/excluded during replay since the last flush (shared between semipath copies)
+    CPersistentList<const COrientedVariant*> m_aPendingIncludedVariants;
+    CPersistentList<int> m_aPendingExcludedVariants;
 
-    std::vector<const COrientedVariant*> m_aIncludedVariants;
-    std::vector<int> m_aExcludedVariants;
+    ///Materialized decisions of the best path
+    CDecisionArray m_decisions;
 
     CHaplotypeSequence m_haplotypeA;
     CHaplotypeSequence m_haplotypeB;
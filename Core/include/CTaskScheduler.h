@@ -0,0 +1,153 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CTaskScheduler.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_TASK_SCHEDULER_H_
+#define _C_TASK_SCHEDULER_H_
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace core
+{
+
+class CTaskScheduler;
+
+/**
+ * @brief Set of tasks submitted to a CTaskScheduler that are waited together
+ *
+ * A group can be created inside a running task (e.g. a chromosome task submitting the blocks of its contig). While such a task
+ * waits for its group, its thread keeps executing the nested tasks of the scheduler instead of blocking a worker.
+ */
+class CTaskGroup
+{
+public:
+
+    explicit CTaskGroup(CTaskScheduler& a_rScheduler);
+
+    ///Waits for the remaining tasks of the group
+    ~CTaskGroup();
+
+    ///Submits the task to the scheduler
+    void Run(const std::function<void()>& a_rTask);
+
+    ///Blocks until all tasks of the group are completed
+    void Wait();
+
+private:
+
+    friend class CTaskScheduler;
+
+    CTaskGroup(const CTaskGroup&);
+    CTaskGroup& operator=(const CTaskGroup&);
+
+    ///Scheduler that executes the tasks
+    CTaskScheduler& m_rScheduler;
+
+    ///Number of submitted tasks that are not completed yet
+    std::atomic<int> m_nPendingCount;
+};
+
+/**
+ * @brief Work stealing thread pool shared by the chromosome and replay block tasks
+ *
+ * Tasks submitted from outside of the pool are kept in a global FIFO queue, so they start in submission order (callers submit
+ * the most expensive tasks first). Tasks submitted by a worker go to the deque of that worker: the owner takes the newest task
+ * and idle workers steal the oldest one from other deques.
+ */
+class CTaskScheduler
+{
+public:
+
+    ///Starts the worker threads (a thread count less than 1 uses GetDefaultThreadCount)
+    explicit CTaskScheduler(int a_nThreadCount);
+
+    ///Completes the queued tasks and joins the worker threads
+    ~CTaskScheduler();
+
+    ///Return the number of worker threads
+    int GetThreadCount() const;
+
+    ///Return the number of cores available to the process (CPU affinity and cgroup cpu quota are taken into account)
+    static int GetDefaultThreadCount();
+
+private:
+
+    friend class CTaskGroup;
+
+    struct STask
+    {
+        std::function<void()> m_function;
+        CTaskGroup* m_pGroup;
+    };
+
+    struct SWorkerQueue
+    {
+        std::mutex m_mutex;
+        std::deque<STask> m_aTasks;
+    };
+
+    CTaskScheduler(const CTaskScheduler&);
+    CTaskScheduler& operator=(const CTaskScheduler&);
+
+    ///Adds the task to the deque of the calling worker or to the global queue
+    void Push(const STask& a_rTask);
+
+    ///Runs a single queued task. Global queue is only checked if a_bTakeGlobal is set. Returns false if no task is found
+    bool RunQueuedTask(bool a_bTakeGlobal);
+
+    ///Waits for the tasks of the group, executing nested tasks meanwhile if called from a worker
+    void Wait(CTaskGroup& a_rGroup);
+
+    ///Main loop of the worker threads
+    void WorkerLoop(int a_nWorkerIndex);
+
+    ///Number of worker threads
+    int m_nThreadCount;
+
+    ///Task deque of each worker
+    std::vector<SWorkerQueue> m_aWorkerQueues;
+
+    ///Tasks submitted from outside of the pool
+    std::deque<STask> m_aGlobalTasks;
+    std::mutex m_globalMutex;
+
+    //Number of tasks waiting in the global queue and worker deques
+    std::atomic<int> m_nGlobalTaskCount;
+    std::atomic<int> m_nWorkerTaskCount;
+
+    //Idle threads sleep on this condition until a task is queued or a group is completed
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCondition;
+    bool m_bIsStopped;
+
+    std::vector<std::thread> m_aThreads;
+};
+
+}
+
+#endif // _C_TASK_SCHEDULER_H_
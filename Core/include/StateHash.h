@@ -0,0 +1,51 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  StateHash.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _STATE_HASH_H_
+#define _STATE_HASH_H_
+
+#include <cstdint>
+
+namespace core
+{
+
+///Finalizer of splitmix64. Spreads the bits of the given value over the whole 64 bit word
+inline uint64_t MixHash(uint64_t a_nValue)
+{
+    a_nValue ^= a_nValue >> 30;
+    a_nValue *= 0xbf58476d1ce4e5b9ULL;
+    a_nValue ^= a_nValue >> 27;
+    a_nValue *= 0x94d049bb133111ebULL;
+    a_nValue ^= a_nValue >> 31;
+    return a_nValue;
+}
+
+///Combine the given value into the hash seed (order dependent)
+inline uint64_t CombineHash(uint64_t a_nSeed, uint64_t a_nValue)
+{
+    return MixHash(a_nSeed ^ (a_nValue + 0x9e3779b97f4a7c15ULL + (a_nSeed << 6) + (a_nSeed >> 2)));
+}
+
+}
+
+#endif // _STATE_HASH_H_
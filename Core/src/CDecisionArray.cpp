@@ -0,0 +1,119 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CDecisionArray.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CDecisionArray.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace core;
+
+CDecisionArray::CDecisionArray()
+: m_nVariantCount(0),
+  m_nIncludedCount(0),
+  m_nExcludedCount(0)
+{
+}
+
+void CDecisionArray::Reset(int a_nVariantCount)
+{
+    m_aPackedDecisions.assign((a_nVariantCount + 3) / 4, 0);
+    m_aPackedDecisions.shrink_to_fit();
+    m_nVariantCount = a_nVariantCount;
+    m_nIncludedCount = 0;
+    m_nExcludedCount = 0;
+}
+
+void CDecisionArray::Fill(const std::vector<const COrientedVariant*>& a_rOrientedVariantList,
+                          const std::vector<const COrientedVariant*>& a_rIncludedVarList,
+                          const std::vector<int>& a_rExcludedVarList)
+{
+    Reset((int)a_rOrientedVariantList.size() / 2);
+
+    for(unsigned int k = 0; k < a_rExcludedVarList.size(); k++)
+        Set(a_rExcludedVarList[k], eDECISION_EXCLUDED);
+
+    //Included variants are not always in variant index order. The search for each starts from the index of the previous one
+    //and goes back if the variant is not found ahead of it
+    int variantIndex = 0;
+    for(unsigned int k = 0; k < a_rIncludedVarList.size(); k++)
+    {
+        const int foundIndex = FindVariantIndex(a_rOrientedVariantList, a_rIncludedVarList[k], variantIndex);
+        if(foundIndex == -1)
+        {
+            std::cerr << "Included variant is not in the oriented variant list of the replay" << std::endl;
+            continue;
+        }
+
+        variantIndex = foundIndex;
+        Set(variantIndex, a_rIncludedVarList[k] == a_rOrientedVariantList[2 * variantIndex] ? eDECISION_INCLUDED_FIRST : eDECISION_INCLUDED_SECOND);
+    }
+}
+
+int CDecisionArray::FindVariantIndex(const std::vector<const COrientedVariant*>& a_rOrientedVariantList, const COrientedVariant* a_pVariant, int a_nStartIndex) const
+{
+    for(int variantIndex = a_nStartIndex; variantIndex < m_nVariantCount; variantIndex++)
+    {
+        if(a_pVariant == a_rOrientedVariantList[2 * variantIndex] || a_pVariant == a_rOrientedVariantList[2 * variantIndex + 1])
+            return variantIndex;
+    }
+
+    for(int variantIndex = std::min(a_nStartIndex, m_nVariantCount) - 1; variantIndex >= 0; variantIndex--)
+    {
+        if(a_pVariant == a_rOrientedVariantList[2 * variantIndex] || a_pVariant == a_rOrientedVariantList[2 * variantIndex + 1])
+            return variantIndex;
+    }
+
+    return -1;
+}
+
+void CDecisionArray::Set(int a_nVariantIndex, EVariantDecision a_decision)
+{
+    const EVariantDecision oldDecision = Get(a_nVariantIndex);
+
+    m_nIncludedCount += (a_decision >= eDECISION_INCLUDED_FIRST) - (oldDecision >= eDECISION_INCLUDED_FIRST);
+    m_nExcludedCount += (a_decision == eDECISION_EXCLUDED) - (oldDecision == eDECISION_EXCLUDED);
+
+    const int shift = (a_nVariantIndex & 3) << 1;
+    uint8_t& rPacked = m_aPackedDecisions[a_nVariantIndex >> 2];
+    rPacked = static_cast<uint8_t>((rPacked & ~(3 << shift)) | (a_decision << shift));
+}
+
+const COrientedVariant* CDecisionArray::GetIncludedVariant(const std::vector<const COrientedVariant*>& a_rOrientedVariantList, int a_nVariantIndex) const
+{
+    return a_rOrientedVariantList[2 * a_nVariantIndex + (Get(a_nVariantIndex) == eDECISION_INCLUDED_SECOND ? 1 : 0)];
+}
+
+int CDecisionArray::GetVariantCount() const
+{
+    return m_nVariantCount;
+}
+
+int CDecisionArray::GetIncludedCount() const
+{
+    return m_nIncludedCount;
+}
+
+int CDecisionArray::GetExcludedCount() const
+{
+    return m_nExcludedCount;
+}
@@ -27,15 +27,18 @@
 
 #include "CHaplotypeSequence.h"
 #include <iostream>
+#include <algorithm>
 
 using namespace core;
 
 CHaplotypeSequence::CHaplotypeSequence()
+: m_nQueueHash(0)
 {}
 
 CHaplotypeSequence::CHaplotypeSequence(const char* a_aRefSequence, int a_nRefSize) 
 : m_aRefSequence(a_aRefSequence),
-  m_nRefSequenceLength(a_nRefSize)
+  m_nRefSequenceLength(a_nRefSize),
+  m_nQueueHash(0)
 {    
     m_nTemplatePosition = -1;
     m_nLastVariantEnd = -1;
@@ -46,7 +49,8 @@ CHaplotypeSequence::CHaplotypeSequence(const CHaplotypeSequence& a_rObj)
 : m_aVariants(a_rObj.m_aVariants),
   m_aRefSequence(a_rObj.m_aRefSequence),
   m_nRefSequenceLength(a_rObj.m_nRefSequenceLength),
-  m_nextVariant(a_rObj.m_nextVariant)
+  m_nextVariant(a_rObj.m_nextVariant),
+  m_nQueueHash(a_rObj.m_nQueueHash)
 {
     m_nPositionInVariant = a_rObj.m_nPositionInVariant;
     m_nLastVariantEnd = a_rObj.m_nLastVariantEnd;
@@ -56,9 +60,9 @@ CHaplotypeSequence::CHaplotypeSequence(const CHaplotypeSequence& a_rObj)
 void CHaplotypeSequence::AddVariant(const COrientedVariant& a_rVariant)
 {
     
-    const SAllele a = a_rVariant.GetAllele();
+    const SAllele& a = a_rVariant.GetAllele();
     
-    if (a.m_nStartPos == a.m_nEndPos && a.m_sequence.length() == 0)
+    if (a.m_nStartPos == a.m_nEndPos && a_rVariant.GetSequenceLength() == 0)
     {
         // Adding the opposite side of a pure insert is redundant
         return;
@@ -68,7 +72,7 @@ void CHaplotypeSequence::AddVariant(const COrientedVariant& a_rVariant)
     if(a.m_nStartPos == -1 || a.m_bIsIgnored == true)
         return;
     
-    m_nLastVariantEnd = a_rVariant.GetAllele().m_nEndPos;
+    m_nLastVariantEnd = a.m_nEndPos;
     
     if(true == m_nextVariant.IsNull())
     {
@@ -76,12 +80,16 @@ void CHaplotypeSequence::AddVariant(const COrientedVariant& a_rVariant)
     }    
     else
     {
-        m_aVariants.push_back(a_rVariant);
+        m_aVariants.PushBack(a_rVariant);
+        m_nQueueHash += a_rVariant.GetHash();
     }
 }
 
 bool CHaplotypeSequence::IsEqual(const CHaplotypeSequence& a_rObj) const
 {
+    if(GetStateHash() != a_rObj.GetStateHash())
+        return false;
+    
     return (CompareTo(a_rObj) == 0);
 }
 
@@ -117,28 +125,35 @@ int CHaplotypeSequence::CompareTo(const CHaplotypeSequence& a_rObj) const
         return varPos;
 
     
-    std::deque<COrientedVariant>::const_iterator itThis = m_aVariants.begin();
-    std::deque<COrientedVariant>::const_iterator itObj = a_rObj.m_aVariants.begin();
+    const int commonSize = std::min(m_aVariants.Size(), a_rObj.m_aVariants.Size());
     
-    while((itThis) != m_aVariants.end())
+    for(int k = 0; k < commonSize; k++)
     {
-        if((itObj) == a_rObj.m_aVariants.end())
-            return 1;
-        
-        int future = itThis->CompareTo(*itObj);
+        int future = m_aVariants[k].CompareTo(a_rObj.m_aVariants[k]);
         if(future != 0)
             return future;
-        
-        ++itThis;
-        ++itObj;
     }
     
-    if(itObj != a_rObj.m_aVariants.end())
-        return -1;
+    if(m_aVariants.Size() != a_rObj.m_aVariants.Size())
+        return m_aVariants.Size() > a_rObj.m_aVariants.Size() ? 1 : -1;
         
     return 0;
 }
 
+uint64_t CHaplotypeSequence::GetStateHash() const
+{
+    uint64_t hash = MixHash(static_cast<uint64_t>(m_nTemplatePosition));
+    
+    //CompareTo does not check the rest of the state if there is no next variant
+    if(m_nextVariant.IsNull())
+        return hash;
+    
+    hash = CombineHash(hash, m_nextVariant.GetHash());
+    hash = CombineHash(hash, static_cast<uint64_t>(m_nPositionInVariant));
+    hash = CombineHash(hash, m_nQueueHash);
+    return CombineHash(hash, m_aVariants.Size());
+}
+
 int CHaplotypeSequence::GetTemplatePosition() const
 {
     return m_nTemplatePosition;
@@ -172,7 +187,7 @@ char CHaplotypeSequence::NextBase() const
     if(m_nPositionInVariant == g_nINVALID)
         return m_nRefSequenceLength > m_nTemplatePosition ? m_aRefSequence[m_nTemplatePosition] : 0;
     else
-        return m_nextVariant.GetAllele().m_sequence[m_nPositionInVariant];
+        return m_nextVariant.GetSequence()[m_nPositionInVariant];
 }
 
 void CHaplotypeSequence::Next()
@@ -204,7 +219,7 @@ void CHaplotypeSequence::Next()
         while(true)
         {
             
-            if(m_nPositionInVariant != static_cast<int>(m_nextVariant.GetAllele().m_sequence.length()))
+            if(m_nPositionInVariant != m_nextVariant.GetSequenceLength())
             {
                 // Haven't reached the end of the current variant.
                 break;
@@ -215,10 +230,11 @@ void CHaplotypeSequence::Next()
                 m_nTemplatePosition = m_nextVariant.GetAllele().m_nEndPos;
                 m_nPositionInVariant = g_nINVALID;
                
-                if(!m_aVariants.empty())
+                if(!m_aVariants.Empty())
                 {
-                    m_nextVariant = m_aVariants.front();
-                    m_aVariants.pop_front();
+                    m_nextVariant = m_aVariants.Front();
+                    m_aVariants.PopFront();
+                    m_nQueueHash -= m_nextVariant.GetHash();
                 }
                 else
                 {
@@ -249,17 +265,46 @@ bool CHaplotypeSequence::IsNew(const COrientedVariant& a_rVar) const
     return a_rVar.GetAllele().m_bIsIgnored || a_rVar.GetAllele().m_nStartPos >= m_nLastVariantEnd;
 }
 
+int CHaplotypeSequence::GetPlainStepCount(const char*& a_rpBases) const
+{
+    if(IsOnTemplate())
+    {
+        //Stop before entering the next variant and the end of reference
+        int lastPosition = m_nRefSequenceLength - 1;
+        if(!m_nextVariant.IsNull())
+            lastPosition = std::min(lastPosition, m_nextVariant.GetAllele().m_nStartPos - 1);
+        
+        a_rpBases = m_aRefSequence + m_nTemplatePosition + 1;
+        return std::max(0, lastPosition - m_nTemplatePosition);
+    }
+    
+    if(!HasNext())
+        return 0;
+    
+    //Stop before the last base of the allele (WantsFutureVariantBases changes there)
+    a_rpBases = m_nextVariant.GetSequence() + m_nPositionInVariant + 1;
+    return std::max(0, m_nextVariant.GetSequenceLength() - 2 - m_nPositionInVariant);
+}
+
+void CHaplotypeSequence::PlainStep(int a_nStepCount)
+{
+    if(IsOnTemplate())
+        m_nTemplatePosition += a_nStepCount;
+    else
+        m_nPositionInVariant += a_nStepCount;
+}
+
 bool CHaplotypeSequence::WantsFutureVariantBases() const
 {
     if (m_nextVariant.IsNull())
         return true;
     
-    if (m_nPositionInVariant != g_nINVALID && m_nPositionInVariant <  static_cast<int>(m_nextVariant.GetAllele().m_sequence.length()) - 1)
+    if (m_nPositionInVariant != g_nINVALID && m_nPositionInVariant < m_nextVariant.GetSequenceLength() - 1)
         return false;
     
-    for(int k= 0; k < static_cast<int>(m_aVariants.size()); k++)
+    for(int k= 0; k < m_aVariants.Size(); k++)
     {
-        if(m_aVariants[k].GetAllele().m_sequence.length() > 0)
+        if(m_aVariants[k].GetSequenceLength() > 0)
             return false;
     }
     
@@ -269,7 +314,7 @@ bool CHaplotypeSequence::WantsFutureVariantBases() const
 void CHaplotypeSequence::Print() const
 {
     std::cout <<"Template Pos:" << m_nTemplatePosition << " Pos in Variant:" << m_nPositionInVariant << " Last Var end:" << m_nLastVariantEnd << std::endl;
-    std::cout <<"Variant Cnt:" << m_aVariants.size() << std::endl;
+    std::cout <<"Variant Cnt:" << m_aVariants.Size() << std::endl;
     std::cout <<"Next Variant is " <<(m_nextVariant.IsNull() ? "null" : "not null") << std::endl;
     std::cout <<"Next Variant start:" << (m_nextVariant.IsNull() ? -1 : m_nextVariant.GetAllele().m_nStartPos) << std::endl;
 }
@@ -35,6 +35,9 @@ COrientedVariant::COrientedVariant()
 {
     m_nAlleleIndex = -1;
     m_nOtherAlleleIndex = -1;
+    m_variant = NULL;
+    m_pSequence = NULL;
+    m_nSequenceLength = 0;
     m_bIsNull = true;
 }
 
@@ -64,6 +67,7 @@ COrientedVariant::COrientedVariant(const CVariant& a_rObj, bool a_bIsOrder)
     }
 
     m_bIsOrderOfGenotype = a_bIsOrder;
+    InitSequence();
 }
 
 COrientedVariant::COrientedVariant(const CVariant& a_rObj, int a_nAlleleIndex)
@@ -73,12 +77,15 @@ COrientedVariant::COrientedVariant(const CVariant& a_rObj, int a_nAlleleIndex)
     m_bIsOrderOfGenotype = true;
     m_nAlleleIndex = a_nAlleleIndex;
     m_nOtherAlleleIndex = a_nAlleleIndex;
+    InitSequence();
 }
 
 
 COrientedVariant::COrientedVariant(const COrientedVariant& a_rObj)
 {
     m_variant = a_rObj.m_variant;
+    m_pSequence = a_rObj.m_pSequence;
+    m_nSequenceLength = a_rObj.m_nSequenceLength;
     m_nAlleleIndex = a_rObj.m_nAlleleIndex;
     m_nOtherAlleleIndex = a_rObj.m_nOtherAlleleIndex;
     m_bIsOrderOfGenotype = a_rObj.m_bIsOrderOfGenotype;
@@ -107,9 +114,11 @@ int COrientedVariant::CompareTo(const COrientedVariant& a_rObj) const
     return (m_nOtherAlleleIndex < a_rObj.m_nOtherAlleleIndex) ? -1 : ((m_nOtherAlleleIndex == a_rObj.m_nOtherAlleleIndex) ? 0 : 1);
 }
 
-const SAllele& COrientedVariant::GetAllele() const
+uint64_t COrientedVariant::GetHash() const
 {
-    return m_variant->m_alleles[m_nAlleleIndex];
+    uint64_t hash = CombineHash(static_cast<uint64_t>(m_variant->GetId()), m_bIsOrderOfGenotype ? 1 : 0);
+    hash = CombineHash(hash, static_cast<uint64_t>(m_nAlleleIndex));
+    return CombineHash(hash, static_cast<uint64_t>(m_nOtherAlleleIndex));
 }
 
 int COrientedVariant::GetStartPos() const
@@ -136,6 +145,7 @@ COrientedVariant COrientedVariant::Other() const
     oVar2.m_nOtherAlleleIndex = m_nAlleleIndex;
     oVar2.m_variant = m_variant;
     oVar2.m_bIsNull = m_bIsNull;
+    oVar2.InitSequence();
     return oVar2;
 }
 
@@ -160,6 +170,19 @@ const CVariant& COrientedVariant::GetVariant() const
 }
 
 
+void COrientedVariant::InitSequence()
+{
+    if(m_variant == NULL || m_nAlleleIndex < 0)
+    {
+        m_pSequence = NULL;
+        m_nSequenceLength = 0;
+        return;
+    }
+    
+    m_pSequence = m_variant->GetAlleleSequence(m_nAlleleIndex);
+    m_nSequenceLength = m_variant->GetAlleleLength(m_nAlleleIndex);
+}
+
 void COrientedVariant::Print() const
 {
     std::cout << m_nAlleleIndex << ":" << m_nOtherAlleleIndex << " " << (m_bIsOrderOfGenotype ? "true" : "false");
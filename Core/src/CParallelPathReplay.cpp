@@ -0,0 +1,688 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CParallelPathReplay.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CParallelPathReplay.h"
+#include "Constants.h"
+#include <iostream>
+#include <climits>
+#include <algorithm>
+#include <map>
+
+using namespace core;
+
+CParallelPathReplay::CParallelPathReplay(std::vector<const CVariant*>& a_aVarListBase,
+                                         std::vector<const CVariant*>& a_aVarListCalled,
+                                         std::vector<const COrientedVariant*>& a_aOVarListBase,
+                                         std::vector<const COrientedVariant*>& a_aOvarlistCalled)
+: m_aVariantListBase(a_aVarListBase),
+  m_aVariantListCalled(a_aVarListCalled),
+  m_aOrientedVariantListBase(a_aOVarListBase),
+  m_aOrientedVariantListCalled(a_aOvarlistCalled)
+{
+    m_nMaxPathSize = DEFAULT_MAX_PATH_SIZE;
+    m_nMaxIterationCount = DEFAULT_MAX_ITERATION_SIZE;
+    m_complexRegionMode = eCOMPLEX_REGION_SKIP;
+    m_nBeamWidth = DEFAULT_BEAM_WIDTH;
+    m_bAdaptiveBudget = false;
+    m_pReplayCache = NULL;
+    m_pReplayStats = NULL;
+    m_pScheduler = NULL;
+    m_nIncludedEndBase = 0;
+    m_nIncludedEndCalled = 0;
+}
+
+void CParallelPathReplay::SetMaxPathAndIteration(int a_nMaxPathSize, int a_nMaxIterationCount)
+{
+    m_nMaxPathSize = a_nMaxPathSize;
+    m_nMaxIterationCount = a_nMaxIterationCount;
+}
+
+void CParallelPathReplay::SetComplexRegionMode(EComplexRegionMode a_mode, int a_nBeamWidth)
+{
+    m_complexRegionMode = a_mode;
+    m_nBeamWidth = a_nBeamWidth;
+}
+
+void CParallelPathReplay::SetAdaptiveBudget(bool a_bIsEnabled)
+{
+    m_bAdaptiveBudget = a_bIsEnabled;
+}
+
+void CParallelPathReplay::SetReplayCache(CReplayCache* a_pReplayCache)
+{
+    m_pReplayCache = a_pReplayCache;
+}
+
+void CParallelPathReplay::SetReplayStats(CReplayStats* a_pReplayStats, const std::string& a_rComparisonName)
+{
+    m_pReplayStats = a_pReplayStats;
+    m_comparisonName = a_rComparisonName;
+}
+
+void CParallelPathReplay::SetScheduler(CTaskScheduler* a_pScheduler)
+{
+    m_pScheduler = a_pScheduler;
+}
+
+void CParallelPathReplay::Clear()
+{
+    m_decisionsBase.Reset(0);
+    m_decisionsCalled.Reset(0);
+    m_SyncPointsBest.clear();
+    m_aSkippedFromStart.clear();
+    m_aRegionStats.clear();
+    m_aInitialStatusBase.clear();
+    m_aInitialStatusCalled.clear();
+    m_aInitialApproximateBase.clear();
+    m_aInitialApproximateCalled.clear();
+    m_nIncludedEndBase = 0;
+    m_nIncludedEndCalled = 0;
+}
+
+CPath CParallelPathReplay::FindBestPath(SContig a_contig, bool a_bIsGenotypeMatch)
+{
+    Clear();
+
+    std::vector<SReplayBlock> blocks;
+    if(m_pScheduler != NULL && m_pScheduler->GetThreadCount() > 1)
+        SplitIntoBlocks(blocks);
+
+    //Nothing to parallelize, replay the whole contig at once
+    if(blocks.size() < 2)
+    {
+        CPath bestPath = ReplayContig(a_contig, a_bIsGenotypeMatch);
+        WriteRegionStats(a_contig, a_bIsGenotypeMatch, m_aRegionStats);
+        return bestPath;
+    }
+
+    StoreInitialStatus();
+
+    //Replay all blocks concurrently. Idle workers (including the ones waiting for other chromosomes) steal the blocks
+    std::vector<SReplayBlockResult> results(blocks.size());
+    {
+        CTaskGroup blockTasks(*m_pScheduler);
+        for(unsigned int k = 0; k < blocks.size(); k++)
+            blockTasks.Run([this, &blocks, &results, &a_contig, a_bIsGenotypeMatch, k]()
+                           { ReplayBlock(blocks[k], a_contig, a_bIsGenotypeMatch, results[k]); });
+        blockTasks.Wait();
+    }
+
+    std::vector<SReplayGroup> groups;
+    CPath bestPath = StitchBlocks(a_contig, a_bIsGenotypeMatch, blocks, results, groups);
+    MarkSkippedFromStart();
+    WriteRegionStats(a_contig, a_bIsGenotypeMatch, m_aRegionStats);
+
+    return bestPath;
+}
+
+void CParallelPathReplay::FindBestPaths(SContig a_contig, CPath& a_rGenotypeMatchPath, CPath& a_rAlleleMatchPath)
+{
+    Clear();
+
+    std::vector<SReplayBlock> blocks;
+    if(m_pScheduler != NULL && m_pScheduler->GetThreadCount() > 1)
+        SplitIntoBlocks(blocks);
+
+    std::vector<SReplayBlockResult> results;
+    std::vector<SAlleleMatchBlock> alleleMatchBlocks;
+    std::vector<SReplayGroup> groups;
+
+    if(blocks.size() < 2)
+    {
+        a_rGenotypeMatchPath = ReplayContig(a_contig, true);
+
+        //The whole contig is a single group
+        SReplayGroup group = {{0, (int)m_aVariantListBase.size(), 0, (int)m_aVariantListCalled.size(), 0}, 0, 0};
+        groups.push_back(group);
+        results.resize(1);
+        alleleMatchBlocks.resize(1);
+        results[0].m_bestPath = a_rGenotypeMatchPath;
+        ReplayAlleleMatchBlock(group.m_block, results[0], a_contig, alleleMatchBlocks[0]);
+    }
+    else
+    {
+        StoreInitialStatus();
+
+        //Allele match replay of the block runs in the same task while its variants and reference region are still in cache
+        results.resize(blocks.size());
+        alleleMatchBlocks.resize(blocks.size());
+        {
+            CTaskGroup blockTasks(*m_pScheduler);
+            for(unsigned int k = 0; k < blocks.size(); k++)
+                blockTasks.Run([this, &blocks, &results, &alleleMatchBlocks, &a_contig, k]()
+                               {
+                                   ReplayBlock(blocks[k], a_contig, true, results[k]);
+                                   ReplayAlleleMatchBlock(blocks[k], results[k], a_contig, alleleMatchBlocks[k]);
+                               });
+            blockTasks.Wait();
+        }
+
+        a_rGenotypeMatchPath = StitchBlocks(a_contig, true, blocks, results, groups);
+
+        //Allele match replays of the merged blocks are run before the genotype match result of the group is known. Replay
+        //the genotype mismatches of the merged groups again
+        {
+            CTaskGroup groupTasks(*m_pScheduler);
+            for(unsigned int k = 0; k < groups.size(); k++)
+            {
+                if(groups[k].m_nFirstBlock == groups[k].m_nLastBlock)
+                    continue;
+
+                groupTasks.Run([this, &groups, &results, &alleleMatchBlocks, &a_contig, k]()
+                               {
+                                   const int lastBlock = groups[k].m_nLastBlock;
+                                   ReplayAlleleMatchBlock(groups[k].m_block, results[lastBlock], a_contig, alleleMatchBlocks[lastBlock]);
+                               });
+            }
+            groupTasks.Wait();
+        }
+    }
+
+    //Genotype mismatches of the contig in variant index order. Groups without any mismatch are left out of the allele match pass
+    std::vector<const CVariant*> varListBase;
+    std::vector<const CVariant*> varListCalled;
+    std::vector<SReplayBlock> alleleMatchRanges;
+    std::vector<SReplayBlockResult> alleleMatchResults;
+    std::vector<const SAlleleMatchBlock*> alleleMatchGroups;
+
+    for(unsigned int k = 0; k < groups.size(); k++)
+    {
+        SAlleleMatchBlock& rAlleleMatch = alleleMatchBlocks[groups[k].m_nLastBlock];
+        if(rAlleleMatch.m_aVariantListBase.empty() && rAlleleMatch.m_aVariantListCalled.empty())
+            continue;
+
+        SReplayBlock range;
+        range.m_nBaseStart = (int)varListBase.size();
+        range.m_nCalledStart = (int)varListCalled.size();
+        varListBase.insert(varListBase.end(), rAlleleMatch.m_aVariantListBase.begin(), rAlleleMatch.m_aVariantListBase.end());
+        varListCalled.insert(varListCalled.end(), rAlleleMatch.m_aVariantListCalled.begin(), rAlleleMatch.m_aVariantListCalled.end());
+        range.m_nBaseEnd = (int)varListBase.size();
+        range.m_nCalledEnd = (int)varListCalled.size();
+        range.m_nStartPosition = 0;
+
+        alleleMatchRanges.push_back(range);
+        alleleMatchResults.push_back(rAlleleMatch.m_result);
+        alleleMatchGroups.push_back(&rAlleleMatch);
+    }
+
+    //Allele match oriented variants include a single allele on both haplotypes
+    std::vector<COrientedVariant> ovarsBase;
+    std::vector<COrientedVariant> ovarsCalled;
+    std::vector<const COrientedVariant*> ovarListBase;
+    std::vector<const COrientedVariant*> ovarListCalled;
+    ovarsBase.reserve(2 * varListBase.size());
+    ovarsCalled.reserve(2 * varListCalled.size());
+    for(unsigned int k = 0; k < varListBase.size(); k++)
+    {
+        ovarsBase.push_back(COrientedVariant(*varListBase[k], 0));
+        ovarsBase.push_back(COrientedVariant(*varListBase[k], 1));
+    }
+    for(unsigned int k = 0; k < varListCalled.size(); k++)
+    {
+        ovarsCalled.push_back(COrientedVariant(*varListCalled[k], 0));
+        ovarsCalled.push_back(COrientedVariant(*varListCalled[k], 1));
+    }
+    for(unsigned int k = 0; k < ovarsBase.size(); k++)
+        ovarListBase.push_back(&ovarsBase[k]);
+    for(unsigned int k = 0; k < ovarsCalled.size(); k++)
+        ovarListCalled.push_back(&ovarsCalled[k]);
+
+    CParallelPathReplay alleleMatchReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
+    CopySettingsTo(alleleMatchReplay);
+
+    if(alleleMatchRanges.empty())
+    {
+        a_rAlleleMatchPath = alleleMatchReplay.ReplayContig(a_contig, false);
+    }
+    else
+    {
+        //A group replayed again while stitching starts from the status before its allele match replay
+        for(unsigned int k = 0; k < alleleMatchGroups.size(); k++)
+        {
+            const SAlleleMatchBlock& rAlleleMatch = *alleleMatchGroups[k];
+            alleleMatchReplay.m_aInitialStatusBase.insert(alleleMatchReplay.m_aInitialStatusBase.end(), rAlleleMatch.m_aInitialStatusBase.begin(), rAlleleMatch.m_aInitialStatusBase.end());
+            alleleMatchReplay.m_aInitialStatusCalled.insert(alleleMatchReplay.m_aInitialStatusCalled.end(), rAlleleMatch.m_aInitialStatusCalled.begin(), rAlleleMatch.m_aInitialStatusCalled.end());
+            alleleMatchReplay.m_aInitialApproximateBase.insert(alleleMatchReplay.m_aInitialApproximateBase.end(), rAlleleMatch.m_aInitialApproximateBase.begin(), rAlleleMatch.m_aInitialApproximateBase.end());
+            alleleMatchReplay.m_aInitialApproximateCalled.insert(alleleMatchReplay.m_aInitialApproximateCalled.end(), rAlleleMatch.m_aInitialApproximateCalled.begin(), rAlleleMatch.m_aInitialApproximateCalled.end());
+        }
+
+        //Smallest start position of the remaining variants from each group (lists are not strictly sorted by trimmed start)
+        int remainingStart = INT_MAX;
+        for(int k = (int)alleleMatchRanges.size() - 1; k >= 0; k--)
+        {
+            for(int j = alleleMatchRanges[k].m_nBaseStart; j < alleleMatchRanges[k].m_nBaseEnd; j++)
+                remainingStart = std::min(remainingStart, varListBase[j]->GetStart());
+            for(int j = alleleMatchRanges[k].m_nCalledStart; j < alleleMatchRanges[k].m_nCalledEnd; j++)
+                remainingStart = std::min(remainingStart, varListCalled[j]->GetStart());
+            alleleMatchRanges[k].m_nStartPosition = remainingStart;
+        }
+
+        std::vector<SReplayGroup> alleleMatchStitched;
+        a_rAlleleMatchPath = alleleMatchReplay.StitchBlocks(a_contig, false, alleleMatchRanges, alleleMatchResults, alleleMatchStitched);
+    }
+
+    MarkSkippedFromStart();
+    alleleMatchReplay.MarkSkippedFromStart();
+
+    WriteRegionStats(a_contig, true, m_aRegionStats);
+    WriteRegionStats(a_contig, false, alleleMatchReplay.m_aRegionStats);
+}
+
+CPath CParallelPathReplay::ReplayContig(const SContig& a_rContig, bool a_bIsGenotypeMatch)
+{
+    CPathReplay pathReplay(m_aVariantListBase, m_aVariantListCalled, m_aOrientedVariantListBase, m_aOrientedVariantListCalled);
+    pathReplay.SetMaxPathAndIteration(m_nMaxPathSize, m_nMaxIterationCount);
+    pathReplay.SetComplexRegionMode(m_complexRegionMode, m_nBeamWidth);
+    pathReplay.SetAdaptiveBudget(m_bAdaptiveBudget);
+    pathReplay.SetReplayCache(m_pReplayCache);
+    pathReplay.SetCollectRegionStats(m_pReplayStats != NULL);
+
+    CPath bestPath = pathReplay.FindBestPath(a_rContig, a_bIsGenotypeMatch);
+    m_aRegionStats = pathReplay.GetRegionStats();
+    return bestPath;
+}
+
+void CParallelPathReplay::WriteRegionStats(const SContig& a_rContig, bool a_bIsGenotypeMatch, const std::vector<SReplayRegionStats>& a_rRegionStats) const
+{
+    if(m_pReplayStats != NULL)
+        m_pReplayStats->Write(a_rContig.m_chromosomeName, m_comparisonName, a_bIsGenotypeMatch, a_rRegionStats);
+}
+
+void CParallelPathReplay::CopySettingsTo(CParallelPathReplay& a_rReplay) const
+{
+    a_rReplay.SetMaxPathAndIteration(m_nMaxPathSize, m_nMaxIterationCount);
+    a_rReplay.SetComplexRegionMode(m_complexRegionMode, m_nBeamWidth);
+    a_rReplay.SetAdaptiveBudget(m_bAdaptiveBudget);
+    a_rReplay.SetReplayCache(m_pReplayCache);
+    a_rReplay.SetReplayStats(m_pReplayStats, m_comparisonName);
+    a_rReplay.SetScheduler(m_pScheduler);
+}
+
+void CParallelPathReplay::StoreInitialStatus()
+{
+    //Blocks that are replayed again should start from the same status
+    for(unsigned int k = 0; k < m_aVariantListBase.size(); k++)
+    {
+        m_aInitialStatusBase.push_back(m_aVariantListBase[k]->m_variantStatus);
+        m_aInitialApproximateBase.push_back(m_aVariantListBase[k]->m_bIsApproximate);
+    }
+    for(unsigned int k = 0; k < m_aVariantListCalled.size(); k++)
+    {
+        m_aInitialStatusCalled.push_back(m_aVariantListCalled[k]->m_variantStatus);
+        m_aInitialApproximateCalled.push_back(m_aVariantListCalled[k]->m_bIsApproximate);
+    }
+}
+
+CPath CParallelPathReplay::StitchBlocks(const SContig& a_rContig,
+                                        bool a_bIsGenotypeMatch,
+                                        const std::vector<SReplayBlock>& a_rBlocks,
+                                        std::vector<SReplayBlockResult>& a_rResults,
+                                        std::vector<SReplayGroup>& a_rGroups)
+{
+    m_decisionsBase.Reset((int)m_aVariantListBase.size());
+    m_decisionsCalled.Reset((int)m_aVariantListCalled.size());
+
+    //Adjacent blocks are merged at their unsafe boundaries first, so each merged group is replayed once
+    std::vector<int> replayedGroups;
+    for(unsigned int k = 0; k < a_rBlocks.size(); k++)
+    {
+        if(k == 0 || IsSafeBoundary(a_rResults[k - 1], a_rBlocks[k]))
+        {
+            SReplayGroup group = {a_rBlocks[k], (int)k, (int)k};
+            a_rGroups.push_back(group);
+        }
+        else
+            MergeGroups(a_rGroups, a_rBlocks[k], (int)k, replayedGroups);
+    }
+
+    //A boundary after a merged group is checked again with the result of the group. If the group did not settle before the
+    //next group, they are merged and replayed again
+    while(!replayedGroups.empty())
+    {
+        ReplayGroups(a_rContig, a_bIsGenotypeMatch, a_rGroups, replayedGroups, a_rResults);
+        replayedGroups.clear();
+
+        std::vector<SReplayGroup> groups;
+        for(unsigned int k = 0; k < a_rGroups.size(); k++)
+        {
+            if(k == 0 || IsSafeBoundary(a_rResults[groups.back().m_nLastBlock], a_rBlocks[a_rGroups[k].m_nFirstBlock]))
+                groups.push_back(a_rGroups[k]);
+            else
+                MergeGroups(groups, a_rGroups[k].m_block, a_rGroups[k].m_nLastBlock, replayedGroups);
+        }
+        a_rGroups.swap(groups);
+    }
+
+    for(unsigned int k = 0; k < a_rGroups.size(); k++)
+    {
+        const int nextBlockStart = k + 1 < a_rGroups.size() ? a_rBlocks[a_rGroups[k + 1].m_nFirstBlock].m_nStartPosition : INT_MAX;
+        AppendBlockResult(a_rGroups[k].m_block, a_rResults[a_rGroups[k].m_nLastBlock], nextBlockStart);
+    }
+
+    std::cerr << "FINISHED " << a_rContig.m_chromosomeName << ": Replay Blocks: " << a_rBlocks.size();
+    std::cerr << " Merged Blocks: " << a_rBlocks.size() - a_rGroups.size() << std::endl;
+
+    CPath bestPath = a_rResults[a_rGroups.back().m_nLastBlock].m_bestPath;
+    bestPath.ClearSyncPointList();
+    bestPath.AddSyncPointList(m_SyncPointsBest);
+    bestPath.SetDecisions(m_decisionsCalled, m_decisionsBase);
+
+    return bestPath;
+}
+
+void CParallelPathReplay::MergeGroups(std::vector<SReplayGroup>& a_rGroups, const SReplayBlock& a_rNextBlock, int a_nNextLastBlock, std::vector<int>& a_rReplayedGroups) const
+{
+    SReplayGroup& rGroup = a_rGroups.back();
+    rGroup.m_block.m_nBaseEnd = a_rNextBlock.m_nBaseEnd;
+    rGroup.m_block.m_nCalledEnd = a_rNextBlock.m_nCalledEnd;
+    rGroup.m_nLastBlock = a_nNextLastBlock;
+
+    const int groupIndex = (int)a_rGroups.size() - 1;
+    if(a_rReplayedGroups.empty() || a_rReplayedGroups.back() != groupIndex)
+        a_rReplayedGroups.push_back(groupIndex);
+}
+
+void CParallelPathReplay::ReplayGroups(const SContig& a_rContig,
+                                       bool a_bIsGenotypeMatch,
+                                       const std::vector<SReplayGroup>& a_rGroups,
+                                       const std::vector<int>& a_rReplayedGroups,
+                                       std::vector<SReplayBlockResult>& a_rResults)
+{
+    //Groups cover disjoint variant ranges, they are restored and replayed independently
+    if(m_pScheduler == NULL || a_rReplayedGroups.size() == 1)
+    {
+        for(unsigned int k = 0; k < a_rReplayedGroups.size(); k++)
+        {
+            const SReplayGroup& rGroup = a_rGroups[a_rReplayedGroups[k]];
+            RestoreVariantStatus(rGroup.m_block);
+            ReplayBlock(rGroup.m_block, a_rContig, a_bIsGenotypeMatch, a_rResults[rGroup.m_nLastBlock]);
+        }
+        return;
+    }
+
+    CTaskGroup groupTasks(*m_pScheduler);
+    for(unsigned int k = 0; k < a_rReplayedGroups.size(); k++)
+    {
+        const SReplayGroup& rGroup = a_rGroups[a_rReplayedGroups[k]];
+        groupTasks.Run([this, &rGroup, &a_rContig, a_bIsGenotypeMatch, &a_rResults]()
+                       {
+                           RestoreVariantStatus(rGroup.m_block);
+                           ReplayBlock(rGroup.m_block, a_rContig, a_bIsGenotypeMatch, a_rResults[rGroup.m_nLastBlock]);
+                       });
+    }
+    groupTasks.Wait();
+}
+
+void CParallelPathReplay::SplitIntoBlocks(std::vector<SReplayBlock>& a_rBlocks) const
+{
+    const int baseCount = (int)m_aVariantListBase.size();
+    const int calledCount = (int)m_aVariantListCalled.size();
+
+    //A gap is safe to cut if it is wider than any variant
+    int maxSpan = 1;
+    for(int k = 0; k < baseCount; k++)
+        maxSpan = std::max(maxSpan, m_aVariantListBase[k]->GetEnd() - m_aVariantListBase[k]->GetStart());
+    for(int k = 0; k < calledCount; k++)
+        maxSpan = std::max(maxSpan, m_aVariantListCalled[k]->GetEnd() - m_aVariantListCalled[k]->GetStart());
+
+    //Smallest start position of the remaining variants of each list (lists are not strictly sorted by trimmed start)
+    std::vector<int> remainingStartBase(baseCount + 1, INT_MAX);
+    std::vector<int> remainingStartCalled(calledCount + 1, INT_MAX);
+    for(int k = baseCount - 1; k >= 0; k--)
+        remainingStartBase[k] = std::min(remainingStartBase[k+1], m_aVariantListBase[k]->GetStart());
+    for(int k = calledCount - 1; k >= 0; k--)
+        remainingStartCalled[k] = std::min(remainingStartCalled[k+1], m_aVariantListCalled[k]->GetStart());
+
+    //Index of the last variant of each phase set. The phase orientation chosen by the replay is carried over sync points, so a
+    //phase set should not be split between blocks
+    std::map<int, int> phaseSetEndBase;
+    std::map<int, int> phaseSetEndCalled;
+    for(int k = 0; k < baseCount; k++)
+        if(m_aVariantListBase[k]->m_nPhaseSet != -1)
+            phaseSetEndBase[m_aVariantListBase[k]->m_nPhaseSet] = k;
+    for(int k = 0; k < calledCount; k++)
+        if(m_aVariantListCalled[k]->m_nPhaseSet != -1)
+            phaseSetEndCalled[m_aVariantListCalled[k]->m_nPhaseSet] = k;
+
+    const int minBlockSize = std::max(PARALLEL_REPLAY_MIN_BLOCK_SIZE, (baseCount + calledCount) / (m_pScheduler->GetThreadCount() * PARALLEL_REPLAY_BLOCKS_PER_THREAD));
+
+    SReplayBlock block = {0, 0, 0, 0, 0};
+    int maxEnd = INT_MIN;
+    int baseIndex = 0;
+    int calledIndex = 0;
+    //Index of the last variant of the phase sets consumed so far
+    int phaseEndBase = -1;
+    int phaseEndCalled = -1;
+
+    while(baseIndex < baseCount || calledIndex < calledCount)
+    {
+        int nextStart = std::min(remainingStartBase[baseIndex], remainingStartCalled[calledIndex]);
+        int blockSize = (baseIndex - block.m_nBaseStart) + (calledIndex - block.m_nCalledStart);
+        bool isInPhaseSet = phaseEndBase >= baseIndex || phaseEndCalled >= calledIndex;
+
+        if(blockSize >= minBlockSize && !isInPhaseSet && (long long)nextStart - maxEnd > maxSpan)
+        {
+            block.m_nBaseEnd = baseIndex;
+            block.m_nCalledEnd = calledIndex;
+            a_rBlocks.push_back(block);
+
+            block.m_nBaseStart = baseIndex;
+            block.m_nCalledStart = calledIndex;
+            block.m_nStartPosition = nextStart;
+        }
+
+        //Consume the variants of both lists in start position order
+        if(calledIndex == calledCount || (baseIndex < baseCount && m_aVariantListBase[baseIndex]->GetStart() <= m_aVariantListCalled[calledIndex]->GetStart()))
+        {
+            if(m_aVariantListBase[baseIndex]->m_nPhaseSet != -1)
+                phaseEndBase = std::max(phaseEndBase, phaseSetEndBase[m_aVariantListBase[baseIndex]->m_nPhaseSet]);
+            maxEnd = std::max(maxEnd, m_aVariantListBase[baseIndex++]->GetEnd());
+        }
+        else
+        {
+            if(m_aVariantListCalled[calledIndex]->m_nPhaseSet != -1)
+                phaseEndCalled = std::max(phaseEndCalled, phaseSetEndCalled[m_aVariantListCalled[calledIndex]->m_nPhaseSet]);
+            maxEnd = std::max(maxEnd, m_aVariantListCalled[calledIndex++]->GetEnd());
+        }
+    }
+
+    block.m_nBaseEnd = baseCount;
+    block.m_nCalledEnd = calledCount;
+    a_rBlocks.push_back(block);
+}
+
+void CParallelPathReplay::ReplayBlock(const SReplayBlock& a_rBlock, const SContig& a_rContig, bool a_bIsGenotypeMatch, SReplayBlockResult& a_rResult)
+{
+    std::vector<const CVariant*> varListBase(m_aVariantListBase.begin() + a_rBlock.m_nBaseStart, m_aVariantListBase.begin() + a_rBlock.m_nBaseEnd);
+    std::vector<const CVariant*> varListCalled(m_aVariantListCalled.begin() + a_rBlock.m_nCalledStart, m_aVariantListCalled.begin() + a_rBlock.m_nCalledEnd);
+    std::vector<const COrientedVariant*> ovarListBase(m_aOrientedVariantListBase.begin() + 2 * a_rBlock.m_nBaseStart,
+                                                      m_aOrientedVariantListBase.begin() + 2 * a_rBlock.m_nBaseEnd);
+    std::vector<const COrientedVariant*> ovarListCalled(m_aOrientedVariantListCalled.begin() + 2 * a_rBlock.m_nCalledStart,
+                                                        m_aOrientedVariantListCalled.begin() + 2 * a_rBlock.m_nCalledEnd);
+
+    ReplayVariants(varListBase, varListCalled, ovarListBase, ovarListCalled, a_rContig, a_bIsGenotypeMatch, a_rResult);
+}
+
+void CParallelPathReplay::ReplayVariants(std::vector<const CVariant*>& a_rVarListBase,
+                                         std::vector<const CVariant*>& a_rVarListCalled,
+                                         std::vector<const COrientedVariant*>& a_rOVarListBase,
+                                         std::vector<const COrientedVariant*>& a_rOVarListCalled,
+                                         const SContig& a_rContig,
+                                         bool a_bIsGenotypeMatch,
+                                         SReplayBlockResult& a_rResult) const
+{
+    CPathReplay pathReplay(a_rVarListBase, a_rVarListCalled, a_rOVarListBase, a_rOVarListCalled);
+    pathReplay.SetMaxPathAndIteration(m_nMaxPathSize, m_nMaxIterationCount);
+    pathReplay.SetComplexRegionMode(m_complexRegionMode, m_nBeamWidth);
+    pathReplay.SetAdaptiveBudget(m_bAdaptiveBudget);
+    pathReplay.SetReplayCache(m_pReplayCache);
+    pathReplay.SetCollectRegionStats(m_pReplayStats != NULL);
+    pathReplay.SetPrintSummary(false);
+    //Complex skips from the start of the block are marked while stitching (see AddSkippedFromStart)
+    pathReplay.SetHasPrecedingVariants(true, true);
+
+    a_rResult.m_bestPath = pathReplay.FindBestPath(a_rContig, a_bIsGenotypeMatch);
+    a_rResult.m_bIsSettled = pathReplay.IsSettled();
+    a_rResult.m_nSettledPosition = pathReplay.GetSettledPosition();
+    a_rResult.m_bSkippedFromStartBase = pathReplay.IsSkippedFromStart(eBASE);
+    a_rResult.m_bSkippedFromStartCalled = pathReplay.IsSkippedFromStart(eCALLED);
+    a_rResult.m_aRegionStats = pathReplay.GetRegionStats();
+}
+
+void CParallelPathReplay::ReplayAlleleMatchBlock(const SReplayBlock& a_rBlock, const SReplayBlockResult& a_rGenotypeResult, const SContig& a_rContig, SAlleleMatchBlock& a_rResult) const
+{
+    const CDecisionArray& decisionsBase = a_rGenotypeResult.m_bestPath.m_baseSemiPath.GetDecisions();
+    const CDecisionArray& decisionsCalled = a_rGenotypeResult.m_bestPath.m_calledSemiPath.GetDecisions();
+
+    a_rResult.m_aVariantListBase.clear();
+    a_rResult.m_aVariantListCalled.clear();
+    for(int k = 0; k < decisionsBase.GetVariantCount(); k++)
+        if(decisionsBase.IsExcluded(k))
+            a_rResult.m_aVariantListBase.push_back(m_aVariantListBase[a_rBlock.m_nBaseStart + k]);
+    for(int k = 0; k < decisionsCalled.GetVariantCount(); k++)
+        if(decisionsCalled.IsExcluded(k))
+            a_rResult.m_aVariantListCalled.push_back(m_aVariantListCalled[a_rBlock.m_nCalledStart + k]);
+
+    //Block is not replayed if the genotype match resolved all of its variants
+    if(a_rResult.m_aVariantListBase.empty() && a_rResult.m_aVariantListCalled.empty())
+        return;
+
+    a_rResult.m_aInitialStatusBase.clear();
+    a_rResult.m_aInitialApproximateBase.clear();
+    a_rResult.m_aInitialStatusCalled.clear();
+    a_rResult.m_aInitialApproximateCalled.clear();
+
+    std::vector<COrientedVariant> ovarsBase;
+    std::vector<COrientedVariant> ovarsCalled;
+    ovarsBase.reserve(2 * a_rResult.m_aVariantListBase.size());
+    ovarsCalled.reserve(2 * a_rResult.m_aVariantListCalled.size());
+
+    for(unsigned int k = 0; k < a_rResult.m_aVariantListBase.size(); k++)
+    {
+        a_rResult.m_aInitialStatusBase.push_back(a_rResult.m_aVariantListBase[k]->m_variantStatus);
+        a_rResult.m_aInitialApproximateBase.push_back(a_rResult.m_aVariantListBase[k]->m_bIsApproximate);
+        ovarsBase.push_back(COrientedVariant(*a_rResult.m_aVariantListBase[k], 0));
+        ovarsBase.push_back(COrientedVariant(*a_rResult.m_aVariantListBase[k], 1));
+    }
+    for(unsigned int k = 0; k < a_rResult.m_aVariantListCalled.size(); k++)
+    {
+        a_rResult.m_aInitialStatusCalled.push_back(a_rResult.m_aVariantListCalled[k]->m_variantStatus);
+        a_rResult.m_aInitialApproximateCalled.push_back(a_rResult.m_aVariantListCalled[k]->m_bIsApproximate);
+        ovarsCalled.push_back(COrientedVariant(*a_rResult.m_aVariantListCalled[k], 0));
+        ovarsCalled.push_back(COrientedVariant(*a_rResult.m_aVariantListCalled[k], 1));
+    }
+
+    std::vector<const COrientedVariant*> ovarListBase;
+    std::vector<const COrientedVariant*> ovarListCalled;
+    for(unsigned int k = 0; k < ovarsBase.size(); k++)
+        ovarListBase.push_back(&ovarsBase[k]);
+    for(unsigned int k = 0; k < ovarsCalled.size(); k++)
+        ovarListCalled.push_back(&ovarsCalled[k]);
+
+    std::vector<const CVariant*> varListBase(a_rResult.m_aVariantListBase);
+    std::vector<const CVariant*> varListCalled(a_rResult.m_aVariantListCalled);
+    ReplayVariants(varListBase, varListCalled, ovarListBase, ovarListCalled, a_rContig, false, a_rResult.m_result);
+}
+
+bool CParallelPathReplay::IsSafeBoundary(const SReplayBlockResult& a_rResult, const SReplayBlock& a_rNextBlock) const
+{
+    //The best path should have reached the contig end, otherwise decisions of the block are lost on the serial replay as well
+    return a_rResult.m_bIsSettled
+           && a_rResult.m_nSettledPosition < a_rNextBlock.m_nStartPosition - 1
+           && a_rResult.m_bestPath.HasFinished();
+}
+
+void CParallelPathReplay::AppendBlockResult(const SReplayBlock& a_rBlock, const SReplayBlockResult& a_rResult, int a_nNextBlockStart)
+{
+    const CPath& path = a_rResult.m_bestPath;
+
+    AddSkippedFromStart(eBASE, a_rBlock, a_rResult);
+    AddSkippedFromStart(eCALLED, a_rBlock, a_rResult);
+
+    //Decisions of the block are indexed relative to the block
+    AppendBlockDecisions(path.m_baseSemiPath.GetDecisions(), a_rBlock.m_nBaseStart, m_aVariantListBase, m_decisionsBase, m_nIncludedEndBase);
+    AppendBlockDecisions(path.m_calledSemiPath.GetDecisions(), a_rBlock.m_nCalledStart, m_aVariantListCalled, m_decisionsCalled, m_nIncludedEndCalled);
+    m_aRegionStats.insert(m_aRegionStats.end(), a_rResult.m_aRegionStats.begin(), a_rResult.m_aRegionStats.end());
+
+    //The sync point pushed at the contig end belongs to the last block only
+    for(unsigned int k = 0; k < path.m_aSyncPointList.size(); k++)
+    {
+        if(path.m_aSyncPointList[k] < a_nNextBlockStart)
+            m_SyncPointsBest.push_back(path.m_aSyncPointList[k]);
+    }
+}
+
+void CParallelPathReplay::AppendBlockDecisions(const CDecisionArray& a_rBlockDecisions,
+                                               int a_nBlockStart,
+                                               const std::vector<const CVariant*>& a_rVariantList,
+                                               CDecisionArray& a_rDecisions,
+                                               int& a_rIncludedEnd)
+{
+    for(int k = 0; k < a_rBlockDecisions.GetVariantCount(); k++)
+    {
+        const EVariantDecision decision = a_rBlockDecisions.Get(k);
+        if(decision == eDECISION_UNDECIDED)
+            continue;
+
+        a_rDecisions.Set(a_nBlockStart + k, decision);
+        if(decision != eDECISION_EXCLUDED)
+            a_rIncludedEnd = std::max(a_rIncludedEnd, a_rVariantList[a_nBlockStart + k]->GetEnd());
+    }
+}
+
+void CParallelPathReplay::AddSkippedFromStart(EVcfName a_uVcfName, const SReplayBlock& a_rBlock, const SReplayBlockResult& a_rResult)
+{
+    const std::vector<const CVariant*>& variantList = a_uVcfName == eBASE ? m_aVariantListBase : m_aVariantListCalled;
+    const bool isSkippedFromStart = a_uVcfName == eBASE ? a_rResult.m_bSkippedFromStartBase : a_rResult.m_bSkippedFromStartCalled;
+    const int blockStart = a_uVcfName == eBASE ? a_rBlock.m_nBaseStart : a_rBlock.m_nCalledStart;
+    const int includedEnd = a_uVcfName == eBASE ? m_nIncludedEndBase : m_nIncludedEndCalled;
+
+    //A serial replay skipping from the start of a block resumes from the preceding variant and marks it (or the first variant
+    //of the contig if there is none)
+    if(!isSkippedFromStart || variantList.empty())
+        return;
+
+    const CVariant* pVariant = variantList[std::max(blockStart - 1, 0)];
+    if(includedEnd < pVariant->m_nStartPos)
+        m_aSkippedFromStart.push_back(pVariant);
+}
+
+void CParallelPathReplay::RestoreVariantStatus(const SReplayBlock& a_rBlock)
+{
+    for(int k = a_rBlock.m_nBaseStart; k < a_rBlock.m_nBaseEnd; k++)
+    {
+        m_aVariantListBase[k]->m_variantStatus = m_aInitialStatusBase[k];
+        m_aVariantListBase[k]->m_bIsApproximate = m_aInitialApproximateBase[k];
+    }
+    for(int k = a_rBlock.m_nCalledStart; k < a_rBlock.m_nCalledEnd; k++)
+    {
+        m_aVariantListCalled[k]->m_variantStatus = m_aInitialStatusCalled[k];
+        m_aVariantListCalled[k]->m_bIsApproximate = m_aInitialApproximateCalled[k];
+    }
+}
+
+void CParallelPathReplay::MarkSkippedFromStart()
+{
+    for(unsigned int k = 0; k < m_aSkippedFromStart.size(); k++)
+        m_aSkippedFromStart[k]->m_variantStatus = eCOMPLEX_SKIPPED;
+}
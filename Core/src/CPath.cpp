@@ -26,49 +26,109 @@
  */
 
 #include "CPath.h"
+#include "CPathPool.h"
 #include <iostream>
-#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
 
 using namespace core;
 
 
 CPath::CPath()
+: m_nIncludedCountBase(0),
+  m_nIncludedCountCalled(0),
+  m_nLastIncludedAlleleBase(-1),
+  m_nLastIncludedAlleleCalled(-1),
+  m_nLastSyncPoint(0),
+  m_nPoolRefCount(0),
+  m_pPoolSlab(NULL),
+  m_pNextFree(NULL)
 {}
 
 CPath::CPath(const char* a_aRefSequence, int a_nRefSize)
 : m_baseSemiPath(a_aRefSequence, a_nRefSize, eBASE),
   m_calledSemiPath(a_aRefSequence, a_nRefSize, eCALLED),
   m_nCSinceSync(0),
-  m_nBSinceSync(0)
+  m_nBSinceSync(0),
+  m_nIncludedCountBase(0),
+  m_nIncludedCountCalled(0),
+  m_nLastIncludedAlleleBase(-1),
+  m_nLastIncludedAlleleCalled(-1),
+  m_nLastSyncPoint(0),
+  m_nPoolRefCount(0),
+  m_pPoolSlab(NULL),
+  m_pNextFree(NULL)
 {
     m_nPathId = -1;
 }
 
 CPath::CPath(const CPath& a_rObj)
 : m_baseSemiPath(a_rObj.m_baseSemiPath),
-  m_calledSemiPath(a_rObj.m_calledSemiPath)
+  m_calledSemiPath(a_rObj.m_calledSemiPath),
+  m_nPoolRefCount(0),
+  m_pPoolSlab(NULL),
+  m_pNextFree(NULL)
 {
-    m_aSyncPointList = std::vector<int>(a_rObj.m_aSyncPointList);
+    m_aSyncPointList = a_rObj.m_aSyncPointList;
+    m_aPendingSyncPoints = a_rObj.m_aPendingSyncPoints;
     m_nCSinceSync = a_rObj.m_nCSinceSync;
     m_nBSinceSync = a_rObj.m_nBSinceSync;
+    m_nIncludedCountBase = a_rObj.m_nIncludedCountBase;
+    m_nIncludedCountCalled = a_rObj.m_nIncludedCountCalled;
+    m_nLastIncludedAlleleBase = a_rObj.m_nLastIncludedAlleleBase;
+    m_nLastIncludedAlleleCalled = a_rObj.m_nLastIncludedAlleleCalled;
+    m_nLastSyncPoint = a_rObj.m_nLastSyncPoint;
     
     m_nPathId = a_rObj.m_nPathId;
 }
 
 CPath::CPath(const CPath& a_rObj, int  a_nSyncPointToPush)
 : m_baseSemiPath(a_rObj.m_baseSemiPath),
-  m_calledSemiPath(a_rObj.m_calledSemiPath)
+  m_calledSemiPath(a_rObj.m_calledSemiPath),
+  m_nPoolRefCount(0),
+  m_pPoolSlab(NULL),
+  m_pNextFree(NULL)
 {
-    m_aSyncPointList = std::vector<int>(a_rObj.m_aSyncPointList);
-    m_aSyncPointList.push_back(a_nSyncPointToPush);
+    m_aSyncPointList = a_rObj.m_aSyncPointList;
+    m_aPendingSyncPoints = a_rObj.m_aPendingSyncPoints;
     m_nCSinceSync = a_rObj.m_nCSinceSync;
     m_nBSinceSync = a_rObj.m_nBSinceSync;
+    m_nIncludedCountBase = a_rObj.m_nIncludedCountBase;
+    m_nIncludedCountCalled = a_rObj.m_nIncludedCountCalled;
+    m_nLastIncludedAlleleBase = a_rObj.m_nLastIncludedAlleleBase;
+    m_nLastIncludedAlleleCalled = a_rObj.m_nLastIncludedAlleleCalled;
+    m_nLastSyncPoint = a_rObj.m_nLastSyncPoint;
+    PushSyncPoint(a_nSyncPointToPush);
     
     m_nPathId = a_rObj.m_nPathId;
 }
 
+CPath& CPath::operator=(const CPath& a_rObj)
+{
+    m_baseSemiPath = a_rObj.m_baseSemiPath;
+    m_calledSemiPath = a_rObj.m_calledSemiPath;
+    m_aSyncPointList = a_rObj.m_aSyncPointList;
+    m_aPendingSyncPoints = a_rObj.m_aPendingSyncPoints;
+    m_nCSinceSync = a_rObj.m_nCSinceSync;
+    m_nBSinceSync = a_rObj.m_nBSinceSync;
+    m_nIncludedCountBase = a_rObj.m_nIncludedCountBase;
+    m_nIncludedCountCalled = a_rObj.m_nIncludedCountCalled;
+    m_nLastIncludedAlleleBase = a_rObj.m_nLastIncludedAlleleBase;
+    m_nLastIncludedAlleleCalled = a_rObj.m_nLastIncludedAlleleCalled;
+    m_nLastSyncPoint = a_rObj.m_nLastSyncPoint;
+    
+    m_nPathId = a_rObj.m_nPathId;
+    return *this;
+}
+
 bool CPath::IsEqual(const CPath& a_rObj) const
 {
+    //Reject non-equal paths without walking the variant queues
+    if(GetStateHash() != a_rObj.GetStateHash())
+        return false;
+    
     return (CompareTo(a_rObj) == 0);
 }
 
@@ -76,10 +136,58 @@ int CPath::CompareTo(const CPath& a_rObj) const
 {
     int res = m_calledSemiPath.CompareTo(a_rObj.m_calledSemiPath);
     
+    if(res != 0)
+        return res;
+    
+    res = m_baseSemiPath.CompareTo(a_rObj.m_baseSemiPath);
+    
     if(res != 0)
         return res;
     else
-        return m_baseSemiPath.CompareTo(a_rObj.m_baseSemiPath);
+        return ComparePhase(a_rObj);
+}
+
+uint64_t CPath::GetStateHash() const
+{
+    uint64_t hash = CombineHash(m_calledSemiPath.GetStateHash(), m_baseSemiPath.GetStateHash());
+    
+    if(HasPhase())
+    {
+        hash = CombineHash(hash, static_cast<uint64_t>(static_cast<uint32_t>(m_baseSemiPath.GetPhaseSet())));
+        hash = CombineHash(hash, static_cast<uint64_t>(static_cast<uint32_t>(m_calledSemiPath.GetPhaseSet())));
+        hash = CombineHash(hash, static_cast<uint64_t>(GetPhaseOrientation()));
+    }
+    
+    return hash;
+}
+
+bool CPath::HasPhase() const
+{
+    return (m_baseSemiPath.GetPhaseSet() != -1 || m_calledSemiPath.GetPhaseSet() != -1) && !InSync();
+}
+
+int CPath::GetPhaseOrientation() const
+{
+    const int baseOrientation = m_baseSemiPath.GetPhaseSet() != -1 && m_baseSemiPath.IsPhaseSwapped() ? 1 : 0;
+    const int calledOrientation = m_calledSemiPath.GetPhaseSet() != -1 && m_calledSemiPath.IsPhaseSwapped() ? 1 : 0;
+    return 2 * baseOrientation + calledOrientation;
+}
+
+int CPath::ComparePhase(const CPath& a_rObj) const
+{
+    if(HasPhase() != a_rObj.HasPhase())
+        return HasPhase() ? 1 : -1;
+    
+    if(!HasPhase())
+        return 0;
+    
+    if(m_baseSemiPath.GetPhaseSet() != a_rObj.m_baseSemiPath.GetPhaseSet())
+        return m_baseSemiPath.GetPhaseSet() < a_rObj.m_baseSemiPath.GetPhaseSet() ? -1 : 1;
+    
+    if(m_calledSemiPath.GetPhaseSet() != a_rObj.m_calledSemiPath.GetPhaseSet())
+        return m_calledSemiPath.GetPhaseSet() < a_rObj.m_calledSemiPath.GetPhaseSet() ? -1 : 1;
+    
+    return GetPhaseOrientation() - a_rObj.GetPhaseOrientation();
 }
 
 CPath& CPath::Exclude(EVcfName a_nVCF, const CVariant& a_rVariant, int a_nVariantIndex)
@@ -104,10 +212,14 @@ CPath& CPath::Include(EVcfName a_nVCF, const COrientedVariant& a_rVariant, int a
         case eBASE:
             m_baseSemiPath.IncludeVariant(a_rVariant, a_nVariantIndex);
             m_nBSinceSync++;
+            m_nIncludedCountBase++;
+            m_nLastIncludedAlleleBase = a_rVariant.GetAlleleIndex();
             break;
         case eCALLED:
             m_calledSemiPath.IncludeVariant(a_rVariant, a_nVariantIndex);
             m_nCSinceSync++;
+            m_nIncludedCountCalled++;
+            m_nLastIncludedAlleleCalled = a_rVariant.GetAlleleIndex();
             break;
     }
 
@@ -115,7 +227,17 @@ CPath& CPath::Include(EVcfName a_nVCF, const COrientedVariant& a_rVariant, int a
 }
 
 
+//Copy the given path into a new path acquired from the pool. Sync point of the source path is pushed if requested
+static void BranchPath(CPathContainer& a_rTarget, CPathPool& a_rPathPool, const CPath& a_rSource, bool a_bPushSyncPoint)
+{
+    a_rTarget = a_rPathPool.Create(a_rSource);
+    
+    if(a_bPushSyncPoint)
+        a_rTarget.m_pPath->PushSyncPoint(a_rSource.m_calledSemiPath.GetPosition()+1);
+}
+
 int CPath::AddVariant(CPathContainer *a_pPathList,
+                      CPathPool& a_rPathPool,
                       EVcfName a_nVcfName,
                       const std::vector<const CVariant *> &a_pVariantList,
                       const std::vector<const COrientedVariant *> &a_pOVariantList,
@@ -141,14 +263,14 @@ int CPath::AddVariant(CPathContainer *a_pPathList,
         const COrientedVariant* Ovar2 = a_pOVariantList[2* a_nVariantIndex + 1];
         
         // Create a new path that excludes this variant
-        a_pPathList[pathCount].m_pPath = isInSync ? std::shared_ptr<CPath>(new CPath(*this, m_calledSemiPath.GetPosition()+1)) : std::shared_ptr<CPath>(new CPath(*this));
+        BranchPath(a_pPathList[pathCount], a_rPathPool, *this, isInSync);
         a_pPathList[pathCount].m_pPath->Exclude(a_nVcfName, *pNextVariant, a_nVariantIndex);
         pathCount++;
         
         // Create new paths that includes this variant in the possible phases
         if (!pNextVariant->IsHeterozygous())
         {
-            a_pPathList[pathCount].m_pPath = isInSync ? std::shared_ptr<CPath>(new CPath(*this, m_calledSemiPath.GetPosition()+1)) : std::shared_ptr<CPath>(new CPath(*this));
+            BranchPath(a_pPathList[pathCount], a_rPathPool, *this, isInSync);
             const CSemiPath* p = a_nVcfName == eBASE ? &a_pPathList[pathCount].m_pPath->m_baseSemiPath : &a_pPathList[pathCount].m_pPath->m_calledSemiPath;
             //Make sure variant is not overlap with the previous one
             if(p->IsNew(*Ovar1))
@@ -160,23 +282,38 @@ int CPath::AddVariant(CPathContainer *a_pPathList,
         
         else
         {
+            //A phased variant of the current phase set of the semipath keeps the orientation chosen at the first variant of the set
+            const int phaseSet = pNextVariant->m_nPhaseSet;
+            const CSemiPath& semiPath = a_nVcfName == eBASE ? m_baseSemiPath : m_calledSemiPath;
+            const bool isPhaseKnown = phaseSet != -1 && phaseSet == semiPath.GetPhaseSet();
+            
             //Include with ordered genotype
-            a_pPathList[pathCount].m_pPath =  isInSync ? std::shared_ptr<CPath>(new CPath(*this, m_calledSemiPath.GetPosition()+1)) : std::shared_ptr<CPath>(new CPath(*this));
-            CSemiPath* p = a_nVcfName == eBASE ? &a_pPathList[pathCount].m_pPath->m_baseSemiPath : &a_pPathList[pathCount].m_pPath->m_calledSemiPath;
-            //Make sure variant is not overlap with the previous one
-            if(p->IsNew(*Ovar1))
+            if(!isPhaseKnown || !semiPath.IsPhaseSwapped())
             {
-                a_pPathList[pathCount].m_pPath->Include(a_nVcfName, *Ovar1, a_nVariantIndex);
-                pathCount++;
+                BranchPath(a_pPathList[pathCount], a_rPathPool, *this, isInSync);
+                CSemiPath* p = a_nVcfName == eBASE ? &a_pPathList[pathCount].m_pPath->m_baseSemiPath : &a_pPathList[pathCount].m_pPath->m_calledSemiPath;
+                //Make sure variant is not overlap with the previous one
+                if(p->IsNew(*Ovar1))
+                {
+                    a_pPathList[pathCount].m_pPath->Include(a_nVcfName, *Ovar1, a_nVariantIndex);
+                    if(phaseSet != -1)
+                        p->SetPhase(phaseSet, false);
+                    pathCount++;
+                }
             }
             //Include with unordered genotype
-            a_pPathList[pathCount].m_pPath =  isInSync ? std::shared_ptr<CPath>(new CPath(*this, m_calledSemiPath.GetPosition()+1)) : std::shared_ptr<CPath>(new CPath(*this));
-            p = a_nVcfName == eBASE ? &a_pPathList[pathCount].m_pPath->m_baseSemiPath : &a_pPathList[pathCount].m_pPath->m_calledSemiPath;
-            //Make sure variant is not overlap with the previous one
-            if(p->IsNew(*Ovar2))
+            if(!isPhaseKnown || semiPath.IsPhaseSwapped())
             {
-                a_pPathList[pathCount].m_pPath->Include(a_nVcfName, *Ovar2, a_nVariantIndex);
-                pathCount++;
+                BranchPath(a_pPathList[pathCount], a_rPathPool, *this, isInSync);
+                CSemiPath* p = a_nVcfName == eBASE ? &a_pPathList[pathCount].m_pPath->m_baseSemiPath : &a_pPathList[pathCount].m_pPath->m_calledSemiPath;
+                //Make sure variant is not overlap with the previous one
+                if(p->IsNew(*Ovar2))
+                {
+                    a_pPathList[pathCount].m_pPath->Include(a_nVcfName, *Ovar2, a_nVariantIndex);
+                    if(phaseSet != -1)
+                        p->SetPhase(phaseSet, true);
+                    pathCount++;
+                }
             }
         }
     }
@@ -188,7 +325,7 @@ int CPath::AddVariant(CPathContainer *a_pPathList,
         const COrientedVariant* Ovars[] = {a_pOVariantList[2* a_nVariantIndex], a_pOVariantList[2* a_nVariantIndex + 1]};
         
         // Create a path extension that excludes this variant
-        a_pPathList[pathCount].m_pPath = std::shared_ptr<CPath>(new CPath(*this, m_calledSemiPath.GetPosition()+1));
+        BranchPath(a_pPathList[pathCount], a_rPathPool, *this, true);
         a_pPathList[pathCount].m_pPath->Exclude(a_nVcfName, *pNextVariant, a_nVariantIndex);
         pathCount++;
         
@@ -196,7 +333,7 @@ int CPath::AddVariant(CPathContainer *a_pPathList,
         {
             if(pNextVariant->m_genotype[k] != 0)
             {
-                a_pPathList[pathCount].m_pPath = isInSync ? std::shared_ptr<CPath>(new CPath(*this, m_calledSemiPath.GetPosition()+1)) : std::shared_ptr<CPath>(new CPath(*this));
+                BranchPath(a_pPathList[pathCount], a_rPathPool, *this, isInSync);
                 const CSemiPath* p = a_nVcfName == eBASE ? &a_pPathList[pathCount].m_pPath->m_baseSemiPath : &a_pPathList[pathCount].m_pPath->m_calledSemiPath;
                 //Make sure variant is not overlap with the previous one
                 if(p->IsNew(*Ovars[k]))
@@ -267,6 +404,106 @@ void CPath::Step()
 
 }
 
+//Return the index of the first base that differs (case insensitive) in the given sequences, or a_nLength if they are equal
+static int FindFirstMismatch(const char* a_pLhs, const char* a_pRhs, int a_nLength)
+{
+    const int CHUNK_SIZE = 64;
+    int index = 0;
+    
+    while(index < a_nLength)
+    {
+        const int chunkEnd = std::min(a_nLength, index + CHUNK_SIZE);
+        
+        //Chunks are compared byte by byte only if they differ (which may be a case difference only)
+        if(0 == memcmp(a_pLhs + index, a_pRhs + index, chunkEnd - index))
+        {
+            index = chunkEnd;
+            continue;
+        }
+        
+        for(; index < chunkEnd; index++)
+        {
+            if(toupper(a_pLhs[index]) != toupper(a_pRhs[index]))
+                return index;
+        }
+    }
+    
+    return a_nLength;
+}
+
+int CPath::StepPlain(int a_nMaxStepCount)
+{
+    if(a_nMaxStepCount <= 0)
+        return 0;
+    
+    if(m_calledSemiPath.FinishedHaplotypeA() || m_calledSemiPath.FinishedHaplotypeB() || m_baseSemiPath.FinishedHaplotypeA() || m_baseSemiPath.FinishedHaplotypeB())
+        return 0;
+    
+    //Same stepping order as Step. It should not change during the steps
+    const int haplotypeDiff = m_calledSemiPath.CompareHaplotypePositions();
+    const bool isStepping[2] = {haplotypeDiff <= 0, haplotypeDiff >= 0};
+    
+    int stepCount = a_nMaxStepCount;
+    const char* calledBases[2] = {NULL, NULL};
+    const char* baseBases[2] = {NULL, NULL};
+    bool isAllOnTemplate = true;
+    
+    for(int k = 0; k < 2; k++)
+    {
+        const CHaplotypeSequence& calledHaplotype = m_calledSemiPath.GetHaplotype(k == 0);
+        const CHaplotypeSequence& baseHaplotype = m_baseSemiPath.GetHaplotype(k == 0);
+        isAllOnTemplate = isAllOnTemplate && calledHaplotype.IsOnTemplate() && baseHaplotype.IsOnTemplate();
+        
+        if(isStepping[k])
+        {
+            stepCount = std::min(stepCount, calledHaplotype.GetPlainStepCount(calledBases[k]));
+            stepCount = std::min(stepCount, baseHaplotype.GetPlainStepCount(baseBases[k]));
+        }
+        
+        //Haplotypes that do not step keep their next base
+        else if(toupper(calledHaplotype.NextBase()) != toupper(baseHaplotype.NextBase()))
+            return 0;
+    }
+    
+    if(haplotypeDiff == 0)
+    {
+        //Called haplotypes should move together to keep stepping both
+        if(m_calledSemiPath.GetHaplotype(true).IsOnTemplate() != m_calledSemiPath.GetHaplotype(false).IsOnTemplate())
+            return 0;
+        
+        //Stop before the path gets in sync
+        if(isAllOnTemplate && m_baseSemiPath.CompareHaplotypePositions() == 0 && m_calledSemiPath.GetPosition() == m_baseSemiPath.GetPosition())
+            stepCount = std::min(stepCount, std::max(m_calledSemiPath.GetVariantEndPosition(), m_baseSemiPath.GetVariantEndPosition()) - m_calledSemiPath.GetPosition() - 1);
+    }
+    else
+    {
+        //Stop before the lagging haplotype catches up with the other one
+        const CHaplotypeSequence& laggingHaplotype = m_calledSemiPath.GetHaplotype(haplotypeDiff < 0);
+        if(laggingHaplotype.IsOnTemplate())
+            stepCount = std::min(stepCount, abs(haplotypeDiff) - 1);
+    }
+    
+    for(int k = 0; k < 2 && stepCount > 0; k++)
+    {
+        if(isStepping[k])
+            stepCount = FindFirstMismatch(calledBases[k], baseBases[k], stepCount);
+    }
+    
+    if(stepCount <= 0)
+        return 0;
+    
+    for(int k = 0; k < 2; k++)
+    {
+        if(isStepping[k])
+        {
+            m_calledSemiPath.PlainStepHaplotype(k == 0, stepCount);
+            m_baseSemiPath.PlainStepHaplotype(k == 0, stepCount);
+        }
+    }
+    
+    return stepCount;
+}
+
 void CPath::MoveForward(int a_nPosition)
 {
     m_calledSemiPath.MoveForward(a_nPosition);
@@ -280,30 +517,36 @@ bool CPath::Matches()
 
 void CPath::ClearIncludedVariants()
 {
+    m_nIncludedCountBase = 0;
+    m_nIncludedCountCalled = 0;
+    m_nLastIncludedAlleleBase = -1;
+    m_nLastIncludedAlleleCalled = -1;
     m_calledSemiPath.ClearIncludedVariants();
     m_baseSemiPath.ClearIncludedVariants();
 }
 
-void CPath::AddIncludedVariants(std::vector<const COrientedVariant*>& a_rIncludedVarListCalled, std::vector<const COrientedVariant*>& a_rIncludedVarListBase)
-{
-    m_calledSemiPath.AddIncludedVariants(a_rIncludedVarListCalled);
-    m_baseSemiPath.AddIncludedVariants(a_rIncludedVarListBase);
-}
-
 void CPath::ClearExcludedVariants()
 {
     m_calledSemiPath.ClearExcludedVariants();
     m_baseSemiPath.ClearExcludedVariants();
 }
 
-void CPath::AddExcludedVariants(std::vector<int>& a_rExcludedVarListCalled, std::vector<int>& a_rExcludedVarListBase)
+void CPath::SetDecisions(const CDecisionArray& a_rDecisionsCalled, const CDecisionArray& a_rDecisionsBase)
+{
+    m_calledSemiPath.SetDecisions(a_rDecisionsCalled);
+    m_baseSemiPath.SetDecisions(a_rDecisionsBase);
+}
+
+void CPath::PushSyncPoint(int a_nSyncPoint)
 {
-    m_baseSemiPath.AddExcludedVariants(a_rExcludedVarListBase);
-    m_calledSemiPath.AddExcludedVariants(a_rExcludedVarListCalled);
+    m_aPendingSyncPoints.PushBack(a_nSyncPoint);
+    m_nLastSyncPoint = a_nSyncPoint;
 }
 
 void CPath::ClearSyncPointList()
 {
+    m_nLastSyncPoint = 0;
+    m_aPendingSyncPoints.Clear();
     m_aSyncPointList.clear();
 }
 
@@ -312,20 +555,23 @@ void CPath::AddSyncPointList(std::vector<int>& a_rSyncPointArray)
     m_aSyncPointList = a_rSyncPointArray;
 }
 
-void CPath::SortIncludedVariants()
+
+void CPathContainer::Release()
 {
-    m_baseSemiPath.SortIncludedVariants();
-    m_calledSemiPath.SortIncludedVariants();
+    if(m_pPath != 0 && --m_pPath->m_nPoolRefCount == 0)
+        m_pPath->m_pPoolSlab->m_pPool->Release(m_pPath);
+    m_pPath = 0;
 }
 
-
 void CPath::Print() const
 {
     std::cout << "-----" << std::endl;
     std::cout << "Sync:" << m_nBSinceSync << " " << m_nCSinceSync << std::endl;
+    std::vector<int> syncPoints(m_aSyncPointList);
+    m_aPendingSyncPoints.AppendTo(syncPoints);
     std::cout << "Sync Points: ";
-    for (int i = (int)m_aSyncPointList.size()-1; i>=0; i--)
-        std::cout << m_aSyncPointList[i] << " ";
+    for (int i = (int)syncPoints.size()-1; i>=0; i--)
+        std::cout << syncPoints[i] << " ";
     std::cout<< std::endl;
     std::cout << "--Base Semipath--" << std::endl;
     m_baseSemiPath.Print();
@@ -0,0 +1,166 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CPathPool.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CPathPool.h"
+#include <cassert>
+#include <algorithm>
+
+using namespace core;
+
+CPathPool::CPathPool()
+{
+    m_pFreeList = NULL;
+    m_nEmptySlabCount = 0;
+    m_nLiveCount = 0;
+    ResetCounters();
+}
+
+CPathPool::~CPathPool()
+{
+    assert(m_nLiveCount == 0);
+    
+    for(unsigned int k = 0; k < m_aSlabs.size(); k++)
+        delete m_aSlabs[k];
+}
+
+CPath* CPathPool::Acquire()
+{
+    if(m_pFreeList == NULL)
+        AllocateSlab();
+    
+    CPath* pPath = m_pFreeList;
+    m_pFreeList = pPath->m_pNextFree;
+    pPath->m_pNextFree = NULL;
+    
+    if(pPath->m_pPoolSlab->m_nLiveCount++ == 0)
+        m_nEmptySlabCount--;
+    
+    m_nLiveCount++;
+    m_nAcquireCount++;
+    m_nPeakLiveCount = std::max(m_nPeakLiveCount, m_nLiveCount);
+    
+    return pPath;
+}
+
+CPathContainer CPathPool::Create(const CPath& a_rSource)
+{
+    CPathContainer container(Acquire());
+    *container.m_pPath = a_rSource;
+    return container;
+}
+
+void CPathPool::Release(CPath* a_pPath)
+{
+    assert(a_pPath->m_nPoolRefCount == 0);
+    
+    //Drop the references to the shared decision lists, so that they are freed as soon as possible
+    a_pPath->ClearSyncPointList();
+    a_pPath->ClearIncludedVariants();
+    a_pPath->ClearExcludedVariants();
+    
+    a_pPath->m_pNextFree = m_pFreeList;
+    m_pFreeList = a_pPath;
+    
+    if(--a_pPath->m_pPoolSlab->m_nLiveCount == 0)
+        m_nEmptySlabCount++;
+    
+    m_nLiveCount--;
+}
+
+void CPathPool::Reclaim()
+{
+    if(m_nEmptySlabCount == 0 || (int)m_aSlabs.size() <= PATH_POOL_RETAINED_SLAB_COUNT)
+        return;
+    
+    //Release the empty slabs until the retained slab count is reached
+    std::vector<SPathSlab*> retainedSlabs;
+    int releasableCount = (int)m_aSlabs.size() - PATH_POOL_RETAINED_SLAB_COUNT;
+    
+    for(unsigned int k = 0; k < m_aSlabs.size(); k++)
+    {
+        if(m_aSlabs[k]->m_nLiveCount == 0 && releasableCount > 0)
+        {
+            delete m_aSlabs[k];
+            m_nEmptySlabCount--;
+            releasableCount--;
+        }
+        else
+            retainedSlabs.push_back(m_aSlabs[k]);
+    }
+    m_aSlabs.swap(retainedSlabs);
+    
+    //Rebuild the free list from the unused paths of the retained slabs
+    m_pFreeList = NULL;
+    for(unsigned int k = 0; k < m_aSlabs.size(); k++)
+    {
+        for(int m = PATH_POOL_SLAB_SIZE - 1; m >= 0; m--)
+        {
+            CPath* pPath = &m_aSlabs[k]->m_aPaths[m];
+            if(pPath->m_nPoolRefCount == 0)
+            {
+                pPath->m_pNextFree = m_pFreeList;
+                m_pFreeList = pPath;
+            }
+        }
+    }
+}
+
+void CPathPool::AllocateSlab()
+{
+    SPathSlab* pSlab = new SPathSlab;
+    pSlab->m_nLiveCount = 0;
+    pSlab->m_pPool = this;
+    
+    for(int k = PATH_POOL_SLAB_SIZE - 1; k >= 0; k--)
+    {
+        pSlab->m_aPaths[k].m_pPoolSlab = pSlab;
+        pSlab->m_aPaths[k].m_pNextFree = m_pFreeList;
+        m_pFreeList = &pSlab->m_aPaths[k];
+    }
+    
+    m_aSlabs.push_back(pSlab);
+    m_nEmptySlabCount++;
+    m_nSlabAllocationCount++;
+}
+
+void CPathPool::ResetCounters()
+{
+    m_nAcquireCount = 0;
+    m_nSlabAllocationCount = 0;
+    m_nPeakLiveCount = m_nLiveCount;
+}
+
+int CPathPool::GetAcquireCount() const
+{
+    return m_nAcquireCount;
+}
+
+int CPathPool::GetSlabAllocationCount() const
+{
+    return m_nSlabAllocationCount;
+}
+
+int CPathPool::GetPeakLiveCount() const
+{
+    return m_nPeakLiveCount;
+}
@@ -29,10 +29,89 @@
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
 #include "CPath.h"
 
 using namespace core;
 
+//Checks if the variant is a substitution (every allele spans the whole variant without changing its length)
+static bool IsSubstitution(const CVariant& a_rVariant)
+{
+    for(int k = 0; k < a_rVariant.m_nAlleleCount; k++)
+    {
+        const SAllele& allele = a_rVariant.m_alleles[k];
+        if(allele.m_bIsIgnored)
+            continue;
+        if(allele.m_nStartPos != a_rVariant.GetStart() || allele.m_nEndPos != a_rVariant.GetEnd() || allele.m_sequence.m_nLength != allele.m_nEndPos - allele.m_nStartPos)
+            return false;
+    }
+    return true;
+}
+
+//Checks if both variants have the same alleles in the same genotype order
+static bool IsIdenticalVariant(const CVariant& a_rLhs, const CVariant& a_rRhs)
+{
+    if(a_rLhs.GetStart() != a_rRhs.GetStart() || a_rLhs.GetEnd() != a_rRhs.GetEnd())
+        return false;
+    if(a_rLhs.m_nAlleleCount != a_rRhs.m_nAlleleCount || a_rLhs.IsHeterozygous() != a_rRhs.IsHeterozygous())
+        return false;
+    
+    for(int k = 0; k < a_rLhs.m_nAlleleCount; k++)
+    {
+        const SAllele& lhs = a_rLhs.m_alleles[k];
+        const SAllele& rhs = a_rRhs.m_alleles[k];
+        if(lhs.m_bIsIgnored != rhs.m_bIsIgnored)
+            return false;
+        if(!lhs.m_bIsIgnored && (lhs.m_nStartPos != rhs.m_nStartPos || lhs.m_nEndPos != rhs.m_nEndPos || lhs.m_sequence.m_nLength != rhs.m_sequence.m_nLength
+                                    || 0 != memcmp(a_rLhs.GetAlleleSequence(k), a_rRhs.GetAlleleSequence(k), lhs.m_sequence.m_nLength)))
+            return false;
+    }
+    return true;
+}
+
+//Add the given sequence to the cache key (8 bases at a time)
+static void CombineCacheKeySequence(SReplayCacheKey& a_rKey, const char* a_pSequence, int a_nLength)
+{
+    CombineCacheKey(a_rKey, static_cast<uint64_t>(a_nLength));
+    
+    int k = 0;
+    for(; k + 8 <= a_nLength; k += 8)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, a_pSequence + k, sizeof(chunk));
+        CombineCacheKey(a_rKey, chunk);
+    }
+    
+    uint64_t tail = 0;
+    for(; k < a_nLength; k++)
+        tail = (tail << 8) | static_cast<unsigned char>(a_pSequence[k]);
+    CombineCacheKey(a_rKey, tail);
+}
+
+//Add the variant to the cache key. Positions are relative to the given origin so that the key does not depend on the location of the region
+static void CombineCacheKeyVariant(SReplayCacheKey& a_rKey, const CVariant& a_rVariant, int a_nOrigin)
+{
+    CombineCacheKey(a_rKey, static_cast<uint64_t>(a_rVariant.GetStart() - a_nOrigin));
+    CombineCacheKey(a_rKey, static_cast<uint64_t>(a_rVariant.GetEnd() - a_nOrigin));
+    CombineCacheKey(a_rKey, static_cast<uint64_t>(a_rVariant.m_nAlleleCount));
+    CombineCacheKey(a_rKey, static_cast<uint64_t>(a_rVariant.IsHeterozygous()));
+    CombineCacheKey(a_rKey, static_cast<uint64_t>(a_rVariant.m_genotype[0]));
+    CombineCacheKey(a_rKey, static_cast<uint64_t>(a_rVariant.m_genotype[1]));
+    
+    for(int k = 0; k < a_rVariant.m_nAlleleCount; k++)
+    {
+        const SAllele& allele = a_rVariant.m_alleles[k];
+        CombineCacheKey(a_rKey, static_cast<uint64_t>(allele.m_bIsIgnored));
+        CombineCacheKey(a_rKey, static_cast<uint64_t>(allele.m_nStartPos == -1 ? -1 : allele.m_nStartPos - a_nOrigin));
+        CombineCacheKey(a_rKey, static_cast<uint64_t>(allele.m_nEndPos == -1 ? -1 : allele.m_nEndPos - a_nOrigin));
+        CombineCacheKeySequence(a_rKey, a_rVariant.GetAlleleSequence(k), a_rVariant.GetAlleleLength(k));
+    }
+}
+
 CPathReplay::CPathReplay(std::vector<const CVariant*>& a_aVarListBase,
             std::vector<const CVariant*>& a_aVarListCalled,
             std::vector<const COrientedVariant*>& a_aOVarListBase,
@@ -44,6 +123,20 @@ CPathReplay::CPathReplay(std::vector<const CVariant*>& a_aVarListBase,
 {
     m_nMaxPathSize = DEFAULT_MAX_PATH_SIZE;
     m_nMaxIterationCount = DEFAULT_MAX_ITERATION_SIZE;
+    m_complexRegionMode = eCOMPLEX_REGION_SKIP;
+    m_nBeamWidth = DEFAULT_BEAM_WIDTH;
+    m_bAdaptiveBudget = false;
+    m_pReplayCache = NULL;
+    m_nMaxEnqueuedIndexBase = -1;
+    m_nMaxEnqueuedIndexCalled = -1;
+    m_bCollectRegionStats = false;
+    m_bPrintSummary = true;
+    m_bHasPrecedingVariantsBase = false;
+    m_bHasPrecedingVariantsCalled = false;
+    m_bIsSettled = false;
+    m_nSettledPosition = -1;
+    m_bSkippedFromStartBase = false;
+    m_bSkippedFromStartCalled = false;
 }
 
 void CPathReplay::SetMaxPathAndIteration(int a_nMaxPathSize, int a_nMaxIterationCount)
@@ -52,11 +145,88 @@ void CPathReplay::SetMaxPathAndIteration(int a_nMaxPathSize, int a_nMaxIteration
     m_nMaxPathSize = a_nMaxPathSize;
 }
 
+void CPathReplay::SetComplexRegionMode(EComplexRegionMode a_mode, int a_nBeamWidth)
+{
+    m_complexRegionMode = a_mode;
+    m_nBeamWidth = std::max(1, a_nBeamWidth);
+}
+
+void CPathReplay::SetAdaptiveBudget(bool a_bIsEnabled)
+{
+    m_bAdaptiveBudget = a_bIsEnabled;
+}
+
+void CPathReplay::SetReplayCache(CReplayCache* a_pReplayCache)
+{
+    m_pReplayCache = a_pReplayCache;
+}
+
+void CPathReplay::SetCollectRegionStats(bool a_bIsEnabled)
+{
+    m_bCollectRegionStats = a_bIsEnabled;
+}
+
+const std::vector<SReplayRegionStats>& CPathReplay::GetRegionStats() const
+{
+    return m_aRegionStats;
+}
+
+void CPathReplay::SetPrintSummary(bool a_bPrintSummary)
+{
+    m_bPrintSummary = a_bPrintSummary;
+}
+
+void CPathReplay::SetHasPrecedingVariants(bool a_bBase, bool a_bCalled)
+{
+    m_bHasPrecedingVariantsBase = a_bBase;
+    m_bHasPrecedingVariantsCalled = a_bCalled;
+}
+
+bool CPathReplay::IsSettled() const
+{
+    return m_bIsSettled;
+}
+
+int CPathReplay::GetSettledPosition() const
+{
+    return m_nSettledPosition;
+}
+
+bool CPathReplay::IsSkippedFromStart(EVcfName a_uVcfName) const
+{
+    return a_uVcfName == eBASE ? m_bSkippedFromStartBase : m_bSkippedFromStartCalled;
+}
+
+
+double CPathReplay::EstimateCost(const std::vector<const CVariant*>& a_rVarListBase, const std::vector<const CVariant*>& a_rVarListCalled)
+{
+    const double variantCount = static_cast<double>(a_rVarListBase.size() + a_rVarListCalled.size());
+    if(variantCount == 0)
+        return 0;
+
+    //Span of the variants on the reference
+    int startPos = INT_MAX;
+    int endPos = INT_MIN;
+    const std::vector<const CVariant*>* aLists[2] = {&a_rVarListBase, &a_rVarListCalled};
+    for(int k = 0; k < 2; k++)
+    {
+        if(aLists[k]->empty())
+            continue;
+        startPos = std::min(startPos, aLists[k]->front()->GetStart());
+        endPos = std::max(endPos, aLists[k]->back()->GetEnd());
+    }
+
+    //Each variant is processed once, dense regions additionally multiply the number of alive paths
+    const double span = std::max(1, endPos - startPos + 1);
+    return variantCount * (1.0 + variantCount / span);
+}
 
 CPath CPathReplay::FindBestPath(SContig a_contig, bool a_bIsGenotypeMatch)
 {
-    CPathContainer initialPath(a_contig.m_pRefSeq, a_contig.m_nRefLength);
-    m_pathList.Add(initialPath);
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    m_pathPool.ResetCounters();
+    CPathContainer initialPath = m_pathPool.Create(CPath(a_contig.m_pRefSeq, a_contig.m_nRefLength));
+    m_pathList.Add(initialPath, initialPath.m_pPath->GetStateHash());
     CPathContainer best(initialPath);
     CPathContainer lastSyncPath;
     int maxPaths = 0;
@@ -67,48 +237,92 @@ CPath CPathReplay::FindBestPath(SContig a_contig, bool a_bIsGenotypeMatch)
     int lastSyncPos = 0;
     int complexRegionCount = 0;
     int totalSkippedVariantCount = 0;
+    long long totalIterations = 0;
+    int maxProcessedPosition = -1;
+    int finishedPathCount = 0;
+    int trivialPairCount = 0;
+    int beamRegionCount = 0;
+    //Variant indexes where the current beam search region starts (-1 if the replay is not in a beam search region)
+    int beamStartBase = -1;
+    int beamStartCalled = -1;
+    //Limits of the region replayed after the last sync point (set from the complexity estimate if the adaptive budget is enabled)
+    int regionPathLimit = m_nMaxPathSize;
+    int regionIterationLimit = m_nMaxIterationCount;
+    int cachedRegionCount = 0;
+    //Cluster whose decisions are stored to the replay cache once the replay reaches the next synchronized single path
+    bool isCacheRegionActive = false;
+    SCachedRegion cacheRegion;
+    int cacheRegionComplexCount = 0;
+    m_bIsSettled = false;
+    m_nSettledPosition = -1;
+    m_bSkippedFromStartBase = false;
+    m_bSkippedFromStartCalled = false;
+    
+    //Statistics of the region replayed since the last sync point that processed a variant
+    SRegionStatsStart regionStats = {-1, -1, 0, 0, 0, 0, startTime};
+    m_aRegionStats.clear();
     
     CPathContainer processedPath;
     
-    while(!m_pathList.Empty())
+    //Pruned paths are not guaranteed to have a surviving continuation. If all of them die out before reaching the end, replay skips the region
+    while(!m_pathList.Empty() || (beamRegionCount > 0 && finishedPathCount == 0))
     {
+        const bool isBeamDeadEnd = m_pathList.Empty();
+        bool isRegionCached = false;
         currentMax = std::max(currentMax, m_pathList.Size());
         currentMaxIterations = std::max(currentMaxIterations, currentIterations++);
-        m_pathList.GetLeastAdvanced(processedPath);
+        totalIterations++;
+        if(!isBeamDeadEnd)
+            m_pathList.GetLeastAdvanced(processedPath);
+        
+        //Track how far the paths went before processing all variants (synchronized paths with no variant left jump to the contig end)
+        if(!IsAllVariantsProcessed(*processedPath.m_pPath))
+            maxProcessedPosition = std::max(maxProcessedPosition, std::max(processedPath.m_pPath->m_calledSemiPath.GetPosition(), processedPath.m_pPath->m_baseSemiPath.GetPosition()));
         
-        if(m_pathList.Size() == 0)
+        if(isBeamDeadEnd)
         {
-            const std::vector<const COrientedVariant*>* calledIncluded;
-            const std::vector<int>* calledExcluded;
-            calledIncluded = &(processedPath.m_pPath->m_calledSemiPath.GetIncludedVariants());
-            calledExcluded = &(processedPath.m_pPath->m_calledSemiPath.GetExcluded());
+            complexRegionCount++;
+            std::cerr << "Beam search could not resolve the reference region ";
+            std::cerr << a_contig.m_chromosomeName << ":" << (lastSyncPos + 1) << "-" << (m_nCurrentPosition + 2) << ". Skipping the region" << std::endl;
             
-            const std::vector<const COrientedVariant*>* baseIncluded;
-            const std::vector<int>* baseExcluded;
-            baseIncluded = &(processedPath.m_pPath->m_baseSemiPath.GetIncludedVariants());
-            baseExcluded = &(processedPath.m_pPath->m_baseSemiPath.GetExcluded());
-
-            if(calledIncluded->size() > 0 || baseIncluded->size() > 0)
+            beamStartBase = -1;
+            beamStartCalled = -1;
+            currentIterations = 0;
+            processedPath = lastSyncPath;
+            m_bSkippedFromStartBase = m_bSkippedFromStartBase || processedPath.m_pPath->m_baseSemiPath.GetVariantIndex() == -1;
+            m_bSkippedFromStartCalled = m_bSkippedFromStartCalled || processedPath.m_pPath->m_calledSemiPath.GetVariantIndex() == -1;
+            totalSkippedVariantCount += SkipVariantsTo(*processedPath.m_pPath, a_contig, m_nCurrentPosition+1);
+        }
+        //A lone path left by the beam pruning is not a sync point until it gets in sync
+        else if(m_pathList.Size() == 0 && (m_complexRegionMode != eCOMPLEX_REGION_BEAM || processedPath.m_pPath->InSync()))
+        {
+            CPath* pPath = processedPath.m_pPath;
+            
+            if(pPath->m_nIncludedCountCalled > 0 || pPath->m_nIncludedCountBase > 0)
             {
-                for(int k = 0; k < (int)calledIncluded->size(); k++)
-                    m_IncludedVariantsCalledBest.push_back((*calledIncluded)[k]);
-                for(int k = 0; k < (int)baseIncluded->size(); k++)
-                    m_IncludedVariantsBaselineBest.push_back((*baseIncluded)[k]);
-                
-                for(int k = 0; k < (int)calledExcluded->size(); k++)
-                    m_ExcludedVariantsCalledBest.push_back((*calledExcluded)[k]);
-                for(int k = 0; k < (int)baseExcluded->size(); k++)
-                    m_ExcludedVariantsBaselineBest.push_back((*baseExcluded)[k]);
-                
-                for(int k = 0; k < (int)processedPath.m_pPath->m_aSyncPointList.size(); k++)
-                    m_SyncPointsBest.push_back(processedPath.m_pPath->m_aSyncPointList[k]);
+                pPath->m_calledSemiPath.AppendPendingVariants(m_IncludedVariantsCalledBest, m_ExcludedVariantsCalledBest);
+                pPath->m_baseSemiPath.AppendPendingVariants(m_IncludedVariantsBaselineBest, m_ExcludedVariantsBaselineBest);
+                pPath->m_aPendingSyncPoints.AppendTo(m_SyncPointsBest);
                 
-                processedPath.m_pPath->ClearSyncPointList();
-                processedPath.m_pPath->ClearIncludedVariants();
-                processedPath.m_pPath->ClearExcludedVariants();
+                pPath->ClearSyncPointList();
+                pPath->ClearIncludedVariants();
+                pPath->ClearExcludedVariants();
+            }
+            
+            //Beam search region ends at the first sync point after the pruning
+            if(beamStartBase != -1)
+            {
+                MarkApproximateVariants(beamStartBase, pPath->m_baseSemiPath.GetVariantIndex(), beamStartCalled, pPath->m_calledSemiPath.GetVariantIndex());
+                beamStartBase = -1;
+                beamStartCalled = -1;
             }
             
             int currentSyncPos = processedPath.m_pPath->m_calledSemiPath.GetPosition();
+            if(m_bCollectRegionStats)
+            {
+                regionStats.m_nPeakPathCount = std::max(regionStats.m_nPeakPathCount, currentMax);
+                AddRegionStats(*pPath, totalIterations, complexRegionCount, beamRegionCount, regionStats);
+            }
             if(currentMax > maxPaths)
             {
                 maxPaths = currentMax;
@@ -118,8 +332,102 @@ CPath CPathReplay::FindBestPath(SContig a_contig, bool a_bIsGenotypeMatch)
             currentIterations = 0;
             lastSyncPos = currentSyncPos;
             lastSyncPath = processedPath;
+            
+            //Record the first point where a single synchronized path is left with all variants processed. If other paths
+            //have finished before, they were alternatives of this path rather than being merged to it
+            if(!m_bIsSettled && finishedPathCount == 0 && IsAllVariantsProcessed(*pPath))
+            {
+                m_bIsSettled = true;
+                m_nSettledPosition = maxProcessedPosition;
+            }
+            
+            //Only the paths referenced by the replay loop are alive at this point. Release the unused slabs
+            m_pathPool.Reclaim();
+            
+            //Store the decisions of the cached region if it is resolved without any complex region fallback
+            if(isCacheRegionActive && pPath->InSync())
+            {
+                isCacheRegionActive = false;
+                std::vector<uint8_t> decisions;
+                if(complexRegionCount + beamRegionCount == cacheRegionComplexCount
+                   && pPath->m_baseSemiPath.GetVariantIndex() == cacheRegion.m_nBaseEnd && pPath->m_calledSemiPath.GetVariantIndex() == cacheRegion.m_nCalledEnd
+                   && m_nMaxEnqueuedIndexBase <= cacheRegion.m_nBaseEnd && m_nMaxEnqueuedIndexCalled <= cacheRegion.m_nCalledEnd
+                   && GetRegionDecisions(*pPath, cacheRegion, decisions))
+                    m_pReplayCache->Insert(cacheRegion.m_key, decisions);
+            }
+            
+            //Play the next cluster with the cached decisions if it is resolved before. Otherwise it is recorded while it is replayed
+            if(m_pReplayCache != NULL && pPath->InSync() && !IsAllVariantsProcessed(*pPath) && GetCachedRegion(*pPath, a_contig, a_bIsGenotypeMatch, cacheRegion))
+            {
+                std::vector<uint8_t> decisions;
+                if(m_pReplayCache->Find(cacheRegion.m_key, decisions))
+                {
+                    CPathContainer cachedPath = m_pathPool.Create(*pPath);
+                    if(PlayCachedRegion(*cachedPath.m_pPath, a_contig, cacheRegion, decisions, a_bIsGenotypeMatch))
+                    {
+                        cachedRegionCount++;
+                        AddIfBetter(cachedPath);
+                        isRegionCached = true;
+                    }
+                }
+                else
+                {
+                    isCacheRegionActive = true;
+                    cacheRegionComplexCount = complexRegionCount + beamRegionCount;
+                    cacheRegion.m_nFlushedIncludedBase = (int)m_IncludedVariantsBaselineBest.size();
+                    cacheRegion.m_nFlushedExcludedBase = (int)m_ExcludedVariantsBaselineBest.size();
+                    cacheRegion.m_nFlushedIncludedCalled = (int)m_IncludedVariantsCalledBest.size();
+                    cacheRegion.m_nFlushedExcludedCalled = (int)m_ExcludedVariantsCalledBest.size();
+                    m_nMaxEnqueuedIndexBase = -1;
+                    m_nMaxEnqueuedIndexCalled = -1;
+                }
+            }
+            
+            regionPathLimit = m_nMaxPathSize;
+            regionIterationLimit = m_nMaxIterationCount;
+            if(!isRegionCached && m_bAdaptiveBudget && pPath->InSync() && !IsAllVariantsProcessed(*pPath))
+            {
+                SRegionEstimate estimate = EstimateRegion(*pPath);
+                
+                if(!IsHopelessRegion(estimate))
+                    regionIterationLimit = GetIterationBudget(estimate);
+                else if(m_complexRegionMode == eCOMPLEX_REGION_BEAM)
+                {
+                    //Beam search starts as soon as the frontier exceeds the beam width
+                    regionPathLimit = std::min(m_nMaxPathSize, m_nBeamWidth);
+                    regionIterationLimit = std::min(m_nMaxIterationCount, ADAPTIVE_MIN_ITERATION_BUDGET);
+                }
+                else
+                {
+                    complexRegionCount++;
+                    std::cerr << "Evaluation is predicted to be too complex!";
+                    std::cerr << " There are " << estimate.m_nVariantCount << " overlapping variants (" << estimate.m_nHeterozygousCount << " heterozygous) at reference region ";
+                    std::cerr << a_contig.m_chromosomeName << ":" << (estimate.m_nStartPosition + 1) << "-" << (estimate.m_nEndPosition + 1) << std::endl;
+                    
+                    //Skip the cluster without replaying it
+                    m_bSkippedFromStartBase = m_bSkippedFromStartBase || pPath->m_baseSemiPath.GetVariantIndex() == -1;
+                    m_bSkippedFromStartCalled = m_bSkippedFromStartCalled || pPath->m_calledSemiPath.GetVariantIndex() == -1;
+                    totalSkippedVariantCount += SkipVariantsTo(*pPath, a_contig, estimate.m_nEndPosition + 1);
+                }
+            }
         }
-        else if(m_pathList.Size() >  m_nMaxPathSize || currentIterations > m_nMaxIterationCount)
+        else if(m_complexRegionMode == eCOMPLEX_REGION_BEAM && (m_pathList.Size() > regionPathLimit || currentIterations > regionIterationLimit))
+        {
+            std::cerr << "Evaluation is too complex!";
+            std::cerr << " There are " << m_pathList.Size() << " unresolved paths, " << currentIterations << " iterations at reference region ";
+            std::cerr << a_contig.m_chromosomeName << ":" << (lastSyncPos + 1) << "-" << (m_nCurrentPosition + 2) << ". Continuing with beam search" << std::endl;
+            
+            if(beamStartBase == -1)
+            {
+                beamRegionCount++;
+                beamStartBase = lastSyncPath.m_pPath->m_baseSemiPath.GetVariantIndex() + 1;
+                beamStartCalled = lastSyncPath.m_pPath->m_calledSemiPath.GetVariantIndex() + 1;
+            }
+            
+            KeepBestPaths(processedPath);
+            currentIterations = 0;
+        }
+        else if(m_pathList.Size() > regionPathLimit || currentIterations > regionIterationLimit)
         {
             complexRegionCount++;
             std::cerr << "Evaluation is too complex!";
@@ -131,18 +439,37 @@ CPath CPathReplay::FindBestPath(SContig a_contig, bool a_bIsGenotypeMatch)
             currentIterations = 0;
             // Create new head containing path up until last sync point
             processedPath = lastSyncPath;
+            m_bSkippedFromStartBase = m_bSkippedFromStartBase || processedPath.m_pPath->m_baseSemiPath.GetVariantIndex() == -1;
+            m_bSkippedFromStartCalled = m_bSkippedFromStartCalled || processedPath.m_pPath->m_calledSemiPath.GetVariantIndex() == -1;
             //Ignore variants until Current Position
             totalSkippedVariantCount += SkipVariantsTo(*processedPath.m_pPath, a_contig, m_nCurrentPosition+1);
         }
 
+        if(isRegionCached)
+            continue;
+
         if(processedPath.m_pPath->HasFinished())
         {
             //Path is done. Update the Best Path if it is better
-            CPathContainer processedCopy(*processedPath.m_pPath, processedPath.m_pPath->m_calledSemiPath.GetPosition());
+            finishedPathCount++;
+            CPathContainer processedCopy = m_pathPool.Create(*processedPath.m_pPath);
+            processedCopy.m_pPath->PushSyncPoint(processedPath.m_pPath->m_calledSemiPath.GetPosition());
             best = FindBetter(best, processedCopy) ? best : processedCopy;
             continue;
         }
 
+        //A single path reaching an isolated identical substitution ends up with both variants included. Play it directly instead of branching
+        if(a_bIsGenotypeMatch && m_pathList.Empty() && IsTrivialVariantPair(*processedPath.m_pPath, a_contig))
+        {
+            CPathContainer trivialPath = m_pathPool.Create(*processedPath.m_pPath);
+            if(PlayTrivialVariantPair(*trivialPath.m_pPath, a_contig))
+            {
+                trivialPairCount++;
+                AddIfBetter(trivialPath);
+                continue;
+            }
+        }
+
         if(EnqueueVariant(*processedPath.m_pPath, eCALLED, a_bIsGenotypeMatch))
         {
             //std::cout << "Called semipath enqueued" << std::endl;
@@ -155,84 +482,262 @@ CPath CPathReplay::FindBestPath(SContig a_contig, bool a_bIsGenotypeMatch)
             continue;
         }
 
-        processedPath.m_pPath->Step();
-        
-        if(processedPath.m_pPath->InSync())
+        //Steps that need no decision are taken without going through the path list
+        bool isMatching = false;
+        const int maxPopCount = m_pathList.Empty() ? INT_MAX : regionIterationLimit - currentIterations;
+        const int popCount = StepPath(*processedPath.m_pPath, a_contig, maxPopCount, maxProcessedPosition, isMatching);
+        totalIterations += popCount;
+        if(!m_pathList.Empty())
         {
-            SkipToNextVariant(*processedPath.m_pPath, a_contig);
-            //std::cout << "In Sync/ skip to next variant" << std::endl;
+            currentIterations += popCount;
+            currentMaxIterations = std::max(currentMaxIterations, currentIterations - 1);
         }
 
-        if(processedPath.m_pPath->Matches())
-        {
-            //std::cout << "Head matches, keeping" << std::endl;
+        if(isMatching)
             AddIfBetter(processedPath);
-            //m_pathList.Print();
-        }
     }
     
-    const std::vector<const COrientedVariant*>* calledIncluded;
-    const std::vector<int>* calledExcluded;
-    calledIncluded = &(best.m_pPath->m_calledSemiPath.GetIncludedVariants());
-    calledExcluded = &(best.m_pPath->m_calledSemiPath.GetExcluded());
-    
-    const std::vector<const COrientedVariant*>* baseIncluded;
-    const std::vector<int>* baseExcluded;
-    baseIncluded = &(best.m_pPath->m_baseSemiPath.GetIncludedVariants());
-    baseExcluded = &(best.m_pPath->m_baseSemiPath.GetExcluded());
-
-    for(int k = 0; k < (int)calledIncluded->size(); k++)
-        m_IncludedVariantsCalledBest.push_back((*calledIncluded)[k]);
-    for(int k = 0; k < (int)baseIncluded->size(); k++)
-        m_IncludedVariantsBaselineBest.push_back((*baseIncluded)[k]);
-    for(int k = 0; k < (int)calledExcluded->size(); k++)
-        m_ExcludedVariantsCalledBest.push_back((*calledExcluded)[k]);
-    for(int k = 0; k < (int)baseExcluded->size(); k++)
-        m_ExcludedVariantsBaselineBest.push_back((*baseExcluded)[k]);
-    for(int k = 0; k < (int)best.m_pPath->m_aSyncPointList.size(); k++)
-        m_SyncPointsBest.push_back(best.m_pPath->m_aSyncPointList[k]);
+    //Beam search region that lasts until the end of the contig
+    if(beamStartBase != -1)
+        MarkApproximateVariants(beamStartBase, (int)m_aVariantListBase.size() - 1, beamStartCalled, (int)m_aVariantListCalled.size() - 1);
+    
+    //Region after the last sync point
+    if(m_bCollectRegionStats)
+    {
+        regionStats.m_nPeakPathCount = std::max(regionStats.m_nPeakPathCount, currentMax);
+        AddRegionStats(*best.m_pPath, totalIterations, complexRegionCount, beamRegionCount, regionStats);
+    }
+    
+    //Materialize the decisions of the best path
+    best.m_pPath->m_calledSemiPath.AppendPendingVariants(m_IncludedVariantsCalledBest, m_ExcludedVariantsCalledBest);
+    best.m_pPath->m_baseSemiPath.AppendPendingVariants(m_IncludedVariantsBaselineBest, m_ExcludedVariantsBaselineBest);
+    best.m_pPath->m_aPendingSyncPoints.AppendTo(m_SyncPointsBest);
+    
+    CDecisionArray decisionsCalled;
+    CDecisionArray decisionsBase;
+    decisionsCalled.Fill(m_aOrientedVariantListCalled, m_IncludedVariantsCalledBest, m_ExcludedVariantsCalledBest);
+    decisionsBase.Fill(m_aOrientedVariantListBase, m_IncludedVariantsBaselineBest, m_ExcludedVariantsBaselineBest);
     
     best.m_pPath->ClearSyncPointList();
     best.m_pPath->AddSyncPointList(m_SyncPointsBest);
     best.m_pPath->ClearIncludedVariants();
-    best.m_pPath->AddIncludedVariants(m_IncludedVariantsCalledBest, m_IncludedVariantsBaselineBest);
     best.m_pPath->ClearExcludedVariants();
-    best.m_pPath->AddExcludedVariants(m_ExcludedVariantsCalledBest, m_ExcludedVariantsBaselineBest);
+    best.m_pPath->SetDecisions(decisionsCalled, decisionsBase);
+    
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    
+    if(m_bPrintSummary)
+    {
+        std::cerr << "FINISHED " << a_contig.m_chromosomeName << ": Complex Region: " << complexRegionCount;
+        std::cerr << " Skipped Variant Count :" << totalSkippedVariantCount;
+        std::cerr << " Beam Search Regions: " << beamRegionCount;
+        std::cerr << " Trivial Variant Pairs: " << trivialPairCount;
+        if(m_pReplayCache != NULL)
+            std::cerr << " Cached Regions: " << cachedRegionCount;
+        std::cerr << " Maximum path complexity is " << maxPaths << ", with "  << currentMaxIterations << " iterations";
+        std::cerr << " Path allocations: " << m_pathPool.GetAcquireCount() << " (heap slabs: " << m_pathPool.GetSlabAllocationCount();
+        std::cerr << ", peak live paths: " << m_pathPool.GetPeakLiveCount() << ")";
+        std::cerr << " Total iterations: " << totalIterations << " (" << (long long)(elapsedSeconds > 0 ? totalIterations / elapsedSeconds : 0) << " iterations/sec)" << std::endl;
+    }
     
-    std::cerr << "FINISHED " << a_contig.m_chromosomeName << ": Complex Region: " << complexRegionCount;
-    std::cerr << " Skipped Variant Count :" << totalSkippedVariantCount;
-    std::cerr << " Maximum path complexity is " << maxPaths << ", with "  << currentMaxIterations << " iterations " << std::endl;
     return *best.m_pPath;
 }
 
-void CPathReplay::AddIfBetter(const CPathContainer& a_path)
+void CPathReplay::AddRegionStats(const CPath& a_rSyncPath, long long a_nTotalIterations, int a_nComplexRegionCount, int a_nBeamRegionCount, SRegionStatsStart& a_rStart)
 {
-    std::set<CPathContainer>::iterator it;
-
-    int cnt = m_pathList.Size();
+    const int baseIndex = std::min(a_rSyncPath.m_baseSemiPath.GetVariantIndex(), (int)m_aVariantListBase.size() - 1);
+    const int calledIndex = std::min(a_rSyncPath.m_calledSemiPath.GetVariantIndex(), (int)m_aVariantListCalled.size() - 1);
+    if(baseIndex <= a_rStart.m_nBaseIndex && calledIndex <= a_rStart.m_nCalledIndex)
+        return;
     
-    it = m_pathList.Find(a_path);
-    if(it != m_pathList.End())
+    SReplayRegionStats region;
+    region.m_nStartPosition = INT_MAX;
+    region.m_nEndPosition = 0;
+    for(int k = a_rStart.m_nBaseIndex + 1; k <= baseIndex; k++)
+    {
+        region.m_nStartPosition = std::min(region.m_nStartPosition, m_aVariantListBase[k]->GetStart());
+        region.m_nEndPosition = std::max(region.m_nEndPosition, m_aVariantListBase[k]->GetEnd());
+    }
+    for(int k = a_rStart.m_nCalledIndex + 1; k <= calledIndex; k++)
     {
-        CPathContainer other = m_pathList.floor(a_path);
-        CPathContainer best =  FindBetter(a_path, other) ? a_path : other;
+        region.m_nStartPosition = std::min(region.m_nStartPosition, m_aVariantListCalled[k]->GetStart());
+        region.m_nEndPosition = std::max(region.m_nEndPosition, m_aVariantListCalled[k]->GetEnd());
+    }
     
-        if(true == best.m_pPath->IsEqual(*a_path.m_pPath))
-        {
-            m_pathList.Erase(other);
-            m_pathList.Add(best);
-            assert(cnt == m_pathList.Size());
-        }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    region.m_nBaseVariantCount = std::max(0, baseIndex - a_rStart.m_nBaseIndex);
+    region.m_nCalledVariantCount = std::max(0, calledIndex - a_rStart.m_nCalledIndex);
+    region.m_nPeakPathCount = a_rStart.m_nPeakPathCount;
+    region.m_nIterationCount = a_nTotalIterations - a_rStart.m_nIterationCount;
+    region.m_nElapsedNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now - a_rStart.m_startTime).count();
+    
+    if(a_nComplexRegionCount > a_rStart.m_nComplexRegionCount)
+        region.m_outcome = eREGION_SKIPPED;
+    else if(a_nBeamRegionCount > a_rStart.m_nBeamRegionCount)
+        region.m_outcome = eREGION_FALLBACK;
+    else
+        region.m_outcome = eREGION_RESOLVED;
+    
+    m_aRegionStats.push_back(region);
+    
+    a_rStart.m_nBaseIndex = std::max(baseIndex, a_rStart.m_nBaseIndex);
+    a_rStart.m_nCalledIndex = std::max(calledIndex, a_rStart.m_nCalledIndex);
+    a_rStart.m_nIterationCount = a_nTotalIterations;
+    a_rStart.m_nPeakPathCount = 0;
+    a_rStart.m_nComplexRegionCount = a_nComplexRegionCount;
+    a_rStart.m_nBeamRegionCount = a_nBeamRegionCount;
+    a_rStart.m_startTime = now;
+}
+
+bool CPathReplay::IsAllVariantsProcessed(const CPath& a_rPath) const
+{
+    return a_rPath.InSync()
+           && a_rPath.m_baseSemiPath.GetVariantIndex() == (int)m_aVariantListBase.size() - 1
+           && a_rPath.m_calledSemiPath.GetVariantIndex() == (int)m_aVariantListCalled.size() - 1;
+}
+
+void CPathReplay::AddIfBetter(const CPathContainer& a_path)
+{
+    const uint64_t hash = a_path.m_pPath->GetStateHash();
+    CPathContainer* pOther = m_pathList.Find(a_path, hash);
+    
+    if(pOther != NULL)
+    {
+        //Equivalent paths share the same position in the frontier, replace the stored one if the new path is better
+        if(FindBetter(a_path, *pOther))
+            *pOther = a_path;
     }
     
     else
     {
         int cnt = m_pathList.Size();
-        m_pathList.Add(a_path);
+        m_pathList.Add(a_path, hash);
         assert(cnt < m_pathList.Size());
     }
 }
 
+void CPathReplay::KeepBestPaths(CPathContainer& a_rProcessedPath)
+{
+    //Paths are taken in the order of the path list so that the paths with equal score are kept in a deterministic order
+    std::vector<CPathContainer> frontier;
+    frontier.reserve(m_pathList.Size() + 1);
+    frontier.push_back(a_rProcessedPath);
+    while(!m_pathList.Empty())
+    {
+        frontier.push_back(CPathContainer());
+        m_pathList.GetLeastAdvanced(frontier.back());
+    }
+    
+    std::stable_sort(frontier.begin(), frontier.end(), [](const CPathContainer& a_rLhs, const CPathContainer& a_rRhs)
+                     { return CompareScore(*a_rLhs.m_pPath, *a_rRhs.m_pPath) > 0; });
+    
+    const int keptCount = std::min(m_nBeamWidth, std::max(1, (int)frontier.size() / 2));
+    for(int k = 0; k < keptCount; k++)
+        m_pathList.Add(frontier[k], frontier[k].m_pPath->GetStateHash());
+    frontier.clear();
+    
+    m_pathList.GetLeastAdvanced(a_rProcessedPath);
+}
+
+SRegionEstimate CPathReplay::EstimateRegion(const CPath& a_rSyncPath) const
+{
+    SRegionEstimate estimate = {0, 0, 0, INT_MAX, INT_MIN, 0.0};
+    const int baseCount = (int)m_aVariantListBase.size();
+    const int calledCount = (int)m_aVariantListCalled.size();
+    int baseIndex = a_rSyncPath.m_baseSemiPath.GetVariantIndex() + 1;
+    int calledIndex = a_rSyncPath.m_calledSemiPath.GetVariantIndex() + 1;
+    double variantBits = 0;
+    
+    while(baseIndex < baseCount || calledIndex < calledCount)
+    {
+        //Consume the variants of both lists in start position order
+        const CVariant* pVariant;
+        if(calledIndex == calledCount || (baseIndex < baseCount && m_aVariantListBase[baseIndex]->GetStart() <= m_aVariantListCalled[calledIndex]->GetStart()))
+            pVariant = m_aVariantListBase[baseIndex++];
+        else
+            pVariant = m_aVariantListCalled[calledIndex++];
+        
+        //Cluster ends at the first variant that does not overlap the previous ones
+        if(estimate.m_nVariantCount > 0 && pVariant->GetStart() > estimate.m_nEndPosition)
+            break;
+        
+        int alleleLength = pVariant->GetEnd() - pVariant->GetStart();
+        for(int k = 0; k < pVariant->m_nAlleleCount; k++)
+            alleleLength = std::max(alleleLength, pVariant->GetAlleleLength(k));
+        
+        estimate.m_nVariantCount++;
+        estimate.m_nAlleleSpan += alleleLength;
+        estimate.m_nStartPosition = std::min(estimate.m_nStartPosition, pVariant->GetStart());
+        estimate.m_nEndPosition = std::max(estimate.m_nEndPosition, pVariant->GetEnd());
+        
+        if(pVariant->IsHeterozygous())
+        {
+            estimate.m_nHeterozygousCount++;
+            variantBits += std::log2(3.0);
+        }
+        else
+            variantBits += 1.0;
+        
+        estimate.m_dPathBits = variantBits + std::log2(1.0 + (double)estimate.m_nAlleleSpan / estimate.m_nVariantCount);
+        
+        if(IsHopelessRegion(estimate))
+            break;
+    }
+    
+    return estimate;
+}
+
+bool CPathReplay::IsHopelessRegion(const SRegionEstimate& a_rEstimate) const
+{
+    return a_rEstimate.m_dPathBits > std::log2((double)m_nMaxPathSize) + ADAPTIVE_HOPELESS_MARGIN_BITS;
+}
+
+int CPathReplay::GetIterationBudget(const SRegionEstimate& a_rEstimate) const
+{
+    //Each predicted path is processed once for every variant of the cluster
+    const double predictedIterations = std::pow(2.0, a_rEstimate.m_dPathBits) * a_rEstimate.m_nVariantCount;
+    const double budget = std::max((double)ADAPTIVE_MIN_ITERATION_BUDGET, ADAPTIVE_BUDGET_FACTOR * predictedIterations);
+    return (int)std::min((double)m_nMaxIterationCount, budget);
+}
+
+void CPathReplay::MarkApproximateVariants(int a_nBaseStart, int a_nBaseEnd, int a_nCalledStart, int a_nCalledEnd)
+{
+    for(int k = a_nBaseStart; k <= a_nBaseEnd; k++)
+        m_aVariantListBase[k]->m_bIsApproximate = true;
+    for(int k = a_nCalledStart; k <= a_nCalledEnd; k++)
+        m_aVariantListCalled[k]->m_bIsApproximate = true;
+}
+
+int CPathReplay::CompareScore(const CPath& a_rLhs, const CPath& a_rRhs)
+{
+    // Prefer paths that maximise total number of included variants (baseline + called)
+    const int lhsVariantCount = a_rLhs.m_nIncludedCountCalled + a_rLhs.m_nIncludedCountBase;
+    const int rhsVariantCount = a_rRhs.m_nIncludedCountCalled + a_rRhs.m_nIncludedCountBase;
+    
+    if(lhsVariantCount != rhsVariantCount)
+        return lhsVariantCount - rhsVariantCount;
+    
+    //Tie break equivalently scoring paths for greater aesthetics (only if both paths have at least one included variant)
+    if(lhsVariantCount == 0)
+        return 0;
+    
+    // Prefer solutions that minimize discrepencies between baseline and call counts since last sync point
+    const int lhsDelta = abs(a_rLhs.m_nBSinceSync - a_rLhs.m_nCSinceSync);
+    const int rhsDelta = abs(a_rRhs.m_nBSinceSync - a_rRhs.m_nCSinceSync);
+    if(lhsDelta != rhsDelta)
+        return rhsDelta - lhsDelta;
+    
+    // Prefer solutions that sync more regularly (more likely to be "simpler")
+    const int syncDelta = a_rLhs.m_nLastSyncPoint - a_rRhs.m_nLastSyncPoint;
+    if(syncDelta != 0)
+        return syncDelta;
+    
+    // At this point break ties arbitrarily based on allele ordering (called side is used if it has any included variant)
+    const int lhsLastAllele = a_rLhs.m_nIncludedCountCalled != 0 ? a_rLhs.m_nLastIncludedAlleleCalled : a_rLhs.m_nLastIncludedAlleleBase;
+    const int rhsLastAllele = a_rRhs.m_nIncludedCountCalled != 0 ? a_rRhs.m_nLastIncludedAlleleCalled : a_rRhs.m_nLastIncludedAlleleBase;
+    return rhsLastAllele - lhsLastAllele;
+}
+
 bool CPathReplay::FindBetter(const CPathContainer& lhs, const CPathContainer& rhs)
 {
     // See if we have obvious no-ops we would rather drop
@@ -251,39 +756,7 @@ bool CPathReplay::FindBetter(const CPathContainer& lhs, const CPathContainer& rh
         }
     }
     
-    // Prefer paths that maximise total number of included variants (baseline + called)
-
-    const std::vector<const COrientedVariant*> lhsIncludedVariants = (lhs.m_pPath->m_calledSemiPath.GetIncludedVariants().size() == 0) ? lhs.m_pPath->m_baseSemiPath.GetIncludedVariants() :
-                                                                                                                                   lhs.m_pPath->m_calledSemiPath.GetIncludedVariants();
-    const std::vector<const COrientedVariant*> rhsIncludedVariants = (rhs.m_pPath->m_calledSemiPath.GetIncludedVariants().size() == 0) ? rhs.m_pPath->m_baseSemiPath.GetIncludedVariants() :
-                                                                                                                                   rhs.m_pPath->m_calledSemiPath.GetIncludedVariants();
-    
-    const int lhsVariantCount = static_cast<int>(lhs.m_pPath->m_calledSemiPath.GetIncludedVariants().size() + lhs.m_pPath->m_baseSemiPath.GetIncludedVariants().size());
-    const int rhsVariantCount = static_cast<int>(rhs.m_pPath->m_calledSemiPath.GetIncludedVariants().size() + rhs.m_pPath->m_baseSemiPath.GetIncludedVariants().size());
-    
-    if(lhsVariantCount == rhsVariantCount)
-    {
-        //Tie break equivalently scoring paths for greater aesthetics
-        if(lhsIncludedVariants.size() != 0 && rhsIncludedVariants.size() != 0)
-        {
-            
-            // Prefer solutions that minimize discrepencies between baseline and call counts since last sync point
-            const int lhsDelta = abs(lhs.m_pPath->m_nBSinceSync - lhs.m_pPath->m_nCSinceSync);
-            const int rhsDelta = abs(rhs.m_pPath->m_nBSinceSync - rhs.m_pPath->m_nCSinceSync);
-            if(lhsDelta != rhsDelta)
-                return lhsDelta < rhsDelta ? true : false;
-
-            // Prefer solutions that sync more regularly (more likely to be "simpler")
-            const int syncDelta = (lhs.m_pPath->m_aSyncPointList.size() == 0 ? 0 : lhs.m_pPath->m_aSyncPointList.back()) - (rhs.m_pPath->m_aSyncPointList.size() == 0 ? 0 : rhs.m_pPath->m_aSyncPointList.back());
-            if(syncDelta != 0)
-                return syncDelta > 0 ? true : false;
-            
-            // At this point break ties arbitrarily based on allele ordering
-            return (lhsIncludedVariants.back()->GetAlleleIndex() < rhsIncludedVariants.back()->GetAlleleIndex()) ? true : false;
-        }
-    }
-    
-    return lhsVariantCount > rhsVariantCount ? true : false;
+    return CompareScore(*lhs.m_pPath, *rhs.m_pPath) > 0;
 }
 
 
@@ -309,8 +782,13 @@ bool CPathReplay::EnqueueVariant(CPath& a_rPathToPlay, EVcfName a_uVcfSide, bool
         //std::cout << "Add alternatives to " << ((a_uVcfSide == eBASE) ? "BASE " : "CALLED ") << pNext->ToString() << std::endl;
         
         m_nCurrentPosition = std::max(m_nCurrentPosition, pNext->GetStart());
+        if(a_uVcfSide == eBASE)
+            m_nMaxEnqueuedIndexBase = std::max(m_nMaxEnqueuedIndexBase, nVariantId);
+        else
+            m_nMaxEnqueuedIndexCalled = std::max(m_nMaxEnqueuedIndexCalled, nVariantId);
         CPathContainer paths[3];
         int pathCount = a_rPathToPlay.AddVariant(paths,
+                                                  m_pathPool,
                                                   a_uVcfSide,
                                                  (a_uVcfSide == eBASE ? m_aVariantListBase : m_aVariantListCalled),
                                                  (a_uVcfSide == eBASE ? m_aOrientedVariantListBase : m_aOrientedVariantListCalled),
@@ -386,10 +864,19 @@ int CPathReplay::SkipVariantsTo(CPath& a_rPath, const SContig& a_rContig, int a_
     int baseSkippedCount = 0;
     int calledSkippedCount = 0;
     
-    while(varIndex < (int)m_aVariantListBase.size() && (varIndex == -1  || m_aVariantListBase[varIndex]->GetStart() < a_nMaxPos))
+    //Index -1 is the contig start, or the variant preceding the list when the replay covers a block of the contig
+    if(varIndex == -1)
     {
-        if(a_rPath.m_baseSemiPath.GetIncludedVariantEndPosition() < m_aVariantListBase[(varIndex >= 0 ? varIndex : 0)]->m_nStartPos)
-           m_aVariantListBase[(varIndex >= 0 ? varIndex : 0)]->m_variantStatus = eCOMPLEX_SKIPPED;
+        if(!m_bHasPrecedingVariantsBase && !m_aVariantListBase.empty() && a_rPath.m_baseSemiPath.GetIncludedVariantEndPosition() < m_aVariantListBase[0]->m_nStartPos)
+            m_aVariantListBase[0]->m_variantStatus = eCOMPLEX_SKIPPED;
+        varIndex++;
+        baseSkippedCount++;
+    }
+    
+    while(varIndex < (int)m_aVariantListBase.size() && m_aVariantListBase[varIndex]->GetStart() < a_nMaxPos)
+    {
+        if(a_rPath.m_baseSemiPath.GetIncludedVariantEndPosition() < m_aVariantListBase[varIndex]->m_nStartPos)
+           m_aVariantListBase[varIndex]->m_variantStatus = eCOMPLEX_SKIPPED;
         varIndex++;
         baseSkippedCount++;
     }
@@ -400,10 +887,18 @@ int CPathReplay::SkipVariantsTo(CPath& a_rPath, const SContig& a_rContig, int a_
     //CALLED SEMIPATH
     varIndex = a_rPath.m_calledSemiPath.GetVariantIndex();
     
-    while(varIndex < (int)m_aVariantListCalled.size() && (varIndex == -1  || m_aVariantListCalled[varIndex]->GetStart() < a_nMaxPos))
+    if(varIndex == -1)
+    {
+        if(!m_bHasPrecedingVariantsCalled && !m_aVariantListCalled.empty() && a_rPath.m_calledSemiPath.GetIncludedVariantEndPosition() < m_aVariantListCalled[0]->m_nStartPos)
+            m_aVariantListCalled[0]->m_variantStatus = eCOMPLEX_SKIPPED;
+        varIndex++;
+        calledSkippedCount++;
+    }
+    
+    while(varIndex < (int)m_aVariantListCalled.size() && m_aVariantListCalled[varIndex]->GetStart() < a_nMaxPos)
     {
-        if(a_rPath.m_calledSemiPath.GetIncludedVariantEndPosition() < m_aVariantListCalled[(varIndex >= 0 ? varIndex : 0)]->m_nStartPos)
-            m_aVariantListCalled[(varIndex >= 0 ? varIndex : 0)]->m_variantStatus = eCOMPLEX_SKIPPED;
+        if(a_rPath.m_calledSemiPath.GetIncludedVariantEndPosition() < m_aVariantListCalled[varIndex]->m_nStartPos)
+            m_aVariantListCalled[varIndex]->m_variantStatus = eCOMPLEX_SKIPPED;
         varIndex++;
         calledSkippedCount++;
     }
@@ -414,6 +909,132 @@ int CPathReplay::SkipVariantsTo(CPath& a_rPath, const SContig& a_rContig, int a_
     return calledSkippedCount + baseSkippedCount;
 }
 
+int CPathReplay::StepPath(CPath& a_rPath, const SContig& a_rContig, int a_nMaxPopCount, int& a_rMaxProcessedPosition, bool& a_rIsMatching)
+{
+    const CPath* pNextPath = m_pathList.Empty() ? NULL : m_pathList.PeekLeastAdvanced().m_pPath;
+    int popCount = 0;
+    
+    while(true)
+    {
+        a_rPath.Step();
+        
+        if(a_rPath.InSync())
+        {
+            SkipToNextVariant(a_rPath, a_rContig);
+            a_rIsMatching = a_rPath.Matches();
+            return popCount;
+        }
+        
+        if(!a_rPath.Matches())
+        {
+            a_rIsMatching = false;
+            return popCount;
+        }
+        
+        a_rIsMatching = true;
+        
+        //The replay loop would pop the path again only if it is still the least advanced one
+        if(popCount >= a_nMaxPopCount || (pNextPath != NULL && !(a_rPath < *pNextPath)))
+            return popCount;
+        
+        if(a_rPath.HasFinished() || GetNextVariant(a_rPath.m_calledSemiPath) != -1 || GetNextVariant(a_rPath.m_baseSemiPath) != -1)
+            return popCount;
+        
+        popCount++;
+        
+        //Plain steps. The path should stay ahead of the next path of the list (paths are ordered by called haplotype A first)
+        int maxStepCount = std::min(a_nMaxPopCount - popCount, GetStepCountToNextVariant(a_rPath));
+        if(pNextPath != NULL)
+            maxStepCount = std::min(maxStepCount, pNextPath->m_calledSemiPath.GetHaplotype(true).GetTemplatePosition() - a_rPath.m_calledSemiPath.GetHaplotype(true).GetTemplatePosition() - 1);
+        popCount += a_rPath.StepPlain(maxStepCount);
+        
+        if(!IsAllVariantsProcessed(a_rPath))
+            a_rMaxProcessedPosition = std::max(a_rMaxProcessedPosition, std::max(a_rPath.m_calledSemiPath.GetPosition(), a_rPath.m_baseSemiPath.GetPosition()));
+    }
+}
+
+int CPathReplay::GetStepCountToNextVariant(const CPath& a_rPath) const
+{
+    int stepCount = INT_MAX;
+    const CSemiPath* semiPaths[2] = {&a_rPath.m_calledSemiPath, &a_rPath.m_baseSemiPath};
+    
+    for(int k = 0; k < 2; k++)
+    {
+        const std::vector<const CVariant*>& variantList = k == 0 ? m_aVariantListCalled : m_aVariantListBase;
+        const int nextIndex = semiPaths[k]->GetVariantIndex() + 1;
+        
+        //Variant is enqueued once the position of the semipath is just before its start
+        if(nextIndex < (int)variantList.size())
+            stepCount = std::min(stepCount, variantList[nextIndex]->GetStart() - 2 - semiPaths[k]->GetPosition());
+    }
+    
+    return stepCount;
+}
+
+bool CPathReplay::IsTrivialVariantPair(const CPath& a_rPath, const SContig& a_rContig) const
+{
+    const int baseIndex = a_rPath.m_baseSemiPath.GetVariantIndex() + 1;
+    const int calledIndex = a_rPath.m_calledSemiPath.GetVariantIndex() + 1;
+    
+    if(baseIndex >= (int)m_aVariantListBase.size() || calledIndex >= (int)m_aVariantListCalled.size())
+        return false;
+    
+    const CVariant& baseVariant = *m_aVariantListBase[baseIndex];
+    const CVariant& calledVariant = *m_aVariantListCalled[calledIndex];
+    
+    //Both variants should be enqueued at the next step of the path
+    if(!a_rPath.InSync() || a_rPath.m_calledSemiPath.GetPosition() + 1 != calledVariant.GetStart())
+        return false;
+    if(a_rPath.m_baseSemiPath.GetIncludedVariantEndPosition() > baseVariant.GetStart() || a_rPath.m_calledSemiPath.GetIncludedVariantEndPosition() > calledVariant.GetStart())
+        return false;
+    
+    //Substitutions of different alleles diverge within the variant, so the alternative paths cannot outlive the pair
+    if(!IsIdenticalVariant(baseVariant, calledVariant) || !IsSubstitution(baseVariant))
+        return false;
+    
+    //Phased variants may have to follow the unordered orientation of their phase set
+    if(baseVariant.m_nPhaseSet != -1 || calledVariant.m_nPhaseSet != -1)
+        return false;
+    
+    //Next variants (and the contig end) should not be reached before the paths of the pair are merged again
+    const int isolationEnd = baseVariant.GetEnd() + 1;
+    if(a_rContig.m_nRefLength - 1 <= isolationEnd + 1)
+        return false;
+    
+    const int nextCalledStart = calledIndex + 1 < (int)m_aVariantListCalled.size() ? m_aVariantListCalled[calledIndex + 1]->GetStart() : INT_MAX;
+    const int nextBaseStart = baseIndex + 1 < (int)m_aVariantListBase.size() ? m_aVariantListBase[baseIndex + 1]->GetStart() : INT_MAX;
+    return std::min(nextCalledStart, nextBaseStart) > isolationEnd;
+}
+
+bool CPathReplay::PlayTrivialVariantPair(CPath& a_rPath, const SContig& a_rContig)
+{
+    const int baseIndex = a_rPath.m_baseSemiPath.GetVariantIndex() + 1;
+    const int calledIndex = a_rPath.m_calledSemiPath.GetVariantIndex() + 1;
+    
+    m_nCurrentPosition = std::max(m_nCurrentPosition, m_aVariantListCalled[calledIndex]->GetStart());
+    
+    //Same decisions as the surviving branch of AddVariant: sync point is pushed by the called side only
+    a_rPath.m_nCSinceSync = 0;
+    a_rPath.m_nBSinceSync = 0;
+    a_rPath.PushSyncPoint(a_rPath.m_calledSemiPath.GetPosition() + 1);
+    a_rPath.Include(eCALLED, *m_aOrientedVariantListCalled[2 * calledIndex], calledIndex);
+    a_rPath.Include(eBASE, *m_aOrientedVariantListBase[2 * baseIndex], baseIndex);
+    
+    while(true)
+    {
+        a_rPath.Step();
+        
+        if(a_rPath.InSync())
+        {
+            SkipToNextVariant(a_rPath, a_rContig);
+            return a_rPath.Matches();
+        }
+        
+        if(!a_rPath.Matches())
+            return false;
+    }
+}
+
 void CPathReplay::Clear()
 {
     m_pathList.Clear();
@@ -430,3 +1051,192 @@ void CPathReplay::Clear()
 
 
 
+
+bool CPathReplay::GetCachedRegion(const CPath& a_rSyncPath, const SContig& a_rContig, bool a_bIsGenotypeMatch, SCachedRegion& a_rRegion) const
+{
+    const int baseCount = (int)m_aVariantListBase.size();
+    const int calledCount = (int)m_aVariantListCalled.size();
+    int baseIndex = a_rSyncPath.m_baseSemiPath.GetVariantIndex() + 1;
+    int calledIndex = a_rSyncPath.m_calledSemiPath.GetVariantIndex() + 1;
+    int startPosition = INT_MAX;
+    int endPosition = INT_MIN;
+    int alleleSpan = 0;
+    
+    a_rRegion.m_nBaseStart = baseIndex;
+    a_rRegion.m_nCalledStart = calledIndex;
+    
+    //Cluster is the chain of overlapping variants (same as EstimateRegion)
+    while(baseIndex < baseCount || calledIndex < calledCount)
+    {
+        const bool isBase = calledIndex == calledCount || (baseIndex < baseCount && m_aVariantListBase[baseIndex]->GetStart() <= m_aVariantListCalled[calledIndex]->GetStart());
+        const CVariant* pVariant = isBase ? m_aVariantListBase[baseIndex] : m_aVariantListCalled[calledIndex];
+        
+        if(startPosition != INT_MAX && pVariant->GetStart() > endPosition)
+            break;
+        
+        //Decisions of phased variants depend on the phase state of the path before the cluster
+        if(pVariant->m_nPhaseSet != -1)
+            return false;
+        
+        int alleleLength = pVariant->GetEnd() - pVariant->GetStart();
+        for(int k = 0; k < pVariant->m_nAlleleCount; k++)
+            alleleLength = std::max(alleleLength, pVariant->GetAlleleLength(k));
+        
+        alleleSpan += alleleLength;
+        startPosition = std::min(startPosition, pVariant->GetStart());
+        endPosition = std::max(endPosition, pVariant->GetEnd());
+        isBase ? baseIndex++ : calledIndex++;
+    }
+    
+    a_rRegion.m_nBaseEnd = baseIndex - 1;
+    a_rRegion.m_nCalledEnd = calledIndex - 1;
+    
+    const int variantCount = (baseIndex - a_rRegion.m_nBaseStart) + (calledIndex - a_rRegion.m_nCalledStart);
+    if(variantCount < REPLAY_CACHE_MIN_VARIANT_COUNT || a_rSyncPath.m_calledSemiPath.GetPosition() >= startPosition)
+        return false;
+    
+    //Replay of the cluster stops at the variants following it. Last cluster of the contig also depends on the contig end
+    const int nextBaseStart = baseIndex < baseCount ? m_aVariantListBase[baseIndex]->GetStart() : INT_MAX;
+    const int nextCalledStart = calledIndex < calledCount ? m_aVariantListCalled[calledIndex]->GetStart() : INT_MAX;
+    const int nextStart = std::min(nextBaseStart, nextCalledStart);
+    if(nextStart >= a_rContig.m_nRefLength - 1 || nextStart - startPosition > REPLAY_CACHE_MAX_REGION_LENGTH)
+        return false;
+    
+    //Semipaths that are out of sync can read the reference beyond the next variant start by the length difference of their alleles
+    const int referenceEnd = std::min(a_rContig.m_nRefLength, nextStart + alleleSpan + 2);
+    
+    SReplayCacheKey& key = a_rRegion.m_key;
+    key.m_nHash1 = 0x5642545245504c31ULL;
+    key.m_nHash2 = 0x5642545245504c32ULL;
+    CombineCacheKey(key, a_bIsGenotypeMatch ? 1 : 0);
+    CombineCacheKey(key, static_cast<uint64_t>(a_rRegion.m_nBaseEnd - a_rRegion.m_nBaseStart));
+    CombineCacheKey(key, static_cast<uint64_t>(a_rRegion.m_nCalledEnd - a_rRegion.m_nCalledStart));
+    for(int k = a_rRegion.m_nBaseStart; k <= a_rRegion.m_nBaseEnd; k++)
+        CombineCacheKeyVariant(key, *m_aVariantListBase[k], startPosition);
+    for(int k = a_rRegion.m_nCalledStart; k <= a_rRegion.m_nCalledEnd; k++)
+        CombineCacheKeyVariant(key, *m_aVariantListCalled[k], startPosition);
+    CombineCacheKey(key, static_cast<uint64_t>(nextBaseStart == INT_MAX ? -1 : nextBaseStart - startPosition));
+    CombineCacheKey(key, static_cast<uint64_t>(nextCalledStart == INT_MAX ? -1 : nextCalledStart - startPosition));
+    CombineCacheKeySequence(key, a_rContig.m_pRefSeq + startPosition, referenceEnd - startPosition);
+    
+    return true;
+}
+
+bool CPathReplay::GetRegionDecisions(const CPath& a_rSyncPath, const SCachedRegion& a_rRegion, std::vector<uint8_t>& a_rDecisions) const
+{
+    const int baseRegionCount = a_rRegion.m_nBaseEnd - a_rRegion.m_nBaseStart + 1;
+    const int calledRegionCount = a_rRegion.m_nCalledEnd - a_rRegion.m_nCalledStart + 1;
+    const uint8_t undecided = 0xFF;
+    a_rDecisions.assign(baseRegionCount + calledRegionCount, undecided);
+    
+    for(int side = 0; side < 2; side++)
+    {
+        const bool isBase = side == 0;
+        const std::vector<const COrientedVariant*>& flushedIncluded = isBase ? m_IncludedVariantsBaselineBest : m_IncludedVariantsCalledBest;
+        const std::vector<int>& flushedExcluded = isBase ? m_ExcludedVariantsBaselineBest : m_ExcludedVariantsCalledBest;
+        const std::vector<const COrientedVariant*>& orientedVariants = isBase ? m_aOrientedVariantListBase : m_aOrientedVariantListCalled;
+        const int regionStart = isBase ? a_rRegion.m_nBaseStart : a_rRegion.m_nCalledStart;
+        const int regionEnd = isBase ? a_rRegion.m_nBaseEnd : a_rRegion.m_nCalledEnd;
+        const int decisionOffset = isBase ? 0 : baseRegionCount;
+        
+        //Decisions made since the cluster started are either flushed at a sync point inside the cluster or still pending in the path
+        std::vector<const COrientedVariant*> included(flushedIncluded.begin() + (isBase ? a_rRegion.m_nFlushedIncludedBase : a_rRegion.m_nFlushedIncludedCalled), flushedIncluded.end());
+        std::vector<int> excluded(flushedExcluded.begin() + (isBase ? a_rRegion.m_nFlushedExcludedBase : a_rRegion.m_nFlushedExcludedCalled), flushedExcluded.end());
+        (isBase ? a_rSyncPath.m_baseSemiPath : a_rSyncPath.m_calledSemiPath).AppendPendingVariants(included, excluded);
+        
+        for(unsigned int k = 0; k < excluded.size(); k++)
+        {
+            if(excluded[k] > regionEnd)
+                return false;
+            if(excluded[k] >= regionStart)
+                a_rDecisions[decisionOffset + excluded[k] - regionStart] = eREPLAY_EXCLUDED;
+        }
+        
+        //Included variants are in variant index order
+        int variantIndex = regionStart;
+        for(unsigned int k = 0; k < included.size(); k++)
+        {
+            while(variantIndex <= regionEnd && included[k] != orientedVariants[2 * variantIndex] && included[k] != orientedVariants[2 * variantIndex + 1])
+                variantIndex++;
+            
+            if(variantIndex > regionEnd)
+                return false;
+            
+            a_rDecisions[decisionOffset + variantIndex - regionStart] = included[k] == orientedVariants[2 * variantIndex] ? eREPLAY_INCLUDED_FIRST : eREPLAY_INCLUDED_SECOND;
+        }
+    }
+    
+    return std::find(a_rDecisions.begin(), a_rDecisions.end(), undecided) == a_rDecisions.end();
+}
+
+bool CPathReplay::PlayCachedRegion(CPath& a_rPath, const SContig& a_rContig, const SCachedRegion& a_rRegion, const std::vector<uint8_t>& a_rDecisions, bool a_bIsGenotypeMatch)
+{
+    const int baseRegionCount = a_rRegion.m_nBaseEnd - a_rRegion.m_nBaseStart + 1;
+    if((int)a_rDecisions.size() != baseRegionCount + a_rRegion.m_nCalledEnd - a_rRegion.m_nCalledStart + 1)
+        return false;
+    
+    while(!a_rPath.HasFinished())
+    {
+        //Variants are added in the same order as the replay loop: called side first
+        EVcfName side = eCALLED;
+        int variantIndex = GetNextVariant(a_rPath.m_calledSemiPath);
+        if(variantIndex == -1)
+        {
+            side = eBASE;
+            variantIndex = GetNextVariant(a_rPath.m_baseSemiPath);
+        }
+        
+        if(variantIndex != -1)
+        {
+            const bool isBase = side == eBASE;
+            if(variantIndex > (isBase ? a_rRegion.m_nBaseEnd : a_rRegion.m_nCalledEnd))
+                return false;
+            
+            const uint8_t decision = a_rDecisions[(isBase ? 0 : baseRegionCount) + variantIndex - (isBase ? a_rRegion.m_nBaseStart : a_rRegion.m_nCalledStart)];
+            const CVariant& variant = *(isBase ? m_aVariantListBase : m_aVariantListCalled)[variantIndex];
+            m_nCurrentPosition = std::max(m_nCurrentPosition, variant.GetStart());
+            
+            //Same sync point and counter updates as the branch of CPath::AddVariant with the given decision
+            const bool isInSync = a_rPath.InSync();
+            if(isInSync)
+            {
+                a_rPath.m_nCSinceSync = 0;
+                a_rPath.m_nBSinceSync = 0;
+            }
+            
+            if(decision == eREPLAY_EXCLUDED)
+            {
+                if(isInSync || !a_bIsGenotypeMatch)
+                    a_rPath.PushSyncPoint(a_rPath.m_calledSemiPath.GetPosition() + 1);
+                a_rPath.Exclude(side, variant, variantIndex);
+            }
+            else
+            {
+                const COrientedVariant& orientedVariant = *(isBase ? m_aOrientedVariantListBase : m_aOrientedVariantListCalled)[2 * variantIndex + (decision == eREPLAY_INCLUDED_FIRST ? 0 : 1)];
+                if(!(isBase ? a_rPath.m_baseSemiPath : a_rPath.m_calledSemiPath).IsNew(orientedVariant))
+                    return false;
+                if(isInSync)
+                    a_rPath.PushSyncPoint(a_rPath.m_calledSemiPath.GetPosition() + 1);
+                a_rPath.Include(side, orientedVariant, variantIndex);
+            }
+            continue;
+        }
+        
+        a_rPath.Step();
+        
+        if(a_rPath.InSync())
+        {
+            SkipToNextVariant(a_rPath, a_rContig);
+            if(!a_rPath.Matches())
+                return false;
+            
+            //Full replay reaches the variants following the cluster with this path
+            if(a_rPath.m_baseSemiPath.GetVariantIndex() == a_rRegion.m_nBaseEnd && a_rPath.m_calledSemiPath.GetVariantIndex() == a_rRegion.m_nCalledEnd)
+                return true;
+        }
+        else if(!a_rPath.Matches())
+            return false;
+    }
+    
+    return false;
+}
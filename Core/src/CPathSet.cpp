@@ -25,81 +25,202 @@
 
 #include "CPathSet.h"
 #include <iostream>
+#include <cassert>
 
 using namespace core;
 
+//Initial size of the hash table (should be power of 2)
+static const int INITIAL_TABLE_SIZE = 64;
+
 CPathSet::CPathSet()
 {
+    m_nSize = 0;
+    STableEntry empty = {0, -1};
+    m_aTable.assign(INITIAL_TABLE_SIZE, empty);
 }
 
 int CPathSet::Size() const
 {
-    return (int)(m_set.size());
+    return m_nSize;
 }
 
 void CPathSet::Clear()
 {
-    m_set.clear();
+    for(int k = 0; k < m_nSize; k++)
+    {
+        m_aTable[m_aHeap[k].m_nTableSlot].m_nHeapIndex = -1;
+        m_aHeap[k].m_path = CPathContainer();
+    }
+    m_nSize = 0;
 }
 
-void CPathSet::Add(const CPathContainer& item)
+void CPathSet::Add(const CPathContainer& a_rItem, uint64_t a_nHash)
 {
-    m_set.insert(item);
+    //Keep the load factor of the table below 0.5
+    if(2 * (m_nSize + 1) > (int)m_aTable.size())
+        GrowTable();
+    
+    if(m_nSize == (int)m_aHeap.size())
+        m_aHeap.push_back(SHeapEntry());
+    
+    m_aHeap[m_nSize].m_path = a_rItem;
+    m_aHeap[m_nSize].m_nHash = a_nHash;
+    InsertToTable(m_nSize);
+    m_nSize++;
+    SiftUp(m_nSize - 1);
 }
 
-void CPathSet::Erase(const CPathContainer& item)
+CPathContainer* CPathSet::Find(const CPathContainer& a_rItem, uint64_t a_nHash)
 {
-    m_set.erase(item);
+    const int mask = (int)m_aTable.size() - 1;
+    
+    for(int slot = (int)(a_nHash & mask); m_aTable[slot].m_nHeapIndex != -1; slot = (slot + 1) & mask)
+    {
+        if(m_aTable[slot].m_nHash == a_nHash && m_aHeap[m_aTable[slot].m_nHeapIndex].m_path.m_pPath->CompareTo(*a_rItem.m_pPath) == 0)
+            return &m_aHeap[m_aTable[slot].m_nHeapIndex].m_path;
+    }
+    
+    return NULL;
 }
 
 // Get the least advanced path
-void CPathSet::GetLeastAdvanced(CPathContainer& item)
+void CPathSet::GetLeastAdvanced(CPathContainer& a_rItem)
 {
-    item = *m_set.begin();
-    m_set.erase(m_set.begin());
+    assert(m_nSize > 0);
+    
+    a_rItem = m_aHeap[0].m_path;
+    RemoveFromTable(m_aHeap[0].m_nTableSlot);
+    
+    m_nSize--;
+    if(m_nSize > 0)
+    {
+        SwapEntries(0, m_nSize);
+        SiftDown(0);
+    }
+    m_aHeap[m_nSize].m_path = CPathContainer();
 }
 
 bool CPathSet::Empty()
 {
-    return m_set.empty();
+    return m_nSize == 0;
 }
 
-bool CPathSet::Contains(const CPathContainer& item) const
+bool CPathSet::Contains(const CPathContainer& a_rItem) const
 {
-    std::set<CPathContainer>::iterator it;
-    
-    for(it = m_set.begin(); it != m_set.end(); ++it)
+    for(int k = 0; k < m_nSize; k++)
     {
-        if(it->m_pPath->IsEqual(*item.m_pPath))
+        if(m_aHeap[k].m_path.m_pPath->IsEqual(*a_rItem.m_pPath))
             return true;
     }
     
     return false;
 }
 
-CPathContainer CPathSet::floor(const CPathContainer& a_rObj)
+const CPathContainer& CPathSet::PeekLeastAdvanced() const
+{
+    assert(m_nSize > 0);
+    return m_aHeap[0].m_path;
+}
+
+bool CPathSet::IsLess(int a_nLhsIndex, int a_nRhsIndex) const
+{
+    return m_aHeap[a_nLhsIndex].m_path < m_aHeap[a_nRhsIndex].m_path;
+}
+
+void CPathSet::SwapEntries(int a_nIndex1, int a_nIndex2)
 {
-    return *m_set.lower_bound(a_rObj);
+    std::swap(m_aHeap[a_nIndex1].m_path.m_pPath, m_aHeap[a_nIndex2].m_path.m_pPath);
+    std::swap(m_aHeap[a_nIndex1].m_nHash, m_aHeap[a_nIndex2].m_nHash);
+    std::swap(m_aHeap[a_nIndex1].m_nTableSlot, m_aHeap[a_nIndex2].m_nTableSlot);
+    
+    if(a_nIndex1 < m_nSize)
+        m_aTable[m_aHeap[a_nIndex1].m_nTableSlot].m_nHeapIndex = a_nIndex1;
+    if(a_nIndex2 < m_nSize)
+        m_aTable[m_aHeap[a_nIndex2].m_nTableSlot].m_nHeapIndex = a_nIndex2;
+}
+
+void CPathSet::SiftUp(int a_nIndex)
+{
+    while(a_nIndex > 0)
+    {
+        int parent = (a_nIndex - 1) / 2;
+        if(!IsLess(a_nIndex, parent))
+            break;
+        SwapEntries(a_nIndex, parent);
+        a_nIndex = parent;
+    }
+}
+
+void CPathSet::SiftDown(int a_nIndex)
+{
+    while(true)
+    {
+        int smallest = a_nIndex;
+        int left = 2 * a_nIndex + 1;
+        int right = left + 1;
+        
+        if(left < m_nSize && IsLess(left, smallest))
+            smallest = left;
+        if(right < m_nSize && IsLess(right, smallest))
+            smallest = right;
+        if(smallest == a_nIndex)
+            break;
+        
+        SwapEntries(a_nIndex, smallest);
+        a_nIndex = smallest;
+    }
 }
 
-std::set<CPathContainer>::iterator CPathSet::Find(const CPathContainer& item)
+void CPathSet::InsertToTable(int a_nHeapIndex)
 {
-    return m_set.find(item);
+    const int mask = (int)m_aTable.size() - 1;
+    int slot = (int)(m_aHeap[a_nHeapIndex].m_nHash & mask);
+    
+    while(m_aTable[slot].m_nHeapIndex != -1)
+        slot = (slot + 1) & mask;
+    
+    m_aTable[slot].m_nHash = m_aHeap[a_nHeapIndex].m_nHash;
+    m_aTable[slot].m_nHeapIndex = a_nHeapIndex;
+    m_aHeap[a_nHeapIndex].m_nTableSlot = slot;
 }
 
-std::set<CPathContainer>::iterator CPathSet::End() const
+void CPathSet::RemoveFromTable(int a_nSlot)
 {
-    return m_set.end();
+    const int mask = (int)m_aTable.size() - 1;
+    int hole = a_nSlot;
+    
+    //Shift back the following entries of the probe sequence which would become unreachable
+    for(int slot = (hole + 1) & mask; m_aTable[slot].m_nHeapIndex != -1; slot = (slot + 1) & mask)
+    {
+        int home = (int)(m_aTable[slot].m_nHash & mask);
+        bool isReachable = (hole <= slot) ? (hole < home && home <= slot) : (hole < home || home <= slot);
+        
+        if(!isReachable)
+        {
+            m_aTable[hole] = m_aTable[slot];
+            m_aHeap[m_aTable[hole].m_nHeapIndex].m_nTableSlot = hole;
+            hole = slot;
+        }
+    }
+    
+    m_aTable[hole].m_nHeapIndex = -1;
 }
 
+void CPathSet::GrowTable()
+{
+    STableEntry empty = {0, -1};
+    m_aTable.assign(m_aTable.size() * 2, empty);
+    
+    for(int k = 0; k < m_nSize; k++)
+        InsertToTable(k);
+}
 
 void CPathSet::Print() const
 {
-    std::set<CPathContainer>::iterator it;
     std::cout << "Paths:";
-    for(it = m_set.begin(); it != m_set.end(); ++it)
+    for(int k = 0; k < m_nSize; k++)
     {
-        std::cout << it->m_pPath->m_nPathId << " ";
+        std::cout << m_aHeap[k].m_path.m_pPath->m_nPathId << " ";
     }
     std::cout << std::endl;
 }
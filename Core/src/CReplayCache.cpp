@@ -0,0 +1,273 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CReplayCache.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CReplayCache.h"
+#include "Constants.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace core;
+
+//Magic of the cache file. Last characters are the version of the file format
+static const char REPLAY_CACHE_MAGIC[8] = {'V', 'B', 'T', 'R', 'C', '0', '0', '1'};
+
+CReplayCache::CReplayCache()
+: m_nSettingsHash(0),
+  m_bIsOpen(false),
+  m_pMappedFile(NULL),
+  m_nMappedSize(0),
+  m_pEntries(NULL),
+  m_nEntryCount(0),
+  m_pDecisions(NULL),
+  m_nHitCount(0),
+  m_nMissCount(0),
+  m_nInsertCount(0)
+{
+}
+
+CReplayCache::~CReplayCache()
+{
+    Close();
+}
+
+bool CReplayCache::Open(const std::string& a_rDirectory, uint64_t a_nSettingsHash)
+{
+    Close();
+
+    if(0 != mkdir(a_rDirectory.c_str(), 0755) && errno != EEXIST)
+    {
+        std::cerr << "Replay cache directory " << a_rDirectory << " cannot be created" << std::endl;
+        return false;
+    }
+
+    m_filePath = a_rDirectory + "/" + REPLAY_CACHE_FILE_NAME;
+    m_nSettingsHash = a_nSettingsHash;
+    m_bIsOpen = true;
+
+    int fileDescriptor = open(m_filePath.c_str(), O_RDONLY);
+    if(fileDescriptor < 0)
+        return true;
+
+    struct stat fileStat;
+    if(0 != fstat(fileDescriptor, &fileStat) || fileStat.st_size < (off_t)sizeof(SFileHeader))
+    {
+        close(fileDescriptor);
+        std::cerr << "Replay cache file " << m_filePath << " is invalid. Starting with an empty cache" << std::endl;
+        return true;
+    }
+
+    void* pMappedFile = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    close(fileDescriptor);
+
+    if(pMappedFile == MAP_FAILED)
+    {
+        std::cerr << "Replay cache file " << m_filePath << " cannot be mapped. Starting with an empty cache" << std::endl;
+        return true;
+    }
+
+    m_pMappedFile = pMappedFile;
+    m_nMappedSize = (size_t)fileStat.st_size;
+
+    const SFileHeader* pHeader = static_cast<const SFileHeader*>(m_pMappedFile);
+    const uint64_t expectedSize = sizeof(SFileHeader) + pHeader->m_nEntryCount * sizeof(SFileEntry) + pHeader->m_nDecisionSize;
+
+    if(0 != memcmp(pHeader->m_aMagic, REPLAY_CACHE_MAGIC, sizeof(REPLAY_CACHE_MAGIC)) || pHeader->m_nSettingsHash != m_nSettingsHash)
+    {
+        std::cerr << "Replay cache file " << m_filePath << " is created with different settings. Starting with an empty cache" << std::endl;
+        Close();
+        m_bIsOpen = true;
+        return true;
+    }
+
+    if(expectedSize != m_nMappedSize)
+    {
+        std::cerr << "Replay cache file " << m_filePath << " is invalid. Starting with an empty cache" << std::endl;
+        Close();
+        m_bIsOpen = true;
+        return true;
+    }
+
+    m_nEntryCount = pHeader->m_nEntryCount;
+    m_pEntries = reinterpret_cast<const SFileEntry*>(static_cast<const char*>(m_pMappedFile) + sizeof(SFileHeader));
+    m_pDecisions = reinterpret_cast<const uint8_t*>(m_pEntries + m_nEntryCount);
+
+    std::cerr << "Replay cache " << m_filePath << " is loaded with " << m_nEntryCount << " regions" << std::endl;
+    return true;
+}
+
+bool CReplayCache::IsOpen() const
+{
+    return m_bIsOpen;
+}
+
+void CReplayCache::Close()
+{
+    if(m_pMappedFile != NULL)
+        munmap(m_pMappedFile, m_nMappedSize);
+
+    m_pMappedFile = NULL;
+    m_nMappedSize = 0;
+    m_pEntries = NULL;
+    m_nEntryCount = 0;
+    m_pDecisions = NULL;
+    m_bIsOpen = false;
+}
+
+bool CReplayCache::Find(const SReplayCacheKey& a_rKey, std::vector<uint8_t>& a_rDecisions)
+{
+    //Mapped entries are read only, they are searched without locking
+    uint64_t low = 0;
+    uint64_t high = m_nEntryCount;
+    while(low < high)
+    {
+        const uint64_t mid = low + (high - low) / 2;
+        const SFileEntry& entry = m_pEntries[mid];
+
+        if(entry.m_nHash1 < a_rKey.m_nHash1 || (entry.m_nHash1 == a_rKey.m_nHash1 && entry.m_nHash2 < a_rKey.m_nHash2))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if(low < m_nEntryCount && m_pEntries[low].m_nHash1 == a_rKey.m_nHash1 && m_pEntries[low].m_nHash2 == a_rKey.m_nHash2)
+    {
+        const uint8_t* pDecisions = m_pDecisions + m_pEntries[low].m_nDecisionOffset;
+        a_rDecisions.assign(pDecisions, pDecisions + m_pEntries[low].m_nDecisionCount);
+        m_nHitCount++;
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_newEntryMutex);
+        std::map<std::pair<uint64_t, uint64_t>, std::vector<uint8_t>>::const_iterator it = m_aNewEntries.find(std::make_pair(a_rKey.m_nHash1, a_rKey.m_nHash2));
+        if(it != m_aNewEntries.end())
+        {
+            a_rDecisions = it->second;
+            m_nHitCount++;
+            return true;
+        }
+    }
+
+    m_nMissCount++;
+    return false;
+}
+
+void CReplayCache::Insert(const SReplayCacheKey& a_rKey, const std::vector<uint8_t>& a_rDecisions)
+{
+    std::lock_guard<std::mutex> lock(m_newEntryMutex);
+    if(m_aNewEntries.insert(std::make_pair(std::make_pair(a_rKey.m_nHash1, a_rKey.m_nHash2), a_rDecisions)).second)
+        m_nInsertCount++;
+}
+
+bool CReplayCache::Save()
+{
+    if(!m_bIsOpen)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_newEntryMutex);
+
+    if(m_aNewEntries.empty())
+        return true;
+
+    //Merge the mapped entries and the new entries, both are sorted by key
+    std::vector<SFileEntry> entries;
+    std::vector<uint8_t> decisions;
+    entries.reserve(m_nEntryCount + m_aNewEntries.size());
+
+    uint64_t mappedIndex = 0;
+    std::map<std::pair<uint64_t, uint64_t>, std::vector<uint8_t>>::const_iterator it = m_aNewEntries.begin();
+
+    while(mappedIndex < m_nEntryCount || it != m_aNewEntries.end())
+    {
+        SFileEntry entry;
+        const uint8_t* pDecisions;
+
+        const bool isMapped = it == m_aNewEntries.end()
+                              || (mappedIndex < m_nEntryCount && std::make_pair(m_pEntries[mappedIndex].m_nHash1, m_pEntries[mappedIndex].m_nHash2) < it->first);
+
+        if(isMapped)
+        {
+            entry = m_pEntries[mappedIndex];
+            pDecisions = m_pDecisions + entry.m_nDecisionOffset;
+            mappedIndex++;
+        }
+        else
+        {
+            entry.m_nHash1 = it->first.first;
+            entry.m_nHash2 = it->first.second;
+            entry.m_nDecisionCount = it->second.size();
+            pDecisions = it->second.data();
+            ++it;
+        }
+
+        entry.m_nDecisionOffset = decisions.size();
+        decisions.insert(decisions.end(), pDecisions, pDecisions + entry.m_nDecisionCount);
+        entries.push_back(entry);
+    }
+
+    SFileHeader header;
+    memcpy(header.m_aMagic, REPLAY_CACHE_MAGIC, sizeof(REPLAY_CACHE_MAGIC));
+    header.m_nSettingsHash = m_nSettingsHash;
+    header.m_nEntryCount = entries.size();
+    header.m_nDecisionSize = decisions.size();
+
+    //Write to a temporary file and replace the cache at once, so that a concurrent run never maps a partially written file
+    const std::string temporaryPath = m_filePath + ".tmp." + std::to_string(getpid());
+    std::ofstream outputFile(temporaryPath.c_str(), std::ios::binary | std::ios::trunc);
+    outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outputFile.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SFileEntry));
+    outputFile.write(reinterpret_cast<const char*>(decisions.data()), decisions.size());
+    outputFile.close();
+
+    if(!outputFile || 0 != rename(temporaryPath.c_str(), m_filePath.c_str()))
+    {
+        std::cerr << "Replay cache file " << m_filePath << " cannot be written" << std::endl;
+        remove(temporaryPath.c_str());
+        return false;
+    }
+
+    std::cerr << "Replay cache " << m_filePath << " is saved with " << entries.size() << " regions" << std::endl;
+    return true;
+}
+
+int CReplayCache::GetHitCount() const
+{
+    return m_nHitCount;
+}
+
+int CReplayCache::GetMissCount() const
+{
+    return m_nMissCount;
+}
+
+int CReplayCache::GetInsertCount() const
+{
+    return m_nInsertCount;
+}
@@ -0,0 +1,102 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CReplayStats.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CReplayStats.h"
+#include <iostream>
+#include <cstdio>
+
+using namespace core;
+
+namespace
+{
+
+const char* GetOutcomeName(EReplayRegionOutcome a_outcome)
+{
+    switch(a_outcome)
+    {
+        case eREGION_SKIPPED:
+            return "skipped";
+        case eREGION_FALLBACK:
+            return "fallback";
+        default:
+            return "resolved";
+    }
+}
+
+}
+
+bool CReplayStats::Open(const std::string& a_rFilePath)
+{
+    m_file.open(a_rFilePath.c_str());
+    if(!m_file.is_open())
+    {
+        std::cerr << "Replay statistics file " << a_rFilePath << " cannot be opened" << std::endl;
+        return false;
+    }
+
+    m_file << "chrom\tstart\tend\tcomparison\tmatch\tbase_variants\tcalled_variants\tpeak_paths\titerations\ttime_us\toutcome" << std::endl;
+    return true;
+}
+
+bool CReplayStats::IsOpen() const
+{
+    return m_file.is_open();
+}
+
+void CReplayStats::Close()
+{
+    if(m_file.is_open())
+        m_file.close();
+}
+
+void CReplayStats::Write(const std::string& a_rChromosome, const std::string& a_rComparison, bool a_bIsGenotypeMatch, const std::vector<SReplayRegionStats>& a_rRegions)
+{
+    if(a_rRegions.empty())
+        return;
+
+    //Rows are formatted before taking the lock, other threads only wait for the file write
+    std::string rows;
+    char line[256];
+    const char* matchName = a_bIsGenotypeMatch ? "GT" : "AM";
+
+    for(unsigned int k = 0; k < a_rRegions.size(); k++)
+    {
+        const SReplayRegionStats& region = a_rRegions[k];
+        std::snprintf(line, sizeof(line), "\t%d\t%d\t%s\t%s\t%d\t%d\t%d\t%lld\t%.3f\t%s\n",
+                      region.m_nStartPosition + 1,
+                      region.m_nEndPosition,
+                      a_rComparison.c_str(),
+                      matchName,
+                      region.m_nBaseVariantCount,
+                      region.m_nCalledVariantCount,
+                      region.m_nPeakPathCount,
+                      region.m_nIterationCount,
+                      region.m_nElapsedNanoseconds / 1000.0,
+                      GetOutcomeName(region.m_outcome));
+        rows += a_rChromosome;
+        rows += line;
+    }
+
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    m_file << rows;
+}
@@ -48,6 +48,8 @@ CSemiPath::CSemiPath(const char* a_aRefSequence, int a_nRefSize, EVcfName a_uVcf
     m_nVariantIndex = -1;
     m_nIncludedVariantEndPosition = 0;
     m_nVariantEndPosition = 0;
+    m_nPhaseSet = -1;
+    m_bIsPhaseSwapped = false;
     m_bFinishedHapA = false;
     m_bFinishedHapB = false;   
 }
@@ -60,9 +62,12 @@ CSemiPath::CSemiPath(const CSemiPath& a_rObj)
     m_nVariantIndex = a_rObj.m_nVariantIndex;
     m_nIncludedVariantEndPosition = a_rObj.m_nIncludedVariantEndPosition;  
     m_nVariantEndPosition = a_rObj.m_nVariantEndPosition;
+    m_nPhaseSet = a_rObj.m_nPhaseSet;
+    m_bIsPhaseSwapped = a_rObj.m_bIsPhaseSwapped;
 
-    m_aIncludedVariants = std::vector<const COrientedVariant*>(a_rObj.m_aIncludedVariants);
-    m_aExcludedVariants = std::vector<int>(a_rObj.m_aExcludedVariants);
+    m_aPendingIncludedVariants = a_rObj.m_aPendingIncludedVariants;
+    m_aPendingExcludedVariants = a_rObj.m_aPendingExcludedVariants;
+    m_decisions = a_rObj.m_decisions;
 
     m_bFinishedHapA = a_rObj.m_bFinishedHapA;
     m_bFinishedHapB = a_rObj.m_bFinishedHapB;
@@ -77,7 +82,7 @@ void CSemiPath::IncludeVariant(const COrientedVariant& a_rVariant, int a_nVarian
 {
     assert(a_nVariantIndex > m_nVariantIndex);
 
-    m_aIncludedVariants.push_back(&a_rVariant);
+    m_aPendingIncludedVariants.PushBack(&a_rVariant);
     m_nVariantIndex = a_nVariantIndex;
     m_nVariantEndPosition = max(m_nVariantEndPosition, a_rVariant.GetVariant().GetEnd());
     m_nIncludedVariantEndPosition = std::max(m_nIncludedVariantEndPosition, a_rVariant.GetVariant().GetEnd());
@@ -90,7 +95,7 @@ void CSemiPath::ExcludeVariant(const CVariant& a_rVariant, int a_nVariantIndex)
 {
     assert(a_nVariantIndex > m_nVariantIndex);
 
-    m_aExcludedVariants.push_back(a_nVariantIndex);
+    m_aPendingExcludedVariants.PushBack(a_nVariantIndex);
     m_nVariantEndPosition = max(m_nVariantEndPosition, a_rVariant.GetEnd());
     m_nVariantIndex = a_nVariantIndex;
 }
@@ -101,11 +106,6 @@ int CSemiPath::CompareHaplotypePositions() const
 }
 
 
-const std::vector<int>& CSemiPath::GetExcluded() const
-{
-    return m_aExcludedVariants;
-}
-
 int CSemiPath::GetPosition() const
 {
     if (m_haplotypeA.GetTemplatePosition() > m_haplotypeB.GetTemplatePosition())
@@ -140,9 +140,20 @@ int CSemiPath::GetIncludedVariantEndPosition() const
     return m_nIncludedVariantEndPosition;
 }
 
-const std::vector<const COrientedVariant*>& CSemiPath::GetIncludedVariants() const
+const CDecisionArray& CSemiPath::GetDecisions() const
+{
+    return m_decisions;
+}
+
+int CSemiPath::GetPendingIncludedCount() const
+{
+    return m_aPendingIncludedVariants.Size();
+}
+
+void CSemiPath::AppendPendingVariants(std::vector<const COrientedVariant*>& a_rIncludedVarList, std::vector<int>& a_rExcludedVarList) const
 {
-    return m_aIncludedVariants;
+    m_aPendingIncludedVariants.AppendTo(a_rIncludedVarList);
+    m_aPendingExcludedVariants.AppendTo(a_rExcludedVarList);
 }
 
 int CSemiPath::CompareTo(const CSemiPath& a_rObj) const
@@ -156,9 +167,17 @@ int CSemiPath::CompareTo(const CSemiPath& a_rObj) const
 
 bool CSemiPath::IsEqual(const CSemiPath& a_rObj) const
 {
+    if(GetStateHash() != a_rObj.GetStateHash())
+        return false;
+    
     return (CompareTo(a_rObj) == 0);
 }
 
+uint64_t CSemiPath::GetStateHash() const
+{
+    return CombineHash(m_haplotypeA.GetStateHash(), m_haplotypeB.GetStateHash());
+}
+
 bool CSemiPath::HasFinished() const
 {
     return m_bFinishedHapA && m_bFinishedHapB;
@@ -231,38 +250,57 @@ void CSemiPath::StepHaplotypeB()
         m_bFinishedHapB = true;
 }
 
-void CSemiPath::ClearIncludedVariants()
+const CHaplotypeSequence& CSemiPath::GetHaplotype(bool a_bIsHaplotypeA) const
 {
-    m_aIncludedVariants.clear();
+    return a_bIsHaplotypeA ? m_haplotypeA : m_haplotypeB;
 }
 
-void CSemiPath::AddIncludedVariants(std::vector<const COrientedVariant*>& a_rIncludedVarList)
+void CSemiPath::PlainStepHaplotype(bool a_bIsHaplotypeA, int a_nStepCount)
 {
-    m_aIncludedVariants = a_rIncludedVarList;
+    if(a_bIsHaplotypeA)
+        m_haplotypeA.PlainStep(a_nStepCount);
+    else
+        m_haplotypeB.PlainStep(a_nStepCount);
 }
 
-void CSemiPath::ClearExcludedVariants()
+int CSemiPath::GetPhaseSet() const
+{
+    return m_nPhaseSet;
+}
+
+bool CSemiPath::IsPhaseSwapped() const
+{
+    return m_bIsPhaseSwapped;
+}
+
+void CSemiPath::SetPhase(int a_nPhaseSet, bool a_bIsSwapped)
 {
-    m_aExcludedVariants.clear();
+    m_nPhaseSet = a_nPhaseSet;
+    m_bIsPhaseSwapped = a_bIsSwapped;
 }
 
-void CSemiPath::AddExcludedVariants(std::vector<int> &a_rExcludedVarList)
+void CSemiPath::ClearIncludedVariants()
+{
+    m_aPendingIncludedVariants.Clear();
+}
+
+void CSemiPath::ClearExcludedVariants()
 {
-    m_aExcludedVariants = a_rExcludedVarList;
+    m_aPendingExcludedVariants.Clear();
 }
 
-void CSemiPath::SortIncludedVariants()
+void CSemiPath::SetDecisions(const CDecisionArray& a_rDecisions)
 {
-    std::sort(m_aIncludedVariants.begin(), m_aIncludedVariants.end(), [](const COrientedVariant* pOvar1, const COrientedVariant* pOvar2){return pOvar1->GetVariant().m_nId < pOvar2->GetVariant().m_nId;});
+    m_decisions = a_rDecisions;
 }
 
 void CSemiPath::Print() const
 {
     std::cout<< "Pos:" << GetPosition() << " VarEnd Pos:" << GetVariantEndPosition() << " VarEnd Ind:" << GetVariantIndex() << std::endl;
-    std::cout<< "Excluded Var Count:" << m_aExcludedVariants.size() << " Included Var Count:" << m_aIncludedVariants.size() << std::endl;
+    std::cout<< "Excluded Var Count:" << m_aPendingExcludedVariants.Size() + m_decisions.GetExcludedCount() << " Included Var Count:" << m_aPendingIncludedVariants.Size() + m_decisions.GetIncludedCount() << std::endl;
     
-    if(m_aIncludedVariants.size() > 0 && !m_aIncludedVariants.back()->IsNull())
-        m_aIncludedVariants.back()->Print();
+    if(!m_aPendingIncludedVariants.Empty() && !m_aPendingIncludedVariants.Back()->IsNull())
+        m_aPendingIncludedVariants.Back()->Print();
         
     std::cout<< "Haplotype A:" << std::endl;
     m_haplotypeA.Print();
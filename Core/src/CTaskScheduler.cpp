@@ -0,0 +1,269 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CTaskScheduler.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CTaskScheduler.h"
+#include "Constants.h"
+#include <fstream>
+#include <string>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace core;
+
+//Scheduler and worker index of the current thread (NULL and -1 outside of the worker threads)
+static thread_local CTaskScheduler* t_pCurrentScheduler = NULL;
+static thread_local int t_nWorkerIndex = -1;
+
+//Read the cpu limit of a cgroup from the given quota/period values. Returns 0 if there is no limit
+static int CpuLimitFromQuota(long long a_nQuota, long long a_nPeriod)
+{
+    if(a_nQuota <= 0 || a_nPeriod <= 0)
+        return 0;
+    return static_cast<int>(std::max(1LL, (a_nQuota + a_nPeriod - 1) / a_nPeriod));
+}
+
+//Read the cpu limit of the cgroup (v2 or v1) of the process. Returns 0 if there is no limit
+static int GetCgroupCpuLimit()
+{
+    //cgroup v2: "<quota> <period>" or "max <period>"
+    std::ifstream cpuMax("/sys/fs/cgroup/cpu.max");
+    if(cpuMax.good())
+    {
+        std::string quota;
+        long long period = 0;
+        cpuMax >> quota >> period;
+        return quota == "max" ? 0 : CpuLimitFromQuota(atoll(quota.c_str()), period);
+    }
+
+    //cgroup v1
+    const char* cgroupDirectories[] = {"/sys/fs/cgroup/cpu/", "/sys/fs/cgroup/cpu,cpuacct/"};
+    for(int k = 0; k < 2; k++)
+    {
+        std::ifstream quotaFile((std::string(cgroupDirectories[k]) + "cpu.cfs_quota_us").c_str());
+        std::ifstream periodFile((std::string(cgroupDirectories[k]) + "cpu.cfs_period_us").c_str());
+        long long quota = 0;
+        long long period = 0;
+        if(quotaFile >> quota && periodFile >> period)
+            return CpuLimitFromQuota(quota, period);
+    }
+
+    return 0;
+}
+
+CTaskGroup::CTaskGroup(CTaskScheduler& a_rScheduler)
+: m_rScheduler(a_rScheduler),
+  m_nPendingCount(0)
+{
+}
+
+CTaskGroup::~CTaskGroup()
+{
+    Wait();
+}
+
+void CTaskGroup::Run(const std::function<void()>& a_rTask)
+{
+    CTaskScheduler::STask task;
+    task.m_function = a_rTask;
+    task.m_pGroup = this;
+
+    m_nPendingCount++;
+    m_rScheduler.Push(task);
+}
+
+void CTaskGroup::Wait()
+{
+    m_rScheduler.Wait(*this);
+}
+
+CTaskScheduler::CTaskScheduler(int a_nThreadCount)
+: m_nThreadCount(a_nThreadCount > 0 ? a_nThreadCount : GetDefaultThreadCount()),
+  m_aWorkerQueues(m_nThreadCount),
+  m_nGlobalTaskCount(0),
+  m_nWorkerTaskCount(0),
+  m_bIsStopped(false)
+{
+    for(int k = 0; k < m_nThreadCount; k++)
+        m_aThreads.push_back(std::thread(&CTaskScheduler::WorkerLoop, this, k));
+}
+
+CTaskScheduler::~CTaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_bIsStopped = true;
+    }
+    m_waitCondition.notify_all();
+
+    for(unsigned int k = 0; k < m_aThreads.size(); k++)
+        m_aThreads[k].join();
+}
+
+int CTaskScheduler::GetThreadCount() const
+{
+    return m_nThreadCount;
+}
+
+int CTaskScheduler::GetDefaultThreadCount()
+{
+    int coreCount = static_cast<int>(std::thread::hardware_concurrency());
+
+#ifdef __linux__
+    //Cores that the process is allowed to run on (taskset / cpuset)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if(0 == sched_getaffinity(0, sizeof(cpuSet), &cpuSet))
+        coreCount = CPU_COUNT(&cpuSet);
+
+    //Cpu quota of the container
+    int cgroupLimit = GetCgroupCpuLimit();
+    if(cgroupLimit > 0 && (coreCount <= 0 || cgroupLimit < coreCount))
+        coreCount = cgroupLimit;
+#endif
+
+    return coreCount > 0 ? std::min(coreCount, MAX_THREAD_COUNT) : FALLBACK_THREAD_COUNT;
+}
+
+void CTaskScheduler::Push(const STask& a_rTask)
+{
+    if(t_pCurrentScheduler == this)
+    {
+        std::lock_guard<std::mutex> lock(m_aWorkerQueues[t_nWorkerIndex].m_mutex);
+        m_aWorkerQueues[t_nWorkerIndex].m_aTasks.push_back(a_rTask);
+        m_nWorkerTaskCount++;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_globalMutex);
+        m_aGlobalTasks.push_back(a_rTask);
+        m_nGlobalTaskCount++;
+    }
+
+    //Lock ensures that a thread checking the task counts before going to sleep does not miss the notification
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+    }
+    m_waitCondition.notify_all();
+}
+
+bool CTaskScheduler::RunQueuedTask(bool a_bTakeGlobal)
+{
+    STask task;
+    bool isFound = false;
+    const int workerIndex = t_pCurrentScheduler == this ? t_nWorkerIndex : -1;
+
+    //Newest task of own deque
+    if(workerIndex >= 0)
+    {
+        SWorkerQueue& queue = m_aWorkerQueues[workerIndex];
+        std::lock_guard<std::mutex> lock(queue.m_mutex);
+        if(!queue.m_aTasks.empty())
+        {
+            task = queue.m_aTasks.back();
+            queue.m_aTasks.pop_back();
+            m_nWorkerTaskCount--;
+            isFound = true;
+        }
+    }
+
+    //Oldest task of the global queue
+    if(!isFound && a_bTakeGlobal)
+    {
+        std::lock_guard<std::mutex> lock(m_globalMutex);
+        if(!m_aGlobalTasks.empty())
+        {
+            task = m_aGlobalTasks.front();
+            m_aGlobalTasks.pop_front();
+            m_nGlobalTaskCount--;
+            isFound = true;
+        }
+    }
+
+    //Steal the oldest task of another worker
+    for(int k = 1; !isFound && k <= m_nThreadCount; k++)
+    {
+        SWorkerQueue& queue = m_aWorkerQueues[(std::max(workerIndex, 0) + k) % m_nThreadCount];
+        std::lock_guard<std::mutex> lock(queue.m_mutex);
+        if(!queue.m_aTasks.empty())
+        {
+            task = queue.m_aTasks.front();
+            queue.m_aTasks.pop_front();
+            m_nWorkerTaskCount--;
+            isFound = true;
+        }
+    }
+
+    if(!isFound)
+        return false;
+
+    task.m_function();
+
+    if(--task.m_pGroup->m_nPendingCount == 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+        }
+        m_waitCondition.notify_all();
+    }
+
+    return true;
+}
+
+void CTaskScheduler::Wait(CTaskGroup& a_rGroup)
+{
+    const bool isWorker = t_pCurrentScheduler == this;
+
+    while(a_rGroup.m_nPendingCount > 0)
+    {
+        //A waiting worker only helps with nested tasks, a new chromosome task would delay the completion of its own task
+        if(isWorker && RunQueuedTask(false))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_waitCondition.wait(lock, [&]() { return a_rGroup.m_nPendingCount == 0 || (isWorker && m_nWorkerTaskCount > 0); });
+    }
+}
+
+void CTaskScheduler::WorkerLoop(int a_nWorkerIndex)
+{
+    t_pCurrentScheduler = this;
+    t_nWorkerIndex = a_nWorkerIndex;
+
+    while(true)
+    {
+        if(RunQueuedTask(true))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_waitCondition.wait(lock, [this]() { return m_bIsStopped || m_nGlobalTaskCount > 0 || m_nWorkerTaskCount > 0; });
+
+        if(m_bIsStopped && m_nGlobalTaskCount == 0 && m_nWorkerTaskCount == 0)
+            break;
+    }
+
+    t_pCurrentScheduler = NULL;
+    t_nWorkerIndex = -1;
+}
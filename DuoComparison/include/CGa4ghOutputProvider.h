@@ -61,9 +61,21 @@ public:
     ///Set contigs [id, name and length] to write output header
     void SetContigList(const std::vector<SVcfContig>& a_rContigs);
     
+    ///Set whether complex regions are resolved with beam search. The approximate decision (BA) flag is declared in the header only in this mode
+    void SetBeamSearchMode(bool a_bIsBeamSearchMode);
+    
     ///Generates the vcf file by merging all chromosomes
     void GenerateGa4ghVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
     
+    ///Creates the vcf file and writes its header. Chromosomes are then added one at a time (streaming mode)
+    void OpenGa4ghVcf();
+    
+    ///Writes the records of the given chromosome with its best path
+    void AddChromosome(const core::CPath& a_rBestPath, const SChrIdTuple& a_rTuple);
+    
+    ///Closes the vcf file
+    void CloseGa4ghVcf();
+    
 private:
     
     //Return the match string
@@ -118,6 +130,9 @@ private:
     //Contig id list to write output header
     std::vector<SVcfContig> m_contigs;
     
+    //True if complex regions are resolved with beam search
+    bool m_bIsBeamSearchMode = false;
+    
 };
 
 }
@@ -34,6 +34,7 @@ namespace core
 {
 class COrientedVariant;
 class CPath;
+class CDecisionArray;
 }
 
 namespace duocomparison
@@ -64,15 +65,26 @@ public:
     ///Set contigs [id, name and length] to write output header
     void SetContigList(const std::vector<SVcfContig>& a_rContigs);
     
+    ///Set whether complex regions are resolved with beam search. The approximate decision (BA) flag is declared in the header only in this mode
+    void SetBeamSearchMode(bool a_bIsBeamSearchMode);
+    
     ///Generates 4 vcf files splitting each variant decisions for given common chromosome list
     void GenerateSplitVcfs(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
+    
+    ///Creates the 4 vcf files and writes their headers. Chromosomes are then added one at a time (streaming mode)
+    void OpenSplitVcfs();
+    
+    ///Writes the variants of the given chromosome to the vcf files according to the best path decisions
+    void AddChromosome(const core::CPath& a_rBestPath, const SChrIdTuple& a_rTuple);
+    
+    ///Closes the 4 vcf files
+    void CloseSplitVcfs();
 
     
 private:
 
-    //Add the given variant list to the given writer vcf
-    void AddRecords(CVcfWriter* a_pWriter, const std::vector<const core::COrientedVariant*>& a_pOvarList);
-    void AddRecords(CVcfWriter* a_pWriter, const std::vector<const CVariant*>& a_pVarList);
+    //Add the variants of the given variant list with the included (or excluded) decision to the given writer vcf
+    void AddRecords(CVcfWriter* a_pWriter, const std::vector<const CVariant*>& a_pVarList, const core::CDecisionArray& a_rDecisions, bool a_bIsIncluded);
     
     //Convert CVariant/COrientedVariant to vcf record
     void VariantToVcfRecord(const core::COrientedVariant* a_pOvar, SVcfRecord& a_rVcfRecord);
@@ -82,12 +94,6 @@ private:
     //@a_bIsBaseSide : if we take filter names from base vcf or called vcf
     void FillHeader(CVcfWriter *a_pWriter, bool a_bIsBaseSide);
     
-    //Generates the vcf files of each category
-    void GenerateTpBaseVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
-    void GenerateTpCalledVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
-    void GenerateFnVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
-    void GenerateFpVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes);
-    
     //Path of output folder where we place vcf files
     std::string m_vcfsFolder;
 
@@ -106,6 +112,9 @@ private:
     //Contig list which will be used to fill header part of output vcf
     std::vector<SVcfContig> m_contigs;
     
+    //True if complex regions are resolved with beam search
+    bool m_bIsBeamSearchMode = false;
+    
 };
     
 }
@@ -33,10 +33,12 @@
 #include "Constants.h"
 #include "SChrIdTuple.h"
 #include "CBaseVariantProvider.h"
+#include "CSimpleBEDParser.h"
 
 namespace core
 {
     class COrientedVariant;
+    class CDecisionArray;
 }
 
 namespace duocomparison
@@ -56,17 +58,29 @@ public:
     ///Constructor
     CVariantProvider();
 
-    ///Initialize the VCF readers for base and called vcf file
+    ///Initialize the VCF readers for base and called vcf file. In streaming mode the variants are not read until LoadChromosome is called
     bool InitializeReaders(const SConfig& a_rConfig);
-
-    ///Return the variant list with the given index list
-    std::vector<const CVariant*> GetVariantList(EVcfName a_uFrom, int a_nChrNo, const std::vector<int>& a_VariantIndexes);
+    
+    ///Return true if the chromosomes are loaded and released one at a time (streaming mode with indexed vcfs)
+    bool IsStreaming() const;
+    
+    ///[Streaming mode] Reads the variants of the given chromosome. Returns false if the chromosome has too few variants to compare
+    bool LoadChromosome(const SChrIdTuple& a_rTuple);
+    
+    ///[Streaming mode] Releases all variant lists of the given chromosome
+    void ReleaseChromosome(const SChrIdTuple& a_rTuple);
 
     ///Return the all the variants belongs to given chromosome
     std::vector<const CVariant*> GetVariantList(EVcfName a_uFrom, int a_nChrNo);
 
-    ///Return the list of variants from varlist according to given variant indexes
-    std::vector<const CVariant*> GetVariantList(std::vector<const CVariant*>& a_varList, const std::vector<int>& a_VariantIndexes);
+    ///Return the variants of the given chromosome excluded by the given best path decisions
+    std::vector<const CVariant*> GetExcludedVariantList(EVcfName a_uFrom, int a_nChrNo, const core::CDecisionArray& a_rDecisions);
+
+    ///Return the variants of varlist excluded by the given best path decisions (decisions are indexed by varlist)
+    std::vector<const CVariant*> GetExcludedVariantList(const std::vector<const CVariant*>& a_varList, const core::CDecisionArray& a_rDecisions);
+
+    ///Return the oriented variants of the given chromosome included by the given best path decisions
+    std::vector<const core::COrientedVariant*> GetIncludedVariantList(EVcfName a_uFrom, int a_nChrNo, bool a_bIsGenotypeMatch, const core::CDecisionArray& a_rDecisions);
 
     ///Return the variants that are not assessed due to being in a complex regions during variant comparison operation
     std::vector<const CVariant*> GetSkippedComplexVariantList(EVcfName a_uFrom, int a_nChrNo);
@@ -93,13 +107,23 @@ public:
 
 private:
 
-    //Open Specified vcf file
-    bool OpenVcfFile(EVcfName a_uFrom, CVcfReader& a_rVcfReader);
+    //Open Specified vcf file. a_nThreadCount is the number of decompression threads of the reader
+    bool OpenVcfFile(EVcfName a_uFrom, CVcfReader& a_rVcfReader, int a_nThreadCount);
     
-    //Finds the tuple index list of chromosome which is contained by both baseline and called vcf
-    void SetChromosomeIdTuples();
+    //Finds the tuple index list of chromosome which is contained by both baseline and called vcf. Variant counts are checked later in streaming mode
+    void SetChromosomeIdTuples(bool a_bCheckVariantCount);
 
-    void FillVariantForSample(int a_nSampleId, SConfig& a_rConfig);
+    //Reads the variants of the given sample. Indexed vcfs are read per contig by a_nThreadCount threads, others sequentially
+    void FillVariantForSample(int a_nSampleId, SConfig& a_rConfig, int a_nThreadCount);
+    
+    //Distributes the contigs of the indexed vcf of the given sample to a_nThreadCount threads
+    void FillVariantForSampleByContig(int a_nSampleId, const SConfig& a_rConfig, int a_nThreadCount);
+    
+    //Reads the variants of a single contig with a separate indexed reader. Only the lists of the given contig are modified
+    void FillVariantForContig(int a_nSampleId, int a_nContigId, const SConfig& a_rConfig, const CSimpleBEDParser& a_rBedParser);
+    
+    //Adds the variant to the assessed, not assessed or multiple trimming list according to the filters (hom ref variants are dropped with their strings). Kept variants are moved from a_rVariant
+    void AddVariant(CVariant& a_rVariant, const SConfig& a_rConfig, std::vector<CVariant>& a_rVariants, std::vector<CVariant>& a_rNotAssessedVariants, std::vector<CVariant>& a_rMultiTrimmableVariants);
     
     //Read through the variant file and fill the variant lists. It assumes that positions are sorted.
     void FillVariantLists();
@@ -107,6 +131,9 @@ private:
     //Read through the variant lists and generate oriented variant list for call and base
     void FillOrientedVariantLists();
     
+    //Generate the oriented variant pair of each variant of a single chromosome
+    void FillOrientedVariantList(const std::vector<CVariant>& a_rVariantList, std::vector<core::COrientedVariant>& a_rOrientedVariantList);
+    
     //Find the optimal trimmings for given variant list
     void FindOptimalTrimmings(std::vector<CVariant>& a_rVariantList, EVcfName a_uFrom);
     
@@ -117,6 +144,10 @@ private:
     CVcfReader m_baseVCF;
     CVcfReader m_calledVCF;
 
+    //Arenas of the contigs that store the strings of the base and called variants
+    std::vector<CVariantArena> m_aBaseArenas;
+    std::vector<CVariantArena> m_aCalledArenas;
+
     //List that stores base Variants in order
     std::vector<std::vector<CVariant>> m_aBaseVariantList;
     //List that stores called Variants in order
@@ -145,6 +176,12 @@ private:
 
     //Chromosome id tuples for each common chromosome
     std::vector<SChrIdTuple> m_aCommonChrTupleList;
+    
+    //Set if the variants are loaded per chromosome by LoadChromosome
+    bool m_bIsStreaming;
+    
+    //Regions of the BED file used by LoadChromosome
+    CSimpleBEDParser m_bedParser;
 };
 
 }
@@ -28,6 +28,10 @@
 
 #include <thread>
 #include "CPathReplay.h"
+#include "CParallelPathReplay.h"
+#include "CTaskScheduler.h"
+#include "CReplayCache.h"
+#include "CReplayStats.h"
 #include "SConfig.h"
 #include "CVariantProvider.h"
 #include "CResultLog.h"
@@ -62,8 +66,14 @@ private:
     //Prints the help menu at console
     void PrintHelp() const;
     
-    //Divide the jobs between different threads homogeneously for given number of thread count. Return the actual thread count
+    //Submit the chromosome jobs to a work stealing scheduler, most expensive chromosomes first. Return the actual thread count
     int AssignJobsToThreads(int a_nThreadCount);
+    
+    //[Streaming mode] Compares, outputs and releases the chromosomes in order while the next chromosome is parsed
+    void ProcessChromosomesStreaming(int a_nThreadCount);
+    
+    //Generates the output vcf(s) of all chromosomes according to the output mode
+    void GenerateOutputs();
         
     //Function that process chromosome in bulk for SPLIT mode (process either genotype or allele match)
     void ThreadFunctionSPLIT(std::vector<SChrIdTuple> a_aTuples, bool a_bIsGenotypeMatch);
@@ -94,8 +104,14 @@ private:
     //Best Paths written by each thread to find Allele matches for each unique chromosome exists
     std::vector<core::CPath> m_aBestPathsAllele;
     
-    //Thread pool we have for multitasking by per chromosome
-    std::thread *m_pThreadPool;
+    //Cache of the replayed region decisions shared by all chromosome jobs (used if a cache directory is given)
+    core::CReplayCache m_replayCache;
+    
+    //Per sync region replay statistics written by all chromosome jobs (used if a statistics file is given)
+    core::CReplayStats m_replayStats;
+    
+    //Scheduler shared by the chromosome jobs and the replay blocks of each chromosome
+    core::CTaskScheduler* m_pScheduler;
     
     //To prevent data race in multi-thread mode
     std::mutex mtx;
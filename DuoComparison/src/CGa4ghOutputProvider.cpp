@@ -56,18 +56,35 @@ void CGa4ghOutputProvider::SetContigList(const std::vector<SVcfContig>& a_rConti
     m_contigs = a_rContigs;
 }
 
+void CGa4ghOutputProvider::SetBeamSearchMode(bool a_bIsBeamSearchMode)
+{
+    m_bIsBeamSearchMode = a_bIsBeamSearchMode;
+}
+
 void CGa4ghOutputProvider::GenerateGa4ghVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
 {
-    
-    m_vcfWriter.CreateVcf(m_vcfPath.c_str());
-    FillHeader();
+    OpenGa4ghVcf();
     
     for(SChrIdTuple tuple : a_rCommonChromosomes)
-    {
-        std::cout << "Processing Chromosome " << tuple.m_chrName << std::endl;
-        AddRecords(m_aBestPaths[tuple.m_nTupleIndex], tuple);
-    }
+        AddChromosome(m_aBestPaths[tuple.m_nTupleIndex], tuple);
     
+    CloseGa4ghVcf();
+}
+
+void CGa4ghOutputProvider::OpenGa4ghVcf()
+{
+    m_vcfWriter.CreateVcf(m_vcfPath.c_str());
+    FillHeader();
+}
+
+void CGa4ghOutputProvider::AddChromosome(const core::CPath& a_rBestPath, const SChrIdTuple& a_rTuple)
+{
+    std::cout << "Processing Chromosome " << a_rTuple.m_chrName << std::endl;
+    AddRecords(a_rBestPath, a_rTuple);
+}
+
+void CGa4ghOutputProvider::CloseGa4ghVcf()
+{
     m_vcfWriter.CloseVcf();
 }
 
@@ -82,6 +99,10 @@ void CGa4ghOutputProvider::FillHeader()
     m_vcfWriter.AddHeaderLine("##FORMAT=<ID=BD,Number=1,Type=String,Description=\"Decision for call (TP/FP/FN/N)\">");
     m_vcfWriter.AddHeaderLine("##FORMAT=<ID=BK,Number=1,Type=String,Description=\"Sub-type for decision (match/mismatch type)\">");
     
+    //ADD APPROXIMATE DECISION FLAG (complex regions resolved with beam search)
+    if(m_bIsBeamSearchMode)
+        m_vcfWriter.AddHeaderLine("##INFO=<ID=BA,Number=0,Type=Flag,Description=\"Decision is made by beam search in a complex region (approximate)\">");
+    
     //ADD FILTER COLUMNS FROM CALL FILE
     std::vector<std::string> filterNames;
     std::vector<std::string> filterDescriptions;
@@ -122,16 +143,16 @@ void CGa4ghOutputProvider::AddSingleSampleRecord(const SVariantSummary &a_rVaria
 void CGa4ghOutputProvider::AddRecords(const core::CPath& a_rBestPath, SChrIdTuple a_rTuple)
 {
     //Best Path excluded variants
-    std::vector<const CVariant*> excludedVarsBase = m_pVariantProvider->GetVariantList(eBASE, a_rTuple.m_nBaseId, a_rBestPath.m_baseSemiPath.GetExcluded());
-    std::vector<const CVariant*> excludedVarsCall = m_pVariantProvider->GetVariantList(eCALLED, a_rTuple.m_nCalledId, a_rBestPath.m_calledSemiPath.GetExcluded());
+    std::vector<const CVariant*> excludedVarsBase = m_pVariantProvider->GetExcludedVariantList(eBASE, a_rTuple.m_nBaseId, a_rBestPath.m_baseSemiPath.GetDecisions());
+    std::vector<const CVariant*> excludedVarsCall = m_pVariantProvider->GetExcludedVariantList(eCALLED, a_rTuple.m_nCalledId, a_rBestPath.m_calledSemiPath.GetDecisions());
     
     //Sort excluded variants by original positions
     std::sort(excludedVarsBase.begin(), excludedVarsBase.end(), CUtils::CompareVariantsById);
     std::sort(excludedVarsCall.begin(), excludedVarsCall.end(), CUtils::CompareVariantsById);
     
     //Best Path included variants
-    std::vector<const core::COrientedVariant*> includedVarsBase = a_rBestPath.m_baseSemiPath.GetIncludedVariants();
-    std::vector<const core::COrientedVariant*> includedVarsCall = a_rBestPath.m_calledSemiPath.GetIncludedVariants();
+    std::vector<const core::COrientedVariant*> includedVarsBase = m_pVariantProvider->GetIncludedVariantList(eBASE, a_rTuple.m_nBaseId, true, a_rBestPath.m_baseSemiPath.GetDecisions());
+    std::vector<const core::COrientedVariant*> includedVarsCall = m_pVariantProvider->GetIncludedVariantList(eCALLED, a_rTuple.m_nCalledId, true, a_rBestPath.m_calledSemiPath.GetDecisions());
     
     //Sort included variants by original positions
     std::sort(includedVarsBase.begin(), includedVarsBase.end(), CUtils::CompareOrientedVariantsById);
@@ -235,11 +256,12 @@ void CGa4ghOutputProvider::AddRecords(const core::CPath& a_rBestPath, SChrIdTupl
 void CGa4ghOutputProvider::VariantToVcfRecord(const CVariant* a_pVariant, SVcfRecord& a_rOutputRec, bool a_bIsBase, const std::string& a_rMatchType, const::std::string& a_rDecision)
 {
     //Fill basic variant data
-    a_rOutputRec.m_chrName = a_pVariant->m_chrName;
+    a_rOutputRec.m_chrName = a_pVariant->GetChrName();
     a_rOutputRec.m_nPosition = a_pVariant->m_nOriginalPos;
-    a_rOutputRec.m_alleles = a_pVariant->m_allelesStr;
+    a_rOutputRec.m_alleles = a_pVariant->GetAllelesStr();
+    a_rOutputRec.m_bIsApproximate = a_pVariant->m_bIsApproximate;
     if(!a_bIsBase)
-        a_rOutputRec.m_aFilterString = a_pVariant->m_filterString;
+        a_rOutputRec.m_aFilterString = a_pVariant->GetFilterNames();
     
     //Fill genotype of sample data
     SPerSampleData data;
@@ -264,10 +286,11 @@ void CGa4ghOutputProvider::MergeVariants(const CVariant* a_pVariantBase,
 {
 
     //Fill basic variant data
-    a_rOutputRec.m_chrName = a_pVariantCalled->m_chrName;
+    a_rOutputRec.m_chrName = a_pVariantCalled->GetChrName();
     a_rOutputRec.m_nPosition = a_pVariantCalled->m_nOriginalPos;
-    a_rOutputRec.m_alleles = a_pVariantCalled->m_allelesStr;
-    a_rOutputRec.m_aFilterString = a_pVariantCalled->m_filterString;
+    a_rOutputRec.m_alleles = a_pVariantCalled->GetAllelesStr();
+    a_rOutputRec.m_aFilterString = a_pVariantCalled->GetFilterNames();
+    a_rOutputRec.m_bIsApproximate = a_pVariantBase->m_bIsApproximate || a_pVariantCalled->m_bIsApproximate;
     
     //Fill base sample (TRUTH)
     SPerSampleData data;
@@ -275,8 +298,8 @@ void CGa4ghOutputProvider::MergeVariants(const CVariant* a_pVariantBase,
     data.m_nHaplotypeCount = a_pVariantBase->m_nZygotCount;
     data.m_bIsNoCallVariant = a_pVariantBase->m_bIsNoCall;
     
-    std::stringstream ss(a_pVariantCalled->m_allelesStr);
-    std::stringstream ss2(a_pVariantBase->m_allelesStr);
+    std::stringstream ss(a_pVariantCalled->GetAllelesStr());
+    std::stringstream ss2(a_pVariantBase->GetAllelesStr());
     std::vector<std::string> calledVariants;
     std::vector<std::string> baseVariants;
     std::string substr;
@@ -340,7 +363,7 @@ void CGa4ghOutputProvider::MergeVariants(const CVariant* a_pVariantBase,
 bool CGa4ghOutputProvider::CanMerge(const CVariant* a_pVariantBase, const CVariant* a_pVariantCalled) const
 {
     bool bIsPosEqual = a_pVariantBase->m_nOriginalPos == a_pVariantCalled->m_nOriginalPos;
-    bool bIsRefEqual = a_pVariantBase->m_refSequence == a_pVariantCalled->m_refSequence;
+    bool bIsRefEqual = a_pVariantBase->GetRefSeq() == a_pVariantCalled->GetRefSeq();
     
     if(bIsPosEqual && bIsRefEqual)
         return true;
@@ -25,6 +25,7 @@
 
 #include "CSplitOutputProvider.h"
 #include "CPath.h"
+#include "CDecisionArray.h"
 #include "CVariantProvider.h"
 #include "Constants.h"
 #include <algorithm>
@@ -57,113 +58,71 @@ void CSplitOutputProvider::SetContigList(const std::vector<SVcfContig>& a_rConti
     m_contigs = a_rContigs;
 }
 
-void CSplitOutputProvider::GenerateSplitVcfs(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
+void CSplitOutputProvider::SetBeamSearchMode(bool a_bIsBeamSearchMode)
 {
-    GenerateTpCalledVcf(a_rCommonChromosomes);
-    GenerateTpBaseVcf(a_rCommonChromosomes);
-    GenerateFnVcf(a_rCommonChromosomes);
-    GenerateFpVcf(a_rCommonChromosomes);
+    m_bIsBeamSearchMode = a_bIsBeamSearchMode;
 }
 
-void CSplitOutputProvider::GenerateTpBaseVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
+void CSplitOutputProvider::GenerateSplitVcfs(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
 {
     std::vector<SChrIdTuple> commonChromosomesOrdered(a_rCommonChromosomes);
     std::sort(commonChromosomesOrdered.begin(), commonChromosomesOrdered.end(), [](const SChrIdTuple& t1, const SChrIdTuple& t2){ return t1.m_nBaseId < t2.m_nBaseId; });
     
-    std::string filePath = m_vcfsFolder + "/TPBase.vcf";
-    m_TPBaseWriter.CreateVcf(filePath.c_str());
-    
-    //Fill the header section
-    FillHeader(&m_TPBaseWriter, true);
+    OpenSplitVcfs();
     
     //Process each chromosome
     for(SChrIdTuple tuple : commonChromosomesOrdered)
-    {
-        const std::vector<const core::COrientedVariant*> ovarList = m_aBestPaths[tuple.m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-        std::vector<const core::COrientedVariant*> sortedOvarList(ovarList);
-        std::sort(sortedOvarList.begin(), sortedOvarList.end(), [](const core::COrientedVariant* ovar1, const core::COrientedVariant* ovar2){return ovar1->GetVariant().m_nId < ovar2->GetVariant().m_nId;});
-        AddRecords(&m_TPBaseWriter, sortedOvarList);
-    }
+        AddChromosome(m_aBestPaths[tuple.m_nTupleIndex], tuple);
     
-    m_TPBaseWriter.CloseVcf();
+    CloseSplitVcfs();
 }
 
-void CSplitOutputProvider::GenerateTpCalledVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
+void CSplitOutputProvider::OpenSplitVcfs()
 {
-    std::vector<SChrIdTuple> commonChromosomesOrdered(a_rCommonChromosomes);
-    std::sort(commonChromosomesOrdered.begin(), commonChromosomesOrdered.end(), [](const SChrIdTuple& t1, const SChrIdTuple& t2){ return t1.m_nBaseId < t2.m_nBaseId; });
-    
     std::string filePath = m_vcfsFolder + "/TPCalled.vcf";
     m_TPCalledWriter.CreateVcf(filePath.c_str());
-    
-    //Fill the header section
     FillHeader(&m_TPCalledWriter, false);
     
-    //Process each chromosome
-    for(SChrIdTuple tuple : commonChromosomesOrdered)
-    {
-        const std::vector<const core::COrientedVariant*> ovarList = m_aBestPaths[tuple.m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
-        std::vector<const core::COrientedVariant*> sortedOvarList(ovarList);
-        std::sort(sortedOvarList.begin(), sortedOvarList.end(), [](const core::COrientedVariant* ovar1, const core::COrientedVariant* ovar2){return ovar1->GetVariant().m_nId < ovar2->GetVariant().m_nId;});
-        AddRecords(&m_TPCalledWriter, sortedOvarList);
-    }
+    filePath = m_vcfsFolder + "/TPBase.vcf";
+    m_TPBaseWriter.CreateVcf(filePath.c_str());
+    FillHeader(&m_TPBaseWriter, true);
     
-    m_TPCalledWriter.CloseVcf();
-}
-
-void CSplitOutputProvider::GenerateFnVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
-{
-    std::vector<SChrIdTuple> commonChromosomesOrdered(a_rCommonChromosomes);
-    std::sort(commonChromosomesOrdered.begin(), commonChromosomesOrdered.end(), [](const SChrIdTuple& t1, const SChrIdTuple& t2){ return t1.m_nBaseId < t2.m_nBaseId; });
-
-    std::string filePath = m_vcfsFolder + "/FN.vcf";
+    filePath = m_vcfsFolder + "/FN.vcf";
     m_FNWriter.CreateVcf(filePath.c_str());
-    
-    //Fill the header section
     FillHeader(&m_FNWriter, true);
     
-    //Process each chromosome
-    for(SChrIdTuple tuple : commonChromosomesOrdered)
-    {
-        const std::vector<const CVariant*> varList = m_pProvider->GetVariantList(eBASE, tuple.m_nBaseId, m_aBestPaths[tuple.m_nTupleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> sortedVarList(varList);
-        std::sort(sortedVarList.begin(), sortedVarList.end(), [](const CVariant* pVar1, const CVariant* pVar2){return pVar1->m_nId < pVar2->m_nId;});
-        AddRecords(&m_FNWriter, sortedVarList);
-    }
-    
-    m_FNWriter.CloseVcf();
+    filePath = m_vcfsFolder + "/FP.vcf";
+    m_FPWriter.CreateVcf(filePath.c_str());
+    FillHeader(&m_FPWriter, false);
 }
 
-void CSplitOutputProvider::GenerateFpVcf(const std::vector<SChrIdTuple>& a_rCommonChromosomes)
+void CSplitOutputProvider::AddChromosome(const core::CPath& a_rBestPath, const SChrIdTuple& a_rTuple)
 {
-    std::vector<SChrIdTuple> commonChromosomesOrdered(a_rCommonChromosomes);
-    std::sort(commonChromosomesOrdered.begin(), commonChromosomesOrdered.end(), [](const SChrIdTuple& t1, const SChrIdTuple& t2){ return t1.m_nBaseId < t2.m_nBaseId; });
-
-    std::string filePath = m_vcfsFolder + "/FP.vcf";
-    m_FPWriter.CreateVcf(filePath.c_str());
-    
-    //Fill the header section
-    FillHeader(&m_FPWriter, false);
-    
-    //Process each chromosome
-    for(SChrIdTuple tuple : commonChromosomesOrdered)
-    {
-        const std::vector<const CVariant*> varList = m_pProvider->GetVariantList(eCALLED, tuple.m_nCalledId, m_aBestPaths[tuple.m_nTupleIndex].m_calledSemiPath.GetExcluded());
-        std::vector<const CVariant*> sortedVarList(varList);
-        std::sort(sortedVarList.begin(), sortedVarList.end(), [](const CVariant* pVar1, const CVariant* pVar2){return pVar1->m_nId < pVar2->m_nId;});
-        AddRecords(&m_FPWriter, sortedVarList);
-    }
+    std::vector<const CVariant*> baseVariants = m_pProvider->GetVariantList(eBASE, a_rTuple.m_nBaseId);
+    std::vector<const CVariant*> calledVariants = m_pProvider->GetVariantList(eCALLED, a_rTuple.m_nCalledId);
     
+    AddRecords(&m_TPCalledWriter, calledVariants, a_rBestPath.m_calledSemiPath.GetDecisions(), true);
+    AddRecords(&m_TPBaseWriter, baseVariants, a_rBestPath.m_baseSemiPath.GetDecisions(), true);
+    AddRecords(&m_FNWriter, baseVariants, a_rBestPath.m_baseSemiPath.GetDecisions(), false);
+    AddRecords(&m_FPWriter, calledVariants, a_rBestPath.m_calledSemiPath.GetDecisions(), false);
+}
+
+void CSplitOutputProvider::CloseSplitVcfs()
+{
+    m_TPCalledWriter.CloseVcf();
+    m_TPBaseWriter.CloseVcf();
+    m_FNWriter.CloseVcf();
     m_FPWriter.CloseVcf();
 }
 
 void CSplitOutputProvider::VariantToVcfRecord(const CVariant* a_pVariant, SVcfRecord& a_rOutputRec)
 {
     //Fill basic variant data
-    a_rOutputRec.m_chrName = a_pVariant->m_chrName;
+    a_rOutputRec.m_chrName = a_pVariant->GetChrName();
     a_rOutputRec.m_nPosition = a_pVariant->m_nOriginalPos;
-    a_rOutputRec.m_alleles = a_pVariant->m_allelesStr;
-    a_rOutputRec.m_aFilterString = a_pVariant->m_filterString;
+    a_rOutputRec.m_alleles = a_pVariant->GetAllelesStr();
+    a_rOutputRec.m_aFilterString = a_pVariant->GetFilterNames();
+    a_rOutputRec.m_bIsApproximate = a_pVariant->m_bIsApproximate;
     
     //Fill genotype of sample data
     SPerSampleData data;
@@ -176,19 +135,20 @@ void CSplitOutputProvider::VariantToVcfRecord(const CVariant* a_pVariant, SVcfRe
     a_rOutputRec.m_aSampleData.push_back(data);
 }
 
-void CSplitOutputProvider::AddRecords(CVcfWriter* a_pWriter, const std::vector<const core::COrientedVariant*>& a_pOvarList)
+void CSplitOutputProvider::AddRecords(CVcfWriter* a_pWriter, const std::vector<const CVariant*>& a_pVarList, const core::CDecisionArray& a_rDecisions, bool a_bIsIncluded)
 {
-    for(const core::COrientedVariant* pOvar : a_pOvarList)
+    std::vector<const CVariant*> selectedVarList;
+    selectedVarList.reserve(a_bIsIncluded ? a_rDecisions.GetIncludedCount() : a_rDecisions.GetExcludedCount());
+    
+    for(int k = 0; k < a_rDecisions.GetVariantCount(); k++)
     {
-        SVcfRecord record;
-        VariantToVcfRecord(&pOvar->GetVariant(), record);
-        a_pWriter->AddRecord(record);
+        if(a_bIsIncluded ? a_rDecisions.IsIncluded(k) : a_rDecisions.IsExcluded(k))
+            selectedVarList.push_back(a_pVarList[k]);
     }
-}
-
-void CSplitOutputProvider::AddRecords(CVcfWriter* a_pWriter, const std::vector<const CVariant*>& a_pVarList)
-{
-    for(const CVariant* pVar : a_pVarList)
+    
+    std::sort(selectedVarList.begin(), selectedVarList.end(), [](const CVariant* pVar1, const CVariant* pVar2){return pVar1->m_nId < pVar2->m_nId;});
+    
+    for(const CVariant* pVar : selectedVarList)
     {
         SVcfRecord record;
         VariantToVcfRecord(pVar, record);
@@ -205,6 +165,10 @@ void CSplitOutputProvider::FillHeader(CVcfWriter *a_pWriter, bool a_bIsBaseSide)
     //ADD REQUIRED FORMATS BY GA4GH
     a_pWriter->AddHeaderLine("##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">");
     
+    //ADD APPROXIMATE DECISION FLAG (complex regions resolved with beam search)
+    if(m_bIsBeamSearchMode)
+        a_pWriter->AddHeaderLine("##INFO=<ID=BA,Number=0,Type=Flag,Description=\"Decision is made by beam search in a complex region (approximate)\">");
+    
     //ADD FILTER COLUMNS FROM CALL FILE
     std::vector<std::string> filterNames;
     std::vector<std::string> filterDescriptions;
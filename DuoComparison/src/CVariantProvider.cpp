@@ -25,17 +25,21 @@
 
 #include "CVariantProvider.h"
 #include "COrientedVariant.h"
+#include "CDecisionArray.h"
 #include "CSimpleBEDParser.h"
 #include "Utils/CUtils.h"
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <thread>
+#include <atomic>
 
 using namespace duocomparison;
 
 CVariantProvider::CVariantProvider()
 {
     m_bIsHomozygousOvarListInitialized = false;
+    m_bIsStreaming = false;
 }
 
 CVariantProvider::~CVariantProvider()
@@ -44,7 +48,7 @@ CVariantProvider::~CVariantProvider()
     m_calledVCF.Close();
 }
 
-void CVariantProvider::SetChromosomeIdTuples()
+void CVariantProvider::SetChromosomeIdTuples(bool a_bCheckVariantCount)
 {
     int tupleIndex = 0;
     
@@ -54,9 +58,11 @@ void CVariantProvider::SetChromosomeIdTuples()
         {
             if(baseItr->first == calledItr->first)
             {
-                if(m_aBaseVariantList[baseItr->second].size() > LEAST_VARIANT_THRESHOLD
-                   &&
-                   m_aCalledVariantList[calledItr->second].size() > LEAST_VARIANT_THRESHOLD)
+                if(!a_bCheckVariantCount
+                   ||
+                   (m_aBaseVariantList[baseItr->second].size() > LEAST_VARIANT_THRESHOLD
+                    &&
+                    m_aCalledVariantList[calledItr->second].size() > LEAST_VARIANT_THRESHOLD))
                 {
                     m_aCommonChrTupleList.push_back(SChrIdTuple(baseItr->second, calledItr->second, baseItr->first, tupleIndex++));
                 }
@@ -69,7 +75,7 @@ void CVariantProvider::SetChromosomeIdTuples()
 }
 
 
-bool CVariantProvider::OpenVcfFile(EVcfName a_uFrom, CVcfReader& a_rVcfReader)
+bool CVariantProvider::OpenVcfFile(EVcfName a_uFrom, CVcfReader& a_rVcfReader, int a_nThreadCount)
 {
     bool bIsSuccess;
  
@@ -77,7 +83,7 @@ bool CVariantProvider::OpenVcfFile(EVcfName a_uFrom, CVcfReader& a_rVcfReader)
     const char* pSampleName = a_uFrom == eBASE ? m_config.m_pBaseSample : m_config.m_pCalledSample;
     const char* pFileName = a_uFrom == eBASE ? m_config.m_pBaseVcfFileName : m_config.m_pCalledVcfFileName;
     
-    bIsSuccess = a_rVcfReader.Open(pFileName);
+    bIsSuccess = a_rVcfReader.Open(pFileName, a_nThreadCount);
     if(!bIsSuccess)
     {
         std::cerr << "VCF file is unable to open: " << pFileName << std::endl;
@@ -110,9 +116,18 @@ bool CVariantProvider::InitializeReaders(const SConfig& a_rConfig)
 
     m_config = a_rConfig;
 
+    //Base and called vcfs are parsed concurrently, the rest of the threads decompress them
+    const int decompressionThreadCount = std::max(0, (m_config.m_nThreadCount - 2) / 2);
+    
     //Open VCF files
-    OpenVcfFile(eBASE, m_baseVCF);
-    OpenVcfFile(eCALLED, m_calledVCF);
+    OpenVcfFile(eBASE, m_baseVCF, decompressionThreadCount);
+    OpenVcfFile(eCALLED, m_calledVCF, decompressionThreadCount);
+    
+    //Strings of the variants are stored per contig, so the contigs can be read in parallel and released one at a time
+    m_baseVCF.InitArenas(m_aBaseArenas);
+    m_calledVCF.InitArenas(m_aCalledArenas);
+    m_baseVCF.SetArenas(&m_aBaseArenas);
+    m_calledVCF.SetArenas(&m_aCalledArenas);
     
     //Open FASTA file
     bIsSuccess = m_referenceFasta.OpenFastaFile(a_rConfig.m_pFastaFileName);
@@ -122,23 +137,91 @@ bool CVariantProvider::InitializeReaders(const SConfig& a_rConfig)
         return false;
     }
     
-    if(bIsSuccess)
+    //Streaming reads each chromosome with its own indexed reader
+    if(true == m_config.m_bStreaming)
+    {
+        m_bIsStreaming = m_baseVCF.LoadIndex() && m_calledVCF.LoadIndex();
+        if(!m_bIsStreaming)
+            std::cerr << "Streaming mode requires indexed (tbi/csi) vcf files. All variants will be loaded at once" << std::endl;
+    }
+    
+    if(m_bIsStreaming)
     {
-        //Fill variant lists from VCF files
-        FillVariantLists();
+        if(true == m_config.m_bInitializeFromBed)
+            m_bedParser.InitBEDFile(m_config.m_pBedFileName);
         
-        //Generate OrientedVariant list using the variant list
-        FillOrientedVariantLists();
+        //Lists are sized once, so that a chromosome can be loaded while another one is compared
+        m_aBaseVariantList = std::vector<std::vector<CVariant>>(m_baseVCF.GetContigs().size());
+        m_aCalledVariantList = std::vector<std::vector<CVariant>>(m_calledVCF.GetContigs().size());
+        m_aBaseNotAssessedVariantList = std::vector<std::vector<CVariant>>(m_baseVCF.GetContigs().size());
+        m_aCalledNotAssessedVariantList = std::vector<std::vector<CVariant>>(m_calledVCF.GetContigs().size());
+        m_aBaseOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_baseVCF.GetContigs().size());
+        m_aCalledOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_calledVCF.GetContigs().size());
+        m_aBaseHomozygousOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_baseVCF.GetContigs().size());
+        m_aCalledHomozygousOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_calledVCF.GetContigs().size());
+        m_bIsHomozygousOvarListInitialized = true;
         
-        //Set the common chromosome list for processing
-        SetChromosomeIdTuples();
+        SetChromosomeIdTuples(false);
+        return true;
     }
     
+    //Fill variant lists from VCF files
+    FillVariantLists();
+    
+    //Generate OrientedVariant list using the variant list
+    FillOrientedVariantLists();
+    
+    //Set the common chromosome list for processing
+    SetChromosomeIdTuples(true);
+    
     return bIsSuccess;
 }
 
-void CVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
+bool CVariantProvider::IsStreaming() const
 {
+    return m_bIsStreaming;
+}
+
+bool CVariantProvider::LoadChromosome(const SChrIdTuple& a_rTuple)
+{
+    //Base and called contigs are filled into separate lists, so they are read in parallel
+    std::thread calledThread(&CVariantProvider::FillVariantForContig, this, eCALLED, a_rTuple.m_nCalledId, std::cref(m_config), std::cref(m_bedParser));
+    FillVariantForContig(eBASE, a_rTuple.m_nBaseId, m_config, m_bedParser);
+    calledThread.join();
+    
+    if(m_aBaseVariantList[a_rTuple.m_nBaseId].size() <= LEAST_VARIANT_THRESHOLD || m_aCalledVariantList[a_rTuple.m_nCalledId].size() <= LEAST_VARIANT_THRESHOLD)
+        return false;
+    
+    FillOrientedVariantList(m_aBaseVariantList[a_rTuple.m_nBaseId], m_aBaseOrientedVariantList[a_rTuple.m_nBaseId]);
+    FillOrientedVariantList(m_aCalledVariantList[a_rTuple.m_nCalledId], m_aCalledOrientedVariantList[a_rTuple.m_nCalledId]);
+    return true;
+}
+
+void CVariantProvider::ReleaseChromosome(const SChrIdTuple& a_rTuple)
+{
+    //Swapping with empty vectors frees the memory (clear keeps the capacity)
+    std::vector<CVariant>().swap(m_aBaseVariantList[a_rTuple.m_nBaseId]);
+    std::vector<CVariant>().swap(m_aCalledVariantList[a_rTuple.m_nCalledId]);
+    std::vector<CVariant>().swap(m_aBaseNotAssessedVariantList[a_rTuple.m_nBaseId]);
+    std::vector<CVariant>().swap(m_aCalledNotAssessedVariantList[a_rTuple.m_nCalledId]);
+    std::vector<core::COrientedVariant>().swap(m_aBaseOrientedVariantList[a_rTuple.m_nBaseId]);
+    std::vector<core::COrientedVariant>().swap(m_aCalledOrientedVariantList[a_rTuple.m_nCalledId]);
+    std::vector<core::COrientedVariant>().swap(m_aBaseHomozygousOrientedVariantList[a_rTuple.m_nBaseId]);
+    std::vector<core::COrientedVariant>().swap(m_aCalledHomozygousOrientedVariantList[a_rTuple.m_nCalledId]);
+    m_aBaseArenas[a_rTuple.m_nBaseId].ReleaseSequences();
+    m_aCalledArenas[a_rTuple.m_nCalledId].ReleaseSequences();
+}
+
+void CVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig, int a_nThreadCount)
+{
+    //Each contig of an indexed vcf can be read independently
+    CVcfReader* pSampleReader = a_nSampleId == 0 ? &m_baseVCF : &m_calledVCF;
+    if(a_nThreadCount > 1 && pSampleReader->LoadIndex())
+    {
+        FillVariantForSampleByContig(a_nSampleId, a_rConfig, a_nThreadCount);
+        return;
+    }
+    
     CSimpleBEDParser bedParser;
     if(true == a_rConfig.m_bInitializeFromBed)
         bedParser.InitBEDFile(a_rConfig.m_pBedFileName);
@@ -161,15 +244,16 @@ void CVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
     
     while(pReader->GetNextRecord(&variant, id++, a_rConfig))
     {
-        if(preChrId != variant.m_chrName)
+        if(preChrId != variant.GetChrName())
         {
             //We update the remaining contig count in BED file
             if(bedParser.m_regionMap[preChrId].size() > 0)
                 remainingBedContigCount--;
             
             regionIterator = 0;
-            preChrId = variant.m_chrName;
-            std::cout << "Processing chromosome " << preChrId << " of " << sampleNameStr  << " vcf" << std::endl;
+            preChrId = variant.GetChrName();
+            //Single insertion so that the lines of the concurrently parsed vcfs are not interleaved
+            std::cout << "Processing chromosome " + preChrId + " of " + sampleNameStr + " vcf\n" << std::flush;
         }
         
         if(a_rConfig.m_bInitializeFromBed)
@@ -179,46 +263,36 @@ void CVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
                 break;
 
             //No Region exist for this chromosome
-            if(regionIterator == bedParser.m_regionMap[variant.m_chrName].size())
+            if(regionIterator == bedParser.m_regionMap[variant.GetChrName()].size())
+            {
+                variant.DiscardStrings();
                 continue;
+            }
             
             //Skip to next region
-            while(regionIterator < bedParser.m_regionMap[variant.m_chrName].size()
+            while(regionIterator < bedParser.m_regionMap[variant.GetChrName()].size()
                   &&
-                  variant.m_nOriginalPos >= bedParser.m_regionMap[variant.m_chrName][regionIterator].m_nEndPos)
+                  variant.m_nOriginalPos >= bedParser.m_regionMap[variant.GetChrName()][regionIterator].m_nEndPos)
             {
                 regionIterator++;
             }
             
             //No remaining Region exist for this chromosome
-            if(regionIterator == bedParser.m_regionMap[variant.m_chrName].size())
+            if(regionIterator == bedParser.m_regionMap[variant.GetChrName()].size())
+            {
+                variant.DiscardStrings();
                 continue;
+            }
 
             //Variant Could not pass from BED region
-            if(bedParser.m_regionMap[variant.m_chrName][regionIterator].m_nStartPos >= (variant.m_nOriginalPos + (int)variant.m_refSequence.length()))
+            if(bedParser.m_regionMap[variant.GetChrName()][regionIterator].m_nStartPos >= (variant.m_nOriginalPos + variant.GetRefLength()))
+            {
+                variant.DiscardStrings();
                 continue;
+            }
         }
         
-        if(!variant.m_bIsNoCall && CUtils::IsHomRef(variant))
-            continue;
-        
-        if(a_rConfig.m_bIsFilterEnabled && variant.m_bIsFilterPASS == false)
-            (*pNonAssessedVariants)[variant.m_nChrId].push_back(variant);
-        
-        else if(a_rConfig.m_bSNPOnly && variant.GetVariantType() != eSNP)
-            (*pNonAssessedVariants)[variant.m_nChrId].push_back(variant);
-        
-        else if(a_rConfig.m_bINDELOnly && variant.GetVariantType() != eINDEL)
-            (*pNonAssessedVariants)[variant.m_nChrId].push_back(variant);
-        
-        else if(CUtils::IsStructuralVariant(variant, a_rConfig.m_nMaxVariantSize))
-            (*pNonAssessedVariants)[variant.m_nChrId].push_back(variant);
-        
-        else if(true == variant.m_bHaveMultipleTrimOption)
-            multiTrimmableVarList.push_back(variant);
-        
-        else
-            (*pVariants)[variant.m_nChrId].push_back(variant);
+        AddVariant(variant, a_rConfig, (*pVariants)[variant.m_nChrId], (*pNonAssessedVariants)[variant.m_nChrId], multiTrimmableVarList);
     }
     
     FindOptimalTrimmings(multiTrimmableVarList, sampleName);
@@ -226,11 +300,125 @@ void CVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
     
     for(unsigned int k = 0; k < pReader->GetContigs().size(); k++)
     {
-        std::sort((*pNonAssessedVariants)[k].begin(), (*pNonAssessedVariants)[k].end(), CUtils::CompareVariants);
-        std::sort((*pVariants)[k].begin(), (*pVariants)[k].end(), CUtils::CompareVariants);
+        CUtils::SortVariants((*pNonAssessedVariants)[k]);
+        CUtils::SortVariants((*pVariants)[k]);
     }
 }
 
+void CVariantProvider::FillVariantForSampleByContig(int a_nSampleId, const SConfig& a_rConfig, int a_nThreadCount)
+{
+    CSimpleBEDParser bedParser;
+    if(true == a_rConfig.m_bInitializeFromBed)
+        bedParser.InitBEDFile(a_rConfig.m_pBedFileName);
+    
+    const int contigCount = static_cast<int>((a_nSampleId == 0 ? m_baseVCF : m_calledVCF).GetContigs().size());
+    std::atomic<int> nextContig(0);
+    
+    auto worker = [&]()
+    {
+        for(int contigId = nextContig++; contigId < contigCount; contigId = nextContig++)
+            FillVariantForContig(a_nSampleId, contigId, a_rConfig, bedParser);
+    };
+    
+    std::vector<std::thread> threads;
+    for(int k = 1; k < std::min(a_nThreadCount, contigCount); k++)
+        threads.push_back(std::thread(worker));
+    
+    worker();
+    
+    for(unsigned int k = 0; k < threads.size(); k++)
+        threads[k].join();
+}
+
+void CVariantProvider::FillVariantForContig(int a_nSampleId, int a_nContigId, const SConfig& a_rConfig, const CSimpleBEDParser& a_rBedParser)
+{
+    EVcfName sampleName = static_cast<EVcfName>(a_nSampleId);
+    std::string sampleNameStr = sampleName == eBASE ? "base" : "called";
+    const std::string contigName = (a_nSampleId == 0 ? m_baseVCF : m_calledVCF).GetContigName(a_nContigId);
+    
+    //Contigs without a BED region are skipped
+    const std::vector<SBedRegion>* pRegions = NULL;
+    if(true == a_rConfig.m_bInitializeFromBed)
+    {
+        auto regionItr = a_rBedParser.m_regionMap.find(contigName);
+        if(regionItr == a_rBedParser.m_regionMap.end() || regionItr->second.empty())
+            return;
+        pRegions = &regionItr->second;
+    }
+    
+    //Contigs that are not in the index have no records
+    CVcfReader reader;
+    if(!OpenVcfFile(sampleName, reader, 0) || !reader.LoadIndex() || !reader.SetContig(contigName))
+        return;
+    reader.SetArenas(a_nSampleId == 0 ? &m_aBaseArenas : &m_aCalledArenas);
+    
+    std::vector<CVariant>& variants = a_nSampleId == 0 ? m_aBaseVariantList[a_nContigId] : m_aCalledVariantList[a_nContigId];
+    std::vector<CVariant>& notAssessedVariants = a_nSampleId == 0 ? m_aBaseNotAssessedVariantList[a_nContigId] : m_aCalledNotAssessedVariantList[a_nContigId];
+    
+    CVariant variant;
+    int id = 0;
+    unsigned int regionIterator = 0;
+    std::vector<CVariant> multiTrimmableVarList;
+    
+    std::cout << "Processing chromosome " + contigName + " of " + sampleNameStr + " vcf\n" << std::flush;
+    
+    while(reader.GetNextRecord(&variant, id++, a_rConfig))
+    {
+        if(pRegions != NULL)
+        {
+            //Skip to next region
+            while(regionIterator < pRegions->size() && variant.m_nOriginalPos >= (*pRegions)[regionIterator].m_nEndPos)
+                regionIterator++;
+            
+            //All regions of the contig are finished
+            if(regionIterator == pRegions->size())
+                break;
+            
+            //Variant Could not pass from BED region
+            if((*pRegions)[regionIterator].m_nStartPos >= (variant.m_nOriginalPos + variant.GetRefLength()))
+            {
+                variant.DiscardStrings();
+                continue;
+            }
+        }
+        
+        AddVariant(variant, a_rConfig, variants, notAssessedVariants, multiTrimmableVarList);
+    }
+    
+    FindOptimalTrimmings(multiTrimmableVarList, sampleName);
+    AppendTrimmedVariants(multiTrimmableVarList, sampleName);
+    
+    CUtils::SortVariants(notAssessedVariants);
+    CUtils::SortVariants(variants);
+}
+
+void CVariantProvider::AddVariant(CVariant& a_rVariant, const SConfig& a_rConfig, std::vector<CVariant>& a_rVariants, std::vector<CVariant>& a_rNotAssessedVariants, std::vector<CVariant>& a_rMultiTrimmableVariants)
+{
+    if(!a_rVariant.m_bIsNoCall && CUtils::IsHomRef(a_rVariant))
+    {
+        a_rVariant.DiscardStrings();
+        return;
+    }
+    
+    if(a_rConfig.m_bIsFilterEnabled && a_rVariant.m_bIsFilterPASS == false)
+        a_rNotAssessedVariants.push_back(std::move(a_rVariant));
+    
+    else if(a_rConfig.m_bSNPOnly && a_rVariant.GetVariantType() != eSNP)
+        a_rNotAssessedVariants.push_back(std::move(a_rVariant));
+    
+    else if(a_rConfig.m_bINDELOnly && a_rVariant.GetVariantType() != eINDEL)
+        a_rNotAssessedVariants.push_back(std::move(a_rVariant));
+    
+    else if(CUtils::IsStructuralVariant(a_rVariant, a_rConfig.m_nMaxVariantSize))
+        a_rNotAssessedVariants.push_back(std::move(a_rVariant));
+    
+    else if(true == a_rVariant.m_bHaveMultipleTrimOption)
+        a_rMultiTrimmableVariants.push_back(std::move(a_rVariant));
+    
+    else
+        a_rVariants.push_back(std::move(a_rVariant));
+}
+
 
 void CVariantProvider::FillVariantLists()
 {
@@ -240,8 +428,11 @@ void CVariantProvider::FillVariantLists()
     m_aBaseNotAssessedVariantList = std::vector<std::vector<CVariant>>(m_baseVCF.GetContigs().size());
     m_aCalledNotAssessedVariantList = std::vector<std::vector<CVariant>>(m_calledVCF.GetContigs().size());
     
-    FillVariantForSample(eBASE, m_config);
-    FillVariantForSample(eCALLED, m_config);
+    //Base and called samples are filled into separate lists, so they are read in parallel
+    const int sampleThreadCount = std::max(1, m_config.m_nThreadCount / 2);
+    std::thread calledThread(&CVariantProvider::FillVariantForSample, this, eCALLED, std::ref(m_config), sampleThreadCount);
+    FillVariantForSample(eBASE, m_config, sampleThreadCount);
+    calledThread.join();
 }
 
 void CVariantProvider::FillOrientedVariantLists()
@@ -251,21 +442,18 @@ void CVariantProvider::FillOrientedVariantLists()
     m_aCalledOrientedVariantList = std::vector<std::vector<core::COrientedVariant>>(m_calledVCF.GetContigs().size());
     
     for(unsigned int i=0; i < m_aBaseOrientedVariantList.size(); i++)
-    {
-        for(unsigned int j=0; j < m_aBaseVariantList[i].size(); j++)
-        {
-            m_aBaseOrientedVariantList[i].push_back(core::COrientedVariant(m_aBaseVariantList[i][j], true));
-            m_aBaseOrientedVariantList[i].push_back(core::COrientedVariant(m_aBaseVariantList[i][j], false));
-        }
-    }
+        FillOrientedVariantList(m_aBaseVariantList[i], m_aBaseOrientedVariantList[i]);
     
     for(unsigned int i=0; i < m_aCalledOrientedVariantList.size(); i++)
+        FillOrientedVariantList(m_aCalledVariantList[i], m_aCalledOrientedVariantList[i]);
+}
+
+void CVariantProvider::FillOrientedVariantList(const std::vector<CVariant>& a_rVariantList, std::vector<core::COrientedVariant>& a_rOrientedVariantList)
+{
+    for(unsigned int j=0; j < a_rVariantList.size(); j++)
     {
-        for(unsigned int j=0; j < m_aCalledVariantList[i].size(); j++)
-        {
-            m_aCalledOrientedVariantList[i].push_back(core::COrientedVariant(m_aCalledVariantList[i][j], true));
-            m_aCalledOrientedVariantList[i].push_back(core::COrientedVariant(m_aCalledVariantList[i][j], false));
-        }
+        a_rOrientedVariantList.push_back(core::COrientedVariant(a_rVariantList[j], true));
+        a_rOrientedVariantList.push_back(core::COrientedVariant(a_rVariantList[j], false));
     }
 }
 
@@ -292,28 +480,6 @@ void CVariantProvider::FillAlleleMatchVariantList(SChrIdTuple& a_tuple, std::vec
     }
 }
 
-std::vector<const CVariant*> CVariantProvider::GetVariantList(EVcfName a_uFrom, int a_nChrNo, const std::vector<int>& a_VariantIndexes)
-{
-    std::vector<const CVariant*> result;
-
-    switch (a_uFrom)
-    {
-        case eBASE:
-            for(unsigned int k=0; k < a_VariantIndexes.size(); k++)
-                result.push_back(&(m_aBaseVariantList[a_nChrNo][a_VariantIndexes[k]]));
-            break;
-            
-        case eCALLED:
-            for(unsigned int k=0; k < a_VariantIndexes.size(); k++)
-                result.push_back(&(m_aCalledVariantList[a_nChrNo][a_VariantIndexes[k]]));
-            
-        default:
-            break;
-    }
-
-    return result;
-}
-
 std::vector<const CVariant*> CVariantProvider::GetVariantList(EVcfName a_uFrom, int a_nChrNo)
 {
     unsigned long size = a_uFrom == eBASE ? m_aBaseVariantList[a_nChrNo].size() : m_aCalledVariantList[a_nChrNo].size();
@@ -337,14 +503,56 @@ std::vector<const CVariant*> CVariantProvider::GetVariantList(EVcfName a_uFrom,
     return result;
 }
 
-std::vector<const CVariant*> CVariantProvider::GetVariantList(std::vector<const CVariant*>& a_varList, const std::vector<int>& a_VariantIndexes)
+std::vector<const CVariant*> CVariantProvider::GetExcludedVariantList(EVcfName a_uFrom, int a_nChrNo, const core::CDecisionArray& a_rDecisions)
+{
+    const std::vector<CVariant>& variantList = a_uFrom == eBASE ? m_aBaseVariantList[a_nChrNo] : m_aCalledVariantList[a_nChrNo];
+    std::vector<const CVariant*> result;
+    result.reserve(a_rDecisions.GetExcludedCount());
+    
+    for(int k = 0; k < a_rDecisions.GetVariantCount(); k++)
+    {
+        if(a_rDecisions.IsExcluded(k))
+            result.push_back(&variantList[k]);
+    }
+    
+    return result;
+}
+
+std::vector<const CVariant*> CVariantProvider::GetExcludedVariantList(const std::vector<const CVariant*>& a_varList, const core::CDecisionArray& a_rDecisions)
+{
+    std::vector<const CVariant*> result;
+    result.reserve(a_rDecisions.GetExcludedCount());
+    
+    for(int k = 0; k < a_rDecisions.GetVariantCount(); k++)
+    {
+        if(a_rDecisions.IsExcluded(k))
+            result.push_back(a_varList[k]);
+    }
+    
+    return result;
+}
+
+std::vector<const core::COrientedVariant*> CVariantProvider::GetIncludedVariantList(EVcfName a_uFrom, int a_nChrNo, bool a_bIsGenotypeMatch, const core::CDecisionArray& a_rDecisions)
 {
-    std::vector<const CVariant*> result(a_VariantIndexes.size());
+    const std::vector<core::COrientedVariant>* pOrientedVariantList;
+    if(a_bIsGenotypeMatch)
+        pOrientedVariantList = a_uFrom == eBASE ? &m_aBaseOrientedVariantList[a_nChrNo] : &m_aCalledOrientedVariantList[a_nChrNo];
+    else
+        pOrientedVariantList = a_uFrom == eBASE ? &m_aBaseHomozygousOrientedVariantList[a_nChrNo] : &m_aCalledHomozygousOrientedVariantList[a_nChrNo];
+    
+    std::vector<const core::COrientedVariant*> result;
+    result.reserve(a_rDecisions.GetIncludedCount());
     
-    for(unsigned int k = 0; k < a_VariantIndexes.size(); k++)
+    //Oriented variants are stored in pairs for each variant, the decision selects one of the pair
+    for(int k = 0; k < a_rDecisions.GetVariantCount(); k++)
     {
-        result[k] = a_varList[a_VariantIndexes[k]];
+        const core::EVariantDecision decision = a_rDecisions.Get(k);
+        if(decision == core::eDECISION_INCLUDED_FIRST)
+            result.push_back(&(*pOrientedVariantList)[2 * k]);
+        else if(decision == core::eDECISION_INCLUDED_SECOND)
+            result.push_back(&(*pOrientedVariantList)[2 * k + 1]);
     }
+    
     return result;
 }
 
@@ -447,5 +655,5 @@ void CVariantProvider::AppendTrimmedVariants(std::vector<CVariant>& a_rVariantLi
     std::vector<std::vector<CVariant>>& variantList = (a_uFrom == eCALLED) ? m_aCalledVariantList : m_aBaseVariantList;
     
     for(unsigned int k = 0; k < a_rVariantList.size(); k++)
-        variantList[a_rVariantList[k].m_nChrId].push_back(a_rVariantList[k]);
+        variantList[a_rVariantList[k].m_nChrId].push_back(std::move(a_rVariantList[k]));
 }
@@ -29,6 +29,7 @@
 #include <algorithm>
 #include "CGa4ghOutputProvider.h"
 #include "CSplitOutputProvider.h"
+#include "Utils/CPhaseTimer.h"
 #include <fstream>
 
 using namespace duocomparison;
@@ -36,7 +37,7 @@ using namespace duocomparison;
 void CVcfAnalyzer::Run(int argc, char** argv)
 {
     
-    std::time_t start;
+    CPhaseTimer timer;
     double duration;
     
     //Read command line parameters to m_config object
@@ -48,7 +49,7 @@ void CVcfAnalyzer::Run(int argc, char** argv)
     std::cout << "MaxPath: " << m_config.m_nMaxPathSize << std::endl;
     std::cout << "MaxIteration: " << m_config.m_nMaxIterationCount << std::endl;
 
-    start = std::time(0);
+    timer.Start();
     
     //Initialize Variant providers which contains VCF and FASTA files
     isSuccess = m_provider.InitializeReaders(m_config);
@@ -56,38 +57,56 @@ void CVcfAnalyzer::Run(int argc, char** argv)
     if(!isSuccess)
         return;
     
-    duration = std::difftime(std::time(0) ,start);
-    std::cout << "Vcf and fasta Parser read completed in " << duration << " secs" << std::endl;
+    double parseDuration = timer.EndPhase("parse");
+    std::cout << "Vcf and fasta Parser read completed in " << parseDuration << " secs" << std::endl;
     
-    std::time_t start1 = std::time(0);
+    //Cached decisions are only valid for the replay settings they are created with
+    if(m_config.m_bUseReplayCache)
+    {
+        uint64_t settingsHash = core::CombineHash(m_config.m_nMaxPathSize, m_config.m_nMaxIterationCount);
+        settingsHash = core::CombineHash(settingsHash, m_config.m_complexRegionMode);
+        settingsHash = core::CombineHash(settingsHash, m_config.m_nBeamWidth);
+        settingsHash = core::CombineHash(settingsHash, m_config.m_bAdaptiveBudget);
+        if(!m_replayCache.Open(m_config.m_pReplayCacheDirectory, settingsHash))
+            std::cerr << "Replay cache is disabled" << std::endl;
+    }
+    
+    if(m_config.m_bWriteReplayStats && !m_replayStats.Open(m_config.m_pReplayStatsPath))
+        std::cerr << "Replay statistics are disabled" << std::endl;
     
     //Creates the threads according to given memory and process the data
-    AssignJobsToThreads(m_config.m_nThreadCount);
+    if(m_provider.IsStreaming())
+        ProcessChromosomesStreaming(m_config.m_nThreadCount);
+    else
+        AssignJobsToThreads(m_config.m_nThreadCount);
     
+    m_replayStats.Close();
     
-    if(0 == strcmp(m_config.m_pOutputMode, "SPLIT"))
+    if(m_replayCache.IsOpen())
     {
-        std::cerr << "Generating Outputs [SPLIT MODE]..." << std::endl;
-        CSplitOutputProvider outputprovider;
-        outputprovider.SetVcfPath(m_config.m_pOutputDirectory);
-        outputprovider.SetVariantProvider(&m_provider);
-        outputprovider.SetBestPaths(m_aBestPaths);
-        outputprovider.SetContigList(m_provider.GetContigs());
-        outputprovider.GenerateSplitVcfs(m_provider.GetChromosomeIdTuples());
+        std::cout << "Replay cache hits: " << m_replayCache.GetHitCount() << ", misses: " << m_replayCache.GetMissCount();
+        std::cout << ", new regions: " << m_replayCache.GetInsertCount() << std::endl;
+        m_replayCache.Save();
     }
     
-    else
+    //Parsing, replay and output of the chromosomes overlap in streaming mode
+    if(m_provider.IsStreaming())
     {
-        std::cerr << "Generating Outputs [GA4GH MODE]..." << std::endl;
-        CGa4ghOutputProvider outputprovider;
-        outputprovider.SetVcfPath(m_config.m_pOutputDirectory);
-        outputprovider.SetVariantProvider(&m_provider);
-        outputprovider.SetBestPaths(m_aBestPaths, m_aBestPathsAllele);
-        outputprovider.SetContigList(m_provider.GetContigs());
-        outputprovider.GenerateGa4ghVcf(m_provider.GetChromosomeIdTuples());
+        duration = timer.EndPhase("streaming");
+        std::cout << "Streaming comparison completed in " << duration << " secs" << std::endl;
     }
     
-    if(true == m_config.m_bGenerateSyncPoints)
+    else
+    {
+        duration = timer.EndPhase("replay");
+        std::cout << "Best path replay completed in " << duration << " secs" << std::endl;
+        GenerateOutputs();
+        duration = timer.EndPhase("output");
+        std::cout << "Output generation completed in " << duration << " secs" << std::endl;
+    }
+
+    //Sync points of the streamed chromosomes are written while they are processed
+    if(true == m_config.m_bGenerateSyncPoints && !m_provider.IsStreaming())
     {
         std::vector<SChrIdTuple> chromosomeListToProcess = m_provider.GetChromosomeIdTuples();
         m_resultLogger.OpenSyncPointFile(std::string(m_config.m_pOutputDirectory) + "/SyncPointList.txt");
@@ -104,10 +123,39 @@ void CVcfAnalyzer::Run(int argc, char** argv)
     int logMode = (0 == strcmp(m_config.m_pOutputMode, "SPLIT") ? 0 : 2) + (m_config.m_bIsGenotypeMatch ? 0 : 1);
     m_resultLogger.WriteStatistics(logMode);
     
-    duration = std::difftime(std::time(0), start1);
-    std::cout << "Processing Chromosomes completed in " << duration << " secs" << std::endl;
-    duration = std::difftime(std::time(0), start);
+    timer.EndPhase("logs");
+    
+    duration = timer.GetElapsedSeconds();
+    std::cout << "Processing Chromosomes completed in " << duration - parseDuration << " secs" << std::endl;
     std::cout << "Total execution time is " << duration << " secs" << std::endl;
+    
+    if(m_config.m_bWriteTimings)
+        timer.WriteJson(m_config.m_pTimingsPath);
+}
+
+void CVcfAnalyzer::GenerateOutputs()
+{
+    if(0 == strcmp(m_config.m_pOutputMode, "SPLIT"))
+    {
+        std::cerr << "Generating Outputs [SPLIT MODE]..." << std::endl;
+        CSplitOutputProvider outputprovider;
+        outputprovider.SetVcfPath(m_config.m_pOutputDirectory);
+        outputprovider.SetVariantProvider(&m_provider);
+        outputprovider.SetBestPaths(m_aBestPaths);
+        outputprovider.SetContigList(m_provider.GetContigs());
+        outputprovider.GenerateSplitVcfs(m_provider.GetChromosomeIdTuples());
+    }
+    
+    else
+    {
+        std::cerr << "Generating Outputs [GA4GH MODE]..." << std::endl;
+        CGa4ghOutputProvider outputprovider;
+        outputprovider.SetVcfPath(m_config.m_pOutputDirectory);
+        outputprovider.SetVariantProvider(&m_provider);
+        outputprovider.SetBestPaths(m_aBestPaths, m_aBestPathsAllele);
+        outputprovider.SetContigList(m_provider.GetContigs());
+        outputprovider.GenerateGa4ghVcf(m_provider.GetChromosomeIdTuples());
+    }
 }
 
 int CVcfAnalyzer::AssignJobsToThreads(int a_nThreadCount)
@@ -119,40 +167,137 @@ int CVcfAnalyzer::AssignJobsToThreads(int a_nThreadCount)
     m_aBestPaths = std::vector<core::CPath>(chromosomeListToProcess.size());
     m_aBestPathsAllele = std::vector<core::CPath>(chromosomeListToProcess.size());
     
-    int exactThreadCount = std::min(a_nThreadCount, (int)chromosomeListToProcess.size());
-        
-    //Allocate threads
-    m_pThreadPool = new std::thread[exactThreadCount];
-    
-    int threadPoolIt = 0;
-    std::vector<SChrIdTuple> *chromosomeLists = new std::vector<SChrIdTuple>[exactThreadCount];
-    
-    //Divide tasks into threads
+    //Order the chromosomes by estimated replay cost so that the largest ones do not start last
+    std::vector<double> costs(chromosomeListToProcess.size());
+    std::vector<int> order(chromosomeListToProcess.size());
     for(unsigned int k = 0; k < chromosomeListToProcess.size(); k++)
     {
-        chromosomeLists[threadPoolIt].push_back(chromosomeListToProcess[k]);
-        threadPoolIt = (threadPoolIt+1) % exactThreadCount;
+        costs[k] = core::CPathReplay::EstimateCost(m_provider.GetVariantList(eBASE, chromosomeListToProcess[k].m_nBaseId),
+                                                   m_provider.GetVariantList(eCALLED, chromosomeListToProcess[k].m_nCalledId));
+        order[k] = k;
     }
+    std::stable_sort(order.begin(), order.end(), [&costs](int a_nLhs, int a_nRhs) { return costs[a_nLhs] > costs[a_nRhs]; });
+    
+    core::CTaskScheduler scheduler(a_nThreadCount);
+    m_pScheduler = &scheduler;
     
-    //Assign divided task to the threads
-    for(int k = 0; k < exactThreadCount; k++)
+    //Submit each chromosome as a separate task. Idle threads steal the replay blocks of the remaining chromosomes
     {
-        if(0 == strcmp("SPLIT", m_config.m_pOutputMode))
-            m_pThreadPool[k] = std::thread(&CVcfAnalyzer::ThreadFunctionSPLIT, this, chromosomeLists[k], m_config.m_bIsGenotypeMatch);
-        else
-            m_pThreadPool[k] = std::thread(&CVcfAnalyzer::ThreadFunctionGA4GH, this, chromosomeLists[k]);
+        core::CTaskGroup chromosomeTasks(scheduler);
+        for(unsigned int k = 0; k < order.size(); k++)
+        {
+            std::vector<SChrIdTuple> tuples(1, chromosomeListToProcess[order[k]]);
+            
+            if(0 == strcmp("SPLIT", m_config.m_pOutputMode))
+                chromosomeTasks.Run(std::bind(&CVcfAnalyzer::ThreadFunctionSPLIT, this, tuples, m_config.m_bIsGenotypeMatch));
+            else
+                chromosomeTasks.Run(std::bind(&CVcfAnalyzer::ThreadFunctionGA4GH, this, tuples));
+        }
+        chromosomeTasks.Wait();
     }
     
-    for(int k = 0; k < exactThreadCount; k++)
-        m_pThreadPool[k].join();
+    m_pScheduler = NULL;
 
-    //Clear allocated memory
-    delete[] chromosomeLists;
-    delete[] m_pThreadPool;
-
-    return exactThreadCount;
+    return scheduler.GetThreadCount();
 }
 
+void CVcfAnalyzer::ProcessChromosomesStreaming(int a_nThreadCount)
+{
+    //Chromosomes are processed in the output order
+    std::vector<SChrIdTuple> chromosomeListToProcess = m_provider.GetChromosomeIdTuples();
+    const bool isSplitMode = 0 == strcmp("SPLIT", m_config.m_pOutputMode);
+    
+    //Best path of a chromosome is only kept until its output is written
+    m_aBestPaths = std::vector<core::CPath>(chromosomeListToProcess.size());
+    m_aBestPathsAllele = std::vector<core::CPath>(chromosomeListToProcess.size());
+    
+    CSplitOutputProvider splitOutputProvider;
+    CGa4ghOutputProvider ga4ghOutputProvider;
+    
+    if(isSplitMode)
+    {
+        std::cerr << "Generating Outputs [SPLIT MODE]..." << std::endl;
+        splitOutputProvider.SetVcfPath(m_config.m_pOutputDirectory);
+        splitOutputProvider.SetVariantProvider(&m_provider);
+        splitOutputProvider.SetContigList(m_provider.GetContigs());
+        splitOutputProvider.SetBeamSearchMode(m_config.m_complexRegionMode == eCOMPLEX_REGION_BEAM);
+        splitOutputProvider.OpenSplitVcfs();
+    }
+    
+    else
+    {
+        std::cerr << "Generating Outputs [GA4GH MODE]..." << std::endl;
+        ga4ghOutputProvider.SetVcfPath(m_config.m_pOutputDirectory);
+        ga4ghOutputProvider.SetVariantProvider(&m_provider);
+        ga4ghOutputProvider.SetContigList(m_provider.GetContigs());
+        ga4ghOutputProvider.SetBeamSearchMode(m_config.m_complexRegionMode == eCOMPLEX_REGION_BEAM);
+        ga4ghOutputProvider.OpenGa4ghVcf();
+    }
+    
+    if(true == m_config.m_bGenerateSyncPoints)
+        m_resultLogger.OpenSyncPointFile(std::string(m_config.m_pOutputDirectory) + "/SyncPointList.txt");
+    
+    core::CTaskScheduler scheduler(a_nThreadCount);
+    m_pScheduler = &scheduler;
+    
+    bool isLoaded = chromosomeListToProcess.size() > 0 && m_provider.LoadChromosome(chromosomeListToProcess[0]);
+    
+    for(unsigned int k = 0; k < chromosomeListToProcess.size(); k++)
+    {
+        const SChrIdTuple& tuple = chromosomeListToProcess[k];
+        
+        //Next chromosome is parsed while the current one is compared and written
+        bool isNextLoaded = false;
+        std::thread producerThread;
+        if(k + 1 < chromosomeListToProcess.size())
+            producerThread = std::thread([this, &isNextLoaded, &chromosomeListToProcess, k]() { isNextLoaded = m_provider.LoadChromosome(chromosomeListToProcess[k + 1]); });
+        
+        if(isLoaded)
+        {
+            //Replay blocks of the chromosome are distributed to the scheduler threads
+            {
+                core::CTaskGroup chromosomeTask(scheduler);
+                std::vector<SChrIdTuple> tuples(1, tuple);
+                
+                if(isSplitMode)
+                    chromosomeTask.Run(std::bind(&CVcfAnalyzer::ThreadFunctionSPLIT, this, tuples, m_config.m_bIsGenotypeMatch));
+                else
+                    chromosomeTask.Run(std::bind(&CVcfAnalyzer::ThreadFunctionGA4GH, this, tuples));
+                chromosomeTask.Wait();
+            }
+            
+            if(isSplitMode)
+                splitOutputProvider.AddChromosome(m_aBestPaths[tuple.m_nTupleIndex], tuple);
+            else
+                ga4ghOutputProvider.AddChromosome(m_aBestPaths[tuple.m_nTupleIndex], tuple);
+            
+            if(true == m_config.m_bGenerateSyncPoints)
+            {
+                std::vector<core::CSyncPoint> syncPointList;
+                CalculateSyncPointList(tuple, syncPointList);
+                m_resultLogger.WriteSyncPointList(tuple.m_chrName, syncPointList);
+            }
+        }
+        
+        m_provider.ReleaseChromosome(tuple);
+        m_aBestPaths[tuple.m_nTupleIndex] = core::CPath();
+        m_aBestPathsAllele[tuple.m_nTupleIndex] = core::CPath();
+        
+        if(producerThread.joinable())
+            producerThread.join();
+        isLoaded = isNextLoaded;
+    }
+    
+    m_pScheduler = NULL;
+    
+    if(true == m_config.m_bGenerateSyncPoints)
+        m_resultLogger.CloseSyncPointFile();
+    
+    if(isSplitMode)
+        splitOutputProvider.CloseSplitVcfs();
+    else
+        ga4ghOutputProvider.CloseGa4ghVcf();
+}
 
 void CVcfAnalyzer::ThreadFunctionGA4GH(std::vector<SChrIdTuple> a_aTuples)
 {
@@ -163,8 +308,13 @@ void CVcfAnalyzer::ThreadFunctionGA4GH(std::vector<SChrIdTuple> a_aTuples)
         std::vector<const core::COrientedVariant*> ovarListBase = m_provider.GetOrientedVariantList(eBASE, a_aTuples[k].m_nBaseId, true);
         std::vector<const core::COrientedVariant*> ovarListCalled = m_provider.GetOrientedVariantList(eCALLED, a_aTuples[k].m_nCalledId, true);
         
-        core::CPathReplay pathReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
+        core::CParallelPathReplay pathReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
         pathReplay.SetMaxPathAndIteration(m_config.m_nMaxPathSize, m_config.m_nMaxIterationCount);
+        pathReplay.SetComplexRegionMode(m_config.m_complexRegionMode, m_config.m_nBeamWidth);
+        pathReplay.SetAdaptiveBudget(m_config.m_bAdaptiveBudget);
+        pathReplay.SetReplayCache(m_replayCache.IsOpen() ? &m_replayCache : NULL);
+        pathReplay.SetReplayStats(m_replayStats.IsOpen() ? &m_replayStats : NULL, "base-called");
+        pathReplay.SetScheduler(m_pScheduler);
         SContig ctg;
         mtx.lock();
         bool IsContigAvailable = m_provider.ReadContig(a_aTuples[k].m_chrName, ctg);
@@ -183,45 +333,29 @@ void CVcfAnalyzer::ThreadFunctionGA4GH(std::vector<SChrIdTuple> a_aTuples)
             continue;
         }
         
-        //Find Best Path [GENOTYPE MATCH]
-        m_aBestPaths[a_aTuples[k].m_nTupleIndex] = pathReplay.FindBestPath(ctg,true);
+        //Find Best Path [GENOTYPE MATCH] and [ALLELE MATCH] of the genotype mismatches
+        pathReplay.FindBestPaths(ctg, m_aBestPaths[a_aTuples[k].m_nTupleIndex], m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex]);
         
         //Genotype Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsBase = m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsCall = m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
+        std::vector<const core::COrientedVariant*> includedVarsBase = m_provider.GetIncludedVariantList(eBASE, a_aTuples[k].m_nBaseId, true, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetDecisions());
+        std::vector<const core::COrientedVariant*> includedVarsCall = m_provider.GetIncludedVariantList(eCALLED, a_aTuples[k].m_nCalledId, true, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetDecisions());
         
-        //Variants that will be passed for allele match check
-        std::vector<const CVariant*> excludedVarsBase = m_provider.GetVariantList(eBASE, a_aTuples[k].m_nBaseId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsCall = m_provider.GetVariantList(eCALLED, a_aTuples[k].m_nCalledId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetExcluded());
+        //Variants that are passed for allele match check
+        std::vector<const CVariant*> excludedVarsBase = m_provider.GetExcludedVariantList(eBASE, a_aTuples[k].m_nBaseId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetDecisions());
+        std::vector<const CVariant*> excludedVarsCall = m_provider.GetExcludedVariantList(eCALLED, a_aTuples[k].m_nCalledId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetDecisions());
         
         //Fill oriented variants for allele match
         m_provider.FillAlleleMatchVariantList(a_aTuples[k], excludedVarsBase, excludedVarsCall);
         
-        //Clear old variant pointers
-        ovarListBase.clear();
-        ovarListCalled.clear();
-        varListBase.clear();
-        varListCalled.clear();
-        
-        //Set new variant pointers for allele match comparison
-        varListBase = excludedVarsBase;
-        varListCalled = excludedVarsCall;
-        ovarListBase = m_provider.GetOrientedVariantList(eBASE, a_aTuples[k].m_nBaseId, false);
-        ovarListCalled = m_provider.GetOrientedVariantList(eCALLED, a_aTuples[k].m_nCalledId, false);
-        pathReplay.Clear();
-        
-        //Find Best Path [ALLELE MATCH]
-        m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex] = pathReplay.FindBestPath(ctg, false);
-        
         //No Match variants
-        std::vector<const CVariant*> excludedVarsBase2 = m_provider.GetVariantList(excludedVarsBase,
-                                                                                   m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsCall2 = m_provider.GetVariantList(excludedVarsCall,
-                                                                                   m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetExcluded());
+        std::vector<const CVariant*> excludedVarsBase2 = m_provider.GetExcludedVariantList(excludedVarsBase,
+                                                                                          m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetDecisions());
+        std::vector<const CVariant*> excludedVarsCall2 = m_provider.GetExcludedVariantList(excludedVarsCall,
+                                                                                          m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetDecisions());
         
         //Allele Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsBase2 = m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsCall2 = m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
+        std::vector<const core::COrientedVariant*> includedVarsBase2 = m_provider.GetIncludedVariantList(eBASE, a_aTuples[k].m_nBaseId, false, m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetDecisions());
+        std::vector<const core::COrientedVariant*> includedVarsCall2 = m_provider.GetIncludedVariantList(eCALLED, a_aTuples[k].m_nCalledId, false, m_aBestPathsAllele[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetDecisions());
         
         mtx.lock();
         m_resultLogger.LogStatistic(a_aTuples[k].m_chrName,
@@ -272,8 +406,13 @@ void CVcfAnalyzer::ThreadFunctionSPLIT(std::vector<SChrIdTuple> a_aTuples, bool
         ovarListBase = m_provider.GetOrientedVariantList(eBASE, a_aTuples[k].m_nBaseId, a_bIsGenotypeMatch);
         ovarListCalled = m_provider.GetOrientedVariantList(eCALLED, a_aTuples[k].m_nCalledId, a_bIsGenotypeMatch);
         
-        core::CPathReplay pathReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
+        core::CParallelPathReplay pathReplay(varListBase, varListCalled, ovarListBase, ovarListCalled);
         pathReplay.SetMaxPathAndIteration(m_config.m_nMaxPathSize, m_config.m_nMaxIterationCount);
+        pathReplay.SetComplexRegionMode(m_config.m_complexRegionMode, m_config.m_nBeamWidth);
+        pathReplay.SetAdaptiveBudget(m_config.m_bAdaptiveBudget);
+        pathReplay.SetReplayCache(m_replayCache.IsOpen() ? &m_replayCache : NULL);
+        pathReplay.SetReplayStats(m_replayStats.IsOpen() ? &m_replayStats : NULL, "base-called");
+        pathReplay.SetScheduler(m_pScheduler);
         
         SContig ctg;
         mtx.lock();
@@ -295,12 +434,12 @@ void CVcfAnalyzer::ThreadFunctionSPLIT(std::vector<SChrIdTuple> a_aTuples, bool
         m_aBestPaths[a_aTuples[k].m_nTupleIndex] = pathReplay.FindBestPath(ctg,a_bIsGenotypeMatch);
         
         //Genotype Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsBase = m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsCall = m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();
+        std::vector<const core::COrientedVariant*> includedVarsBase = m_provider.GetIncludedVariantList(eBASE, a_aTuples[k].m_nBaseId, a_bIsGenotypeMatch, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetDecisions());
+        std::vector<const core::COrientedVariant*> includedVarsCall = m_provider.GetIncludedVariantList(eCALLED, a_aTuples[k].m_nCalledId, a_bIsGenotypeMatch, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetDecisions());
         
         //Variants that will be passed for allele match check
-        std::vector<const CVariant*> excludedVarsBase = m_provider.GetVariantList(eBASE, a_aTuples[k].m_nBaseId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsCall = m_provider.GetVariantList(eCALLED, a_aTuples[k].m_nCalledId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetExcluded());
+        std::vector<const CVariant*> excludedVarsBase = m_provider.GetExcludedVariantList(eBASE, a_aTuples[k].m_nBaseId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_baseSemiPath.GetDecisions());
+        std::vector<const CVariant*> excludedVarsCall = m_provider.GetExcludedVariantList(eCALLED, a_aTuples[k].m_nCalledId, m_aBestPaths[a_aTuples[k].m_nTupleIndex].m_calledSemiPath.GetDecisions());
         
         mtx.lock();
         m_resultLogger.LogStatistic(a_aTuples[k].m_chrName,
@@ -333,11 +472,14 @@ void CVcfAnalyzer::ThreadFunctionSPLIT(std::vector<SChrIdTuple> a_aTuples, bool
 
 void CVcfAnalyzer::CalculateSyncPointList(const SChrIdTuple& a_rTuple, std::vector<core::CSyncPoint>& a_rSyncPointList)
 {
-    std::vector<const core::COrientedVariant*> pBaseIncluded = m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetIncludedVariants();
-    std::vector<const core::COrientedVariant*> pCalledIncluded = m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetIncludedVariants();;
+    //Best paths are allele match paths only in SPLIT mode with allele matching
+    const bool isGenotypeMatch = 0 != strcmp(m_config.m_pOutputMode, "SPLIT") || m_config.m_bIsGenotypeMatch;
+    
+    std::vector<const core::COrientedVariant*> pBaseIncluded = m_provider.GetIncludedVariantList(eBASE, a_rTuple.m_nBaseId, isGenotypeMatch, m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetDecisions());
+    std::vector<const core::COrientedVariant*> pCalledIncluded = m_provider.GetIncludedVariantList(eCALLED, a_rTuple.m_nCalledId, isGenotypeMatch, m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetDecisions());
     
-    std::vector<const CVariant*> pBaseExcluded = m_provider.GetVariantList(eBASE, a_rTuple.m_nBaseId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetExcluded());
-    std::vector<const CVariant*> pCalledExcluded = m_provider.GetVariantList(eCALLED, a_rTuple.m_nCalledId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetExcluded());
+    std::vector<const CVariant*> pBaseExcluded = m_provider.GetExcludedVariantList(eBASE, a_rTuple.m_nBaseId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_baseSemiPath.GetDecisions());
+    std::vector<const CVariant*> pCalledExcluded = m_provider.GetExcludedVariantList(eCALLED, a_rTuple.m_nCalledId, m_aBestPaths[a_rTuple.m_nTupleIndex].m_calledSemiPath.GetDecisions());
     
     core::CPath *pPath = &m_aBestPaths[a_rTuple.m_nTupleIndex];
     
@@ -467,6 +609,14 @@ bool CVcfAnalyzer::ReadParameters(int argc, char** argv)
     const char* PARAM_MAX_PATH_SIZE = "-max-path-size";
     const char* PARAM_MAX_ITERATION_COUNT = "-max-iteration-count";
     const char* PARAM_MAX_BP_LENGTH = "-max-bp-length";
+    const char* PARAM_COMPLEX_MODE = "-complex-mode";
+    const char* PARAM_BEAM_WIDTH = "-beam-width";
+    const char* PARAM_ADAPTIVE_BUDGET = "--adaptive-budget";
+    const char* PARAM_USE_PHASING = "--use-phasing";
+    const char* PARAM_CACHE_DIR = "-cache-dir";
+    const char* PARAM_REPLAY_STATS = "-replay-stats";
+    const char* PARAM_TIMINGS = "-timings";
+    const char* PARAM_STREAMING = "--streaming";
     
     bool bBaselineSet = false;
     bool bCalledSet = false;
@@ -625,11 +775,74 @@ bool CVcfAnalyzer::ReadParameters(int argc, char** argv)
             m_config.m_nMaxVariantSize = atoi(argv[it+1]);
             it+=2;
         }
+
+        else if(0 == strcmp(argv[it], PARAM_COMPLEX_MODE))
+        {
+            if(0 == strcmp("skip", argv[it+1]))
+                m_config.m_complexRegionMode = eCOMPLEX_REGION_SKIP;
+            else if(0 == strcmp("beam", argv[it+1]))
+                m_config.m_complexRegionMode = eCOMPLEX_REGION_BEAM;
+            else
+            {
+                std::cout << "Invalid Complex Region Mode. skip mode is selected instead!" << std::endl;
+                m_config.m_complexRegionMode = eCOMPLEX_REGION_SKIP;
+            }
+            it+=2;
+        }
+
+        else if(0 == strcmp(argv[it], PARAM_BEAM_WIDTH))
+        {
+            m_config.m_nBeamWidth = std::max(1, atoi(argv[it+1]));
+            it+=2;
+        }
+
+        else if(0 == strcmp(argv[it], PARAM_ADAPTIVE_BUDGET))
+        {
+            m_config.m_bAdaptiveBudget = true;
+            it++;
+        }
+
+        else if(0 == strcmp(argv[it], PARAM_USE_PHASING))
+        {
+            m_config.m_bUsePhasing = true;
+            it++;
+        }
+
+        else if(0 == strcmp(argv[it], PARAM_CACHE_DIR))
+        {
+            m_config.m_pReplayCacheDirectory = argv[it+1];
+            m_config.m_bUseReplayCache = true;
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_REPLAY_STATS))
+        {
+            m_config.m_pReplayStatsPath = argv[it+1];
+            m_config.m_bWriteReplayStats = true;
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_TIMINGS))
+        {
+            m_config.m_pTimingsPath = argv[it+1];
+            m_config.m_bWriteTimings = true;
+            it+=2;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_STREAMING))
+        {
+            m_config.m_bStreaming = true;
+            it++;
+        }
         
         else
             it++; //break;
     }
     
+    //Thread count is resolved once here since it is split between the vcf readers before the scheduler is created
+    if(m_config.m_nThreadCount < 1)
+        m_config.m_nThreadCount = core::CTaskScheduler::GetDefaultThreadCount();
+    
     if(!bBaselineSet)
         std::cout << "Baseline vcf file is not set" << std::endl;
     else if(!bCalledSet)
@@ -660,12 +873,20 @@ void CVcfAnalyzer::PrintHelp() const
     std::cout << "-sample-base <sample_name>   [Optional.Read only the given sample in base VCF. Default value is the first sample.]" << std::endl;
     std::cout << "-sample-called <sample_name> [Optional.Read only the given sample in called VCF. Default value is the first sample.]" << std::endl;
     std::cout << "--disable-ref-overlap        [Optional.Disable reference overlapping. Does not trim alleles]" << std::endl;
+    std::cout << "--use-phasing                [Optional.Use the phase sets (PS) of the phased genotypes. Heterozygous variants of the same phase set are matched in a single orientation]" << std::endl;
     std::cout << "--generate-sync-point        [Optional.Prints the sync point list of two vcf file. Default value is false.]" << std::endl;
     std::cout << "--trim-endings-first         [Optional.If set, starts trimming variants from ending base pairs. Default is from beginning]" << std::endl;
-    std::cout << "-thread-count                [Optional.Specify the number of threads that program will use. Default value is 2]" << std::endl;
+    std::cout << "-cache-dir <cache_directory> [Optional.Keep the decisions of the replayed regions in the given directory and reuse them in the later runs with the same settings]" << std::endl;
+    std::cout << "-replay-stats <file_path>    [Optional.Write the replay statistics of each sync region (variant counts, peak path count, iterations, time and outcome) to the given tab delimited file]" << std::endl;
+    std::cout << "-timings <file_path>         [Optional.Write the wall time, CPU time, peak memory and the durations of the parse, replay, output and logs phases to the given JSON file]" << std::endl;
+    std::cout << "-thread-count                [Optional.Specify the number of threads that program will use. Default value is the number of available cores]" << std::endl;
+    std::cout << "--streaming                  [Optional.Compare and output the chromosomes one at a time while the next chromosome is parsed, and release their variants. Keeps memory bounded by the largest chromosomes. Requires indexed (tbi/csi) vcfs]" << std::endl;
     std::cout << "-max-bp-length               [*Optional.Specify the maximum base pair length of variant to process. Default value is 1000]" << std::endl;
     std::cout << "-max-path-size <size>        [*Optional.Specify the maximum size of path that core algorithm can store inside. Default value is 150,000]" << std::endl;
     std::cout << "-max-iteration-count <count> [*Optional.Specify the maximum iteration count that core algorithm can decide to include/exclude variant. Default value is 10,000,000]" << std::endl;
+    std::cout << "-complex-mode <mode>         [*Optional.Choose what to do when a region exceeds the path size or iteration limit. skip excludes the region from the comparison, beam keeps the best scoring paths and marks the decisions as approximate (BA). Default value is skip]" << std::endl;
+    std::cout << "-beam-width <width>          [*Optional.Specify the maximum number of paths kept by the beam search mode. Default value is 1,000]" << std::endl;
+    std::cout << "--adaptive-budget            [*Optional.Estimate the complexity of each region before replay. Regions get an iteration budget proportional to the estimate, and the regions predicted to be hopeless are sent to the complex region mode directly]" << std::endl;
     std::cout << "(*) - advanced usage" << std::endl;
     std::cout << std::endl;
     std::cout << "Example Commands:" << std::endl;
@@ -35,6 +35,8 @@
 #include "CMendelianDecider.h"
 #include "ENoCallMode.h"
 #include "CViolationRegionOutputGenerator.h"
+#include "CTaskScheduler.h"
+#include "CReplayStats.h"
 #include <thread>
 #include <mutex>
 
@@ -70,7 +72,7 @@ private:
     ///A Function to process mendelian violation pipeline for given chromosome id
     void ProcessChromosome(const std::vector<SChrIdTriplet>& a_rChromosomeIds);
         
-    ///Divide the jobs between different threads homogeneously for given number of thread count. Return the actual thread count
+    ///Submit the chromosome jobs to a work stealing scheduler, most expensive chromosomes first. Return the actual thread count
     int AssignJobsToThreads(int a_nThreadCount);
     
     ///Prints the help menu at console
@@ -108,6 +110,12 @@ private:
     std::vector<core::CPath> m_aBestPathsMotherChildGT;
     std::vector<core::CPath> m_aBestPathsMotherChildAM;
     
+    ///Scheduler shared by the chromosome jobs and the replay blocks of each chromosome
+    core::CTaskScheduler* m_pScheduler;
+    
+    ///Per sync region replay statistics written by all chromosome jobs (used if a statistics file is given)
+    core::CReplayStats m_replayStats;
+    
     //To prevent data race in multi-thread mode
     std::mutex mtx;
 
@@ -32,6 +32,13 @@
 #include "EMendelianVcfName.h"
 #include "SChrIdTriplet.h"
 #include "CBaseVariantProvider.h"
+#include "CSimpleBEDParser.h"
+#include <atomic>
+
+namespace core
+{
+    class CDecisionArray;
+}
 
 namespace mendelian
 {
@@ -59,11 +66,25 @@ public:
     ///Return all the variants belongs to given chromosome sorted by variant ids
     std::vector<const CVariant*> GetSortedVariantListByIDandStartPos(EMendelianVcfName a_uFrom, int a_nChrNo) const;
 
-    ///Return all the variants belongs to given chromosome according to given index list
-    std::vector<const CVariant*> GetVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, const std::vector<int>& a_nIndexList) const;
+    ///Return the variants of the given chromosome excluded by the given best path decisions
+    std::vector<const CVariant*> GetExcludedVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, const core::CDecisionArray& a_rDecisions) const;
+
+    ///Return the variants of the given list excluded by the given best path decisions (decisions are indexed by the list)
+    std::vector<const CVariant*> GetExcludedVariantList(const std::vector<const CVariant*>& a_rVariantList, const core::CDecisionArray& a_rDecisions) const;
 
-    ///Return all the variants belongs to given List according to given index list
-    std::vector<const CVariant*> GetVariantList(const std::vector<const CVariant*> a_rVariantList, const std::vector<int>& a_nIndexList) const;
+    ///Return the oriented variants of the given chromosome included by the given genotype match decisions
+    std::vector<const core::COrientedVariant*> GetIncludedVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, const core::CDecisionArray& a_rGTDecisions) const;
+
+    /**
+     * @brief Return the oriented variants of the given chromosome included by the given allele match decisions
+     *
+     * Allele match is replayed on the variants excluded by the genotype match, so the allele match decisions are indexed by
+     * the excluded variants of the genotype match decisions.
+     */
+    std::vector<const core::COrientedVariant*> GetIncludedVariantList(EMendelianVcfName a_uFrom,
+                                                                      int a_nChrNo,
+                                                                      const core::CDecisionArray& a_rGTDecisions,
+                                                                      const core::CDecisionArray& a_rAMDecisions) const;
 
     ///Return the count of not assessed variants in vcf file - variants that contains any of *, <, >, [, ], {, } symbols at their allele string
     int GetNotAssessedVariantCount(EMendelianVcfName a_uFrom);
@@ -83,12 +104,6 @@ public:
     ///Return all the oriented variants belongs to given chromosome
     std::vector<const core::COrientedVariant*> GetOrientedVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, bool a_bIsAlleleMatch = false) const;
     
-    ///Return all the oriented variants belongs to given chromosome with provided index list
-    std::vector<const core::COrientedVariant*> GetOrientedVariantList(EMendelianVcfName a_uFrom,
-                                                                      int a_nChrNo,
-                                                                      bool a_bIsAlleleMatch,
-                                                                      const std::vector<int>& a_nIndexList) const;
-        
     //Return a list of common chromosome id triplets found in all 3 vcf file
     const std::vector<SChrIdTriplet>& GetCommonChromosomes() const;
 
@@ -103,8 +118,24 @@ private:
     //Fill the common chromosome list
     void SetCommonChromosomes();
     
-    //Fill Variants for given sample Id
-    void FillVariantForSample(int a_nSampleId, SConfig& a_rConfig);
+    //Fill Variants for given sample Id. Indexed vcfs are read per contig by a_nThreadCount threads, others sequentially
+    void FillVariantForSample(int a_nSampleId, SConfig& a_rConfig, int a_nThreadCount);
+    
+    //Distributes the contigs of the indexed vcf of the given sample to a_nThreadCount threads
+    void FillVariantForSampleByContig(int a_nSampleId, const SConfig& a_rConfig, int a_nThreadCount);
+    
+    //Reads the variants of a single contig with a separate indexed reader. Only the list of the given contig is modified
+    void FillVariantForContig(int a_nSampleId, int a_nContigId, const SConfig& a_rConfig, const CSimpleBEDParser& a_rBedParser);
+    
+    //Adds the variant to the variant list or the multiple trimming list according to the filters. Returns false if the variant is eliminated, otherwise it is moved from a_rVariant.
+    //Filtered and structural variants are counted in a_rNotAssessedVariantCount
+    bool AddVariant(CVariant& a_rVariant, const SConfig& a_rConfig, std::vector<CVariant>& a_rVariants, std::vector<CVariant>& a_rMultiTrimmableVariants, int& a_rNotAssessedVariantCount);
+    
+    //Return the not assessed variant counter of the given sample
+    std::atomic<int>& GetNotAssessedCounter(EMendelianVcfName a_uFrom);
+    
+    //Return the vcf reader of the given sample
+    CVcfReader& GetVcfReader(EMendelianVcfName a_uFrom);
     
     //Fill Variant sets for parent and child
     void FillVariants();
@@ -131,6 +162,11 @@ private:
     SConfig m_motherChildConfig;
     SConfig m_fatherChildConfig;
     
+    //Arenas of the contigs that store the strings of the variants of each vcf
+    std::vector<CVariantArena> m_aFatherArenas;
+    std::vector<CVariantArena> m_aMotherArenas;
+    std::vector<CVariantArena> m_aChildArenas;
+    
     //List that stores Father Variants in order
     std::vector<std::vector<CVariant>> m_aFatherVariantList;
     //List that stores Mother Variants in order
@@ -152,20 +188,15 @@ private:
     //List that store the allele match base Oriented variant tuples (In the order of genotype)
     std::vector<std::vector<core::COrientedVariant>> m_aChildAlleleMatchOrientedVariantList;
     
-    //Father variants which are filtered out from comparison
-    int m_nFatherNotAssessedVariantCount;
+    //Father variants which are filtered out from comparison. Contigs of a sample are filled in parallel, so the counts are atomic
+    std::atomic<int> m_nFatherNotAssessedVariantCount;
     //Mother variants which are filtered out from comparison
-    int m_nMotherNotAssessedVariantCount;
+    std::atomic<int> m_nMotherNotAssessedVariantCount;
     //Child variants which are filtered out from comparison
-    int m_nChildNotAssessedVariantCount;
+    std::atomic<int> m_nChildNotAssessedVariantCount;
     
     //Chromosomes that all three samples shares variant
     std::vector<SChrIdTriplet> m_aCommonChromosomes;
-    
-    //Variant counts contains asterisk which will are eliminated from comparison
-    int m_nMotherAsteriskCount;
-    int m_nFatherAsteriskCount;
-    int m_nChildAsteriskCount;
 };
 
 }
@@ -26,25 +26,27 @@
 #include "CMendelianAnalyzer.h"
 #include "SConfig.h"
 #include <string>
-#include "CPathReplay.h"
+#include "CParallelPathReplay.h"
 #include <iostream>
 #include "CVariantIterator.h"
 #include "CSyncPoint.h"
 #include "Utils/CUtils.h"
+#include "Utils/CPhaseTimer.h"
 #include <algorithm>
 
 using namespace mendelian;
 
 CMendelianAnalyzer::CMendelianAnalyzer() :
 m_mendelianDecider(m_aBestPathsFatherChildGT, m_aBestPathsFatherChildAM, m_aBestPathsMotherChildGT, m_aBestPathsMotherChildAM, m_provider, m_resultLog),
-m_violationRegionGenerator(m_aBestPathsFatherChildGT, m_aBestPathsFatherChildAM, m_aBestPathsMotherChildGT, m_aBestPathsMotherChildAM, m_provider, m_resultLog)
+m_violationRegionGenerator(m_aBestPathsFatherChildGT, m_aBestPathsFatherChildAM, m_aBestPathsMotherChildGT, m_aBestPathsMotherChildAM, m_provider, m_resultLog),
+m_pScheduler(NULL)
 {
     m_noCallMode = ENoCallMode::eExplicitNoCall;
 }
 
 int CMendelianAnalyzer::run(int argc, char **argv)
 {
-    std::time_t start, start1;
+    CPhaseTimer timer;
     double duration;
     
     //Reads the command line parameters
@@ -54,7 +56,7 @@ int CMendelianAnalyzer::run(int argc, char **argv)
     if(!isSuccess)
         return -1;
     
-    start = std::time(0);
+    timer.Start();
     
     //Initialize variant provider
     isSuccess = m_provider.InitializeReaders(m_fatherChildConfig, m_motherChildConfig);
@@ -63,9 +65,8 @@ int CMendelianAnalyzer::run(int argc, char **argv)
     if(!isSuccess)
         return -1;
 
-    duration = std::difftime(std::time(0), start);
-    std::cerr << "[stderr] Vcf and fasta Parser read completed in " << duration << " secs" << std::endl;
-    start1 = std::time(0);
+    double parseDuration = timer.EndPhase("parse");
+    std::cerr << "[stderr] Vcf and fasta Parser read completed in " << parseDuration << " secs" << std::endl;
     
     std::cerr << "[stderr] initializing output writer" << std::endl;
     
@@ -90,9 +91,17 @@ int CMendelianAnalyzer::run(int argc, char **argv)
     
     std::cerr << "[stderr] Running best path algorithm pipeline for each chromosome..." << std::endl;
     
+    if(m_fatherChildConfig.m_bWriteReplayStats && !m_replayStats.Open(m_fatherChildConfig.m_pReplayStatsPath))
+        std::cerr << "[stderr] Replay statistics are disabled" << std::endl;
+    
     //Run core comparison engine on parallel
     AssignJobsToThreads(m_fatherChildConfig.m_nThreadCount);
     
+    m_replayStats.Close();
+    
+    duration = timer.EndPhase("replay");
+    std::cerr << "[stderr] Best path replay completed in " << duration << " secs" << std::endl;
+    
     std::cerr << "[stderr] Evaluating mendelian consistency of variants..." << std::endl;
     
     //Perform merge process
@@ -127,6 +136,9 @@ int CMendelianAnalyzer::run(int argc, char **argv)
     m_trioWriter.SetInfoReadParameters(m_fatherChildConfig.m_pCalledVcfFileName, m_fatherChildConfig.m_pBaseVcfFileName, m_motherChildConfig.m_pBaseVcfFileName);
     m_trioWriter.GenerateTrioVcf(chrIds);
     
+    duration = timer.EndPhase("output");
+    std::cerr << "[stderr] Output generation completed in " << duration << " secs" << std::endl;
+    
     std::cerr << "[stderr] Generating detailed output logs.." << std::endl;
     
     m_resultLog.LogSkippedVariantCounts(m_provider.GetSkippedVariantCount(eCHILD),
@@ -148,11 +160,15 @@ int CMendelianAnalyzer::run(int argc, char **argv)
     m_resultLog.WriteDetailedReportTabDelimited(m_fatherChildConfig.m_output_prefix);
     m_resultLog.WriteShortReportTable(m_fatherChildConfig.m_output_prefix);
     
-    duration = std::difftime(std::time(0), start1);
-    std::cerr << "[stderr] Processing Chromosomes completed in " << duration << " secs" << std::endl;
-    duration = std::difftime(std::time(0), start);
+    timer.EndPhase("logs");
+    
+    duration = timer.GetElapsedSeconds();
+    std::cerr << "[stderr] Processing Chromosomes completed in " << duration - parseDuration << " secs" << std::endl;
     std::cerr << "[stderr] Total execution time is " << duration << " secs" << std::endl;
     
+    if(m_fatherChildConfig.m_bWriteTimings)
+        timer.WriteJson(m_fatherChildConfig.m_pTimingsPath);
+    
     return 0;
 }
 
@@ -184,6 +200,9 @@ bool CMendelianAnalyzer::ReadParameters(int argc, char **argv)
     
     const char* PARAM_AUTOSOME_ONLY = "--autosome-only";
     
+    const char* PARAM_REPLAY_STATS = "-replay-stats";
+    const char* PARAM_TIMINGS = "-timings";
+    
     bool bFatherSet = false;
     bool bMotherSet = false;
     bool bChildSet = false;
@@ -341,6 +360,18 @@ bool CMendelianAnalyzer::ReadParameters(int argc, char **argv)
             m_fatherChildConfig.m_nThreadCount = std::min(std::max(1, atoi(argv[it+1])), MAX_THREAD_COUNT);
         }
         
+        else if(0 == strcmp(argv[it], PARAM_REPLAY_STATS))
+        {
+            m_fatherChildConfig.m_pReplayStatsPath = argv[it+1];
+            m_fatherChildConfig.m_bWriteReplayStats = true;
+        }
+        
+        else if(0 == strcmp(argv[it], PARAM_TIMINGS))
+        {
+            m_fatherChildConfig.m_pTimingsPath = argv[it+1];
+            m_fatherChildConfig.m_bWriteTimings = true;
+        }
+        
         else
         {
             std::cerr << "Unknown Command or Argument: " << argv[it] << std::endl;
@@ -352,6 +383,13 @@ bool CMendelianAnalyzer::ReadParameters(int argc, char **argv)
         it += 2;
     }
     
+    //Thread count is resolved once here since it is split between the vcf readers before the scheduler is created
+    if(m_fatherChildConfig.m_nThreadCount < 1)
+    {
+        m_fatherChildConfig.m_nThreadCount = core::CTaskScheduler::GetDefaultThreadCount();
+        m_motherChildConfig.m_nThreadCount = m_fatherChildConfig.m_nThreadCount;
+    }
+    
     bool bIsVcfFilesAccesible = true;
     
     if(!bChildSet)
@@ -381,9 +419,6 @@ bool CMendelianAnalyzer::ReadParameters(int argc, char **argv)
 
 int CMendelianAnalyzer::AssignJobsToThreads(int a_nThreadCount)
 {
-    //Thread pool we have for multitasking by per chromosome
-    std::thread *pThreadPool;
-    
     //Get the list of chromosomes to be processed
     std::vector<SChrIdTriplet> chromosomeListToProcess = m_provider.GetCommonChromosomes();
 
@@ -393,35 +428,36 @@ int CMendelianAnalyzer::AssignJobsToThreads(int a_nThreadCount)
     m_aBestPathsFatherChildAM = std::vector<core::CPath>(m_provider.GetCommonChromosomes().size());
     m_aBestPathsMotherChildAM = std::vector<core::CPath>(m_provider.GetCommonChromosomes().size());
     
-    int exactThreadCount = std::min(a_nThreadCount, (int)chromosomeListToProcess.size());
-    
-    //Allocate threads
-    pThreadPool = new std::thread[exactThreadCount];
-    
-    int threadPoolIt = 0;
-    std::vector<SChrIdTriplet> *chromosomeLists = new std::vector<SChrIdTriplet>[exactThreadCount];
-    
-    //Divide tasks into threads
+    //Order the chromosomes by estimated replay cost (father-child + mother-child) so that the largest ones do not start last
+    std::vector<double> costs(chromosomeListToProcess.size());
+    std::vector<int> order(chromosomeListToProcess.size());
     for(unsigned int k = 0; k < chromosomeListToProcess.size(); k++)
     {
-        chromosomeLists[threadPoolIt].push_back(chromosomeListToProcess[k]);
-        threadPoolIt = (threadPoolIt+1) % exactThreadCount;
+        const SChrIdTriplet& triplet = chromosomeListToProcess[k];
+        std::vector<const CVariant*> varListChild = m_provider.GetVariantList(eCHILD, triplet.m_nCid);
+        costs[k] = core::CPathReplay::EstimateCost(m_provider.GetVariantList(eFATHER, triplet.m_nFid), varListChild)
+                   + core::CPathReplay::EstimateCost(m_provider.GetVariantList(eMOTHER, triplet.m_nMid), varListChild);
+        order[k] = k;
     }
+    std::stable_sort(order.begin(), order.end(), [&costs](int a_nLhs, int a_nRhs) { return costs[a_nLhs] > costs[a_nRhs]; });
     
-    //Assign divided task to the threads
-    for(int k = 0; k < exactThreadCount; k++)
-        pThreadPool[k] = std::thread(&CMendelianAnalyzer::ProcessChromosome, this, chromosomeLists[k]);
+    core::CTaskScheduler scheduler(a_nThreadCount);
+    m_pScheduler = &scheduler;
     
-    for(int k = 0; k < exactThreadCount; k++)
-        pThreadPool[k].join();
-
-    //Clean allocation
-    delete[] chromosomeLists;
+    //Submit each chromosome as a separate task. Idle threads steal the replay blocks of the remaining chromosomes
+    {
+        core::CTaskGroup chromosomeTasks(scheduler);
+        for(unsigned int k = 0; k < order.size(); k++)
+        {
+            std::vector<SChrIdTriplet> triplets(1, chromosomeListToProcess[order[k]]);
+            chromosomeTasks.Run(std::bind(&CMendelianAnalyzer::ProcessChromosome, this, triplets));
+        }
+        chromosomeTasks.Wait();
+    }
     
-    //Clean threads
-    delete[] pThreadPool;
+    m_pScheduler = NULL;
     
-    return exactThreadCount;
+    return scheduler.GetThreadCount();
     
 }
 
@@ -454,36 +490,31 @@ void CMendelianAnalyzer::ProcessChromosome(const std::vector<SChrIdTriplet>& a_n
         // === PROCESS FATHER-CHILD ===
         
         //Create path replay for parent child;
-        core::CPathReplay replayFatherChildGT(varListFather, varListChild, ovarListGTFather, ovarListGTChild);
+        core::CParallelPathReplay replayFatherChild(varListFather, varListChild, ovarListGTFather, ovarListGTChild);
+        replayFatherChild.SetScheduler(m_pScheduler);
+        replayFatherChild.SetReplayStats(m_replayStats.IsOpen() ? &m_replayStats : NULL, "father-child");
         
-        //Find Best Path Father-Child GT Match
-        m_aBestPathsFatherChildGT[triplet.m_nTripleIndex] = replayFatherChildGT.FindBestPath(ctg, true);
+        //Find Best Path Father-Child GT Match and AM Match of the genotype mismatches
+        replayFatherChild.FindBestPaths(ctg, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex], m_aBestPathsFatherChildAM[triplet.m_nTripleIndex]);
         
         //Genotype Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsChildGT = m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsFatherGT = m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants();
-        
-        //Variants that will be passed for allele match check
-        std::vector<const CVariant*> excludedVarsFather = m_provider.GetVariantList(eFATHER, triplet.m_nFid, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsChild = m_provider.GetVariantList(eCHILD, triplet.m_nCid,m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        
-        //Allele Match oriented variants
-        std::vector<const core::COrientedVariant*> ovarListAMFather = m_provider.GetOrientedVariantList(eFATHER, triplet.m_nFid, true, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const core::COrientedVariant*> ovarListAMChildFC = m_provider.GetOrientedVariantList(eCHILD, triplet.m_nCid, true, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        
-        //Clear Father child replay object
-        replayFatherChildGT.Clear();
-        
-        //Change the variant list to process
-        core::CPathReplay replayFatherChildAM(excludedVarsFather, excludedVarsChild, ovarListAMFather, ovarListAMChildFC);
-        
-        //Find Best Path Father-Child AM Match
-        m_aBestPathsFatherChildAM[triplet.m_nTripleIndex] = replayFatherChildAM.FindBestPath(ctg, false);
-        const std::vector<const core::COrientedVariant*>& includedVarsChildAM = m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsFatherAM = m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants();
+        std::vector<const core::COrientedVariant*> includedVarsChildGT = m_provider.GetIncludedVariantList(eCHILD, triplet.m_nCid, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+        std::vector<const core::COrientedVariant*> includedVarsFatherGT = m_provider.GetIncludedVariantList(eFATHER, triplet.m_nFid, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
+        
+        //Variants that are passed for allele match check
+        std::vector<const CVariant*> excludedVarsFather = m_provider.GetExcludedVariantList(eFATHER, triplet.m_nFid, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
+        std::vector<const CVariant*> excludedVarsChild = m_provider.GetExcludedVariantList(eCHILD, triplet.m_nCid, m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+        
+        //Allele Match variants
+        std::vector<const core::COrientedVariant*> includedVarsChildAM = m_provider.GetIncludedVariantList(eCHILD, triplet.m_nCid,
+                                                                                                   m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions(),
+                                                                                                   m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+        std::vector<const core::COrientedVariant*> includedVarsFatherAM = m_provider.GetIncludedVariantList(eFATHER, triplet.m_nFid,
+                                                                                                   m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions(),
+                                                                                                   m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
 
-        const std::vector<const CVariant*> excludedVarsChildFC = m_provider.GetVariantList(excludedVarsChild, m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        const std::vector<const CVariant*> excludedVarsFatherFC = m_provider.GetVariantList(excludedVarsFather, m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
+        const std::vector<const CVariant*> excludedVarsChildFC = m_provider.GetExcludedVariantList(excludedVarsChild, m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+        const std::vector<const CVariant*> excludedVarsFatherFC = m_provider.GetExcludedVariantList(excludedVarsFather, m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
         
         //Set Variant status of child variants
         m_provider.SetVariantStatus(includedVarsChildAM, eALLELE_MATCH);
@@ -496,39 +527,36 @@ void CMendelianAnalyzer::ProcessChromosome(const std::vector<SChrIdTriplet>& a_n
         m_provider.SetVariantStatus(excludedVarsFatherFC, eNO_MATCH);
 
         //Clear Father child replay object
-        replayFatherChildAM.Clear();
+        replayFatherChild.Clear();
         
         // === PROCESS MOTHER-CHILD ===
      
         //Create path replay for parent child;
-        core::CPathReplay replayMotherChildGT(varListMother, varListChild, ovarListGTMother, ovarListGTChild);
+        core::CParallelPathReplay replayMotherChild(varListMother, varListChild, ovarListGTMother, ovarListGTChild);
+        replayMotherChild.SetScheduler(m_pScheduler);
+        replayMotherChild.SetReplayStats(m_replayStats.IsOpen() ? &m_replayStats : NULL, "mother-child");
         
-        //Find Best Path Father-Child GT Match
-        m_aBestPathsMotherChildGT[triplet.m_nTripleIndex] = replayMotherChildGT.FindBestPath(ctg, true);
+        //Find Best Path Mother-Child GT Match and AM Match of the genotype mismatches
+        replayMotherChild.FindBestPaths(ctg, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex], m_aBestPathsMotherChildAM[triplet.m_nTripleIndex]);
         
         //Genotype Match variants
-        const std::vector<const core::COrientedVariant*>& includedVarsChildGTMC = m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsMotherGT = m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants();
-        
-        //Variants that will be passed for allele match check
-        std::vector<const CVariant*> excludedVarsMother = m_provider.GetVariantList(eMOTHER, triplet.m_nMid, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsChild2 = m_provider.GetVariantList(eCHILD, triplet.m_nCid,m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        
-        std::vector<const core::COrientedVariant*> ovarListAMMother = m_provider.GetOrientedVariantList(eMOTHER, triplet.m_nMid, true, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
-        std::vector<const core::COrientedVariant*> ovarListAMChildMC = m_provider.GetOrientedVariantList(eCHILD, triplet.m_nCid, true, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        
-        //Clear Mother child replay object
-        replayMotherChildGT.Clear();
-        //Change the variant list to process
-        core::CPathReplay replayMotherChildAM(excludedVarsMother, excludedVarsChild2, ovarListAMMother, ovarListAMChildMC);
-        
-        //Find Best Path Mother-Child AM Match
-        m_aBestPathsMotherChildAM[triplet.m_nTripleIndex] = replayMotherChildAM.FindBestPath(ctg, false);
-        const std::vector<const core::COrientedVariant*>& includedVarsChildAMMC = m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants();
-        const std::vector<const core::COrientedVariant*>& includedVarsMotherAM = m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants();
+        std::vector<const core::COrientedVariant*> includedVarsChildGTMC = m_provider.GetIncludedVariantList(eCHILD, triplet.m_nCid, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+        std::vector<const core::COrientedVariant*> includedVarsMotherGT = m_provider.GetIncludedVariantList(eMOTHER, triplet.m_nMid, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
+        
+        //Variants that are passed for allele match check
+        std::vector<const CVariant*> excludedVarsMother = m_provider.GetExcludedVariantList(eMOTHER, triplet.m_nMid, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
+        std::vector<const CVariant*> excludedVarsChild2 = m_provider.GetExcludedVariantList(eCHILD, triplet.m_nCid, m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+        
+        //Allele Match variants
+        std::vector<const core::COrientedVariant*> includedVarsChildAMMC = m_provider.GetIncludedVariantList(eCHILD, triplet.m_nCid,
+                                                                                                   m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions(),
+                                                                                                   m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+        std::vector<const core::COrientedVariant*> includedVarsMotherAM = m_provider.GetIncludedVariantList(eMOTHER, triplet.m_nMid,
+                                                                                                   m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions(),
+                                                                                                   m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
 
-        const std::vector<const CVariant*> excludedVarsChildMC = m_provider.GetVariantList(excludedVarsChild2, m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded());
-        const std::vector<const CVariant*> excludedVarsMotherMC = m_provider.GetVariantList(excludedVarsMother, m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
+        const std::vector<const CVariant*> excludedVarsChildMC = m_provider.GetExcludedVariantList(excludedVarsChild2, m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+        const std::vector<const CVariant*> excludedVarsMotherMC = m_provider.GetExcludedVariantList(excludedVarsMother, m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
 
         
         //Set Variant status of child variants
@@ -542,8 +570,8 @@ void CMendelianAnalyzer::ProcessChromosome(const std::vector<SChrIdTriplet>& a_n
         m_provider.SetVariantStatus(excludedVarsMotherMC, eNO_MATCH);
         
     
-        //Clear Father child replay object
-        replayMotherChildAM.Clear();
+        //Clear Mother child replay object
+        replayMotherChild.Clear();
         
         //Lock the logging mechanism
         mtx.lock();
@@ -552,18 +580,18 @@ void CMendelianAnalyzer::ProcessChromosome(const std::vector<SChrIdTriplet>& a_n
         m_resultLog.LogBestPathStatistic(true,
                                          triplet,
                                          static_cast<int>(includedVarsChildGT.size() + includedVarsChildAM.size()),
-                                         static_cast<int>(m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants().size() +
-                                                          m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants().size()),
-                                         static_cast<int>(m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded().size()),
-                                         static_cast<int>(m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded().size()));
+                                         static_cast<int>(m_aBestPathsFatherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions().GetIncludedCount() +
+                                                          m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions().GetIncludedCount()),
+                                         static_cast<int>(m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions().GetExcludedCount()),
+                                         static_cast<int>(m_aBestPathsFatherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions().GetExcludedCount()));
         
         m_resultLog.LogBestPathStatistic(false,
                                          triplet,
                                          static_cast<int>(includedVarsChildGTMC.size() + includedVarsChildAMMC.size()),
-                                         static_cast<int>(m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants().size() +
-                                                          m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetIncludedVariants().size()),
-                                         static_cast<int>(m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetExcluded().size()),
-                                         static_cast<int>(m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded().size()));
+                                         static_cast<int>(m_aBestPathsMotherChildGT[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions().GetIncludedCount() +
+                                                          m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions().GetIncludedCount()),
+                                         static_cast<int>(m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions().GetExcludedCount()),
+                                         static_cast<int>(m_aBestPathsMotherChildAM[triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions().GetExcludedCount()));
         
         //Unlock the logging mechanism
         mtx.unlock();
@@ -595,7 +623,9 @@ void CMendelianAnalyzer::PrintHelp() const
     std::cout << "-filter <filter_name>        [Optional.Filter variants based on filter column. Default value is PASS. Use 'none' to disable filtering]" << std::endl;
     std::cout << "--disable-ref-overlap        [Optional.Disable reference overlapping. Does not trim alleles]" << std::endl;;
     std::cout << "--autosome-only              [Optional.If specified, process only autosomes. For this parameter, chromosome naming in VCF should be either chr1,chr2 or 1,2]" << std::endl;
-    std::cout << "-thread-count <1-25>         [Optional.Specify the number of threads that program will use. Default value is 2]" << std::endl;
+    std::cout << "-thread-count <1-1024>       [Optional.Specify the number of threads that program will use. Default value is the number of available cores]" << std::endl;
+    std::cout << "-replay-stats <file_path>    [Optional.Write the replay statistics of each sync region (variant counts, peak path count, iterations, time and outcome) to the given tab delimited file]" << std::endl;
+    std::cout << "-timings <file_path>         [Optional.Write the wall time, CPU time, peak memory and the durations of the parse, replay, output and logs phases to the given JSON file]" << std::endl;
     std::cout << std::endl;
     std::cout << "Example Commands:" << std::endl;
     std::cout << "./vbt mendelian -mother mother.vcf -father father.vcf -child child.vcf -ref reference.fasta -outDir <SampleResultDir> -filter none -no-call none" << std::endl;
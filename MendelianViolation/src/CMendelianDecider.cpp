@@ -198,27 +198,34 @@ void CMendelianDecider::GetSyncPointList(SChrIdTriplet& a_rTriplet, bool a_bIsFa
         core::CPath *pPathGT = a_bIsFatherChild ? &m_aBestPathsFatherChildGT[a_rTriplet.m_nTripleIndex] : &m_aBestPathsMotherChildGT[a_rTriplet.m_nTripleIndex];
         pPathSync = pPathGT;
         
-        std::vector<const CVariant*> excludedVarsBase = m_provider.GetVariantList(a_bIsFatherChild ? eFATHER : eMOTHER, a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid, pPathGT->m_baseSemiPath.GetExcluded());
-        std::vector<const CVariant*> excludedVarsCalled = m_provider.GetVariantList(eCHILD, a_rTriplet.m_nCid, pPathGT->m_calledSemiPath.GetExcluded());
+        std::vector<const CVariant*> excludedVarsBase = m_provider.GetExcludedVariantList(a_bIsFatherChild ? eFATHER : eMOTHER, a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid, pPathGT->m_baseSemiPath.GetDecisions());
+        std::vector<const CVariant*> excludedVarsCalled = m_provider.GetExcludedVariantList(eCHILD, a_rTriplet.m_nCid, pPathGT->m_calledSemiPath.GetDecisions());
         
-        pBaseIncluded = pPath->m_baseSemiPath.GetIncludedVariants();
-        pCalledIncluded = pPath->m_calledSemiPath.GetIncludedVariants();
+        pBaseIncluded = m_provider.GetIncludedVariantList(a_bIsFatherChild ? eFATHER : eMOTHER,
+                                                          a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid,
+                                                          pPathGT->m_baseSemiPath.GetDecisions(),
+                                                          pPath->m_baseSemiPath.GetDecisions());
+        pCalledIncluded = m_provider.GetIncludedVariantList(eCHILD, a_rTriplet.m_nCid, pPathGT->m_calledSemiPath.GetDecisions(), pPath->m_calledSemiPath.GetDecisions());
         
-        pBaseExcluded = m_provider.GetVariantList(excludedVarsBase, pPath->m_baseSemiPath.GetExcluded());
-        pCalledExcluded = m_provider.GetVariantList(excludedVarsCalled, pPath->m_calledSemiPath.GetExcluded());
+        pBaseExcluded = m_provider.GetExcludedVariantList(excludedVarsBase, pPath->m_baseSemiPath.GetDecisions());
+        pCalledExcluded = m_provider.GetExcludedVariantList(excludedVarsCalled, pPath->m_calledSemiPath.GetDecisions());
     }
     else
     {
         pPath = a_bIsFatherChild ? &m_aBestPathsFatherChildGT[a_rTriplet.m_nTripleIndex] : &m_aBestPathsMotherChildGT[a_rTriplet.m_nTripleIndex];
         pPathSync = pPath;
         
-        pBaseIncluded = pPath->m_baseSemiPath.GetIncludedVariants();
-        pCalledIncluded = pPath->m_calledSemiPath.GetIncludedVariants();
+        pBaseIncluded = m_provider.GetIncludedVariantList(a_bIsFatherChild ? eFATHER : eMOTHER, a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid, pPath->m_baseSemiPath.GetDecisions());
+        pCalledIncluded = m_provider.GetIncludedVariantList(eCHILD, a_rTriplet.m_nCid, pPath->m_calledSemiPath.GetDecisions());
         
-        pBaseExcluded = m_provider.GetVariantList(a_bIsFatherChild ? eFATHER : eMOTHER, a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid, pPath->m_baseSemiPath.GetExcluded());
-        pCalledExcluded = m_provider.GetVariantList(eCHILD, a_rTriplet.m_nCid, pPath->m_calledSemiPath.GetExcluded());
+        pBaseExcluded = m_provider.GetExcludedVariantList(a_bIsFatherChild ? eFATHER : eMOTHER, a_bIsFatherChild ? a_rTriplet.m_nFid : a_rTriplet.m_nMid, pPath->m_baseSemiPath.GetDecisions());
+        pCalledExcluded = m_provider.GetExcludedVariantList(eCHILD, a_rTriplet.m_nCid, pPath->m_calledSemiPath.GetDecisions());
     }
     
+    //Included variants are processed in variant id order
+    std::sort(pBaseIncluded.begin(), pBaseIncluded.end(), CUtils::CompareOrientedVariantsById);
+    std::sort(pCalledIncluded.begin(), pCalledIncluded.end(), CUtils::CompareOrientedVariantsById);
+    
     
     unsigned int baseIncludedItr = 0;
     unsigned int baseExcludedItr = 0;
@@ -658,19 +665,25 @@ void CMendelianDecider::MergeFunc(SChrIdTriplet& a_triplet,
     
     std::vector<const CVariant*> childVariants = m_provider.GetSortedVariantListByID(eCHILD, a_triplet.m_nCid);
     
-    //Sort variants according to variant ids
-    m_aBestPathsFatherChildGT[a_triplet.m_nTripleIndex].SortIncludedVariants();
-    m_aBestPathsFatherChildAM[a_triplet.m_nTripleIndex].SortIncludedVariants();
-    m_aBestPathsMotherChildGT[a_triplet.m_nTripleIndex].SortIncludedVariants();
-    m_aBestPathsMotherChildAM[a_triplet.m_nTripleIndex].SortIncludedVariants();
+    //Included child variants sorted by variant ids
+    std::vector<const core::COrientedVariant*> childIncludedFatherGT = m_provider.GetIncludedVariantList(eCHILD, a_triplet.m_nCid, m_aBestPathsFatherChildGT[a_triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+    std::vector<const core::COrientedVariant*> childIncludedFatherAM = m_provider.GetIncludedVariantList(eCHILD, a_triplet.m_nCid,
+                                                                                                         m_aBestPathsFatherChildGT[a_triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions(),
+                                                                                                         m_aBestPathsFatherChildAM[a_triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+    std::vector<const core::COrientedVariant*> childIncludedMotherGT = m_provider.GetIncludedVariantList(eCHILD, a_triplet.m_nCid, m_aBestPathsMotherChildGT[a_triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+    std::vector<const core::COrientedVariant*> childIncludedMotherAM = m_provider.GetIncludedVariantList(eCHILD, a_triplet.m_nCid,
+                                                                                                         m_aBestPathsMotherChildGT[a_triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions(),
+                                                                                                         m_aBestPathsMotherChildAM[a_triplet.m_nTripleIndex].m_calledSemiPath.GetDecisions());
+    std::sort(childIncludedFatherGT.begin(), childIncludedFatherGT.end(), CUtils::CompareOrientedVariantsById);
+    std::sort(childIncludedFatherAM.begin(), childIncludedFatherAM.end(), CUtils::CompareOrientedVariantsById);
+    std::sort(childIncludedMotherGT.begin(), childIncludedMotherGT.end(), CUtils::CompareOrientedVariantsById);
+    std::sort(childIncludedMotherAM.begin(), childIncludedMotherAM.end(), CUtils::CompareOrientedVariantsById);
     
     //Merged Genotype and Allele match Child variants with Father
-    CVariantIterator FatherChildVariants(m_aBestPathsFatherChildGT[a_triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants(),
-                                         m_aBestPathsFatherChildAM[a_triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants());
+    CVariantIterator FatherChildVariants(childIncludedFatherGT, childIncludedFatherAM);
     
     //Merged Genotype and Allele match Child variants with Mother
-    CVariantIterator MotherChildVariants(m_aBestPathsMotherChildGT[a_triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants(),
-                                         m_aBestPathsMotherChildAM[a_triplet.m_nTripleIndex].m_calledSemiPath.GetIncludedVariants());
+    CVariantIterator MotherChildVariants(childIncludedMotherGT, childIncludedMotherAM);
     
     //Check if the two list have common variants
     if(FatherChildVariants.hasNext() == false && MotherChildVariants.hasNext() == false)
@@ -726,14 +739,14 @@ void CMendelianDecider::MergeFunc(SChrIdTriplet& a_triplet,
     }
     
     //Excluded Mother variant Check - If we can find 0/0 hidden child site correspond to mother variant
-    std::vector<const CVariant*> uniqueMotherVars = m_provider.GetVariantList(m_provider.GetVariantList(eMOTHER, a_triplet.m_nMid,  m_aBestPathsMotherChildGT[a_triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded()),
-                                                                              m_aBestPathsMotherChildAM[a_triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
+    std::vector<const CVariant*> uniqueMotherVars = m_provider.GetExcludedVariantList(m_provider.GetExcludedVariantList(eMOTHER, a_triplet.m_nMid,  m_aBestPathsMotherChildGT[a_triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions()),
+                                                                                      m_aBestPathsMotherChildAM[a_triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
     std::vector<bool> motherDecisions(uniqueMotherVars.size());
     CheckUniqueVars(eMOTHER, a_triplet, uniqueMotherVars, motherDecisions, a_rMotherDecisions, a_rChildDecisions);
     
     //Excluded Father variant Check - If we can find 0/0 hidden child site correspond to father variant
-    std::vector<const CVariant*> uniqueFatherVars = m_provider.GetVariantList(m_provider.GetVariantList(eFATHER, a_triplet.m_nFid,  m_aBestPathsFatherChildGT[a_triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded()),
-                                                                              m_aBestPathsFatherChildAM[a_triplet.m_nTripleIndex].m_baseSemiPath.GetExcluded());
+    std::vector<const CVariant*> uniqueFatherVars = m_provider.GetExcludedVariantList(m_provider.GetExcludedVariantList(eFATHER, a_triplet.m_nFid,  m_aBestPathsFatherChildGT[a_triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions()),
+                                                                                      m_aBestPathsFatherChildAM[a_triplet.m_nTripleIndex].m_baseSemiPath.GetDecisions());
     std::vector<bool> fatherDecisions(uniqueFatherVars.size());
     CheckUniqueVars(eFATHER, a_triplet, uniqueFatherVars, fatherDecisions, a_rFatherDecisions, a_rChildDecisions);
     
@@ -233,7 +233,7 @@ void CMendelianTrioMerger::AddSample(const CVariant* a_pVariant, std::vector<std
         a_rSampleData.m_nHaplotypeCount = a_pVariant->m_nZygotCount;
         a_rSampleData.m_bIsPhased = a_pVariant->m_bIsPhased; // Future Work: Phasings of variants we found can be written to output
         a_rSampleData.m_bIsNoCallVariant = m_noCallMode == eNone ? false : a_pVariant->m_bIsNoCall;
-        int additionalBasePairCount = static_cast<int>(a_rAlleles[0].length() - a_pVariant->m_refSequence.length());
+        int additionalBasePairCount = static_cast<int>(a_rAlleles[0].length()) - a_pVariant->GetRefLength();
         
         for(unsigned int k = 0; k < (unsigned int)a_pVariant->m_nZygotCount; k++)
         {
@@ -264,7 +264,7 @@ void CMendelianTrioMerger::AddAllele(const CVariant* a_pVariant, int a_nMaxRefSe
     if(a_pVariant != NULL)
     {
         //If child reference is shorter than the the records reference, we complete all of its alleles with the missing Base pairs
-        int additionalBasePairCount = a_nMaxRefSequenceLength - (int)a_pVariant->m_refSequence.length();
+        int additionalBasePairCount = a_nMaxRefSequenceLength - a_pVariant->GetRefLength();
         
         for(unsigned int k= 0; k < (unsigned int)a_pVariant->m_nAlleleCount; k++)
         {
@@ -285,7 +285,7 @@ void CMendelianTrioMerger::DoMerge(const CVariant* a_pVarMother,
     SVcfRecord vcfrecord;
 
     vcfrecord.m_nPosition = a_pVarMother == NULL ? (a_pVarFather != NULL ? a_pVarFather->m_nOriginalPos : a_pVarChild->m_nOriginalPos) : a_pVarMother->m_nOriginalPos;
-    vcfrecord.m_chrName = a_pVarMother == NULL ? (a_pVarFather != NULL ? a_pVarFather->m_chrName : a_pVarChild->m_chrName) : a_pVarMother->m_chrName;
+    vcfrecord.m_chrName = a_pVarMother == NULL ? (a_pVarFather != NULL ? a_pVarFather->GetChrName() : a_pVarChild->GetChrName()) : a_pVarMother->GetChrName();
     vcfrecord.m_mendelianDecision = std::to_string(static_cast<int>(a_decision));
     vcfrecord.m_fQuality = a_pVarChild == NULL ? (a_pVarFather != NULL ? a_pVarFather->m_fQuality : a_pVarMother->m_fQuality) : a_pVarChild->m_fQuality;
 
@@ -304,17 +304,17 @@ void CMendelianTrioMerger::DoMerge(const CVariant* a_pVarMother,
     std::vector<std::string> alleles;
     
     //Detect the longest reference sequence
-    int maxRefSequenceLength = std::max({a_pVarMother != 0 ? (int)a_pVarMother->m_refSequence.length() : INT_MIN,
-                                         a_pVarFather != 0 ? (int)a_pVarFather->m_refSequence.length() : INT_MIN,
-                                         a_pVarChild  != 0 ? (int)a_pVarChild->m_refSequence.length() : INT_MIN});
+    int maxRefSequenceLength = std::max({a_pVarMother != 0 ? a_pVarMother->GetRefLength() : INT_MIN,
+                                         a_pVarFather != 0 ? a_pVarFather->GetRefLength() : INT_MIN,
+                                         a_pVarChild  != 0 ? a_pVarChild->GetRefLength() : INT_MIN});
     
     //Push the longest reference sequence as our reference
-    if(a_pVarChild != NULL && (int)a_pVarChild->m_refSequence.length() == maxRefSequenceLength)
-        alleles.push_back(a_pVarChild->m_refSequence);
-    else if (a_pVarMother != NULL && (int)a_pVarMother->m_refSequence.length() == maxRefSequenceLength)
-        alleles.push_back(a_pVarMother->m_refSequence);
+    if(a_pVarChild != NULL && a_pVarChild->GetRefLength() == maxRefSequenceLength)
+        alleles.push_back(a_pVarChild->GetRefSeq());
+    else if (a_pVarMother != NULL && a_pVarMother->GetRefLength() == maxRefSequenceLength)
+        alleles.push_back(a_pVarMother->GetRefSeq());
     else
-        alleles.push_back(a_pVarFather->m_refSequence);
+        alleles.push_back(a_pVarFather->GetRefSeq());
     
     //Add  mother father and child unique alleles
     AddAllele(a_pVarChild, maxRefSequenceLength, alleles);
@@ -25,11 +25,14 @@
 
 #include <algorithm>
 #include "CMendelianVariantProvider.h"
+#include "CDecisionArray.h"
 #include "CSimplePEDParser.h"
 #include "CSimpleBEDParser.h"
 #include "Utils/CUtils.h"
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <atomic>
 
 using namespace mendelian;
 
@@ -39,24 +42,35 @@ bool CMendelianVariantProvider::OpenVcfFiles()
     bool bIsSuccessMother = true;
     bool bIsSuccessChild = true;
     
+    //Three vcfs are parsed concurrently, the rest of the threads decompress them
+    const int decompressionThreadCount = std::max(0, (m_fatherChildConfig.m_nThreadCount - 3) / 3);
+    
     //Open FATHER vcf file
-    bIsSuccessFather = m_FatherVcf.Open(m_fatherChildConfig.m_pBaseVcfFileName);
+    bIsSuccessFather = m_FatherVcf.Open(m_fatherChildConfig.m_pBaseVcfFileName, decompressionThreadCount);
     if(!bIsSuccessFather)
         std::cerr << "Father VCF file is unable to open!: " << m_fatherChildConfig.m_pBaseVcfFileName << std::endl;
     
     //Open MOTHER vcf file
-    bIsSuccessMother = m_MotherVcf.Open(m_motherChildConfig.m_pBaseVcfFileName);
+    bIsSuccessMother = m_MotherVcf.Open(m_motherChildConfig.m_pBaseVcfFileName, decompressionThreadCount);
     if(!bIsSuccessMother)
         std::cerr << "Mother VCF file is unable to open!: " << m_motherChildConfig.m_pBaseVcfFileName << std::endl;
     
     //Open CHILD vcf file
-    bIsSuccessChild = m_ChildVcf.Open(m_fatherChildConfig.m_pCalledVcfFileName);
+    bIsSuccessChild = m_ChildVcf.Open(m_fatherChildConfig.m_pCalledVcfFileName, decompressionThreadCount);
     if(!bIsSuccessChild)
         std::cerr << "Child VCF file is unable to open!: " << m_fatherChildConfig.m_pCalledVcfFileName << std::endl;
     
     if(!bIsSuccessChild || !bIsSuccessFather || !bIsSuccessMother)
         return false;
     
+    //Strings of the variants are stored per contig, so the contigs can be read in parallel
+    m_FatherVcf.InitArenas(m_aFatherArenas);
+    m_MotherVcf.InitArenas(m_aMotherArenas);
+    m_ChildVcf.InitArenas(m_aChildArenas);
+    m_FatherVcf.SetArenas(&m_aFatherArenas);
+    m_MotherVcf.SetArenas(&m_aMotherArenas);
+    m_ChildVcf.SetArenas(&m_aChildArenas);
+    
     if(true == m_fatherChildConfig.m_bIsReadINFO)
     {
         m_FatherVcf.GetInfoNames(m_fatherChildConfig.m_infotags);
@@ -182,9 +196,16 @@ bool CMendelianVariantProvider::InitializeReaders(const SConfig &a_rFatherChildC
     return bIsSuccessVCFs && bIsSuccessFasta;
 }
 
-void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig)
+void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a_rConfig, int a_nThreadCount)
 {
     EMendelianVcfName sampleName = static_cast<EMendelianVcfName>(a_nSampleId);
+    
+    //Each contig of an indexed vcf can be read independently
+    if(a_nThreadCount > 1 && GetVcfReader(sampleName).LoadIndex())
+    {
+        FillVariantForSampleByContig(a_nSampleId, a_rConfig, a_nThreadCount);
+        return;
+    }
 
     CSimpleBEDParser bedParser;
     unsigned int remainingBedContigCount = 0;
@@ -195,8 +216,6 @@ void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a
         remainingBedContigCount = bedParser.m_nTotalContigCount;
     }
     
-    int* pNonAssessedVariantCount;
-    int* pAsteriskVariantCount;
     std::vector<std::vector<CVariant>>* pVariants;
     CVcfReader* pReader;
     std::string sampleNameStr;
@@ -204,30 +223,24 @@ void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a
     switch (sampleName)
     {
         case eFATHER:
-            pNonAssessedVariantCount = &m_nFatherNotAssessedVariantCount;
             pVariants = &m_aFatherVariantList;
             pReader = &m_FatherVcf;
-            pAsteriskVariantCount = &m_nFatherAsteriskCount;
             sampleNameStr = "father";
             break;
         case eMOTHER:
-            pNonAssessedVariantCount = &m_nMotherNotAssessedVariantCount;
             pVariants = &m_aMotherVariantList;
             pReader = &m_MotherVcf;
-            pAsteriskVariantCount = &m_nMotherAsteriskCount;
             sampleNameStr = "mother";
             break;
         case eCHILD:
-            pNonAssessedVariantCount = &m_nChildNotAssessedVariantCount;
             pVariants = &m_aChildVariantList;
             pReader = &m_ChildVcf;
-            pAsteriskVariantCount = &m_nChildAsteriskCount;
             sampleNameStr = "child";
             break;
             
         default:
             std::cerr << "Wrong Sample Enumeration in Mendelian Variant Provider!" << std::endl;
-            break;
+            return;
     }
     
     CVariant variant;
@@ -235,19 +248,21 @@ void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a
     std::string preChrId = "";
     unsigned int regionIterator = 0;
     
+    int notAssessedVariantCount = 0;
     std::vector<CVariant> multiTrimmableVarList;
     
     
     while(pReader->GetNextRecord(&variant, id, a_rConfig))
     {
-        if(preChrId != variant.m_chrName)
+        if(preChrId != variant.GetChrName())
         {
             //We update the remaining contig count in BED file
             if(bedParser.m_regionMap[preChrId].size() > 0)
                 remainingBedContigCount--;
             
-            preChrId = variant.m_chrName;
-            std::cerr << "Reading chromosome " << preChrId << " of Parent[" << sampleNameStr <<"] vcf" << std::endl;
+            preChrId = variant.GetChrName();
+            //Single insertion so that the lines of the concurrently parsed vcfs are not interleaved
+            std::cerr << "Reading chromosome " + preChrId + " of Parent[" + sampleNameStr + "] vcf\n";
             id = 0;
             variant.m_nId = id;
             
@@ -261,71 +276,221 @@ void CMendelianVariantProvider::FillVariantForSample(int a_nSampleId, SConfig& a
                 break;
             
             //No Region exist for this chromosome
-            if(regionIterator == bedParser.m_regionMap[variant.m_chrName].size())
+            if(regionIterator == bedParser.m_regionMap[variant.GetChrName()].size())
+            {
+                variant.DiscardStrings();
                 continue;
+            }
             
             //Skip to next region
-            while(regionIterator < bedParser.m_regionMap[variant.m_chrName].size()
+            while(regionIterator < bedParser.m_regionMap[variant.GetChrName()].size()
                   &&
-                  variant.m_nOriginalPos >= bedParser.m_regionMap[variant.m_chrName][regionIterator].m_nEndPos)
+                  variant.m_nOriginalPos >= bedParser.m_regionMap[variant.GetChrName()][regionIterator].m_nEndPos)
             {
                 regionIterator++;
             }
             
             //Skip if regions are finished for given chromosome
-            if(regionIterator == bedParser.m_regionMap[variant.m_chrName].size())
+            if(regionIterator == bedParser.m_regionMap[variant.GetChrName()].size())
+            {
+                variant.DiscardStrings();
                 continue;
+            }
             
             //Variant Could not pass from BED region
-            if(bedParser.m_regionMap[variant.m_chrName][regionIterator].m_nStartPos >= (variant.m_nOriginalPos + (int)variant.m_refSequence.length()))
+            if(bedParser.m_regionMap[variant.GetChrName()][regionIterator].m_nStartPos >= (variant.m_nOriginalPos + variant.GetRefLength()))
+            {
+                variant.DiscardStrings();
                 continue;
+            }
         }
             
-        if(!variant.m_bIsNoCall && CUtils::IsHomRef(variant))
-            continue;
-        
-        //Eliminate variants rather than diploid
-        if(variant.m_nZygotCount != 2)
-            continue;
-        
-        std::size_t found = variant.m_allelesStr.find('*');
-        if (found!=std::string::npos)
-        {
-            pAsteriskVariantCount++;
-            continue;
-        }
-        
-        else if(a_rConfig.m_bIsFilterEnabled && variant.m_bIsFilterPASS == false)
-            pNonAssessedVariantCount++;
-        
-        else if(CUtils::IsStructuralVariant(variant, a_rConfig.m_nMaxVariantSize))
-            pNonAssessedVariantCount++;
-        
-        else if(true == variant.m_bHaveMultipleTrimOption)
-        {
-            multiTrimmableVarList.push_back(variant);
+        if(AddVariant(variant, a_rConfig, (*pVariants)[variant.m_nChrId], multiTrimmableVarList, notAssessedVariantCount))
             id++;
-        }
-        
         else
-        {
-            (*pVariants)[variant.m_nChrId].push_back(variant);
-            id++;
-        }
+            variant.DiscardStrings();
     }
     
+    GetNotAssessedCounter(sampleName) += notAssessedVariantCount;
+    
     FindOptimalTrimmings(multiTrimmableVarList, sampleName);
     AppendTrimmedVariants(multiTrimmableVarList, sampleName);
     
     for(unsigned int k = 0; k < pReader->GetContigs().size(); k++)
     {
-        std::sort((*pVariants)[k].begin(), (*pVariants)[k].end(), CUtils::CompareVariants);
+        CUtils::SortVariants((*pVariants)[k]);
         (*pVariants)[k].shrink_to_fit();
     }
     
     (*pVariants).shrink_to_fit();
 }
 
+void CMendelianVariantProvider::FillVariantForSampleByContig(int a_nSampleId, const SConfig& a_rConfig, int a_nThreadCount)
+{
+    CSimpleBEDParser bedParser;
+    if(true == a_rConfig.m_bInitializeFromBed)
+        bedParser.InitBEDFile(a_rConfig.m_pBedFileName);
+    
+    const int contigCount = static_cast<int>(GetVcfReader(static_cast<EMendelianVcfName>(a_nSampleId)).GetContigs().size());
+    std::atomic<int> nextContig(0);
+    
+    auto worker = [&]()
+    {
+        for(int contigId = nextContig++; contigId < contigCount; contigId = nextContig++)
+            FillVariantForContig(a_nSampleId, contigId, a_rConfig, bedParser);
+    };
+    
+    std::vector<std::thread> threads;
+    for(int k = 1; k < std::min(a_nThreadCount, contigCount); k++)
+        threads.push_back(std::thread(worker));
+    
+    worker();
+    
+    for(unsigned int k = 0; k < threads.size(); k++)
+        threads[k].join();
+}
+
+void CMendelianVariantProvider::FillVariantForContig(int a_nSampleId, int a_nContigId, const SConfig& a_rConfig, const CSimpleBEDParser& a_rBedParser)
+{
+    EMendelianVcfName sampleName = static_cast<EMendelianVcfName>(a_nSampleId);
+    CVcfReader& rSampleReader = GetVcfReader(sampleName);
+    const std::string contigName = rSampleReader.GetContigName(a_nContigId);
+    
+    //Contigs without a BED region are skipped
+    const std::vector<SBedRegion>* pRegions = NULL;
+    if(true == a_rConfig.m_bInitializeFromBed)
+    {
+        auto regionItr = a_rBedParser.m_regionMap.find(contigName);
+        if(regionItr == a_rBedParser.m_regionMap.end() || regionItr->second.empty())
+            return;
+        pRegions = &regionItr->second;
+    }
+    
+    //Each contig is read by its own reader. The header of the main reader only contains the selected sample
+    CVcfReader reader;
+    std::vector<std::string> sampleNames;
+    rSampleReader.GetSampleNames(sampleNames);
+    if(!reader.Open(rSampleReader.GetFilename().c_str()) || sampleNames.empty() || !reader.SelectSample(sampleNames[0]))
+    {
+        std::cerr << "Unable to read chromosome " + contigName + " of " + rSampleReader.GetFilename() + "\n";
+        return;
+    }
+    
+    if(true == a_rConfig.m_bIsReadINFO)
+        reader.GetInfoNames(a_rConfig.m_infotags);
+    
+    //Contigs that are not in the index have no records
+    if(!reader.LoadIndex() || !reader.SetContig(contigName))
+        return;
+    reader.SetArenas(sampleName == eFATHER ? &m_aFatherArenas : (sampleName == eMOTHER ? &m_aMotherArenas : &m_aChildArenas));
+    
+    std::vector<CVariant>& variants = sampleName == eFATHER ? m_aFatherVariantList[a_nContigId]
+                                    : (sampleName == eMOTHER ? m_aMotherVariantList[a_nContigId] : m_aChildVariantList[a_nContigId]);
+    std::string sampleNameStr = sampleName == eFATHER ? "father" : (sampleName == eMOTHER ? "mother" : "child");
+    
+    CVariant variant;
+    int id = 0;
+    unsigned int regionIterator = 0;
+    int notAssessedVariantCount = 0;
+    std::vector<CVariant> multiTrimmableVarList;
+    
+    std::cerr << "Reading chromosome " + contigName + " of Parent[" + sampleNameStr + "] vcf\n";
+    
+    while(reader.GetNextRecord(&variant, id, a_rConfig))
+    {
+        if(pRegions != NULL)
+        {
+            //Skip to next region
+            while(regionIterator < pRegions->size() && variant.m_nOriginalPos >= (*pRegions)[regionIterator].m_nEndPos)
+                regionIterator++;
+            
+            //All regions of the contig are finished
+            if(regionIterator == pRegions->size())
+                break;
+            
+            //Variant Could not pass from BED region
+            if((*pRegions)[regionIterator].m_nStartPos >= (variant.m_nOriginalPos + variant.GetRefLength()))
+            {
+                variant.DiscardStrings();
+                continue;
+            }
+        }
+        
+        if(AddVariant(variant, a_rConfig, variants, multiTrimmableVarList, notAssessedVariantCount))
+            id++;
+        else
+            variant.DiscardStrings();
+    }
+    
+    GetNotAssessedCounter(sampleName) += notAssessedVariantCount;
+    
+    FindOptimalTrimmings(multiTrimmableVarList, sampleName);
+    AppendTrimmedVariants(multiTrimmableVarList, sampleName);
+    
+    CUtils::SortVariants(variants);
+    variants.shrink_to_fit();
+}
+
+bool CMendelianVariantProvider::AddVariant(CVariant& a_rVariant, const SConfig& a_rConfig, std::vector<CVariant>& a_rVariants, std::vector<CVariant>& a_rMultiTrimmableVariants, int& a_rNotAssessedVariantCount)
+{
+    if(!a_rVariant.m_bIsNoCall && CUtils::IsHomRef(a_rVariant))
+        return false;
+    
+    //Eliminate variants rather than diploid
+    if(a_rVariant.m_nZygotCount != 2)
+        return false;
+    
+    //Asterisk, filtered and structural variants are not assessed. Only the last two are reported as not assessed
+    if(a_rVariant.GetAllelesStr().find('*') != std::string::npos)
+        return false;
+    
+    else if(a_rConfig.m_bIsFilterEnabled && a_rVariant.m_bIsFilterPASS == false)
+    {
+        a_rNotAssessedVariantCount++;
+        return false;
+    }
+    
+    else if(CUtils::IsStructuralVariant(a_rVariant, a_rConfig.m_nMaxVariantSize))
+    {
+        a_rNotAssessedVariantCount++;
+        return false;
+    }
+    
+    else if(true == a_rVariant.m_bHaveMultipleTrimOption)
+        a_rMultiTrimmableVariants.push_back(std::move(a_rVariant));
+    
+    else
+        a_rVariants.push_back(std::move(a_rVariant));
+    
+    return true;
+}
+
+std::atomic<int>& CMendelianVariantProvider::GetNotAssessedCounter(EMendelianVcfName a_uFrom)
+{
+    switch (a_uFrom)
+    {
+        case eFATHER:
+            return m_nFatherNotAssessedVariantCount;
+        case eMOTHER:
+            return m_nMotherNotAssessedVariantCount;
+        default:
+            return m_nChildNotAssessedVariantCount;
+    }
+}
+
+CVcfReader& CMendelianVariantProvider::GetVcfReader(EMendelianVcfName a_uFrom)
+{
+    switch (a_uFrom)
+    {
+        case eFATHER:
+            return m_FatherVcf;
+        case eMOTHER:
+            return m_MotherVcf;
+        default:
+            return m_ChildVcf;
+    }
+}
+
 void CMendelianVariantProvider::FillVariants()
 {
     //initialize variant lists
@@ -336,14 +501,13 @@ void CMendelianVariantProvider::FillVariants()
     m_nMotherNotAssessedVariantCount = 0;
     m_nChildNotAssessedVariantCount = 0;
     
-    //TODO : this will be replaced ??
-    m_nMotherAsteriskCount = 0;
-    m_nFatherAsteriskCount = 0;
-    m_nChildAsteriskCount  = 0;
-    
-    FillVariantForSample(eMOTHER, m_motherChildConfig);
-    FillVariantForSample(eFATHER, m_fatherChildConfig);
-    FillVariantForSample(eCHILD, m_motherChildConfig);
+    //Each sample is filled into its own lists, so the three vcfs are read in parallel
+    const int sampleThreadCount = std::max(1, m_fatherChildConfig.m_nThreadCount / 3);
+    std::thread motherThread(&CMendelianVariantProvider::FillVariantForSample, this, eMOTHER, std::ref(m_motherChildConfig), sampleThreadCount);
+    std::thread fatherThread(&CMendelianVariantProvider::FillVariantForSample, this, eFATHER, std::ref(m_fatherChildConfig), sampleThreadCount);
+    FillVariantForSample(eCHILD, m_motherChildConfig, sampleThreadCount);
+    motherThread.join();
+    fatherThread.join();
 }
 
 
@@ -516,32 +680,75 @@ std::vector<const CVariant*> CMendelianVariantProvider::GetVariantList(EMendelia
     return varList;
 }
 
-std::vector<const CVariant*> CMendelianVariantProvider::GetVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, const std::vector<int>& a_nIndexList) const
+std::vector<const CVariant*> CMendelianVariantProvider::GetExcludedVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, const core::CDecisionArray& a_rDecisions) const
 {
+    const std::vector<CVariant>* pVariantList = &m_aChildVariantList[a_nChrNo];
+    if(a_uFrom == eFATHER)
+        pVariantList = &m_aFatherVariantList[a_nChrNo];
+    else if(a_uFrom == eMOTHER)
+        pVariantList = &m_aMotherVariantList[a_nChrNo];
+    
     std::vector<const CVariant*> varList;
+    varList.reserve(a_rDecisions.GetExcludedCount());
     
-    switch (a_uFrom)
+    for(int k = 0; k < a_rDecisions.GetVariantCount(); k++)
     {
-        case eCHILD:
-            for(unsigned int k = 0; k < a_nIndexList.size(); k++)
-                varList.push_back(&m_aChildVariantList[a_nChrNo][a_nIndexList[k]]);
-            break;
-        case eFATHER:
-            for(unsigned int k = 0; k < a_nIndexList.size(); k++)
-                varList.push_back(&m_aFatherVariantList[a_nChrNo][a_nIndexList[k]]);
-            break;
-        case eMOTHER:
-            for(unsigned int k = 0; k < a_nIndexList.size(); k++)
-                varList.push_back(&m_aMotherVariantList[a_nChrNo][a_nIndexList[k]]);
-            break;
-            
-        default:
-            break;
+        if(a_rDecisions.IsExcluded(k))
+            varList.push_back(&(*pVariantList)[k]);
     }
     
     return varList;
 }
 
+std::vector<const core::COrientedVariant*> CMendelianVariantProvider::GetIncludedVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, const core::CDecisionArray& a_rGTDecisions) const
+{
+    const std::vector<core::COrientedVariant>* pOvarList = &m_aChildOrientedVariantList[a_nChrNo];
+    if(a_uFrom == eFATHER)
+        pOvarList = &m_aFatherOrientedVariantList[a_nChrNo];
+    else if(a_uFrom == eMOTHER)
+        pOvarList = &m_aMotherOrientedVariantList[a_nChrNo];
+    
+    std::vector<const core::COrientedVariant*> ovarList;
+    ovarList.reserve(a_rGTDecisions.GetIncludedCount());
+    
+    for(int k = 0; k < a_rGTDecisions.GetVariantCount(); k++)
+    {
+        if(a_rGTDecisions.IsIncluded(k))
+            ovarList.push_back(&(*pOvarList)[2 * k + (a_rGTDecisions.Get(k) == core::eDECISION_INCLUDED_SECOND ? 1 : 0)]);
+    }
+    
+    return ovarList;
+}
+
+std::vector<const core::COrientedVariant*> CMendelianVariantProvider::GetIncludedVariantList(EMendelianVcfName a_uFrom,
+                                                                                            int a_nChrNo,
+                                                                                            const core::CDecisionArray& a_rGTDecisions,
+                                                                                            const core::CDecisionArray& a_rAMDecisions) const
+{
+    const std::vector<core::COrientedVariant>* pOvarList = &m_aChildAlleleMatchOrientedVariantList[a_nChrNo];
+    if(a_uFrom == eFATHER)
+        pOvarList = &m_aFatherAlleleMatchOrientedVariantList[a_nChrNo];
+    else if(a_uFrom == eMOTHER)
+        pOvarList = &m_aMotherAlleleMatchOrientedVariantList[a_nChrNo];
+    
+    std::vector<const core::COrientedVariant*> ovarList;
+    ovarList.reserve(a_rAMDecisions.GetIncludedCount());
+    
+    //Index of the variant in the allele match replay is its rank among the variants excluded by the genotype match
+    int alleleMatchIndex = 0;
+    for(int k = 0; k < a_rGTDecisions.GetVariantCount() && alleleMatchIndex < a_rAMDecisions.GetVariantCount(); k++)
+    {
+        if(!a_rGTDecisions.IsExcluded(k))
+            continue;
+        
+        if(a_rAMDecisions.IsIncluded(alleleMatchIndex))
+            ovarList.push_back(&(*pOvarList)[2 * k + (a_rAMDecisions.Get(alleleMatchIndex) == core::eDECISION_INCLUDED_SECOND ? 1 : 0)]);
+        alleleMatchIndex++;
+    }
+    
+    return ovarList;
+}
+
 std::vector<const CVariant*> CMendelianVariantProvider::GetSortedVariantListByID(EMendelianVcfName a_uFrom, int a_nChrNo) const
 {
     std::vector<const CVariant*> varList = GetVariantList(a_uFrom, a_nChrNo);
@@ -593,40 +800,16 @@ std::vector<const core::COrientedVariant*> CMendelianVariantProvider::GetOriente
     return ovarList;
 }
 
-std::vector<const core::COrientedVariant*> CMendelianVariantProvider::GetOrientedVariantList(EMendelianVcfName a_uFrom, int a_nChrNo, bool a_bIsAlleleMatch, const std::vector<int>& a_nIndexList) const
+std::vector<const CVariant*> CMendelianVariantProvider::GetExcludedVariantList(const std::vector<const CVariant*>& a_rVariantList, const core::CDecisionArray& a_rDecisions) const
 {
-    std::vector<const core::COrientedVariant*> ovarList;
-    const std::vector<std::vector<core::COrientedVariant>>* pBaseVarList;
-
-    switch (a_uFrom)
-    {
-        case eCHILD:
-            pBaseVarList = a_bIsAlleleMatch ? &m_aChildAlleleMatchOrientedVariantList : &m_aChildOrientedVariantList;
-            break;
-        case eFATHER:
-            pBaseVarList = a_bIsAlleleMatch ? &m_aFatherAlleleMatchOrientedVariantList : &m_aFatherOrientedVariantList;
-            break;
-        case eMOTHER:
-            pBaseVarList = a_bIsAlleleMatch ? &m_aMotherAlleleMatchOrientedVariantList : &m_aMotherOrientedVariantList;
-            break;
-        default:
-            break;
-    }
+    std::vector<const CVariant*> resultList;
+    resultList.reserve(a_rDecisions.GetExcludedCount());
     
-    for(unsigned int k = 0; k < a_nIndexList.size();k++)
+    for(int k = 0; k < a_rDecisions.GetVariantCount(); k++)
     {
-        ovarList.push_back(&((*pBaseVarList)[a_nChrNo][a_nIndexList[k]*2]));
-        ovarList.push_back(&((*pBaseVarList)[a_nChrNo][a_nIndexList[k]*2+1]));
+        if(a_rDecisions.IsExcluded(k))
+            resultList.push_back(a_rVariantList[k]);
     }
-
-    return ovarList;
-}
-
-std::vector<const CVariant*> CMendelianVariantProvider::GetVariantList(const std::vector<const CVariant*> a_rVariantList, const std::vector<int>& a_nIndexList) const
-{
-    std::vector<const CVariant*> resultList(a_nIndexList.size());
-    for(unsigned int k = 0; k < a_nIndexList.size(); k++)
-        resultList[k] = a_rVariantList[a_nIndexList[k]];
     
     return resultList;
 }
@@ -783,5 +966,5 @@ void CMendelianVariantProvider::AppendTrimmedVariants(std::vector<CVariant>& a_r
     }
     
     for(unsigned int k = 0; k < a_rVariantList.size(); k++)
-        (*variantList)[a_rVariantList[k].m_nChrId].push_back(a_rVariantList[k]);
+        (*variantList)[a_rVariantList[k].m_nChrId].push_back(std::move(a_rVariantList[k]));
 }
@@ -0,0 +1,90 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CPhaseTimer.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "Utils/CPhaseTimer.h"
+#include <fstream>
+#include <iostream>
+#include <sys/resource.h>
+
+namespace
+{
+
+double GetSeconds(std::chrono::steady_clock::time_point a_start, std::chrono::steady_clock::time_point a_end)
+{
+    return std::chrono::duration<double>(a_end - a_start).count();
+}
+
+}
+
+CPhaseTimer::CPhaseTimer()
+{
+    Start();
+}
+
+void CPhaseTimer::Start()
+{
+    m_startTime = std::chrono::steady_clock::now();
+    m_phaseStartTime = m_startTime;
+    m_aPhases.clear();
+}
+
+double CPhaseTimer::EndPhase(const std::string& a_rPhaseName)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double duration = GetSeconds(m_phaseStartTime, now);
+    m_aPhases.push_back(std::make_pair(a_rPhaseName, duration));
+    m_phaseStartTime = now;
+    return duration;
+}
+
+double CPhaseTimer::GetElapsedSeconds() const
+{
+    return GetSeconds(m_startTime, std::chrono::steady_clock::now());
+}
+
+bool CPhaseTimer::WriteJson(const std::string& a_rFilePath) const
+{
+    std::ofstream file(a_rFilePath.c_str());
+    if(!file.is_open())
+    {
+        std::cerr << "Timings file " << a_rFilePath << " cannot be opened" << std::endl;
+        return false;
+    }
+
+    //CPU time covers all threads of the process. ru_maxrss is in kilobytes on Linux
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    double cpuSeconds = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+
+    file << "{" << std::endl;
+    file << "    \"wall_seconds\": " << GetElapsedSeconds() << "," << std::endl;
+    file << "    \"cpu_seconds\": " << cpuSeconds << "," << std::endl;
+    file << "    \"peak_rss_kb\": " << usage.ru_maxrss << "," << std::endl;
+    file << "    \"phases\": {";
+    for(unsigned int k = 0; k < m_aPhases.size(); k++)
+        file << (k == 0 ? "" : ",") << std::endl << "        \"" << m_aPhases[k].first << "\": " << m_aPhases[k].second;
+    file << std::endl << "    }" << std::endl;
+    file << "}" << std::endl;
+
+    return file.good();
+}
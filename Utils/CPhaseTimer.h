@@ -0,0 +1,65 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CPhaseTimer.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_PHASE_TIMER_H_
+#define _C_PHASE_TIMER_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+
+/**
+ * @brief Measures the durations of the consecutive phases of a run
+ *
+ * Each phase starts where the previous one ends. Phase durations are measured with a monotonic clock, and the timings of the
+ * run can be written to a JSON file together with the CPU time and the peak resident memory of the process.
+ */
+class CPhaseTimer
+{
+public:
+
+    CPhaseTimer();
+
+    ///Restarts the run and the first phase
+    void Start();
+
+    ///Ends the current phase with the given name and starts the next one. Returns the duration of the ended phase in seconds
+    double EndPhase(const std::string& a_rPhaseName);
+
+    ///Return the time since Start in seconds
+    double GetElapsedSeconds() const;
+
+    ///Writes the wall time, CPU time, peak RSS and the phase durations of the run as JSON. Returns false if the file cannot be written
+    bool WriteJson(const std::string& a_rFilePath) const;
+
+private:
+
+    std::chrono::steady_clock::time_point m_startTime;
+    std::chrono::steady_clock::time_point m_phaseStartTime;
+
+    ///Name and duration (in seconds) of the ended phases in run order
+    std::vector<std::pair<std::string, double>> m_aPhases;
+};
+
+#endif // _C_PHASE_TIMER_H_
@@ -27,6 +27,7 @@
 #include "CVariant.h"
 #include "COrientedVariant.h"
 #include <fstream>
+#include <algorithm>
 #include <sys/stat.h>
 
 //Checks if the given two range is overlapping
@@ -56,6 +57,54 @@ bool CUtils::CompareVariants(const CVariant& var1, const CVariant& var2)
     return var1.m_nId < var2.m_nId;
 }
 
+namespace
+{
+    //Key fields of the variant that CompareVariants uses, with the index of the variant in the unsorted list
+    struct SVariantSortKey
+    {
+        SVariantKey m_key;
+        unsigned int m_nIndex;
+    };
+}
+
+void CUtils::SortVariants(std::vector<CVariant>& a_rVariants)
+{
+    std::vector<SVariantSortKey> keys(a_rVariants.size());
+    for(unsigned int k = 0; k < a_rVariants.size(); k++)
+    {
+        keys[k].m_key = a_rVariants[k];
+        keys[k].m_nIndex = k;
+    }
+    
+    std::sort(keys.begin(), keys.end(), [](const SVariantSortKey& a_rKey1, const SVariantSortKey& a_rKey2)
+    {
+        if(a_rKey1.m_key.m_nStartPos != a_rKey2.m_key.m_nStartPos)
+            return a_rKey1.m_key.m_nStartPos < a_rKey2.m_key.m_nStartPos;
+        if(a_rKey1.m_key.m_nEndPos != a_rKey2.m_key.m_nEndPos)
+            return a_rKey1.m_key.m_nEndPos < a_rKey2.m_key.m_nEndPos;
+        return a_rKey1.m_key.m_nId < a_rKey2.m_key.m_nId;
+    });
+    
+    //Apply the permutation in place by following its cycles (position k receives the variant at keys[k].m_nIndex)
+    std::vector<bool> isPlaced(a_rVariants.size(), false);
+    for(unsigned int k = 0; k < keys.size(); k++)
+    {
+        if(isPlaced[k] || keys[k].m_nIndex == k)
+            continue;
+        
+        CVariant displaced = std::move(a_rVariants[k]);
+        unsigned int current = k;
+        while(keys[current].m_nIndex != k)
+        {
+            a_rVariants[current] = std::move(a_rVariants[keys[current].m_nIndex]);
+            isPlaced[current] = true;
+            current = keys[current].m_nIndex;
+        }
+        a_rVariants[current] = std::move(displaced);
+        isPlaced[current] = true;
+    }
+}
+
 bool CUtils::IsHomRef(const CVariant& a_rVariant)
 {
     bool res = true;
@@ -77,7 +126,7 @@ bool CUtils::IsStructuralVariant(const CVariant& a_rVariant, int a_nMaxLength)
     
     for(int k = 0; k < a_rVariant.m_nAlleleCount; k++)
     {
-        std::string allele = a_rVariant.m_alleles[k].m_sequence;
+        std::string allele = a_rVariant.GetAlleleSeq(k);
         
         if((int)allele.size() > a_nMaxLength)
             return true;
@@ -27,6 +27,7 @@
 #define _C_UTILS_H_
 
 #include <string>
+#include <vector>
 
 class CVariant;
 namespace core
@@ -48,6 +49,9 @@ public:
 
     ///Compare 2 variants according to variant start end positions and variant id
     static bool CompareVariants(const CVariant& var1, const CVariant& var2);
+    
+    ///Sort the variants in CompareVariants order. Only the position keys are sorted, each variant is moved at most once
+    static void SortVariants(std::vector<CVariant>& a_rVariants);
 
     ///Checks if the variant genotype is 0/0 (homref)
     static bool IsHomRef(const CVariant& a_rVariant);
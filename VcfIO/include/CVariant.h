@@ -32,6 +32,7 @@
 #include "EVariantMatch.h"
 #include "EVariantCategory.h"
 #include "SInfo.h"
+#include "CVariantArena.h"
 
 enum EVariantType
 {
@@ -47,26 +48,47 @@ enum EVariantType
  */
 struct SAllele
 {
-    std::string m_sequence;
+    ///View of the allele sequence in the arena of the variant. Trimming only moves the view
+    SSequenceView m_sequence;
     int m_nStartPos = -1;
     int m_nEndPos = -1;
     bool m_bIsIgnored = false;
     bool m_bIsTrimmed = false;
 };
 
+///Fields of a variant read by sorting and by the replay engine. They lead the variant layout and are copied alone for sorting
+struct SVariantKey
+{
+    ///Start Position of the variant - min start pos of all alleles
+    int m_nStartPos = -1;
+
+    ///End Position of the variant - max end pos of all alleles
+    int m_nEndPos = -1;
+    
+    ///Unique Id of variant
+    int m_nId = -1;
+    
+    ///Id of the chromosome that variant belogs to
+    int m_nChrId = -1;
+};
+
 /**
  * @brief A Container that stores the necessary information of variant
  *
- * CVariant is a container for variants that stores necessary vcfrecord information read with htslib
+ * CVariant is a container for variants that stores necessary vcfrecord information read with htslib. Strings of the variant are
+ * stored in the arena of its contig.
  */
-class CVariant
+class CVariant : public SVariantKey
 {
     public:
     ///Default constructor
     CVariant();
     
-    ///Copy constructor
-    CVariant(const CVariant& a_rObj);
+    ///Variants are copied and moved member-wise. Copies share the strings in the arena
+    CVariant(const CVariant& a_rObj) = default;
+    CVariant(CVariant&& a_rObj) = default;
+    CVariant& operator=(const CVariant& a_rObj) = default;
+    CVariant& operator=(CVariant&& a_rObj) = default;
     
     ///Clear the Variant
     bool Clear();
@@ -107,8 +129,38 @@ class CVariant
     ///Return the reference sequences
     std::string GetRefSeq() const;
     
+    ///Return the length of the reference sequence
+    int GetRefLength() const;
+    
+    ///Return the original alleles string read from vcf file (REF and ALT alleles separated by commas)
+    std::string GetAllelesStr() const;
+    
+    ///Set the original alleles string stored in the arena of the variant. Reference sequence is its first a_nRefLength characters
+    void SetAllelesStr(const SSequenceView& a_rAllelesStr, int a_nRefLength);
+    
+    ///Remove the strings of the variant from its arena. Only valid for the last variant added to the arena (eg. a dropped record)
+    void DiscardStrings();
+    
     ///Return the allele sequence specified with the id (0 is first allele, 1 is second allele)
-    SAllele GetAllele(int a_nAlleleId) const;
+    const SAllele& GetAllele(int a_nAlleleId) const;
+    
+    ///Return the bases of the allele specified with the id. They are not null terminated, see GetAlleleLength
+    const char* GetAlleleSequence(int a_nAlleleId) const
+    {
+        return m_pArena != NULL ? m_pArena->GetSequence(m_alleles[a_nAlleleId].m_sequence) : "";
+    }
+    
+    ///Return the length of the allele sequence specified with the id
+    int GetAlleleLength(int a_nAlleleId) const
+    {
+        return m_alleles[a_nAlleleId].m_sequence.m_nLength;
+    }
+    
+    ///Return a copy of the allele sequence specified with the id
+    std::string GetAlleleSeq(int a_nAlleleId) const;
+    
+    ///Point the allele specified with the id to the allele of the alleles string with the given index (0 is REF)
+    void SetAlleleSequence(int a_nAlleleId, int a_nOriginalAlleleIndex);
 
     ///Return the type of variant
     EVariantType GetVariantType() const;
@@ -131,24 +183,26 @@ class CVariant
     ///Trim the redundant nucleotides from beginning and ending of given allele. Nucleotides to be clipped from beginning and ending of the allele are specified as parameter
     void TrimVariant(int a_nAlleleIndex, unsigned int trimLengthFromBeginning, unsigned int trimLengthFromEnd);
     
+    ///Set the arena that stores the strings of the variant
+    void SetArena(CVariantArena* a_pArena);
+    
+    ///Return the chromosome name of the variant
+    const std::string& GetChrName() const;
+    
+    ///Return the filter column values of the variant
+    const std::vector<std::string>& GetFilterNames() const;
+    
+    ///Set the filter column values with the id of a filter list of the arena
+    void SetFilterListId(int a_nFilterListId);
+    
+    //Fields are ordered by size to avoid padding. Fields used by sorting and replay are in SVariantKey
+    
     ///ID of which vcf file that the variant belongs to
     int m_nVcfId;
 
-    ///Id of the chromosome that variant belogs to
-    int m_nChrId;
-
-    ///Unique Id of variant
-    int m_nId;
-
     ///Allele count of the variant (2 for diploid and 1 for haploid)
     int m_nAlleleCount;
     
-    ///Start Position of the variant - min start pos of all alleles
-    int m_nStartPos;
-
-    ///End Position of the variant - max end pos of all alleles
-    int m_nEndPos;
-    
     ///Original Genotype list read from vcf file
     int m_genotype[2];
     
@@ -158,11 +212,17 @@ class CVariant
     ///Original variant position
     int m_nOriginalPos;
     
+    ///Phase set of the phased genotype (PS format field). -1 if the genotype is unphased or phasing is not used
+    int m_nPhaseSet;
+    
     //Quality of variant
     float m_fQuality;
     
     mutable EVariantMatch m_variantStatus;
     
+    ///True if the variant is decided in a complex region resolved by beam search (decision is approximate)
+    mutable bool m_bIsApproximate;
+    
     ///True if the variant genotype is phased
     bool m_bIsPhased;
     
@@ -178,27 +238,14 @@ class CVariant
     ///If the variant can be trimmed more than 1 way (for -ref-overlap mode)
     bool m_bHaveMultipleTrimOption;
     
+    ///True if the variant passes the filter given by the config
+    bool m_bIsFilterPASS;
+    
     ///Allele array of the variant
     SAllele m_alleles[2];
 
-    ///Reference sequence
-    std::string m_refSequence;
-    
-    ///Filter Data
-    bool m_bIsFilterPASS;
-    std::vector<std::string> m_filterString;
-    
-    ///Variant id retrieved from the VCF
-    std::string m_variantIDfromVcf;
     SInfo m_info;
     
-    
-    ///Chromosome name
-    std::string m_chrName;
-    
-    ///Original Alleles string read from vcf file
-    std::string m_allelesStr;
-    
 private:
     
     ///Trim the redundant nucleotides from beginning and ending of given allele (Beginning nucleotides will be trimmed first)
@@ -206,8 +253,21 @@ private:
     
     ///Trim the redundant nucleotides from beginning and ending of given allele (Ending nucleotides will be trimmed first)
     void TrimVariantEndFirst(int a_nAlleleIndex);
-
     
+    ///Return true if the given allele is the deletion allele (*)
+    bool IsAsteriskAllele(int a_nAlleleIndex) const;
+    
+    ///Arena of the contig that stores the strings of the variant
+    CVariantArena* m_pArena;
+    
+    ///Original Alleles string read from vcf file
+    SSequenceView m_allelesStr;
+    
+    ///Length of the reference sequence (the first allele of m_allelesStr)
+    int m_nRefLength;
+    
+    ///Id of the filter list of the arena
+    int m_nFilterListId;
 };
 
 
@@ -0,0 +1,93 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CVariantArena.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _C_VARIANT_ARENA_H_
+#define _C_VARIANT_ARENA_H_
+
+#include <string>
+#include <vector>
+
+///Offset and length of a string stored in the sequence buffer of a CVariantArena
+struct SSequenceView
+{
+    int m_nOffset = 0;
+    int m_nLength = 0;
+};
+
+/**
+ * @brief Stores the strings of the variants of a single contig of a vcf
+ *
+ * The REF/ALT column of each record is appended to one contiguous sequence buffer and the variants keep offset/length views
+ * into it. The contig name and the distinct filter lists are stored once per arena. An arena is filled by the single thread that
+ * reads its contig and is only read afterwards, so it needs no locking. The owner of the arena (variant provider or vcf reader)
+ * must keep it alive and at the same address as long as its variants are used.
+ */
+class CVariantArena
+{
+public:
+
+    ///Id of the empty filter list
+    static const int EMPTY_FILTER_LIST_ID = 0;
+
+    ///Constructor
+    CVariantArena();
+
+    ///Set the name of the contig
+    void SetContigName(const std::string& a_rName);
+
+    ///Return the name of the contig
+    const std::string& GetContigName() const;
+
+    ///Append the given characters to the sequence buffer and return their view
+    SSequenceView AddSequence(const char* a_pSequence, int a_nLength);
+
+    ///Return the characters of the given view. The pointer is invalidated when a sequence is appended
+    const char* GetSequence(const SSequenceView& a_rView) const
+    {
+        return m_sequences.data() + a_rView.m_nOffset;
+    }
+
+    ///Remove the sequence of the given view and the sequences appended after it (used to drop the last read record)
+    void DiscardSequences(const SSequenceView& a_rView);
+
+    ///Release the sequence buffer. Views into the arena are invalid afterwards
+    void ReleaseSequences();
+
+    ///Return the id of the given filter list, adding it if it is not stored yet
+    int AddFilterList(const std::vector<std::string>& a_rFilterNames);
+
+    ///Return the filter list of the given id
+    const std::vector<std::string>& GetFilterList(int a_nFilterListId) const;
+
+private:
+
+    std::string m_contigName;
+
+    ///REF/ALT columns of the records of the contig
+    std::string m_sequences;
+
+    ///Distinct filter lists of the records. First list is the empty list
+    std::vector<std::vector<std::string>> m_aFilterLists;
+};
+
+#endif // _C_VARIANT_ARENA_H_
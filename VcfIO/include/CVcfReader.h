@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 #include "htslib/vcf.h"
+#include "htslib/tbx.h"
 #include "CVariant.h"
 #include "SConfig.h"
 #include <map>
@@ -55,14 +56,29 @@ public:
     CVcfReader(const char * a_pFilename);
     ~CVcfReader();
     
-    ///Open a VCF file given file path
-    bool Open(const char * a_pFilename);
+    ///Open a VCF file given file path. a_nThreadCount is the number of additional threads that decompress a bgzipped file (0 reads it in the calling thread)
+    bool Open(const char * a_pFilename, int a_nThreadCount = 0);
     
     ///Close a VCF file
     bool Close();
     
+    ///Loads the index (.tbi or .csi) of the opened file. Returns false if the file is not indexed
+    bool LoadIndex();
+    
+    ///Checks if the index of the file is loaded
+    bool HasIndex() const;
+    
+    ///Restricts the next records to the given contig using the index. Returns false if the contig cannot be queried
+    bool SetContig(const std::string& a_rContigName);
+    
     ///Get next record in the file. a_nId sets the id of variant (no need to be set)
     bool GetNextRecord(CVariant* a_pVariant, int a_nId, const SConfig& a_rConfig);
+    
+    ///Fills the given list with an empty arena for each contig of the header
+    void InitArenas(std::vector<CVariantArena>& a_rArenas) const;
+    
+    ///Stores the strings of the next records in the given arenas (one per header contig, see InitArenas) instead of the arenas of the reader
+    void SetArenas(std::vector<CVariantArena>* a_pArenas);
         
     ///Selects the sample name from multi sample VCF file and ignore other samples
     bool SelectSample(std::string a_sampleName);
@@ -124,8 +140,8 @@ private:
     /// Trimms the alt string that contains ref allele
     void TrimAllele(SAllele& a_rAllele);
         
-    /// Return whether given allele can be trimmed more than one way
-    bool HasMultipleTrimming(SAllele& a_rAllele);
+    /// Return whether given allele of the variant can be trimmed more than one way
+    bool HasMultipleTrimming(const CVariant& a_rVariant, int a_nAlleleIndex) const;
     
     ///Check if the first nucleotide for alleles are redundant (for indels)
     bool HasRedundantFirstNucleotide() const;
@@ -133,12 +149,62 @@ private:
     ///Return the chromosome number [0 to 24]
     int GetChromosomeNumber(const std::string& a_chrName) const;
     
+    ///Reads the next record of the file, or of the selected contig if an index iterator is set. Returns 0 on success
+    int ReadRecord();
+    
+    ///Releases the index and the iterator
+    void ReleaseIndex();
+    
+    ///Return the id of the filter list of the current record in the given arena. Each filter set is added once per contig
+    int GetFilterListId(CVariantArena& a_rArena);
+    
+    ///Return the header key of the given filter name. The key of the last queried name is cached since it is checked for every record
+    int GetCachedFilterKey(const char* a_pFilterName);
+    
+    ///Releases the scratch buffers used to decode the records
+    void ReleaseBuffers();
+    
     
     std::string m_filename;
     bool m_bIsOpen;
     htsFile *   m_pHtsFile;
     bcf_hdr_t * m_pHeader;
     bcf1_t *    m_pRecord;  
+    
+    ///Index of a bgzipped vcf
+    tbx_t * m_pTabixIndex;
+    ///Index of a bcf
+    hts_idx_t * m_pBcfIndex;
+    ///Iterator over the records of the selected contig (NULL reads the whole file)
+    hts_itr_t * m_pIterator;
+    ///Line buffer of the vcf records read through the tabix iterator
+    kstring_t m_line;
+    
+    ///Arenas of the header contigs that store the strings of the variants read by this reader (unless SetArenas is called)
+    std::vector<CVariantArena> m_aArenas;
+    ///Arenas that the strings of the next records are stored in
+    std::vector<CVariantArena>* m_pArenas;
+    ///Filter list ids of the filter sets read so far. Keys are the contig id followed by the header filter ids of a record
+    std::map<std::vector<int>, int> m_filterListIds;
+    ///Key of the current record, reused across records to look up m_filterListIds
+    std::vector<int> m_aFilterKeyBuffer;
+    ///REF/ALT column of the current record, reused across records
+    std::string m_allelesStrBuffer;
+    
+    ///Scratch buffers reused across records to decode genotypes, phase sets and info values (htslib grows them as needed)
+    int* m_pGenotypeBuffer;
+    int m_nGenotypeBufferSize;
+    int* m_pPhaseSetBuffer;
+    int m_nPhaseSetBufferSize;
+    void* m_pInfoBuffer;
+    int m_nInfoBufferSize;
+    
+    ///Filter name of the config and its header key (-1 if the header does not contain the filter)
+    const char* m_pCachedFilterName;
+    int m_nCachedFilterKey;
+    
+    ///Header id of the last contig whose records are skipped since it is not defined in the header (-1 if none)
+    int m_nLastSkippedContigId;
 
     std::vector<SVcfContig> m_contigs;
     int m_nVcfId;
@@ -0,0 +1,39 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  EComplexRegionMode.h
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#ifndef _E_COMPLEX_REGION_MODE_H_
+#define _E_COMPLEX_REGION_MODE_H_
+
+/**
+ * @brief ENUM of the strategies to handle a region that exceeds the path size or iteration limit of the Core Comparison module
+ *
+ */
+enum EComplexRegionMode
+{
+    ///Drop all paths and mark the variants of the region as complex skipped
+    eCOMPLEX_REGION_SKIP,
+    ///Keep only the best scoring paths and continue the replay (decisions of the region are approximate)
+    eCOMPLEX_REGION_BEAM
+};
+
+#endif // _E_COMPLEX_REGION_MODE_H_
@@ -27,6 +27,7 @@
 #define _S_CONFIG_H_
 
 #include "Constants.h"
+#include "EComplexRegionMode.h"
 
 /**
  * @brief Any configuration that will be used will be distributed over classes via this object
@@ -120,6 +121,33 @@ struct SConfig
     ///Maximum number of iteration to resolve a variant (max iteration count for a variant to give TP/FP/FN decision)
     int m_nMaxIterationCount = DEFAULT_MAX_ITERATION_SIZE;
     
+    ///Strategy of variant comparison core when path size or iteration count limit is exceeded
+    EComplexRegionMode m_complexRegionMode = eCOMPLEX_REGION_SKIP;
+    
+    ///Number of paths kept in beam search mode
+    int m_nBeamWidth = DEFAULT_BEAM_WIDTH;
+    
+    ///Estimate the complexity of each region before replay to assign its iteration budget (hopeless regions go to the fallback directly)
+    bool m_bAdaptiveBudget = false;
+    
+    ///Read the phase sets (PS) of the phased genotypes, so that the comparison core keeps a single orientation per phase set
+    bool m_bUsePhasing = false;
+    
+    ///Directory of the persistent cache that stores the decisions of the replayed regions across runs
+    const char* m_pReplayCacheDirectory;
+    bool m_bUseReplayCache = false;
+    
+    ///File that the replay statistics of each sync region (variant counts, path complexity, time and outcome) are written to
+    const char* m_pReplayStatsPath;
+    bool m_bWriteReplayStats = false;
+    
+    ///File that the wall time, CPU time, peak memory and phase durations of the run are written to as JSON
+    const char* m_pTimingsPath;
+    bool m_bWriteTimings = false;
+    
+    ///Load, compare, output and release one chromosome at a time (requires indexed vcfs) so that memory is bounded by the largest chromosomes
+    bool m_bStreaming = false;
+    
     ///Maximum size of the variant that will be processed by VCF comparison algorithm (Use it to eliminate SVs)
     int m_nMaxVariantSize = DEFAULT_MAX_BP_LENGTH;
     
@@ -10,21 +10,20 @@
 #define _S_INFO_H_
 
 #include <vector>
+#include <string>
 
 struct SInfoEntry
 {
     int n; //Len
     int type; //Info Type
     std::string key = ""; //Info Tag
-    void* values = NULL; //Data
+    std::vector<char> values; //Data
 };
 
 struct SInfo
 {
     SInfo() {};
     
-    SInfo(const SInfo& a_rInfo) {m_infoArray = std::vector<SInfoEntry>(a_rInfo.m_infoArray);};
-    
     void Clear() {m_infoArray.clear();};
     
     std::vector<SInfoEntry> m_infoArray;
@@ -72,6 +72,8 @@ struct SVcfRecord
     int m_nPosition;
     ///Quality of the variant
     float m_fQuality = 0.0f;
+    ///INFO : Decision is made by beam search in a complex region
+    bool m_bIsApproximate = false;
     ///Mendelian Decision INFO (Used for mendelian comparison feature)
     std::string m_mendelianDecision = "";
     ///Filter string of the variant (eg. "PASS")
@@ -26,71 +26,37 @@
 #include "CVariant.h"
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 #include "Constants.h"
 
+namespace
+{
+    //Names and filters of the variants without an arena
+    const std::string g_emptyString;
+    const std::vector<std::string> g_emptyList;
+}
 
 CVariant::CVariant(): m_nVcfId(-1),
-            m_nChrId(-1),
-            m_chrName(),
             m_bIsPhased(false),
-            m_nStartPos(-1)
+            m_pArena(NULL),
+            m_nRefLength(0),
+            m_nFilterListId(CVariantArena::EMPTY_FILTER_LIST_ID)
 
 {
-    m_nId = -1;
     m_nAlleleCount = 0;
     m_bIsFirstNucleotideTrimmed = false;
     
-    m_allelesStr = "";
     m_nZygotCount = 0;
     m_variantStatus = eNOT_ASSESSED;
+    m_bIsApproximate = false;
+    m_nPhaseSet = -1;
     m_genotype[0] = -1;
     m_genotype[1] = -1;
     m_bIsNoCall = false;
     m_bHaveMultipleTrimOption = false;
-    m_variantIDfromVcf = "";
     m_fQuality = 0.0f;
 }
 
-CVariant::CVariant(const CVariant& a_rObj)
-{
-    m_nVcfId = a_rObj.m_nVcfId;
-    m_nChrId = a_rObj.m_nChrId;
-    m_chrName = a_rObj.m_chrName;
-    m_bIsPhased = a_rObj.m_bIsPhased;
-    m_nAlleleCount = a_rObj.m_nAlleleCount;
-    m_alleles[0].m_nEndPos = a_rObj.m_alleles[0].m_nEndPos;
-    m_alleles[0].m_nStartPos = a_rObj.m_alleles[0].m_nStartPos;
-    m_alleles[0].m_sequence = a_rObj.m_alleles[0].m_sequence;
-    m_alleles[0].m_bIsIgnored = a_rObj.m_alleles[0].m_bIsIgnored;
-    m_alleles[0].m_bIsTrimmed = a_rObj.m_alleles[0].m_bIsTrimmed;
-    m_alleles[1].m_nEndPos = a_rObj.m_alleles[1].m_nEndPos;
-    m_alleles[1].m_nStartPos = a_rObj.m_alleles[1].m_nStartPos;
-    m_alleles[1].m_sequence = a_rObj.m_alleles[1].m_sequence;
-    m_alleles[1].m_bIsIgnored = a_rObj.m_alleles[1].m_bIsIgnored;
-    m_alleles[1].m_bIsTrimmed = a_rObj.m_alleles[1].m_bIsTrimmed;
-    
-    m_variantIDfromVcf = a_rObj.m_variantIDfromVcf;
-    m_nStartPos = a_rObj.m_nStartPos;
-    m_nEndPos = a_rObj.m_nEndPos;
-    m_nId = a_rObj.m_nId;
-    m_refSequence = a_rObj.m_refSequence;
-    m_bIsHeterozygous = a_rObj.m_bIsHeterozygous;
-    m_bIsFirstNucleotideTrimmed = a_rObj.m_bIsFirstNucleotideTrimmed;
-    m_bHaveMultipleTrimOption = a_rObj.m_bHaveMultipleTrimOption;
-    
-    m_fQuality = a_rObj.m_fQuality;
-    m_info = a_rObj.m_info;
-    m_filterString = a_rObj.m_filterString;
-    m_allelesStr = a_rObj.m_allelesStr;
-    m_nZygotCount = a_rObj.m_nZygotCount;
-    m_genotype[0] = a_rObj.m_genotype[0];
-    m_genotype[1] = a_rObj.m_genotype[1];
-    m_variantStatus = a_rObj.m_variantStatus;
-    m_nOriginalPos = a_rObj.m_nOriginalPos;
-    m_bIsNoCall = a_rObj.m_bIsNoCall;
-    
-}
-
 int CVariant::CompareTo(const CVariant& a_rObj) const
 {
     if(GetStart() < a_rObj.GetStart())
@@ -106,28 +72,52 @@ bool CVariant::Clear()
     m_nVcfId = -1;
     m_nChrId = -1;
     m_nStartPos = -1;
-    m_chrName.clear();
+    m_pArena = NULL;
     m_nAlleleCount = 0;
     m_nZygotCount = 0;
-    m_allelesStr.clear();
-    m_filterString.clear();
+    m_allelesStr = SSequenceView();
+    m_nRefLength = 0;
+    m_nFilterListId = CVariantArena::EMPTY_FILTER_LIST_ID;
     m_bIsFirstNucleotideTrimmed = false;
     m_variantStatus = eNOT_ASSESSED;
+    m_bIsApproximate = false;
+    m_nPhaseSet = -1;
     m_nOriginalPos = -1;
     m_fQuality = 0.0f;
     m_alleles[0].m_bIsIgnored = false;
     m_alleles[1].m_bIsIgnored = false;
     m_alleles[0].m_bIsTrimmed = false;
     m_alleles[1].m_bIsTrimmed = false;
+    m_alleles[0].m_sequence = SSequenceView();
+    m_alleles[1].m_sequence = SSequenceView();
     m_genotype[0] = -1;
     m_genotype[1] = -1;
     m_bIsNoCall = false;
     m_bHaveMultipleTrimOption = false;
-    m_variantIDfromVcf = "";
     m_info.Clear();
     return true;
 }
 
+void CVariant::SetArena(CVariantArena* a_pArena)
+{
+    m_pArena = a_pArena;
+}
+
+const std::string& CVariant::GetChrName() const
+{
+    return m_pArena != NULL ? m_pArena->GetContigName() : g_emptyString;
+}
+
+const std::vector<std::string>& CVariant::GetFilterNames() const
+{
+    return m_pArena != NULL ? m_pArena->GetFilterList(m_nFilterListId) : g_emptyList;
+}
+
+void CVariant::SetFilterListId(int a_nFilterListId)
+{
+    m_nFilterListId = a_nFilterListId;
+}
+
 bool CVariant::IsHeterozygous() const
 {
     return m_bIsHeterozygous;
@@ -139,10 +129,10 @@ void CVariant::Print() const
         std::cout << "Belongs to  : Baseline" << std::endl;
     else
         std::cout << "Belongs to  : Called" << std::endl;
-    std::cout <<     "Ref : " << m_refSequence << std::endl;
+    std::cout <<     "Ref : " << GetRefSeq() << std::endl;
     for(int k = 0; k < m_nAlleleCount; k++)
     {
-        std::cout << "Alt" << k << ": " << m_alleles[k].m_sequence << std::endl;
+        std::cout << "Alt" << k << ": " << GetAlleleSeq(k) << std::endl;
     }
 }
 
@@ -173,21 +163,72 @@ bool CVariant::IsPhased() const
 
 std::string CVariant::GetRefSeq() const
 {
-    return m_refSequence;
+    if(m_pArena == NULL)
+        return "";
+    return std::string(m_pArena->GetSequence(m_allelesStr), m_nRefLength);
 }
 
-SAllele CVariant::GetAllele(int a_nAlleleId) const
+int CVariant::GetRefLength() const
+{
+    return m_nRefLength;
+}
+
+std::string CVariant::GetAllelesStr() const
+{
+    if(m_pArena == NULL)
+        return "";
+    return std::string(m_pArena->GetSequence(m_allelesStr), m_allelesStr.m_nLength);
+}
+
+void CVariant::SetAllelesStr(const SSequenceView& a_rAllelesStr, int a_nRefLength)
+{
+    m_allelesStr = a_rAllelesStr;
+    m_nRefLength = a_nRefLength;
+}
+
+void CVariant::DiscardStrings()
+{
+    if(m_pArena != NULL)
+        m_pArena->DiscardSequences(m_allelesStr);
+    m_allelesStr = SSequenceView();
+    m_nRefLength = 0;
+}
+
+const SAllele& CVariant::GetAllele(int a_nAlleleId) const
 {
     return m_alleles[a_nAlleleId];
 }
 
+std::string CVariant::GetAlleleSeq(int a_nAlleleId) const
+{
+    return std::string(GetAlleleSequence(a_nAlleleId), GetAlleleLength(a_nAlleleId));
+}
+
+void CVariant::SetAlleleSequence(int a_nAlleleId, int a_nOriginalAlleleIndex)
+{
+    //Find the comma separated allele inside the REF/ALT string of the arena
+    const char* pBegin = m_pArena->GetSequence(m_allelesStr);
+    const char* pEnd = pBegin + m_allelesStr.m_nLength;
+    const char* pStart = pBegin;
+    for(int k = 0; k < a_nOriginalAlleleIndex && pStart != pEnd; k++)
+    {
+        pStart = std::find(pStart, pEnd, ',');
+        if(pStart != pEnd)
+            pStart++;
+    }
+    const char* pStop = std::find(pStart, pEnd, ',');
+    
+    m_alleles[a_nAlleleId].m_sequence.m_nOffset = m_allelesStr.m_nOffset + static_cast<int>(pStart - pBegin);
+    m_alleles[a_nAlleleId].m_sequence.m_nLength = static_cast<int>(pStop - pStart);
+}
+
 std::string CVariant::GetOriginalAlleleStr(unsigned int a_nAlleleIndex) const
 {
     if(m_bIsNoCall == true)
         return "";
     
     std::vector<std::string> alleleList;
-    std::stringstream ss(m_allelesStr);
+    std::stringstream ss(GetAllelesStr());
     std::string alel;
     while (std::getline(ss, alel, ','))
     {
@@ -211,14 +252,14 @@ std::string CVariant::ToString() const
 {
     std::string toRet = "";
     
-    toRet = m_chrName + ":" + std::to_string(GetStart() + 1) + "-" + std::to_string(GetEnd() + 1) + " (";
+    toRet = GetChrName() + ":" + std::to_string(GetStart() + 1) + "-" + std::to_string(GetEnd() + 1) + " (";
     
     for(int k=0; k < m_nAlleleCount; k++)
     {
         if(k > 0)
             toRet = toRet + ":";
         
-        toRet = toRet + (m_alleles[k].m_bIsIgnored ? "*" : m_alleles[k].m_sequence);
+        toRet = toRet + (m_alleles[k].m_bIsIgnored ? "*" : GetAlleleSeq(k));
     }
     toRet = toRet + ")";
     
@@ -233,14 +274,14 @@ bool CVariant::IsFilterPASS() const
 EVariantType CVariant::GetVariantType() const
 {
     //SNP CASE
-    if(m_refSequence.length() == 1 && m_alleles[0].m_sequence.length() == 1 && m_alleles[1].m_sequence.length() == 1)
+    if(m_nRefLength == 1 && GetAlleleLength(0) == 1 && GetAlleleLength(1) == 1)
         return eSNP;
     
     //SV CASE
     std::size_t found;
     for(int k = 0; k < m_nAlleleCount; k++)
     {
-        std::string allele = m_alleles[k].m_sequence;
+        std::string allele = GetAlleleSeq(k);
 
         found = allele.find('[');
         if(found != std::string::npos)
@@ -265,7 +306,7 @@ EVariantCategory CVariant::GetVariantCategory() const
 {
     //Split alleles string to vector of allele strings
     std::vector<std::string> alleles;
-    std::stringstream ss(m_allelesStr);
+    std::stringstream ss(GetAllelesStr());
     
     std::string al;
     while(std::getline(ss, al, ','))
@@ -324,20 +365,23 @@ void CVariant::GetMaxTrimStartEnd(int a_nAlleleIndex, unsigned int& trimLengthFr
 {
     trimLengthFromBeginning = 0;
     trimLengthFromEnd = 0;
+    const char* pRef = m_pArena->GetSequence(m_allelesStr);
+    const char* pSequence = GetAlleleSequence(a_nAlleleIndex);
+    const int sequenceLength = GetAlleleLength(a_nAlleleIndex);
     
     //Trim from the beginning
-    unsigned int compSize = static_cast<unsigned int>(std::min(m_refSequence.size(), m_alleles[a_nAlleleIndex].m_sequence.size()));
+    unsigned int compSize = static_cast<unsigned int>(std::min(m_nRefLength, sequenceLength));
     for(unsigned int k = 0; k < compSize; k++)
     {
-        if(m_alleles[a_nAlleleIndex].m_sequence[k] != m_refSequence[k])
+        if(pSequence[k] != pRef[k])
             break;
         trimLengthFromBeginning++;
     }
     
     //Trim from the end
-    for(int k = static_cast<int>(m_refSequence.size() - 1), p = static_cast<int>(m_alleles[a_nAlleleIndex].m_sequence.size() - 1); k >= 0 && p >= 0;  k--, p--)
+    for(int k = m_nRefLength - 1, p = sequenceLength - 1; k >= 0 && p >= 0;  k--, p--)
     {
-        if(m_alleles[a_nAlleleIndex].m_sequence[p] != m_refSequence[k])
+        if(pSequence[p] != pRef[k])
             break;
         trimLengthFromEnd++;
     }
@@ -352,37 +396,44 @@ void CVariant::TrimVariant(int a_nAlleleIndex, bool a_bIsBeginFirst)
 
 }
 
+bool CVariant::IsAsteriskAllele(int a_nAlleleIndex) const
+{
+    return GetAlleleLength(a_nAlleleIndex) == 1 && GetAlleleSequence(a_nAlleleIndex)[0] == '*';
+}
+
 void CVariant::TrimVariantEndFirst(int a_nAlleleIndex)
 {
-    if(m_alleles[a_nAlleleIndex].m_sequence == "*")
+    if(IsAsteriskAllele(a_nAlleleIndex))
         return;
     
-    //Ref string
-    std::string refString = m_refSequence;
+    //Trimming moves the view of the allele sequence, the bases in the arena are not changed
+    SAllele& allele = m_alleles[a_nAlleleIndex];
+    const char* pRef = m_pArena->GetSequence(m_allelesStr);
+    const char* pSequence = GetAlleleSequence(a_nAlleleIndex);
     
     int trimLengthFromBeginning = 0;
     int trimLengthFromEnd = 0;
     
     //Trim from the end
-    for(int k = static_cast<int>(refString.size() - 1), p = static_cast<int>(m_alleles[a_nAlleleIndex].m_sequence.size() - 1); k >= 0 && p >= 0;  k--, p--)
+    for(int k = m_nRefLength - 1, p = allele.m_sequence.m_nLength - 1; k >= 0 && p >= 0;  k--, p--)
     {
-        if(m_alleles[a_nAlleleIndex].m_sequence[p] == refString[k] && p == 0)
+        if(pSequence[p] == pRef[k] && p == 0)
         {
-            trimLengthFromEnd = static_cast<int>(m_alleles[a_nAlleleIndex].m_sequence.size());
-            m_alleles[a_nAlleleIndex].m_nEndPos -= trimLengthFromEnd;
+            trimLengthFromEnd = allele.m_sequence.m_nLength;
+            allele.m_nEndPos -= trimLengthFromEnd;
             break;
         }
         
-        else if(m_alleles[a_nAlleleIndex].m_sequence[p] == refString[k] && k == 0)
+        else if(pSequence[p] == pRef[k] && k == 0)
         {
-            trimLengthFromEnd = static_cast<int>(refString.size());
-            m_alleles[a_nAlleleIndex].m_nEndPos -= trimLengthFromEnd;
+            trimLengthFromEnd = m_nRefLength;
+            allele.m_nEndPos -= trimLengthFromEnd;
             break;
         }
         
-        else if(m_alleles[a_nAlleleIndex].m_sequence[p] != refString[k])
+        else if(pSequence[p] != pRef[k])
         {
-            m_alleles[a_nAlleleIndex].m_nEndPos -= trimLengthFromEnd;
+            allele.m_nEndPos -= trimLengthFromEnd;
             break;
         }
         else
@@ -390,22 +441,22 @@ void CVariant::TrimVariantEndFirst(int a_nAlleleIndex)
     }
     
     //Cut the end of the string
-    m_alleles[a_nAlleleIndex].m_sequence = m_alleles[a_nAlleleIndex].m_sequence.substr(0, m_alleles[a_nAlleleIndex].m_sequence.length() - trimLengthFromEnd);
+    allele.m_sequence.m_nLength -= trimLengthFromEnd;
     
     //Trim from the beginning
-    int compSize = static_cast<int>(std::min(refString.size() - trimLengthFromEnd, m_alleles[a_nAlleleIndex].m_sequence.size()));
+    int compSize = std::min(m_nRefLength - trimLengthFromEnd, allele.m_sequence.m_nLength);
     for(int k = 0; k < compSize; k++)
     {
-        if(m_alleles[a_nAlleleIndex].m_sequence[k] == refString[k] && k == compSize -1)
+        if(pSequence[k] == pRef[k] && k == compSize -1)
         {
             trimLengthFromBeginning++;
-            m_alleles[a_nAlleleIndex].m_nStartPos += trimLengthFromBeginning;
+            allele.m_nStartPos += trimLengthFromBeginning;
             break;
         }
         
-        else if(m_alleles[a_nAlleleIndex].m_sequence[k] != refString[k])
+        else if(pSequence[k] != pRef[k])
         {
-            m_alleles[a_nAlleleIndex].m_nStartPos += trimLengthFromBeginning;
+            allele.m_nStartPos += trimLengthFromBeginning;
             break;
         }
         
@@ -414,11 +465,12 @@ void CVariant::TrimVariantEndFirst(int a_nAlleleIndex)
     }
     
     //Cut the beginning of the string
-    m_alleles[a_nAlleleIndex].m_sequence = m_alleles[a_nAlleleIndex].m_sequence.substr(trimLengthFromBeginning);
+    allele.m_sequence.m_nOffset += trimLengthFromBeginning;
+    allele.m_sequence.m_nLength -= trimLengthFromBeginning;
 
     
     //Set the trimming check as true
-    m_alleles[a_nAlleleIndex].m_bIsTrimmed = true;
+    allele.m_bIsTrimmed = true;
     
     return;
 }
@@ -426,29 +478,31 @@ void CVariant::TrimVariantEndFirst(int a_nAlleleIndex)
 
 void CVariant::TrimVariantBeginFirst(int a_nAlleleIndex)
 {    
-    if(m_alleles[a_nAlleleIndex].m_sequence == "*")
+    if(IsAsteriskAllele(a_nAlleleIndex))
         return;
     
-    //Ref string
-    std::string refString = m_refSequence;
+    //Trimming moves the view of the allele sequence, the bases in the arena are not changed
+    SAllele& allele = m_alleles[a_nAlleleIndex];
+    const char* pRef = m_pArena->GetSequence(m_allelesStr);
+    const char* pSequence = GetAlleleSequence(a_nAlleleIndex);
     
     int trimLengthFromBeginning = 0;
     int trimLengthFromEnd = 0;
     
     //Trim from the beginning
-    int compSize = static_cast<int>(std::min(refString.size(), m_alleles[a_nAlleleIndex].m_sequence.size()));
+    int compSize = std::min(m_nRefLength, allele.m_sequence.m_nLength);
     for(int k = 0; k < compSize; k++)
     {
-        if(m_alleles[a_nAlleleIndex].m_sequence[k] == refString[k] && k == compSize -1)
+        if(pSequence[k] == pRef[k] && k == compSize -1)
         {
             trimLengthFromBeginning++;
-            m_alleles[a_nAlleleIndex].m_nStartPos += trimLengthFromBeginning;
+            allele.m_nStartPos += trimLengthFromBeginning;
             break;
         }
         
-        else if(m_alleles[a_nAlleleIndex].m_sequence[k] != refString[k])
+        else if(pSequence[k] != pRef[k])
         {
-            m_alleles[a_nAlleleIndex].m_nStartPos += trimLengthFromBeginning;
+            allele.m_nStartPos += trimLengthFromBeginning;
             break;
         }
         
@@ -457,29 +511,31 @@ void CVariant::TrimVariantBeginFirst(int a_nAlleleIndex)
     }
     
     //Cut the beginning of the string
-    m_alleles[a_nAlleleIndex].m_sequence = m_alleles[a_nAlleleIndex].m_sequence.substr(trimLengthFromBeginning);
+    allele.m_sequence.m_nOffset += trimLengthFromBeginning;
+    allele.m_sequence.m_nLength -= trimLengthFromBeginning;
+    pSequence += trimLengthFromBeginning;
     
     //Trim from the end
-    for(int k = static_cast<int>(refString.size() - 1), p = static_cast<int>(m_alleles[a_nAlleleIndex].m_sequence.size() - 1); k >= trimLengthFromBeginning && p >= 0;  k--, p--)
+    for(int k = m_nRefLength - 1, p = allele.m_sequence.m_nLength - 1; k >= trimLengthFromBeginning && p >= 0;  k--, p--)
     {
-        if(m_alleles[a_nAlleleIndex].m_sequence[p] == refString[k] && p == 0)
+        if(pSequence[p] == pRef[k] && p == 0)
         {
-            trimLengthFromEnd = static_cast<int>(m_alleles[a_nAlleleIndex].m_sequence.size());
-            m_alleles[a_nAlleleIndex].m_nEndPos -= trimLengthFromEnd;
+            trimLengthFromEnd = allele.m_sequence.m_nLength;
+            allele.m_nEndPos -= trimLengthFromEnd;
             break;
         }
         
-        else if(m_alleles[a_nAlleleIndex].m_sequence[p] == refString[k] && k == trimLengthFromBeginning)
+        else if(pSequence[p] == pRef[k] && k == trimLengthFromBeginning)
         {
-            trimLengthFromEnd = static_cast<int>(refString.size()) - trimLengthFromBeginning;
-            m_alleles[a_nAlleleIndex].m_nEndPos -= trimLengthFromEnd;
+            trimLengthFromEnd = m_nRefLength - trimLengthFromBeginning;
+            allele.m_nEndPos -= trimLengthFromEnd;
             break;
         }
         
         
-        else if(m_alleles[a_nAlleleIndex].m_sequence[p] != refString[k])
+        else if(pSequence[p] != pRef[k])
         {
-            m_alleles[a_nAlleleIndex].m_nEndPos -= trimLengthFromEnd;
+            allele.m_nEndPos -= trimLengthFromEnd;
             break;
         }
         else
@@ -487,20 +543,23 @@ void CVariant::TrimVariantBeginFirst(int a_nAlleleIndex)
     }
     
     //Cut the end of the string
-    m_alleles[a_nAlleleIndex].m_sequence = m_alleles[a_nAlleleIndex].m_sequence.substr(0, m_alleles[a_nAlleleIndex].m_sequence.length() - trimLengthFromEnd);
+    allele.m_sequence.m_nLength -= trimLengthFromEnd;
 
     //Set the trimming check as true
-    m_alleles[a_nAlleleIndex].m_bIsTrimmed = true;
+    allele.m_bIsTrimmed = true;
     
     return;    
 }
 
 void CVariant::TrimVariant(int a_nAlleleIndex, unsigned int trimLengthFromBeginning, unsigned int trimLengthFromEnd)
 {
-    m_alleles[a_nAlleleIndex].m_bIsTrimmed = true;
+    SAllele& allele = m_alleles[a_nAlleleIndex];
+    allele.m_bIsTrimmed = true;
+    const char* pRef = m_pArena->GetSequence(m_allelesStr);
+    const char* pSequence = GetAlleleSequence(a_nAlleleIndex);
 
     //Update maximum trim size from begininning in case it already trimmed from the end
-    unsigned int compSize = std::min(int(m_alleles[a_nAlleleIndex].m_nEndPos - m_alleles[a_nAlleleIndex].m_nStartPos), (int)m_alleles[a_nAlleleIndex].m_sequence.size());
+    unsigned int compSize = std::min(int(allele.m_nEndPos - allele.m_nStartPos), allele.m_sequence.m_nLength);
     trimLengthFromBeginning =  std::min(compSize, trimLengthFromBeginning);
     
     bool canTrimFromBegin = true;
@@ -509,7 +568,7 @@ void CVariant::TrimVariant(int a_nAlleleIndex, unsigned int trimLengthFromBeginn
     //Trim from the beginning
     for(unsigned int k = 0; k < trimLengthFromBeginning ; k++)
     {
-        if(m_alleles[a_nAlleleIndex].m_sequence[k] != m_refSequence[m_alleles[a_nAlleleIndex].m_nStartPos - m_nOriginalPos + k])
+        if(pSequence[k] != pRef[allele.m_nStartPos - m_nOriginalPos + k])
         {
             std::cerr << "Unable to Trim : " << ToString() << std::endl;
             canTrimFromBegin = false;
@@ -519,22 +578,24 @@ void CVariant::TrimVariant(int a_nAlleleIndex, unsigned int trimLengthFromBeginn
     
     if(canTrimFromBegin == true)
     {
-        m_alleles[a_nAlleleIndex].m_sequence = m_alleles[a_nAlleleIndex].m_sequence.substr(trimLengthFromBeginning);
-        m_alleles[a_nAlleleIndex].m_nStartPos += trimLengthFromBeginning;
+        allele.m_sequence.m_nOffset += trimLengthFromBeginning;
+        allele.m_sequence.m_nLength -= trimLengthFromBeginning;
+        pSequence += trimLengthFromBeginning;
+        allele.m_nStartPos += trimLengthFromBeginning;
         compSize -= trimLengthFromBeginning;
     }
     
     //Update trimming size from the end
     trimLengthFromEnd = std::min(trimLengthFromEnd, compSize);
-    unsigned int originalEndPos = m_nOriginalPos + (int)m_refSequence.length();
+    unsigned int originalEndPos = m_nOriginalPos + m_nRefLength;
     
     //Trim from the end
-    for(int k = originalEndPos - m_nEndPos - 1, p = static_cast<int>(m_alleles[a_nAlleleIndex].m_sequence.size()) - 1; k >= 0;  k--, p--)
+    for(int k = originalEndPos - m_nEndPos - 1, p = allele.m_sequence.m_nLength - 1; k >= 0;  k--, p--)
     {
-        if(p == (int)m_alleles[a_nAlleleIndex].m_sequence.size() - (int)trimLengthFromEnd - 1)
+        if(p == allele.m_sequence.m_nLength - (int)trimLengthFromEnd - 1)
            break;
         
-        if(m_alleles[a_nAlleleIndex].m_sequence[p] != m_refSequence[k])
+        if(pSequence[p] != pRef[k])
         {
             canTrimFromEnd = false;
             std::cerr << "Unable to Trim : " << ToString() << std::endl;
@@ -544,8 +605,8 @@ void CVariant::TrimVariant(int a_nAlleleIndex, unsigned int trimLengthFromBeginn
     
     if(canTrimFromEnd == true)
     {
-        m_alleles[a_nAlleleIndex].m_sequence = m_alleles[a_nAlleleIndex].m_sequence.substr(0, m_alleles[a_nAlleleIndex].m_sequence.length() - trimLengthFromEnd);
-        m_alleles[a_nAlleleIndex].m_nEndPos -= trimLengthFromEnd;
+        allele.m_sequence.m_nLength -= trimLengthFromEnd;
+        allele.m_nEndPos -= trimLengthFromEnd;
     }
 }
 
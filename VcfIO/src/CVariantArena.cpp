@@ -0,0 +1,78 @@
+/*
+ *
+ * Copyright 2017 Seven Bridges Genomics Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  CVariantArena.cpp
+ *  VariantBenchmarkingTools
+ *
+ */
+
+#include "CVariantArena.h"
+
+CVariantArena::CVariantArena()
+: m_aFilterLists(1)
+{
+}
+
+void CVariantArena::SetContigName(const std::string& a_rName)
+{
+    m_contigName = a_rName;
+}
+
+const std::string& CVariantArena::GetContigName() const
+{
+    return m_contigName;
+}
+
+SSequenceView CVariantArena::AddSequence(const char* a_pSequence, int a_nLength)
+{
+    SSequenceView view;
+    view.m_nOffset = static_cast<int>(m_sequences.size());
+    view.m_nLength = a_nLength;
+    m_sequences.append(a_pSequence, a_nLength);
+    return view;
+}
+
+void CVariantArena::DiscardSequences(const SSequenceView& a_rView)
+{
+    if(a_rView.m_nOffset < (int)m_sequences.size())
+        m_sequences.resize(a_rView.m_nOffset);
+}
+
+void CVariantArena::ReleaseSequences()
+{
+    //Swapping with an empty string frees the memory (clear keeps the capacity)
+    std::string().swap(m_sequences);
+}
+
+int CVariantArena::AddFilterList(const std::vector<std::string>& a_rFilterNames)
+{
+    //A vcf has a few distinct filter lists, so they are searched linearly
+    for(unsigned int k = 0; k < m_aFilterLists.size(); k++)
+    {
+        if(m_aFilterLists[k] == a_rFilterNames)
+            return k;
+    }
+    
+    m_aFilterLists.push_back(a_rFilterNames);
+    return static_cast<int>(m_aFilterLists.size()) - 1;
+}
+
+const std::vector<std::string>& CVariantArena::GetFilterList(int a_nFilterListId) const
+{
+    return m_aFilterLists[a_nFilterListId];
+}
@@ -24,6 +24,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include "CVcfReader.h"
 #include <iostream>
 #include <sstream>
@@ -31,11 +32,37 @@
 CVcfReader::CVcfReader()
 {
     m_bIsOpen = false;
+    m_pTabixIndex = NULL;
+    m_pBcfIndex = NULL;
+    m_pIterator = NULL;
+    m_line.l = m_line.m = 0;
+    m_line.s = NULL;
+    m_pGenotypeBuffer = NULL;
+    m_pPhaseSetBuffer = NULL;
+    m_pInfoBuffer = NULL;
+    m_nGenotypeBufferSize = m_nPhaseSetBufferSize = m_nInfoBufferSize = 0;
+    m_pCachedFilterName = NULL;
+    m_nCachedFilterKey = -1;
+    m_nLastSkippedContigId = -1;
+    m_pArenas = &m_aArenas;
 }
 
 CVcfReader::CVcfReader(const char * a_pFilename)
 {
     m_bIsOpen = false;
+    m_pTabixIndex = NULL;
+    m_pBcfIndex = NULL;
+    m_pIterator = NULL;
+    m_line.l = m_line.m = 0;
+    m_line.s = NULL;
+    m_pGenotypeBuffer = NULL;
+    m_pPhaseSetBuffer = NULL;
+    m_pInfoBuffer = NULL;
+    m_nGenotypeBufferSize = m_nPhaseSetBufferSize = m_nInfoBufferSize = 0;
+    m_pCachedFilterName = NULL;
+    m_nCachedFilterKey = -1;
+    m_nLastSkippedContigId = -1;
+    m_pArenas = &m_aArenas;
     Open(a_pFilename);
 }
 
@@ -44,7 +71,7 @@ CVcfReader::~CVcfReader()
     Close();
 }
 
-bool CVcfReader::Open(const char * a_pFilename)
+bool CVcfReader::Open(const char * a_pFilename, int a_nThreadCount)
 {
     if (true == m_bIsOpen)
     {
@@ -53,6 +80,7 @@ bool CVcfReader::Open(const char * a_pFilename)
     }
     
     assert(a_pFilename);
+    m_filename = a_pFilename;
     m_pHtsFile = bcf_open(a_pFilename, "r");
     
     if (m_pHtsFile == NULL)
@@ -61,6 +89,10 @@ bool CVcfReader::Open(const char * a_pFilename)
         return false;
     }
     
+    //Blocks of a bgzipped file are decompressed by the htslib threads while the records are parsed. It has no effect on plain vcf
+    if (a_nThreadCount > 0 && hts_set_threads(m_pHtsFile, a_nThreadCount) != 0)
+        fprintf(stderr, "WARNING: Multithreaded decompression is disabled for the vcf file: %s.\n", a_pFilename);
+    
     // Read header
     m_pHeader = bcf_hdr_read(m_pHtsFile);
     if (m_pHeader == NULL)
@@ -83,12 +115,19 @@ bool CVcfReader::Open(const char * a_pFilename)
     m_pRecord  = bcf_init();
     assert(m_pRecord);
     
+    InitArenas(m_aArenas);
+    
     m_bIsOpen = true;
     return true;
 }
 
 bool CVcfReader::Close()
 {
+    ReleaseIndex();
+    free(m_line.s);
+    m_line.l = m_line.m = 0;
+    m_line.s = NULL;
+    
     if (m_bIsOpen)
     {
         bcf_hdr_destroy(m_pHeader);
@@ -99,31 +138,186 @@ bool CVcfReader::Close()
     m_pHeader = NULL;
     m_pRecord = NULL;
     m_pHtsFile = NULL;
-    
+    m_filterListIds.clear();
+    ReleaseBuffers();
+    m_nLastSkippedContigId = -1;
 
     return true;
 }
 
+bool CVcfReader::LoadIndex()
+{
+    if (!m_bIsOpen)
+        return false;
+    
+    if (HasIndex())
+        return true;
+    
+    //Plain vcf files cannot be indexed
+    const htsFormat* pFormat = hts_get_format(m_pHtsFile);
+    if (pFormat->format == bcf)
+        m_pBcfIndex = bcf_index_load(m_filename.c_str());
+    else if (pFormat->compression == bgzf)
+        m_pTabixIndex = tbx_index_load(m_filename.c_str());
+    
+    return HasIndex();
+}
+
+bool CVcfReader::HasIndex() const
+{
+    return m_pTabixIndex != NULL || m_pBcfIndex != NULL;
+}
+
+bool CVcfReader::SetContig(const std::string& a_rContigName)
+{
+    if (!HasIndex())
+        return false;
+    
+    if (m_pIterator != NULL)
+        hts_itr_destroy(m_pIterator);
+    
+    if (m_pBcfIndex != NULL)
+        m_pIterator = bcf_itr_querys(m_pBcfIndex, m_pHeader, a_rContigName.c_str());
+    else
+        m_pIterator = tbx_itr_querys(m_pTabixIndex, a_rContigName.c_str());
+    
+    return m_pIterator != NULL;
+}
+
+int CVcfReader::ReadRecord()
+{
+    if (m_pIterator == NULL)
+        return bcf_read(m_pHtsFile, m_pHeader, m_pRecord);
+    
+    if (m_pBcfIndex != NULL)
+    {
+        //Iterator does not subset the samples as bcf_read does
+        int result = bcf_itr_next(m_pHtsFile, m_pIterator, m_pRecord);
+        if (result >= 0 && m_pHeader->keep_samples != NULL)
+            return bcf_subset_format(m_pHeader, m_pRecord);
+        return result < 0 ? result : 0;
+    }
+    
+    int result = tbx_itr_next(m_pHtsFile, m_pTabixIndex, m_pIterator, &m_line);
+    if (result < 0)
+        return result;
+    return vcf_parse1(&m_line, m_pHeader, m_pRecord);
+}
+
+void CVcfReader::ReleaseIndex()
+{
+    if (m_pIterator != NULL)
+        hts_itr_destroy(m_pIterator);
+    if (m_pTabixIndex != NULL)
+        tbx_destroy(m_pTabixIndex);
+    if (m_pBcfIndex != NULL)
+        hts_idx_destroy(m_pBcfIndex);
+    
+    m_pIterator = NULL;
+    m_pTabixIndex = NULL;
+    m_pBcfIndex = NULL;
+}
+
+void CVcfReader::InitArenas(std::vector<CVariantArena>& a_rArenas) const
+{
+    a_rArenas = std::vector<CVariantArena>(m_contigs.size());
+    for(unsigned int k = 0; k < m_contigs.size(); k++)
+        a_rArenas[k].SetContigName(m_contigs[k].name);
+}
+
+void CVcfReader::SetArenas(std::vector<CVariantArena>* a_pArenas)
+{
+    m_pArenas = a_pArenas;
+}
+
+int CVcfReader::GetFilterListId(CVariantArena& a_rArena)
+{
+    if(m_pRecord->d.n_flt == 0)
+        return CVariantArena::EMPTY_FILTER_LIST_ID;
+    
+    //Filter ids of the record are copied to a reused key buffer, so the lookup does not allocate once the filter set is cached
+    m_aFilterKeyBuffer.assign(1, m_pRecord->rid);
+    m_aFilterKeyBuffer.insert(m_aFilterKeyBuffer.end(), m_pRecord->d.flt, m_pRecord->d.flt + m_pRecord->d.n_flt);
+    std::map<std::vector<int>, int>::const_iterator cached = m_filterListIds.find(m_aFilterKeyBuffer);
+    if(cached != m_filterListIds.end())
+        return cached->second;
+    
+    std::vector<std::string> filterNames;
+    for(int k = 0; k < m_pRecord->d.n_flt; k++)
+        filterNames.push_back(m_pHeader->id[BCF_DT_ID][m_pRecord->d.flt[k]].key);
+    
+    const int listId = a_rArena.AddFilterList(filterNames);
+    m_filterListIds[m_aFilterKeyBuffer] = listId;
+    return listId;
+}
+
+int CVcfReader::GetCachedFilterKey(const char* a_pFilterName)
+{
+    if(a_pFilterName != m_pCachedFilterName)
+    {
+        m_pCachedFilterName = a_pFilterName;
+        m_nCachedFilterKey = a_pFilterName == NULL ? -1 : getFilterKey(a_pFilterName);
+    }
+    return m_nCachedFilterKey;
+}
+
+void CVcfReader::ReleaseBuffers()
+{
+    free(m_pGenotypeBuffer);
+    free(m_pPhaseSetBuffer);
+    free(m_pInfoBuffer);
+    m_pGenotypeBuffer = NULL;
+    m_pPhaseSetBuffer = NULL;
+    m_pInfoBuffer = NULL;
+    m_nGenotypeBufferSize = 0;
+    m_nPhaseSetBufferSize = 0;
+    m_nInfoBufferSize = 0;
+    m_pCachedFilterName = NULL;
+    m_nCachedFilterKey = -1;
+}
+
 bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig& a_rConfig)
 {
     a_pVariant->Clear();
     a_pVariant->m_nVcfId = m_nVcfId;
-    int* gt_arr = NULL;
-    int ngt_arr = 0;
 
     int samplenumber = GetNumberOfSamples();
     int zygotCount = 0;
     
+    const int* gt_arr = NULL;
+    
     bcf_clear(m_pRecord);
     m_pRecord->d.m_allele = 0;
-    const int ok = bcf_read(m_pHtsFile, m_pHeader, m_pRecord);
-    bcf_unpack(m_pRecord, BCF_UN_ALL);
+    int ok = ReadRecord();
+    
+    //Contigs without a ##contig header line are added to the header while reading. They have no variant list in the providers, so their records are skipped
+    while(ok == 0 && m_pRecord->rid >= (int)m_contigs.size())
+    {
+        if(m_pRecord->rid != m_nLastSkippedContigId)
+        {
+            std::cerr << "WARNING: Contig " << m_pHeader->id[BCF_DT_CTG][m_pRecord->rid].key << " is not defined in the header of " << m_filename << ". Its records are skipped" << std::endl;
+            m_nLastSkippedContigId = m_pRecord->rid;
+        }
+        bcf_clear(m_pRecord);
+        m_pRecord->d.m_allele = 0;
+        ok = ReadRecord();
+    }
     
     if (ok == 0)
     {
+        //Unpack only the fields that are read below. ID column is unpacked together with the alleles
+        int unpackFlags = BCF_UN_STR | BCF_UN_FLT;
+        if(true == a_rConfig.m_bIsReadINFO)
+            unpackFlags |= BCF_UN_INFO;
+        if(samplenumber != 0)
+            unpackFlags |= BCF_UN_FMT;
+        bcf_unpack(m_pRecord, unpackFlags);
+        
+        CVariantArena& arena = (*m_pArenas)[m_pRecord->rid];
         a_pVariant->m_nId = a_nId;
-        a_pVariant->m_chrName = m_pHeader->id[BCF_DT_CTG][m_pRecord->rid].key;
-        a_pVariant->m_nChrId = m_chrIndexMap[m_pHeader->id[BCF_DT_CTG][m_pRecord->rid].key];
+        a_pVariant->SetArena(&arena);
+        //Contig ids of the header are used as the chromosome ids (see m_contigs and m_chrIndexMap)
+        a_pVariant->m_nChrId = m_pRecord->rid;
         
         //READ FILTER DATA
         bool isPassed = false;
@@ -131,17 +325,14 @@ bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig&
         if(m_pRecord->d.n_flt == 0)
             isPassed = true;
         
+        const int passFilterKey = GetCachedFilterKey(a_rConfig.m_pFilterName);
         for(int k=0; k< m_pRecord->d.n_flt; k++)
         {
-            a_pVariant->m_filterString.push_back(std::string(m_pHeader->id[BCF_DT_ID][m_pRecord->d.flt[k]].key));
-                
-            if(0 == strcmp(m_pHeader->id[BCF_DT_ID][m_pRecord->d.flt[k]].key, a_rConfig.m_pFilterName))
+            if(m_pRecord->d.flt[k] == passFilterKey)
                 isPassed = true;
         }
         a_pVariant->m_bIsFilterPASS = isPassed;
-        
-        //READ VARIANT ID
-        a_pVariant->m_variantIDfromVcf = std::string(m_pRecord->d.id);
+        a_pVariant->SetFilterListId(GetFilterListId(arena));
         
         //READ QUALITY DATA
         a_pVariant->m_fQuality = m_pRecord->qual;
@@ -168,22 +359,37 @@ bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig&
                 if(pInfo->type == BCF_BT_NULL)
                     infoEntry.type = BCF_HT_FLAG;
                 
-                infoEntry.values = malloc(pInfo->vptr_len);
+                //Values are decoded into the scratch buffer, whose size is kept in bytes since htslib counts it in elements of the decoded type
+                const int elementSize = infoEntry.type == BCF_HT_STR ? 1 : 4;
+                int bufferElementCount = m_nInfoBufferSize / elementSize;
                 int isSuccessToStructure = bcf_get_info_values(m_pHeader, m_pRecord, m_infoNames[k].c_str(),
-                                                           (void**)(&infoEntry.values), &infoEntry.n, infoEntry.type);
+                                                               &m_pInfoBuffer, &bufferElementCount, infoEntry.type);
+                m_nInfoBufferSize = std::max(m_nInfoBufferSize, bufferElementCount * elementSize);
                 
                 if(isSuccessToStructure <= 0)
                     std::cerr << "BCF info failed while reading tag:" << m_infoNames[k] << std::endl;
                 else
-                    a_pVariant->m_info.m_infoArray.push_back(infoEntry);
+                {
+                    //Element count is the one htslib reports for an empty buffer (flags carry no values)
+                    if(infoEntry.type == BCF_HT_STR)
+                        infoEntry.n = pInfo->len + 1;
+                    else if(infoEntry.type != BCF_HT_FLAG)
+                        infoEntry.n = pInfo->len;
+                    
+                    const char* pValues = static_cast<const char*>(m_pInfoBuffer);
+                    infoEntry.values.assign(pValues, pValues + infoEntry.n * elementSize);
+                    a_pVariant->m_info.m_infoArray.push_back(std::move(infoEntry));
+                }
             }
         }
         
         //READ GENOTYPE DATA
         if(samplenumber != 0)
         {
-            bcf_get_genotypes(m_pHeader, m_pRecord, &gt_arr, &ngt_arr);
-            zygotCount = ngt_arr / samplenumber;
+            //Return value is used instead of the buffer size since the buffer is reused across records
+            const int genotypeCount = bcf_get_genotypes(m_pHeader, m_pRecord, &m_pGenotypeBuffer, &m_nGenotypeBufferSize);
+            zygotCount = std::max(0, genotypeCount) / samplenumber;
+            gt_arr = m_pGenotypeBuffer;
             a_pVariant->m_nAlleleCount = zygotCount;
             if(zygotCount == 2)
                 a_pVariant->m_bIsPhased = bcf_gt_is_phased(gt_arr[0]) || bcf_gt_is_phased(gt_arr[1]);
@@ -191,21 +397,39 @@ bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig&
                 a_pVariant->m_bIsPhased = bcf_gt_is_phased(gt_arr[0]);
         }
         
-        //READ SEQUENCE DATA AND FILL ALLELES
-        a_pVariant->m_refSequence = std::string(m_pRecord->d.allele[0]);
+        //READ PHASE SET
+        if(a_rConfig.m_bUsePhasing && a_pVariant->m_bIsPhased)
+        {
+            if(bcf_get_format_int32(m_pHeader, m_pRecord, "PS", &m_pPhaseSetBuffer, &m_nPhaseSetBufferSize) > 0 && m_pPhaseSetBuffer[0] != bcf_int32_missing)
+                a_pVariant->m_nPhaseSet = m_pPhaseSetBuffer[0];
+            else
+                a_pVariant->m_nPhaseSet = UNNAMED_PHASE_SET;
+        }
+        
+        //READ SEQUENCE DATA AND FILL ALLELES. REF/ALT column is stored in the arena and the reference sequence is its first allele
+        m_allelesStrBuffer.clear();
+        for(int k = 0; k < m_pRecord->n_allele; k++)
+        {
+            if(k != 0)
+                m_allelesStrBuffer += ',';
+            m_allelesStrBuffer += m_pRecord->d.allele[k];
+        }
+        const int refLength = static_cast<int>(strlen(m_pRecord->d.allele[0]));
+        a_pVariant->SetAllelesStr(arena.AddSequence(m_allelesStrBuffer.data(), static_cast<int>(m_allelesStrBuffer.size())), refLength);
         
         for (int i = 0; i < zygotCount; ++i)
         {
             int index = bcf_gt_allele(gt_arr[i]) == -1 ? 0 : bcf_gt_allele(gt_arr[i]);
-            a_pVariant->m_alleles[i].m_sequence = m_pRecord->d.allele[index];
+            a_pVariant->SetAlleleSequence(i, index);
             a_pVariant->m_alleles[i].m_nStartPos = m_pRecord->pos;
-            a_pVariant->m_alleles[i].m_nEndPos = static_cast<int>(m_pRecord->pos + a_pVariant->m_refSequence.length());
+            a_pVariant->m_alleles[i].m_nEndPos = static_cast<int>(m_pRecord->pos + refLength);
         }
         
         //SET ZYGOSITY OF THE VARIANT (HOMOZYGOUS or HETEROZYGOUS)
         if(zygotCount == 2)
         {
-            if(a_pVariant->m_alleles[0].m_sequence == a_pVariant->m_alleles[1].m_sequence)
+            if(a_pVariant->GetAlleleLength(0) == a_pVariant->GetAlleleLength(1)
+               && 0 == memcmp(a_pVariant->GetAlleleSequence(0), a_pVariant->GetAlleleSequence(1), a_pVariant->GetAlleleLength(0)))
             {
                 a_pVariant->m_nAlleleCount = 1;
                 a_pVariant->m_bIsHeterozygous = false;
@@ -231,7 +455,7 @@ bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig&
                 
                 if(curGT == 0 || curGT == -1)
                     a_pVariant->m_alleles[i].m_bIsIgnored = true;
-                else if(HasMultipleTrimming(a_pVariant->m_alleles[i]))
+                else if(HasMultipleTrimming(*a_pVariant, i))
                     a_pVariant->m_bHaveMultipleTrimOption = true;
                 else
                     a_pVariant->TrimVariant(i, a_rConfig.m_bTrimBeginningFirst);
@@ -267,17 +491,11 @@ bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig&
         else
         {
             a_pVariant->m_nStartPos = m_pRecord->pos;
-            a_pVariant->m_nEndPos = m_pRecord->pos + static_cast<int>(a_pVariant->m_refSequence.length());
+            a_pVariant->m_nEndPos = m_pRecord->pos + refLength;
         }
         
-        //FILL ORIGINAL ALLELE STR AND GENOTYPE FOR LATER ACCESS
+        //FILL GENOTYPE FOR LATER ACCESS
         a_pVariant->m_nZygotCount = zygotCount;
-        for(int k = 0; k < m_pRecord->n_allele; k++)
-        {
-            if(k != 0)
-                a_pVariant->m_allelesStr += ",";
-            a_pVariant->m_allelesStr += std::string(m_pRecord->d.allele[k]);
-        }
         
         //Set original genotypes
         a_pVariant->m_bIsNoCall = true;
@@ -292,9 +510,6 @@ bool CVcfReader::GetNextRecord(CVariant * a_pVariant, int a_nId, const SConfig&
         //Set original position
         a_pVariant->m_nOriginalPos = m_pRecord->pos;
         
-        
-        //FREE BUFFERS
-        free(gt_arr);
         return true;
     }
     else 
@@ -363,7 +578,11 @@ int CVcfReader::getFilterKey(const char* a_pFilterValue)
 
 void CVcfReader::TrimAllele(SAllele& a_rAllele)
 {
-    a_rAllele.m_sequence = a_rAllele.m_sequence.substr(1, a_rAllele.m_sequence.length() - 1);
+    if(a_rAllele.m_sequence.m_nLength > 0)
+    {
+        a_rAllele.m_sequence.m_nOffset += 1;
+        a_rAllele.m_sequence.m_nLength -= 1;
+    }
     a_rAllele.m_nStartPos += 1;
 }
 
@@ -400,34 +619,38 @@ void CVcfReader::GetFilterInfo(std::vector<std::string> &a_rFilterNames, std::ve
     }
 }
 
-bool CVcfReader::HasMultipleTrimming(SAllele& a_rAllele)
+bool CVcfReader::HasMultipleTrimming(const CVariant& a_rVariant, int a_nAlleleIndex) const
 {
-    if(a_rAllele.m_sequence == "*" || a_rAllele.m_sequence.length() < 2)
+    const char* pSequence = a_rVariant.GetAlleleSequence(a_nAlleleIndex);
+    const int sequenceLength = a_rVariant.GetAlleleLength(a_nAlleleIndex);
+    
+    if((sequenceLength == 1 && pSequence[0] == '*') || sequenceLength < 2)
         return false;
     
     //Ref string
-    std::string refString = m_pRecord->d.allele[0];
+    const char* pRef = m_pRecord->d.allele[0];
+    const int refLength = static_cast<int>(strlen(pRef));
     
     //We do not need to check insertion
-    if(refString.length() < a_rAllele.m_sequence.length() || refString.length() < 2)
+    if(refLength < sequenceLength || refLength < 2)
         return false;
     
     unsigned int trimLengthFromBeginning = 0;
     unsigned int trimLengthFromEnd = 0;
     
     //Trim from the beginning
-    unsigned int compSize = static_cast<unsigned int>(std::min(refString.size(), a_rAllele.m_sequence.size()));
+    unsigned int compSize = static_cast<unsigned int>(std::min(refLength, sequenceLength));
     for(unsigned int k = 0; k < compSize; k++)
     {
-        if(a_rAllele.m_sequence[k] != refString[k])
+        if(pSequence[k] != pRef[k])
             break;
         trimLengthFromBeginning++;
     }
     
     //Trim from the end
-    for(int k = static_cast<int>(refString.size() - 1), p = static_cast<int>(a_rAllele.m_sequence.size() - 1); k >= 0 && p >= 0;  k--, p--)
+    for(int k = refLength - 1, p = sequenceLength - 1; k >= 0 && p >= 0;  k--, p--)
     {
-        if(a_rAllele.m_sequence[p] != refString[k])
+        if(pSequence[p] != pRef[k])
             break;
         trimLengthFromEnd++;
     }
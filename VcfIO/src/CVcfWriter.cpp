@@ -143,6 +143,15 @@ void CVcfWriter::AddRecord(const SVcfRecord& a_rVcfRecord)
             std::cerr << "Failed to update Filter for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
     }
     
+    //Set approximate decision flag
+    if(a_rVcfRecord.m_bIsApproximate)
+    {
+        success = bcf_update_info_flag(m_pHeader, m_pRecord, "BA", NULL, 1);
+        
+        if(success < 0)
+            std::cerr << "Failed to update BA INFO for Record: " << "Chr" << a_rVcfRecord.m_chrName << " Position: " << a_rVcfRecord.m_nPosition << std::endl;
+    }
+    
     //==Set Per Sample Data==
 
     //1.Genotype Set (GT)
@@ -365,7 +374,7 @@ void CVcfWriter::WriteInfoColumns(const SInfo* pInfo)
     {
         for(int k = 0; k < (int)pInfo->m_infoArray.size(); k++)
         {
-            success = bcf_update_info(m_pHeader, m_pRecord, pInfo->m_infoArray[k].key.c_str(), pInfo->m_infoArray[k].values, pInfo->m_infoArray[k].n, pInfo->m_infoArray[k].type);
+            success = bcf_update_info(m_pHeader, m_pRecord, pInfo->m_infoArray[k].key.c_str(), pInfo->m_infoArray[k].values.data(), pInfo->m_infoArray[k].n, pInfo->m_infoArray[k].type);
             if(success < 0)
             {
                 std::cout << "INFO update is failed : " << pInfo->m_infoArray[k].key << std::endl;